@@ -7,6 +7,9 @@ CONFIG_DIR=$PROJECT/config_cc65
 # name that will be used in files
 VERSION_STRING="1.1b3"
 
+# number of 8k banks of flash f/manager takes up. the CSVs in flash_config must install fm.00 up to the last of them
+FLASH_BANK_COUNT=13
+
 # debug logging levels: 1=error, 2=warn, 3=info, 4=debug general, 5=allocations
 #DEBUG_DEF_1="-DLOG_LEVEL_1"
 #DEBUG_DEF_2="-DLOG_LEVEL_2"
@@ -67,7 +70,12 @@ cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_D
 cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T list_panel.c -o $BUILD_DIR/list_panel.s
 # MB 2024-12-15: even -Os is now resulting in segmentation fault for the memsys file. turned it off for now.
 cc65 -g --cpu $CC65CPU -t $CC65TGT --code-name OVERLAY_MEMSYS -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T memsys.c -o $BUILD_DIR/memsys.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT --code-name OVERLAY_BANKOPS $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T overlay_bankops.c -o $BUILD_DIR/overlay_bankops.s
 cc65 -g --cpu $CC65CPU -t $CC65TGT --code-name OVERLAY_EM $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T overlay_em.c -o $BUILD_DIR/overlay_em.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT --code-name OVERLAY_FILEOPS $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T overlay_fileops.c -o $BUILD_DIR/overlay_fileops.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT --code-name OVERLAY_HEX $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T overlay_hex.c -o $BUILD_DIR/overlay_hex.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT --code-name OVERLAY_SNAPSHOT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T overlay_snapshot.c -o $BUILD_DIR/overlay_snapshot.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT --code-name OVERLAY_PATCH $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T overlay_patch.c -o $BUILD_DIR/overlay_patch.s
 cc65 -g --cpu $CC65CPU -t $CC65TGT --code-name OVERLAY_STARTUP $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T overlay_startup.c -o $BUILD_DIR/overlay_startup.s
 cc65 -g --cpu $CC65CPU -t $CC65TGT --code-name OVERLAY_SCREEN $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T screen.c -o $BUILD_DIR/screen.s
 cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T sys.c -o $BUILD_DIR/sys.s
@@ -95,7 +103,12 @@ ca65 -t $CC65TGT keyboard.s
 ca65 -t $CC65TGT list_panel.s
 ca65 -t $CC65TGT list.s
 ca65 -t $CC65TGT memsys.s
+ca65 -t $CC65TGT overlay_bankops.s
 ca65 -t $CC65TGT overlay_em.s
+ca65 -t $CC65TGT overlay_fileops.s
+ca65 -t $CC65TGT overlay_hex.s
+ca65 -t $CC65TGT overlay_patch.s
+ca65 -t $CC65TGT overlay_snapshot.s
 ca65 -t $CC65TGT overlay_startup.s
 ca65 -t $CC65TGT screen.s
 ca65 -t $CC65TGT sys.s
@@ -113,7 +126,7 @@ ca65 -t $CC65TGT ../text_ml.asm -o text_ml.o
 echo "\n**************************\nLD65 link start...\n**************************\n"
 
 # link files into an executable
-ld65 -C $CONFIG_DIR/$OVERLAY_CONFIG -o fmanager.rom kernel.o app.o bank.o comm_buffer.o debug.o file.o folder.o general.o keyboard.o list.o list_panel.o memory.o memsys.o overlay_em.o overlay_startup.o screen.o sys.o text.o text_ml.o $CC65LIB -m fmanager_$CC65TGT.map -Ln labels.lbl
+ld65 -C $CONFIG_DIR/$OVERLAY_CONFIG -o fmanager.rom kernel.o app.o bank.o comm_buffer.o debug.o file.o folder.o general.o keyboard.o list.o list_panel.o memory.o memsys.o overlay_bankops.o overlay_em.o overlay_fileops.o overlay_hex.o overlay_patch.o overlay_snapshot.o overlay_startup.o screen.o sys.o text.o text_ml.o $CC65LIB -m fmanager_$CC65TGT.map -Ln labels.lbl
 # $PROJECT/cc65/lib/common.lib
 
 #noTE: 2024-02-12: removed name.o as it was incompatible with the lichking-style memory map I want to use to get more memory
@@ -130,8 +143,8 @@ cp ../strings/strings.bin .
 
 
 #build pgZ for disk
-fname=("fmanager.rom" "fmanager.rom.1" "fmanager.rom.2" "fmanager.rom.3" "fmanager.rom.4" "fmanager.rom.5" "strings.bin")
-addr=("990700" "000001" "002001" "004001" "006001" "008001" "004002")
+fname=("fmanager.rom" "fmanager.rom.1" "fmanager.rom.2" "fmanager.rom.3" "fmanager.rom.4" "fmanager.rom.5" "fmanager.rom.6" "fmanager.rom.7" "fmanager.rom.8" "fmanager.rom.9" "fmanager.rom.10" "strings.bin")
+addr=("990700" "000001" "002001" "004001" "006001" "008001" "00a001" "00c001" "00e001" "000002" "002002" "004002")
 
 
 for ((i = 1; i <= $#fname; i++)); do
@@ -141,7 +154,7 @@ done
 echo -n 'Z' >> pgZ_start.hdr
 echo -n '\x99\x07\x00\x00\x00\x00' >> pgZ_end.hdr
 
-cat pgZ_start.hdr fmanager.rom.hdr fmanager.rom fmanager.rom.1.hdr fmanager.rom.1 fmanager.rom.2.hdr fmanager.rom.2 fmanager.rom.3.hdr fmanager.rom.3 fmanager.rom.4.hdr fmanager.rom.4 fmanager.rom.5.hdr fmanager.rom.5 strings.bin.hdr strings.bin pgZ_end.hdr > fm.pgZ 
+cat pgZ_start.hdr fmanager.rom.hdr fmanager.rom fmanager.rom.1.hdr fmanager.rom.1 fmanager.rom.2.hdr fmanager.rom.2 fmanager.rom.3.hdr fmanager.rom.3 fmanager.rom.4.hdr fmanager.rom.4 fmanager.rom.5.hdr fmanager.rom.5 fmanager.rom.6.hdr fmanager.rom.6 fmanager.rom.7.hdr fmanager.rom.7 fmanager.rom.8.hdr fmanager.rom.8 fmanager.rom.9.hdr fmanager.rom.9 fmanager.rom.10.hdr fmanager.rom.10 strings.bin.hdr strings.bin pgZ_end.hdr > fm.pgZ 
 
 rm *.hdr
 
@@ -171,8 +184,16 @@ cat $PROJECT/fm_firmware_header.bin fm.pgZ > fm.bin
 cd fm_install/flash
 split -d -b8192 ../../fm.bin fm.
 
-# make the last chunk be exactly 8k
-truncate -s 8K fm.07
+# the CSVs only install FLASH_BANK_COUNT chunks: anything past that would be left out of flash
+if [[ -e fm.$(printf '%02d' $FLASH_BANK_COUNT) ]]; then
+echo "fm.bin needs more than $FLASH_BANK_COUNT banks of flash: raise FLASH_BANK_COUNT, and add the new chunks to the flash_config CSVs"
+exit 1
+fi
+
+# make every chunk be exactly 8k. this also creates any (empty) chunk the CSVs list but split didn't need
+for ((i = 0; i < $FLASH_BANK_COUNT; i++)); do
+truncate -s 8K fm.$(printf '%02d' $i)
+done
 
 # zip it up
 cd ../../
@@ -27,6 +27,8 @@
 #include "memory.h"
 #include "memsys.h"
 #include "overlay_em.h"
+#include "overlay_fileops.h"
+#include "overlay_hex.h"
 #include "overlay_startup.h"
 #include "text.h"
 #include "screen.h"
@@ -71,6 +73,7 @@ static UI_Menu_Enabler_Info	app_menu_enabler;		// info to pass to Screen to help
 
 static uint8_t				app_active_panel_id;	// PANEL_ID_LEFT or PANEL_ID_RIGHT
 static uint8_t				app_connected_drive_count;
+static bool					app_menu_overdrawn;		// set when the progress bar has been drawn over the bottom rows of the menu
 
 static uint8_t				app_progress_bar_char[8] = 
 {
@@ -90,15 +93,28 @@ static uint8_t				app_progress_bar_char[8] =
 
 char					app_search_phrase_human_readable_storage[MAX_SEARCH_PHRASE_LEN + 1];
 char					app_search_phrase_storage[MAX_SEARCH_PHRASE_LEN + 1];
+uint8_t					app_search_mask_storage[MAX_SEARCH_PHRASE_LEN + 1];
 char*					global_search_phrase_human_readable = app_search_phrase_human_readable_storage;
 char*					global_search_phrase = app_search_phrase_storage;
+uint8_t*				global_search_mask = app_search_mask_storage;	// one per byte of global_search_phrase. FF=must match exactly
 uint8_t					global_search_phrase_len;
 
+char					app_multi_search_human_readable_storage[MAX_MULTI_SEARCH_INPUT_LEN + 1];
+uint8_t					app_multi_search_phrases_storage[MAX_MULTI_SEARCH_INPUT_LEN + 2];
+char*					global_multi_search_human_readable = app_multi_search_human_readable_storage;
+uint8_t*				global_multi_search_phrases = app_multi_search_phrases_storage;	// each phrase as its length, then its bytes. a length of 0 ends the list
+
+uint8_t					global_bank_checksum_stale[BANK_CHECKSUM_NUM_BANKS / 8];	// one bit per bank: set if f/manager wrote to the bank since its checksum was last calculated
+uint8_t					global_bank_header_stale[BANK_CHECKSUM_NUM_BANKS / 8];	// one bit per bank: set if the bank's KUP header needs to be read again
+uint8_t					global_bank_profile_stale[BANK_CHECKSUM_NUM_BANKS / 8];	// one bit per bank: set if the bank map needs to profile the bank again
+uint8_t					global_snapshot_count;	// RAM snapshots made or restored since f/manager started. until there is one, a snapshot stores every bank
+
 
 char*					global_named_app_dos = "dos";
 char*					global_named_app_basic = "basic";
 
 int8_t					global_connected_device[DEVICE_MAX_DEVICE_COUNT];	// will be 8, 9, etc, if connected, or -1 if not. 
+int32_t					global_free_bytes_on_disk[DEVICE_MAX_DEVICE_COUNT];	// free space per drive, as of the last time a directory on it was read. FILE_FREE_BYTES_UNKNOWN if not known, FILE_FREE_BYTES_NOT_REPORTED if the drive doesn't say.
 
 bool					global_started_from_flash;		// tracks whether app started from flash or from disk
 bool					global_clock_is_visible;		// tracks whether or not the clock should be drawn. set to false when not showing main 2-panel screen.
@@ -159,6 +175,18 @@ void App_InitializePanelForMemory(uint8_t panel_id, bool for_flash);
 // handles user input
 uint8_t App_MainLoop(void);
 
+// copy the_len bytes of physical memory from src_addr to dst_addr in one DMA operation -- no bank switching
+// DMA copies upwards, so the ranges must not overlap unless dst_addr is below src_addr
+// pass wait_for_vblank=true for the first operation of a job, and false for any that follow it straight away
+void App_CopyMemoryWithDMA(uint32_t dst_addr, uint32_t src_addr, uint32_t the_len, bool wait_for_vblank);
+
+// map the bank holding phys_addr into the bulk EM window, and return the CPU address phys_addr is now visible at
+// disables interrupts and the I/O page: call App_EMUnmapBulkWindow() as soon as possible
+uint8_t* App_EMMapBulkWindow(uint32_t phys_addr);
+
+// put the I/O page back in place of the bulk EM window, and re-enable interrupts
+void App_EMUnmapBulkWindow(void);
+
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
@@ -197,6 +225,7 @@ int8_t	App_ScanDevices(void)
 	for (device = DEVICE_LOWEST_DEVICE_NUM; device <= DEVICE_HIGHEST_DEVICE_NUM; device++)
 	{
 		sprintf(the_drive_path, "%u:", device);
+		global_free_bytes_on_disk[device] = FILE_FREE_BYTES_UNKNOWN;
 //	Buffer_NewMessage(the_drive_path);
 		dir = Kernel_OpenDir(the_drive_path);
 
@@ -230,6 +259,11 @@ void App_Initialize(void)
 {
 	Buffer_Clear();
 
+	// nothing has been checksummed or scanned for KUP headers yet
+	memset(global_bank_checksum_stale, 0xFF, sizeof(global_bank_checksum_stale));
+	memset(global_bank_header_stale, 0xFF, sizeof(global_bank_header_stale));
+	memset(global_bank_profile_stale, 0xFF, sizeof(global_bank_profile_stale));
+
 	// show info about the host F256 and environment, as well as copyright, version of f/manager
 	App_LoadOverlay(OVERLAY_SCREEN);
 	Screen_ShowAppAboutInfo();
@@ -389,7 +423,16 @@ uint8_t App_MainLoop(void)
 			Screen_UpdateMenuStates(&app_menu_enabler);
 			
 			// ask Screen to draw the appropriate set of menus, only doing those that haven't changed since last round
-			Screen_RenderMenu(PARAM_ONLY_RENDER_CHANGED_ITEMS);
+			// the progress bar sits on top of the last few menu rows: if it was shown, redraw the whole menu
+			if (app_menu_overdrawn == true)
+			{
+				Screen_RenderMenu(PARAM_RENDER_ALL_MENU_ITEMS);
+				app_menu_overdrawn = false;
+			}
+			else
+			{
+				Screen_RenderMenu(PARAM_ONLY_RENDER_CHANGED_ITEMS);
+			}
 
 			// ask Screen to get user input and vet it against the menu items that are currently enabled
 			// only inputs for active menu items will cause an input to be returned here
@@ -474,6 +517,30 @@ uint8_t App_MainLoop(void)
 					//Buffer_NewMessage(global_string_buff1);
 					break;
 				
+				case ACTION_MOVE:
+					success = Panel_MoveSelectedFiles(the_panel, &app_file_panel[(app_active_panel_id + 1) % 2]);
+					break;
+				
+				case ACTION_MARK_TOGGLE:
+					success = Panel_ToggleCurrentFileMark(the_panel);
+					break;
+				
+				case ACTION_MARK_ALL:
+					success = Panel_SetAllFileMarks(the_panel, PARAM_MARK_ALL);
+					break;
+				
+				case ACTION_MARK_INVERT:
+					success = Panel_SetAllFileMarks(the_panel, PARAM_MARK_INVERT);
+					break;
+				
+				case ACTION_UNMARK_ALL:
+					success = Panel_SetAllFileMarks(the_panel, PARAM_MARK_NONE);
+					break;
+				
+				case ACTION_MARK_BY_PATTERN:
+					success = Panel_MarkFilesByPattern(the_panel);
+					break;
+				
 				case ACTION_RENAME:
 					success = Panel_RenameCurrentFile(the_panel);
 					break;
@@ -503,6 +570,67 @@ uint8_t App_MainLoop(void)
 					success = Panel_SearchCurrentBank(the_panel);
 					break;
 
+				case ACTION_COPY_MEMORY_RANGE:
+					success = Panel_CopyMemoryRange(the_panel, &app_file_panel[(app_active_panel_id + 1) % 2]);
+					break;
+
+				case ACTION_SAVE_MEMORY_RANGE:
+					success = Panel_SaveMemoryRange(the_panel, &app_file_panel[(app_active_panel_id + 1) % 2]);
+					break;
+
+				case ACTION_SNAPSHOT_MEMORY:
+					success = Panel_SnapshotMemory(the_panel, &app_file_panel[(app_active_panel_id + 1) % 2]);
+					break;
+
+				case ACTION_RESTORE_SNAPSHOT:
+					success = Panel_RestoreMemorySnapshot(the_panel, &app_file_panel[(app_active_panel_id + 1) % 2]);
+					break;
+
+				case ACTION_APPLY_PATCH:
+					success = Panel_ApplyPatch(the_panel, &app_file_panel[(app_active_panel_id + 1) % 2]);
+					break;
+
+				case ACTION_SEARCH_MEMORY_ALL:
+					global_clock_is_visible = false;
+					success = Panel_SearchAllFromCurrentBank(the_panel);
+					App_LoadOverlay(OVERLAY_SCREEN);
+					Screen_Render();	// the results list has completely overwritten the screen
+					Screen_RenderMenu(PARAM_RENDER_ALL_MENU_ITEMS);
+					Panel_RenderContents(&app_file_panel[PANEL_ID_LEFT]);
+					Panel_RenderContents(&app_file_panel[PANEL_ID_RIGHT]);
+					break;
+
+				case ACTION_SEARCH_MEMORY_MULTI:
+					global_clock_is_visible = false;
+					success = Panel_SearchPhrasesFromCurrentBank(the_panel);
+					App_LoadOverlay(OVERLAY_SCREEN);
+					Screen_Render();	// the results list has completely overwritten the screen
+					Screen_RenderMenu(PARAM_RENDER_ALL_MENU_ITEMS);
+					Panel_RenderContents(&app_file_panel[PANEL_ID_LEFT]);
+					Panel_RenderContents(&app_file_panel[PANEL_ID_RIGHT]);
+					break;
+
+				case ACTION_COMPARE_BANKS:
+					global_clock_is_visible = false;
+					success = Panel_CompareBanks(the_panel, &app_file_panel[(app_active_panel_id + 1) % 2]);
+					App_LoadOverlay(OVERLAY_SCREEN);
+					Screen_Render();	// the results list has completely overwritten the screen
+					Screen_RenderMenu(PARAM_RENDER_ALL_MENU_ITEMS);
+					Panel_RenderContents(&app_file_panel[PANEL_ID_LEFT]);
+					Panel_RenderContents(&app_file_panel[PANEL_ID_RIGHT]);
+					break;
+
+				case ACTION_BANK_MAP:
+					global_clock_is_visible = false;
+					App_LoadOverlay(OVERLAY_HEX);
+					Hex_DisplayBankMap();
+					App_LoadOverlay(OVERLAY_SCREEN);
+					Screen_Render();	// the bank map has completely overwritten the screen
+					Screen_RenderMenu(PARAM_RENDER_ALL_MENU_ITEMS);
+					Panel_RenderContents(&app_file_panel[PANEL_ID_LEFT]);
+					Panel_RenderContents(&app_file_panel[PANEL_ID_RIGHT]);
+					break;
+
 				case ACTION_SEARCH_MEMORY_NEXT:
 					App_LoadOverlay(OVERLAY_EM);
 					success = global_find_next_enabled = EM_SearchMemory(PARAM_START_AFTER_LAST_HIT);					
@@ -528,6 +656,8 @@ uint8_t App_MainLoop(void)
 					break;
 					
 				case ACTION_REFRESH_PANEL:
+					// f/manager never writes to flash, or notices other programs writing to RAM: only an explicit refresh re-reads every KUP header
+					memset(global_bank_header_stale, 0xFF, sizeof(global_bank_header_stale));
 					Panel_Refresh(the_panel);			
 					break;
 				
@@ -657,6 +787,8 @@ uint8_t App_MainLoop(void)
 // Draws the progress bar frame on the screen
 void App_ShowProgressBar(void)
 {
+	app_menu_overdrawn = true;
+	
 	Text_DrawHLine(UI_MIDDLE_AREA_START_X, PROGRESS_BAR_Y - 1, UI_MIDDLE_AREA_WIDTH, CH_UNDERSCORE, MENU_ACCENT_COLOR, APP_BACKGROUND_COLOR, CHAR_AND_ATTR);
 	Text_DrawHLine(UI_MIDDLE_AREA_START_X, PROGRESS_BAR_Y,     UI_MIDDLE_AREA_WIDTH, CH_SPACE,      MENU_ACCENT_COLOR, APP_BACKGROUND_COLOR, CHAR_AND_ATTR);
 	Text_DrawHLine(UI_MIDDLE_AREA_START_X, PROGRESS_BAR_Y + 1, UI_MIDDLE_AREA_WIDTH, CH_OVERSCORE,  MENU_ACCENT_COLOR, APP_BACKGROUND_COLOR, CHAR_AND_ATTR);
@@ -763,53 +895,381 @@ void App_UpdateProgressBar(uint8_t progress_bar_total)
 // }
 
 
+// remember that f/manager has written to the_len bytes of physical memory starting at phys_addr
+// the checksums, KUP headers, and bank map profiles of the banks involved are out of date until they are next looked at
+void App_MarkBanksChanged(uint32_t phys_addr, uint32_t the_len)
+{
+	uint8_t		the_bank_num;
+	uint8_t		last_bank_num;
+	uint8_t		the_bit;
+	
+	if (the_len == 0)
+	{
+		return;
+	}
+	
+	the_bank_num = (uint8_t)(phys_addr >> 13);
+	last_bank_num = (uint8_t)((phys_addr + the_len - 1) >> 13);
+	
+	for (; the_bank_num <= last_bank_num && the_bank_num < BANK_CHECKSUM_NUM_BANKS; the_bank_num++)
+	{
+		// the checksum table's own bank changes every time anything is stored in it. it is only f/manager's bookkeeping: leave it be.
+		if (the_bank_num == BANK_CHECKSUM_EM_SLOT)
+		{
+			continue;
+		}
+		
+		the_bit = (1 << (the_bank_num & 0x07));
+		global_bank_checksum_stale[the_bank_num >> 3] |= the_bit;
+		global_bank_header_stale[the_bank_num >> 3] |= the_bit;
+		global_bank_profile_stale[the_bank_num >> 3] |= the_bit;
+	}
+}
+
+
+// copy the_len bytes of physical memory from src_addr to dst_addr in one DMA operation -- no bank switching
+// DMA copies upwards, so the ranges must not overlap unless dst_addr is below src_addr
+// pass wait_for_vblank=true for the first operation of a job, and false for any that follow it straight away
+void App_CopyMemoryWithDMA(uint32_t dst_addr, uint32_t src_addr, uint32_t the_len, bool wait_for_vblank)
+{
+	App_MarkBanksChanged(dst_addr, the_len);
+	
+	*(uint16_t*)ZP_TO_ADDR = dst_addr & 0xFFFF;
+	*(uint8_t*)(ZP_TO_ADDR + 2) = (dst_addr >> 16) & 0xFF;
+	
+	*(uint16_t*)ZP_FROM_ADDR = src_addr & 0xFFFF;
+	*(uint8_t*)(ZP_FROM_ADDR + 2) = (src_addr >> 16) & 0xFF;
+	
+	*(uint16_t*)ZP_COPY_LEN = the_len & 0xFFFF;
+	*(uint8_t*)(ZP_COPY_LEN + 2) = (the_len >> 16) & 0xFF;
+	
+	Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
+	Memory_CopyWithDMA(wait_for_vblank);
+	Sys_RestoreIOPage();
+}
+
+
+// copy the_len bytes of physical memory from src_addr to dst_addr, using DMA -- no bank switching
+// addresses are 20-bit physical machine addresses, and both ranges must be in RAM: DMA can't read flash
+// the ranges may overlap: the result is the same as if the source had first been copied somewhere else (like memmove)
+void App_MoveMemoryWithDMA(uint32_t dst_addr, uint32_t src_addr, uint32_t the_len)
+{
+	uint32_t	the_distance;
+	uint32_t	the_chunk_len;
+	bool		wait_for_vblank = true;
+	
+	// LOGIC:
+	//   DMA always copies upwards, from the first byte to the last.
+	//   that is fine if the ranges don't overlap, or if dst is below src: every byte is read before anything can overwrite it.
+	//   if dst is above src and the ranges overlap, work from the end backwards, in chunks:
+	//     a chunk no longer than the distance between src and dst can't overlap its own target, so it can be copied directly.
+	//     if the distance is under a page, that would be a great many tiny operations, so instead each page is bounced
+	//     through the interbank buffer, which can't overlap either range (it is in the first 64K, which is never a valid target).
+	//   either way, by the time a chunk is written, every source byte it overwrites has already been copied.
+	//   only the first DMA operation of the job waits for vertical blank: the rest follow it straight away.
+	//     (with a short distance there are 2 operations per page, and waiting for each would cost a whole frame per page)
+	
+	if (the_len == 0 || dst_addr == src_addr)
+	{
+		return;
+	}
+	
+	if (dst_addr < src_addr || dst_addr >= src_addr + the_len)
+	{
+		App_CopyMemoryWithDMA(dst_addr, src_addr, the_len, true);
+		return;
+	}
+	
+	the_distance = dst_addr - src_addr;
+	
+	while (the_len > 0)
+	{
+		if (the_distance >= STORAGE_FILE_BUFFER_1_LEN)
+		{
+			the_chunk_len = (the_len < the_distance ? the_len : the_distance);
+			the_len -= the_chunk_len;
+			App_CopyMemoryWithDMA(dst_addr + the_len, src_addr + the_len, the_chunk_len, wait_for_vblank);
+		}
+		else
+		{
+			the_chunk_len = (the_len < STORAGE_FILE_BUFFER_1_LEN ? the_len : STORAGE_FILE_BUFFER_1_LEN);
+			the_len -= the_chunk_len;
+			App_CopyMemoryWithDMA(STORAGE_FILE_BUFFER_1_PHYS_ADDR, src_addr + the_len, the_chunk_len, wait_for_vblank);
+			App_CopyMemoryWithDMA(dst_addr + the_len, STORAGE_FILE_BUFFER_1_PHYS_ADDR, the_chunk_len, false);
+		}
+		
+		wait_for_vblank = false;
+	}
+}
+
+
+// fill a range of physical memory with the passed value, using DMA -- no bank switching
+// phys_addr is the 20-bit physical machine address to start at. the_len is number of bytes to fill (eg, 8192 for a whole bank)
+void App_FillMemoryWithDMA(uint32_t phys_addr, uint32_t the_len, uint8_t the_fill_value)
+{
+	// LOGIC:
+	//   one hardware operation fills the whole range, no matter how many banks it spans: nothing gets mapped into CPU space.
+	//   DMA can only write to RAM. caller is responsible for not pointing this at flash, or at f/manager's own memory.
+	
+	App_MarkBanksChanged(phys_addr, the_len);
+	
+	*(uint16_t*)ZP_TO_ADDR = phys_addr & 0xFFFF;
+	*(uint8_t*)(ZP_TO_ADDR + 2) = (phys_addr >> 16) & 0xFF;
+	
+	*(uint16_t*)ZP_COPY_LEN = the_len & 0xFFFF;
+	*(uint8_t*)(ZP_COPY_LEN + 2) = (the_len >> 16) & 0xFF;
+	
+	*(uint8_t*)ZP_OTHER_PARAM = the_fill_value;
+	
+	Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
+	Memory_FillWithDMA();
+	Sys_RestoreIOPage();
+}
+
+
+// fill a rectangle of physical memory with the passed value, using DMA -- no bank switching
+// phys_addr is the 20-bit physical machine address of the top left corner. 
+// the_height rows of the_width bytes are filled, with the start of each row the_stride bytes after the start of the previous one
+void App_FillMemoryRectWithDMA(uint32_t phys_addr, uint16_t the_width, uint8_t the_height, uint16_t the_stride, uint8_t the_fill_value)
+{
+	if (the_height > 0)
+	{
+		App_MarkBanksChanged(phys_addr, (uint32_t)the_stride * (the_height - 1) + the_width);
+	}
+	
+	*(uint16_t*)ZP_TO_ADDR = phys_addr & 0xFFFF;
+	*(uint8_t*)(ZP_TO_ADDR + 2) = (phys_addr >> 16) & 0xFF;
+	
+	*(uint16_t*)ZP_COPY_LEN = the_width;
+	*(uint8_t*)(ZP_COPY_LEN + 2) = the_height;
+	
+	*(uint16_t*)ZP_FROM_ADDR = the_stride;
+	
+	*(uint8_t*)ZP_OTHER_PARAM = the_fill_value;
+	
+	Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
+	Memory_FillWithDMA2D();
+	Sys_RestoreIOPage();
+}
+
+
+// map the bank holding phys_addr into the bulk EM window, and return the CPU address phys_addr is now visible at
+// disables interrupts and the I/O page: call App_EMUnmapBulkWindow() as soon as possible
+uint8_t* App_EMMapBulkWindow(uint32_t phys_addr)
+{
+	// LOGIC:
+	//   the window is the i/o + kernel#2 slot ($C000-$DFFF), not the overlay slot. that way, overlay code that asked for the copy or scan
+	//   is still mapped in while it runs. same approach as General_GetString(), just for any bank.
+	//   bank # is physical address / 8192. eg, 0x28000 / 0x2000 = bank 0x14
+	
+	// Disable the I/O page so we can get to RAM under it
+	asm("SEI"); // disable interrupts in case some other process has a role here
+	Sys_DisableIOBank();
+	asm("SEI"); // disable interrupts in case some other process has a role here
+	
+	zp_bank_num = (uint8_t)(phys_addr >> 13);
+	Memory_SwapInNewBank(EM_BULK_WINDOW_SLOT);
+	
+	return (uint8_t*)(EM_BULK_WINDOW_CPU_ADDR + ((uint16_t)phys_addr & (EM_BULK_WINDOW_LEN - 1)));
+}
+
+
+// put the I/O page back in place of the bulk EM window, and re-enable interrupts
+void App_EMUnmapBulkWindow(void)
+{
+	Memory_RestorePreviousBank(EM_BULK_WINDOW_SLOT);
+	asm("CLI"); // restore interrupts
+	
+	// Re-enable the I/O page, which unmaps the EM bank from 6502 RAM space
+	Sys_RestoreIOPage();
+}
+
+
+// copy the_len bytes between specified 6502 addr and any physical memory address, using bank switching -- no DMA
+// phys_addr is the 20-bit physical machine address. the range may cross any number of bank boundaries
+// each bank is mapped in once, and up to 8K is copied per mapping
+// cpu_addr must not be in $C000-$DFFF: that is where the bank is mapped
+// set to_em to true to copy from CPU space to EM, or false to copy from EM to specified CPU addr. PARAM_COPY_TO_EM/PARAM_COPY_FROM_EM
+void App_EMBulkCopy(uint8_t* cpu_addr, uint32_t phys_addr, uint16_t the_len, bool to_em)
+{
+	uint16_t	run_len;
+	uint8_t*	em_cpu_addr;
+	
+	if (to_em == true)
+	{
+		App_MarkBanksChanged(phys_addr, the_len);
+	}
+	
+	while (the_len > 0)
+	{
+		// copy as far as the end of the current bank, or the end of the range, whichever comes first
+		run_len = EM_BULK_WINDOW_LEN - ((uint16_t)phys_addr & (EM_BULK_WINDOW_LEN - 1));
+		
+		if (run_len > the_len)
+		{
+			run_len = the_len;
+		}
+		
+		em_cpu_addr = App_EMMapBulkWindow(phys_addr);
+		
+		if (to_em == true)
+		{
+			memcpy(em_cpu_addr, cpu_addr, run_len);
+		}
+		else
+		{
+			memcpy(cpu_addr, em_cpu_addr, run_len);
+		}
+		
+		App_EMUnmapBulkWindow();
+		
+		cpu_addr += run_len;
+		phys_addr += run_len;
+		the_len -= run_len;
+	}
+}
+
+
+// process the_len bytes of physical memory in place, without copying them anywhere first
+// phys_addr is the 20-bit physical machine address. the range may cross any number of bank boundaries
+// the_callback is called once per bank with a pointer to the data (in $C000-$DFFF), the number of bytes there (1-8192), and their physical address
+// the callback runs with interrupts and the I/O page disabled: it must not draw to the screen, call the kernel, or switch banks
+// the callback returns false to stop early
+// returns false if the callback stopped early, true if the whole range was processed
+bool App_EMForEachRun(uint32_t phys_addr, uint32_t the_len, bool (* the_callback)(uint8_t*, uint16_t, uint32_t))
+{
+	uint16_t	run_len;
+	uint8_t*	em_cpu_addr;
+	bool		keep_going;
+	
+	while (the_len > 0)
+	{
+		run_len = EM_BULK_WINDOW_LEN - ((uint16_t)phys_addr & (EM_BULK_WINDOW_LEN - 1));
+		
+		if (run_len > the_len)
+		{
+			run_len = the_len;
+		}
+		
+		em_cpu_addr = App_EMMapBulkWindow(phys_addr);
+		keep_going = (*the_callback)(em_cpu_addr, run_len, phys_addr);
+		App_EMUnmapBulkWindow();
+		
+		if (keep_going == false)
+		{
+			return false;
+		}
+		
+		phys_addr += run_len;
+		the_len -= run_len;
+	}
+	
+	return true;
+}
+
+
 // copy 256b chunks of data between specified 6502 addr and the fixed address range in EM, using bank switching -- no DMA
 // em_bank_num is used to derive the base EM address
 // page_num is used to calculate distance from the base EM address
 // set to_em to true to copy from CPU space to EM, or false to copy from EM to specified CPU addr. PARAM_COPY_TO_EM/PARAM_COPY_FROM_EM
 void App_EMDataCopy(uint8_t* cpu_addr, uint8_t em_bank_num, uint8_t page_num, bool to_em)
 {
-	//uint32_t	em_addr;			// physical memory address (20 bit)
-	uint8_t		em_slot;			// 00-7F are valid slots, but our dedicated EM storage starts at bank $14
-	uint8_t*	em_cpu_addr;		// A000-BFFF: the specific target address within the CPU address space that the EM memory has been banked into
-	uint8_t		previous_overlay_bank_num;
-	
-
 	// LOGIC:
-	//   The overlay bank will be temporarily swapped out, and the required EM bank swapped in (tried to swap out kernel#2/IO bank, but froze up)
-	//   required bank # can be calculated by taking system address and dividing by 8192. eg, 0x40000 / 0x2000 = bank 0x20
 	//   sys address is physical machine 20-bit address.
 	//   sys address is relative to em_bank_num, based on page_num passed
 	//     eg, if em_bank_num=$14 (EM_STORAGE_START_PHYS_ADDR ($28000=bank 14)) and page_num=0, it is $28000, if page_num is 7 it is $28000 + 7*256
-	//   cpu address is $0000-$FFFF range that CPU can access
-	
-	// add the offset to the base address get to the right place for this chunk's copy
-	em_slot = em_bank_num + (page_num / 32);
-	//em_addr = (uint32_t)(em_bank_num * 8192) + (page_num * 256));
+	//   a page never straddles a bank, so this is always exactly one mapping
 	
-	// CPU addr has to keep recycling space between A000-BFFF, so when chunk num is >32, need to get it back down under 32
-	em_cpu_addr = (uint8_t*)((uint16_t)EM_STORAGE_START_CPU_ADDR + ((page_num % 32) * 256));
+	App_EMBulkCopy(cpu_addr, ((uint32_t)em_bank_num * EM_BULK_WINDOW_LEN) + ((uint16_t)page_num * 256), 256, to_em);
+}
+
+
+// read up to one bank of data from an open file straight into the specified bank of physical memory -- no interbank buffer
+// the bank is mapped into the overlay slot while the kernel reads into it, so this must live in MAIN, not in an overlay
+// if less than a full bank (but more than nothing) is read, the rest of the last 256b page is zeroed, so the data is always terminated
+// returns the number of bytes read (0-8192)
+uint16_t App_EMReadFromFile(FILE* the_file_handler, uint8_t em_bank_num)
+{
+	uint16_t	bytes_read;
+	uint8_t		previous_overlay_bank_num;
+	uint8_t*	em_cpu_addr = (uint8_t*)EM_STORAGE_START_CPU_ADDR;
 	
-	//sprintf(global_string_buff1, "EM copy page_num=%u, em_slot=%u, em_cpu_addr=%p", page_num, em_slot, em_cpu_addr);
-	//Buffer_NewMessage(global_string_buff1);
+	// LOGIC:
+	//   the kernel can only deliver 255 bytes per read event, but read() keeps asking until it has the whole bank or hits EOF.
+	//   each delivery goes straight from the kernel into the mapped bank: no per-page memset, and no copy through STORAGE_FILE_BUFFER_1.
+	//   can't use the bulk EM window for this: it needs interrupts and the I/O page off, and the kernel needs both.
+	//   if the file had already run out (it was an exact multiple of 8K), nothing is read, and the bank is left exactly as it was.
 	
-	// map the required EM bank into the overlay bank temporarily
-	zp_bank_num = em_slot;
+	zp_bank_num = em_bank_num;
 	previous_overlay_bank_num = Memory_SwapInNewBank(EM_STORAGE_START_SLOT);
 	
-	// copy data to/from
-	if (to_em == true)
+	bytes_read = fread(em_cpu_addr, sizeof(char), EM_BULK_WINDOW_LEN, the_file_handler);
+	
+	if (bytes_read > 0)
 	{
-		memcpy(em_cpu_addr, cpu_addr, 256);
+		App_MarkBanksChanged((uint32_t)em_bank_num * EM_BULK_WINDOW_LEN, EM_BULK_WINDOW_LEN);
 	}
-	else
+	
+	if (bytes_read > 0 && bytes_read < EM_BULK_WINDOW_LEN)
 	{
-		memcpy(cpu_addr, em_cpu_addr, 256);
+		// zero out the rest of the final page, to help prevent problems with future consumers of the EM data (the viewers work in whole pages)
+		memset(em_cpu_addr + bytes_read, 0, 256 - (bytes_read & 0xFF));
 	}
 	
 	// map whatever overlay had been in place, back in place
 	zp_bank_num = previous_overlay_bank_num;
-	previous_overlay_bank_num = Memory_SwapInNewBank(EM_STORAGE_START_SLOT);	
+	Memory_SwapInNewBank(EM_STORAGE_START_SLOT);
+	
+	return bytes_read;
+}
+
+
+// read exactly the_len bytes from an open file straight into the specified bank of physical memory -- no interbank buffer
+// the_offset is the distance from the start of the bank. the_offset + the_len must not go past the end of the bank
+// the bank is mapped into the overlay slot while the kernel reads into it, so this must live in MAIN, not in an overlay
+// returns false if the file ran out before the_len bytes were read
+bool App_EMReadRangeFromFile(FILE* the_file_handler, uint8_t em_bank_num, uint16_t the_offset, uint16_t the_len)
+{
+	uint16_t	bytes_read;
+	uint8_t		previous_overlay_bank_num;
+	
+	App_MarkBanksChanged((uint32_t)em_bank_num * EM_BULK_WINDOW_LEN + the_offset, the_len);
+	
+	zp_bank_num = em_bank_num;
+	previous_overlay_bank_num = Memory_SwapInNewBank(EM_STORAGE_START_SLOT);
+	
+	bytes_read = fread((uint8_t*)(EM_STORAGE_START_CPU_ADDR + the_offset), sizeof(char), the_len, the_file_handler);
+	
+	// map whatever overlay had been in place, back in place
+	zp_bank_num = previous_overlay_bank_num;
+	Memory_SwapInNewBank(EM_STORAGE_START_SLOT);
+	
+	return (bytes_read == the_len);
+}
+
+
+// write the_len bytes from the specified bank of physical memory straight to an open file -- no interbank buffer
+// the_offset is the distance from the start of the bank. the_offset + the_len must not go past the end of the bank
+// the bank is mapped into the overlay slot while the kernel writes from it, so this must live in MAIN, not in an overlay
+// returns false if the kernel didn't accept all the bytes
+bool App_EMWriteToFile(FILE* the_file_handler, uint8_t em_bank_num, uint16_t the_offset, uint16_t the_len)
+{
+	uint16_t	bytes_written;
+	uint8_t		previous_overlay_bank_num;
+	
+	// LOGIC:
+	//   write() splits this into 254-byte kernel writes, each taken straight from the mapped bank.
+	
+	zp_bank_num = em_bank_num;
+	previous_overlay_bank_num = Memory_SwapInNewBank(EM_STORAGE_START_SLOT);
+	
+	bytes_written = fwrite((uint8_t*)(EM_STORAGE_START_CPU_ADDR + the_offset), sizeof(char), the_len, the_file_handler);
+	
+	// map whatever overlay had been in place, back in place
+	zp_bank_num = previous_overlay_bank_num;
+	Memory_SwapInNewBank(EM_STORAGE_START_SLOT);
+	
+	return (bytes_written == the_len);
 }
 
 
@@ -927,6 +1387,8 @@ void App_SetFilenameInEM(WB2KFileObject* the_file, const char* the_filename)
 	addr_loc = (0xC000 + FILE_MAX_FILENAME_SIZE * the_file->id_);
 	the_addr = (char*)addr_loc;
 	
+	App_MarkBanksChanged((uint32_t)(FILENAME_STORAGE_EM_SLOT + the_file->panel_id_) * EM_BULK_WINDOW_LEN + FILE_MAX_FILENAME_SIZE * the_file->id_, FILE_MAX_FILENAME_SIZE);
+	
 	// Disable the I/O page so we can get to RAM under it
 	asm("SEI"); // disable interrupts in case some other process has a role here
 	asm("lda $01");	// Stash the current IO page at ZP_OLD_IO_PAGE
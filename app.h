@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <stdio.h>
 //#include <string.h>
 
 
@@ -71,6 +72,9 @@
 #define FILE_SIZE_MAX_SIZE			16	// max size of human-readable file size. eg, "255 blocks", "1,200 MB"
 #define FILE_BYTES_PER_BLOCK_IEC	254	// for CBM DOS, 1 block = 256b but really only 254
 #define FILE_BYTES_PER_BLOCK		256	// for FAT32, 1 block = 256b
+#define FILE_FREE_BYTES_UNKNOWN		-1	// free space on a drive that hasn't been (or can't be) reported by the kernel
+#define FILE_FREE_BYTES_NOT_REPORTED	-2	// a directory on the drive was read to the end, and the kernel had no free space for it. asking again won't help until the next read
+#define FILE_FREE_BYTES_MAX			0x7FFFFFFF	// free space is tracked as a signed 32-bit number. more than this is just reported as this.
 #define MAX_NUM_FILES_IEC			144 // The directory track should be contained totally on track 18. Sectors 1-18 contain the entries and sector 0 contains the BAM (Block Availability Map) and disk name/ID. Since the directory is only 18 sectors large (19 less one for the BAM), and each sector can contain only 8 entries (32 bytes per entry), the maximum number of directory entries is 18 * 8 = 144. http://justsolve.archiveteam.org/wiki/CBMFS
 // BUT... 1581 supported 296 entries. hmm. 
 
@@ -102,6 +106,7 @@
 #define STORAGE_GETSTRING_BUFFER_LEN		256	// 1-page buffer. see cc65 memory config file. this is outside cc65 space.
 #define STORAGE_FILE_BUFFER_1				0x0500	// interbank buffer for file reading operations
 #define STORAGE_FILE_BUFFER_1_LEN			256	// 1-page buffer. see cc65 memory config file. this is outside cc65 space.
+#define STORAGE_FILE_BUFFER_1_PHYS_ADDR		0x00500	// same buffer, as seen by DMA. CPU slot 0 is always physical bank 0.
 #define STORAGE_STRING_BUFFER_1				(STORAGE_FILE_BUFFER_1 + STORAGE_FILE_BUFFER_1_LEN)	// temp string merge/etc buff
 #define STORAGE_STRING_BUFFER_1_LEN			204	// 204b buffer. see cc65 memory config file. this is outside cc65 space.
 #define STORAGE_STRING_BUFFER_2				(STORAGE_STRING_BUFFER_1 + STORAGE_STRING_BUFFER_1_LEN)	// temp string merge/etc buff
@@ -118,6 +123,32 @@
 #define FILENAME_STORAGE_EM_SLOT             0x1B
 #define FILENAME_STORAGE_PHYS_ADDR           0x36000
 
+// table of matches from the last find-all search: 4-byte physical addresses
+#define SEARCH_RESULTS_EM_SLOT             0x13
+#define SEARCH_RESULTS_PHYS_ADDR           0x26000
+#define SEARCH_RESULTS_MAX_HITS            2048	// can be lowered to taste. 2048 * 4 bytes fills the bank
+#define SEARCH_RESULTS_ADDR_MASK           0x000FFFFFUL	// top byte of an entry is 0, or for a multi-phrase search, the phrase number (1-8)
+
+// automaton for multi-phrase searches. see SEARCH_AUTOMATON_* in memory.h for its layout
+#define SEARCH_AUTOMATON_EM_SLOT           0x1E
+#define SEARCH_AUTOMATON_PHYS_ADDR         0x3C000
+
+// table of checksums and cached KUP header info for every bank of RAM and flash. see MEMSYS_CHECKSUM_* in memsys.c for its layout
+#define BANK_CHECKSUM_EM_SLOT              0x1F
+#define BANK_CHECKSUM_PHYS_ADDR            0x3E000
+#define BANK_CHECKSUM_NUM_BANKS            128	// 64 RAM + 64 flash
+
+// what Memory_ProfileBank() last returned for every bank of RAM and flash (BANK_PROFILE_LEN bytes apiece), for the bank map. after the checksum table, in the same bank
+#define BANK_PROFILE_PHYS_ADDR             (BANK_CHECKSUM_PHYS_ADDR + 0x0400)
+
+// checksum of every bank of RAM (4 bytes apiece) as of the last snapshot made or restored, so the next snapshot can leave out the banks that haven't changed
+#define BANK_SNAPSHOT_PHYS_ADDR            (BANK_CHECKSUM_PHYS_ADDR + 0x0600)
+// ... and the checksums of the snapshot being made or restored, which replace them once it is complete
+#define BANK_SNAPSHOT_PENDING_PHYS_ADDR    (BANK_CHECKSUM_PHYS_ADDR + 0x0700)
+
+// lookup table for Memory_Crc32(), built by Memory_MakeCrc32Table() when a patch is opened. see CRC32_TABLE_* in memory.h. in the same bank
+#define BANK_CRC32_TABLE_PHYS_ADDR         (BANK_CHECKSUM_PHYS_ADDR + 0x0800)
+
 
 /*****************************************************************************/
 /*                           App-wide color choices                          */
@@ -138,6 +169,8 @@
 
 #define LIST_ACTIVE_COLOR			COLOR_BRIGHT_GREEN
 #define LIST_INACTIVE_COLOR			COLOR_GREEN
+#define LIST_MARKED_COLOR			COLOR_BRIGHT_YELLOW
+#define LIST_MARKED_INACTIVE_COLOR	COLOR_BROWN
 
 #define LIST_HEADER_COLOR			COLOR_BRIGHT_YELLOW
 
@@ -155,6 +188,7 @@
 #define FILE_CONTENTS_FOREGROUND_COLOR	COLOR_BRIGHT_GREEN
 #define FILE_CONTENTS_BACKGROUND_COLOR	COLOR_BLACK
 #define FILE_CONTENTS_ACCENT_COLOR		COLOR_GREEN
+#define FILE_CONTENTS_CHANGED_COLOR		COLOR_BRIGHT_YELLOW	// hex viewer: bytes that differ from the bank being compared against
 
 
 /*****************************************************************************/
@@ -193,6 +227,23 @@
 #define ACTION_LOAD_MEMORY			'L'
 #define ACTION_SEARCH_MEMORY		'f'
 #define ACTION_SEARCH_MEMORY_NEXT	'g'
+#define ACTION_SEARCH_MEMORY_ALL	'G'	// find every match, and list them
+#define ACTION_SEARCH_MEMORY_MULTI	'E'	// find every match to any of several phrases, in one pass, and list them
+#define ACTION_COMPARE_BANKS		'B'	// compare the banks selected in the 2 panels, and list where they differ
+#define ACTION_BANK_MAP				'H'	// show every bank of RAM and flash as a grid, colored by how it is being used
+#define ACTION_COPY_MEMORY_RANGE	'K'	// copy any range of RAM to anywhere else in RAM
+#define ACTION_SAVE_MEMORY_RANGE	'W'	// write any number of banks to one file
+#define ACTION_SNAPSHOT_MEMORY		'Z'	// pack every bank of RAM the user can write to into one file. after the first, only banks that changed
+#define ACTION_RESTORE_SNAPSHOT		'U'	// unpack a snapshot file back into RAM
+#define ACTION_APPLY_PATCH			'P'	// apply an IPS or BPS patch to a file, or to RAM
+#define ACTION_MOVE					'v'
+
+// multi-file selection ("marking") actions
+#define ACTION_MARK_TOGGLE			CH_SPACE
+#define ACTION_MARK_ALL				'A'
+#define ACTION_MARK_INVERT			CH_KTIMES
+#define ACTION_MARK_BY_PATTERN		CH_KPLUS
+#define ACTION_UNMARK_ALL			CH_KMINUS
 
 
 // folder actions
@@ -280,11 +331,13 @@
 #define OVERLAY_EM				0x0A
 #define OVERLAY_STARTUP			0x0B
 #define OVERLAY_MEMSYSTEM		0x0C
-#define OVERLAY_6					0x0D
-#define OVERLAY_7					0x0E
-#define OVERLAY_8					0x0F
-#define OVERLAY_9					0x10
-#define OVERLAY_10					0x11
+#define OVERLAY_FILEOPS			0x0D
+#define OVERLAY_BANKOPS			0x0E
+#define OVERLAY_HEX				0x0F
+#define OVERLAY_SNAPSHOT		0x10
+#define OVERLAY_PATCH			0x11
+
+#define OVERLAY_LAST_IN_USE		OVERLAY_PATCH	// every bank up to and including this one holds f/manager code or data: user can't write to them
 
 #define CUSTOM_FONT_PHYS_ADDR              0x3A000	// temporary buffer for loading in a font?
 #define CUSTOM_FONT_SLOT                   0x05
@@ -347,12 +400,63 @@ void App_UpdateProgressBar(uint8_t progress_bar_total);
 // // set to_em to true to copy from CPU space to EM, or false to copy from EM to specified CPU addr.
 // void App_EMDataCopyDMA(uint8_t* cpu_addr, uint8_t page_num, bool to_em);
 
+// remember that f/manager has written to the_len bytes of physical memory starting at phys_addr
+// the checksums, KUP headers, and bank map profiles of the banks involved are out of date until they are next looked at
+void App_MarkBanksChanged(uint32_t phys_addr, uint32_t the_len);
+
+// copy the_len bytes of physical memory from src_addr to dst_addr, using DMA -- no bank switching
+// addresses are 20-bit physical machine addresses, and both ranges must be in RAM: DMA can't read flash
+// the ranges may overlap: the result is the same as if the source had first been copied somewhere else (like memmove)
+void App_MoveMemoryWithDMA(uint32_t dst_addr, uint32_t src_addr, uint32_t the_len);
+
+// fill a range of physical memory with the passed value, using DMA -- no bank switching
+// phys_addr is the 20-bit physical machine address to start at. the_len is number of bytes to fill (eg, 8192 for a whole bank)
+void App_FillMemoryWithDMA(uint32_t phys_addr, uint32_t the_len, uint8_t the_fill_value);
+
+// fill a rectangle of physical memory with the passed value, using DMA -- no bank switching
+// phys_addr is the 20-bit physical machine address of the top left corner. 
+// the_height rows of the_width bytes are filled, with the start of each row the_stride bytes after the start of the previous one
+void App_FillMemoryRectWithDMA(uint32_t phys_addr, uint16_t the_width, uint8_t the_height, uint16_t the_stride, uint8_t the_fill_value);
+
+// copy the_len bytes between specified 6502 addr and any physical memory address, using bank switching -- no DMA
+// phys_addr is the 20-bit physical machine address. the range may cross any number of bank boundaries
+// each bank is mapped in once, and up to 8K is copied per mapping
+// cpu_addr must not be in $C000-$DFFF: that is where the bank is mapped
+// set to_em to true to copy from CPU space to EM, or false to copy from EM to specified CPU addr. PARAM_COPY_TO_EM/PARAM_COPY_FROM_EM
+void App_EMBulkCopy(uint8_t* cpu_addr, uint32_t phys_addr, uint16_t the_len, bool to_em);
+
+// process the_len bytes of physical memory in place, without copying them anywhere first
+// phys_addr is the 20-bit physical machine address. the range may cross any number of bank boundaries
+// the_callback is called once per bank with a pointer to the data (in $C000-$DFFF), the number of bytes there (1-8192), and their physical address
+// the callback runs with interrupts and the I/O page disabled: it must not draw to the screen, call the kernel, or switch banks
+// the callback returns false to stop early
+// returns false if the callback stopped early, true if the whole range was processed
+bool App_EMForEachRun(uint32_t phys_addr, uint32_t the_len, bool (* the_callback)(uint8_t*, uint16_t, uint32_t));
+
 // copy 256b chunks of data between specified 6502 addr and the fixed address range in EM, using bank switching -- no DMA
 // em_bank_num is used to derive the base EM address
 // page_num is used to calculate distance from the base EM address
 // set to_em to true to copy from CPU space to EM, or false to copy from EM to specified CPU addr. PARAM_COPY_TO_EM/PARAM_COPY_FROM_EM
 void App_EMDataCopy(uint8_t* cpu_addr, uint8_t em_bank_num, uint8_t page_num, bool to_em);
 
+// read up to one bank of data from an open file straight into the specified bank of physical memory -- no interbank buffer
+// the bank is mapped into the overlay slot while the kernel reads into it, so this must live in MAIN, not in an overlay
+// if less than a full bank (but more than nothing) is read, the rest of the last 256b page is zeroed, so the data is always terminated
+// returns the number of bytes read (0-8192)
+uint16_t App_EMReadFromFile(FILE* the_file_handler, uint8_t em_bank_num);
+
+// read exactly the_len bytes from an open file straight into the specified bank of physical memory -- no interbank buffer
+// the_offset is the distance from the start of the bank. the_offset + the_len must not go past the end of the bank
+// the bank is mapped into the overlay slot while the kernel reads into it, so this must live in MAIN, not in an overlay
+// returns false if the file ran out before the_len bytes were read
+bool App_EMReadRangeFromFile(FILE* the_file_handler, uint8_t em_bank_num, uint16_t the_offset, uint16_t the_len);
+
+// write the_len bytes from the specified bank of physical memory straight to an open file -- no interbank buffer
+// the_offset is the distance from the start of the bank. the_offset + the_len must not go past the end of the bank
+// the bank is mapped into the overlay slot while the kernel writes from it, so this must live in MAIN, not in an overlay
+// returns false if the kernel didn't accept all the bytes
+bool App_EMWriteToFile(FILE* the_file_handler, uint8_t em_bank_num, uint16_t the_offset, uint16_t the_len);
+
 // read the real time clock and display it
 void App_DisplayTime(void);
 
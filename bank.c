@@ -250,19 +250,11 @@ void Bank_Clear(FMBankObject* the_bank)
 // fills the bank with the passed value
 void Bank_Fill(FMBankObject* the_bank, uint8_t the_fill_value)
 {
-	uint8_t		i;
-	char*		the_buffer = (char*)STORAGE_FILE_BUFFER_1;
-	
 	// LOGIC:
-	//   bank is made up of 64 pages of 256b
-	//   to fill, we set the desired value in the interbank copy buff, then do 64 copy ops
+	//   a bank is 8192 contiguous bytes of physical memory, starting at bank_num * 8192
+	//   DMA fills all of it in one hardware operation, without having to map it into CPU space page by page
 
-	memset(the_buffer, the_fill_value, STORAGE_FILE_BUFFER_1_LEN);
-	
-	for (i = 0; i < PAGES_PER_BANK; i++)
-	{
-		App_EMDataCopy((uint8_t*)the_buffer, the_bank->bank_num_, i, PARAM_COPY_TO_EM);
-	}
+	App_FillMemoryWithDMA((uint32_t)the_bank->bank_num_ * BYTES_PER_BANK, BYTES_PER_BANK, the_fill_value);
 	
 	sprintf(global_string_buff1, General_GetString(ID_STR_MSG_BANK_FILLED_WITH), the_bank->bank_num_, the_fill_value, the_fill_value);
 	Buffer_NewMessage(global_string_buff1);
@@ -408,6 +400,8 @@ void Bank_Render(FMBankObject* the_bank, bool as_selected, int8_t y_offset, bool
 	uint8_t	typex;
 	uint8_t	the_color;
 	int8_t	y;
+	uint32_t	the_checksum;
+	bool	is_identical;
 	
 	// LOGIC:
 	//   Panel is responsible for having flowed the content in a way that each bank either has a displayable display_row_ value, or -1.
@@ -438,11 +432,20 @@ void Bank_Render(FMBankObject* the_bank, bool as_selected, int8_t y_offset, bool
 		sprintf(global_string_buff1, "%06lX", the_bank->addr_);
 		y = the_bank->display_row_ + y_offset;
 		Text_FillBox(x1, y, x2, y, CH_SPACE, the_color, APP_BACKGROUND_COLOR);
-		Text_DrawStringAtXY( x1, y, the_bank->name_, the_color, APP_BACKGROUND_COLOR);
 		Text_DrawStringAtXY( sizex, y, global_string_buff1, the_color, APP_BACKGROUND_COLOR);
 		sprintf(global_string_buff1, "%02X", the_bank->bank_num_);
 		Text_DrawStringAtXY( typex, y, global_string_buff1, the_color, APP_BACKGROUND_COLOR);
 		
+		// name gets cut off to make room for the checksum. a bank with the same checksum as another gets a '=' after its checksum.
+		General_Strlcpy(global_string_buff1, the_bank->name_, UI_PANEL_BANK_SUM_OFFSET);
+		Text_DrawStringAtXY( x1, y, global_string_buff1, the_color, APP_BACKGROUND_COLOR);
+		
+		if (MemSys_GetBankChecksum(the_bank->bank_num_, &the_checksum, &is_identical) == true)
+		{
+			sprintf(global_string_buff1, "%08lX%c", the_checksum, (is_identical ? '=' : ' '));
+			Text_DrawStringAtXY( x1 + UI_PANEL_BANK_SUM_OFFSET, y, global_string_buff1, the_color, APP_BACKGROUND_COLOR);
+		}
+		
 		if (as_selected == true)
 		{
 			Text_SetXY(x1, y);
@@ -49,6 +49,25 @@
 /*****************************************************************************/
 
 #define PAGES_PER_BANK	32	// page=256b, bank=8192b, 8192/256=32
+#define BYTES_PER_BANK	8192
+#define BANK_SAVE_CHUNK_LEN	2048	// bytes handed to the kernel per write when saving a bank: big enough to keep the device busy, small enough to move the progress bar
+
+// layout of a RAM snapshot file: a header, the checksum of every bank of RAM, then a record for each bank stored in the file
+#define BANK_SNAPSHOT_SIGNATURE				"FMRS"	// f/manager RAM snapshot
+#define BANK_SNAPSHOT_SIGNATURE_LEN			4
+#define BANK_SNAPSHOT_VERSION				4		// offset of the format version byte in the header
+#define BANK_SNAPSHOT_NUM_RECORDS			5		// offset of the number of banks stored in the file
+#define BANK_SNAPSHOT_FLAGS					6		// offset of the flags byte. the last byte of the header is unused
+#define BANK_SNAPSHOT_HEADER_LEN			8
+#define BANK_SNAPSHOT_CURRENT_VERSION		1
+#define BANK_SNAPSHOT_FLAG_INCREMENTAL		0x01	// banks that hadn't changed since the previous snapshot were left out: restore that one first
+#define BANK_SNAPSHOT_CHECKSUMS_LEN			256		// after the header: 4b Fletcher-32 checksum of each bank of RAM, stored or not. 0 for f/manager's own banks
+#define BANK_SNAPSHOT_RECORD_BANK			0		// each record: 1b bank number, 1b encoding, 2b length of the data that follows it
+#define BANK_SNAPSHOT_RECORD_ENCODING		1
+#define BANK_SNAPSHOT_RECORD_DATA_LEN		2
+#define BANK_SNAPSHOT_RECORD_LEN			4
+#define BANK_SNAPSHOT_ENCODING_RAW			0		// the bank as it is
+#define BANK_SNAPSHOT_ENCODING_PACKED		1		// the bank packed by Memory_CompressBank()
 
 #define PARAM_MARK_SELECTION_AS_ACTIVE		true	// param for Bank_Render(). When marking selection, use the active formatting.
 #define PARAM_MARK_SELECTION_AS_INACTIVE	true	// param for Bank_Render(). When marking selection, use the inactive formatting.
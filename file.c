@@ -20,6 +20,7 @@
 #include "comm_buffer.h"
 #include "debug.h"
 #include "file.h"
+#include "folder.h"
 #include "general.h"
 #include "kernel.h"
 #include "keyboard.h"
@@ -56,6 +57,8 @@ static char*		file_compare_filename = file_compare_filename_buffer;
 
 static uint8_t		temp_file_extension_buffer[FILE_MAX_EXTENSION_SIZE];	// 8 probably larger than needed, but... 
 
+static FILE*		file_unpack_file_handler;	// file File_ReadStreamBuffer() reads from, while File_UnpackFileToEM() runs
+
 #pragma data-name (pop)
 
 
@@ -84,10 +87,19 @@ extern uint8_t				zp_bank_num;
 // returns an identified file type, or the default_file_type passed if no match found
 uint8_t File_GetFileTypeFromExtension(uint8_t default_file_type, const char* the_file_name);
 
+// compare the first bytes of a file to known signatures ("magic numbers") to find file type
+// returns an identified file type, or the default_file_type passed if no match found
+uint8_t File_GetFileTypeFromSignature(uint8_t default_file_type, const uint8_t* the_bytes);
+
 // return a human-readable(ish) string for the filetype of the filetype ID passed - no allocation
 // see cbm_filetype.h
 char* File_GetFileTypeString(uint8_t cbm_filetype_id);
 
+// unpack an LZ4 frame or ZX0 stream from an open file into EM, starting at em_bank_num, and filling no more than max_banks
+// the_file_type is FNX_FILETYPE_LZ4 or FNX_FILETYPE_ZX0. the file must be at its start
+// Returns the number of banks filled, or FILE_LOAD_ERROR_DAMAGED or FILE_LOAD_ERROR_NO_ROOM
+int16_t File_UnpackFileToEM(FILE* the_file_handler, uint8_t em_bank_num, uint8_t max_banks, uint8_t the_file_type);
+
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
@@ -164,6 +176,95 @@ uint8_t File_GetFileTypeFromExtension(uint8_t default_file_type, const char* the
 	{
 		return _CBM_T_DIR;
 	}
+	else if (General_Strncasecmp((char*)&temp_file_extension_buffer, "lz4", FILE_MAX_EXTENSION_SIZE) == 0)
+	{
+		return FNX_FILETYPE_LZ4;
+	}
+	else if (General_Strncasecmp((char*)&temp_file_extension_buffer, "zx0", FILE_MAX_EXTENSION_SIZE) == 0)
+	{
+		// ZX0 has no signature: the extension is the only way to know
+		return FNX_FILETYPE_ZX0;
+	}
+
+	return default_file_type;
+}
+
+
+// compare the first bytes of a file to known signatures ("magic numbers") to find file type
+// returns an identified file type, or the default_file_type passed if no match found
+uint8_t File_GetFileTypeFromSignature(uint8_t default_file_type, const uint8_t* the_bytes)
+{
+	uint32_t	segment_addr;
+	uint32_t	segment_len;
+	
+	// LOGIC:
+	//   the_bytes must point to at least FILE_SNIFF_LEN bytes. any bytes past end of file should have been zeroed by caller.
+	//   .mod files have no signature in the first bytes: see File_SniffFileType
+	//   a single 'Z' or $FF $Ex is far too common to go on: any text file starting with Z, or any $FF-padded binary, would pass.
+	//     a pgZ has to start with a segment that loads something into RAM, and an MP3 with a frame header that has no reserved values in it.
+	
+	// do this in order of most likely to least likely
+	if (the_bytes[0] == 'Z' || the_bytes[0] == 'z')
+	{
+		// pgZ: 'Z' = 24 bit addresses, 'z' = 32 bit addresses
+		if (the_bytes[0] == 'Z')
+		{
+			segment_addr = the_bytes[1] | ((uint16_t)the_bytes[2] << 8) | ((uint32_t)the_bytes[3] << 16);
+			segment_len = the_bytes[4] | ((uint16_t)the_bytes[5] << 8) | ((uint32_t)the_bytes[6] << 16);
+		}
+		else
+		{
+			segment_addr = *(uint32_t*)&the_bytes[1];
+			segment_len = *(uint32_t*)&the_bytes[5];
+		}
+		
+		if (segment_len > 0 && segment_addr < FILE_PGZ_RAM_SIZE && segment_len <= FILE_PGZ_RAM_SIZE - segment_addr)
+		{
+			return FNX_FILETYPE_EXE;
+		}
+	}
+	
+	if (memcmp(the_bytes, "PGX", 3) == 0)
+	{
+		return FNX_FILETYPE_EXE;
+	}
+	else if (the_bytes[0] == 0xF2 && the_bytes[1] == 0x56)
+	{
+		// KUP header, same signature MemSys_PopulateBanks looks for
+		return FNX_FILETYPE_EXE;
+	}
+	else if (memcmp(the_bytes, "FORM", 4) == 0 && (memcmp(the_bytes + 8, "ILBM", 4) == 0 || memcmp(the_bytes + 8, "PBM ", 4) == 0))
+	{
+		return FNX_FILETYPE_IMAGE;
+	}
+	else if (memcmp(the_bytes, "MThd", 4) == 0)
+	{
+		return FNX_FILETYPE_MIDI;
+	}
+	else if (memcmp(the_bytes, "RIFF", 4) == 0 && memcmp(the_bytes + 8, "WAVE", 4) == 0)
+	{
+		return FNX_FILETYPE_WAV;
+	}
+	else if (memcmp(the_bytes, "OggS", 4) == 0)
+	{
+		return FNX_FILETYPE_OGG;
+	}
+	else if (memcmp(the_bytes, "ID3", 3) == 0)
+	{
+		// ID3v2 tag
+		return FNX_FILETYPE_MP3;
+	}
+	else if (the_bytes[0] == 0xFF && (the_bytes[1] & 0xE0) == 0xE0 && 
+		FILE_MP3_VERSION(the_bytes[1]) != 1 && FILE_MP3_LAYER(the_bytes[1]) != 0 && 
+		FILE_MP3_BITRATE(the_bytes[2]) != 0 && FILE_MP3_BITRATE(the_bytes[2]) != 15 && FILE_MP3_SAMPLE_RATE(the_bytes[2]) != 3)
+	{
+		// a bare MPEG audio frame header: 11 sync bits, and nothing reserved or unplayable in the rest
+		return FNX_FILETYPE_MP3;
+	}
+	else if (memcmp(the_bytes, FILE_LZ4_MAGIC, FILE_LZ4_MAGIC_LEN) == 0)
+	{
+		return FNX_FILETYPE_LZ4;
+	}
 
 	return default_file_type;
 }
@@ -240,6 +341,14 @@ char* File_GetFileTypeString(uint8_t cbm_filetype_id)
 			// a midi file that can be opened with a midi player
 			return General_GetString(ID_STR_FILETYPE_MIDI);
 		
+		case FNX_FILETYPE_LZ4:
+			// an LZ4 frame, unpacked when loaded into memory
+			return General_GetString(ID_STR_FILETYPE_LZ4);
+		
+		case FNX_FILETYPE_ZX0:
+			// a ZX0 packed file, unpacked when loaded into memory
+			return General_GetString(ID_STR_FILETYPE_ZX0);
+		
 		default:
 			//sprintf(global_string_buff1, "Unrecognized file type: %u", cbm_filetype_id);
 			//Buffer_NewMessage(global_string_buff1);
@@ -260,6 +369,75 @@ char* File_GetFileTypeString(uint8_t cbm_filetype_id)
 }
 
 
+// unpack an LZ4 frame or ZX0 stream from an open file into EM, starting at em_bank_num, and filling no more than max_banks
+// the_file_type is FNX_FILETYPE_LZ4 or FNX_FILETYPE_ZX0. the file must be at its start
+// Returns the number of banks filled, or FILE_LOAD_ERROR_DAMAGED or FILE_LOAD_ERROR_NO_ROOM
+int16_t File_UnpackFileToEM(FILE* the_file_handler, uint8_t em_bank_num, uint8_t max_banks, uint8_t the_file_type)
+{
+	uint8_t*	the_header = (uint8_t*)STORAGE_FILE_BUFFER_1;
+	uint8_t		the_format = PARAM_UNPACK_ZX0;
+	uint8_t		the_flags;
+	uint8_t		bytes_to_skip;
+	uint8_t		last_bank_num;
+	uint8_t		the_result;
+	
+	// LOGIC:
+	//   a ZX0 file is nothing but the packed stream, so it goes straight to the unpacker.
+	//   an LZ4 file is a frame: the header is read and checked here, then the unpacker takes the blocks that follow it.
+	//   frames that need a dictionary can't be unpacked (there is no way to get the dictionary), so are treated as damaged.
+	//   the header checksum, and the checksum of the whole content at the end of the frame, are not checked.
+	//   the unpacker reads the file 255 bytes at a time into STORAGE_FILE_BUFFER_1, and unpacks from there as the bytes arrive.
+	//   nothing is packed into a bank of its own first: every byte is written once, to where it finally belongs.
+	//   matches may reach back into earlier banks, which is why the banks must be consecutive.
+	
+	if (the_file_type == FNX_FILETYPE_LZ4)
+	{
+		if (fread(the_header, sizeof(char), FILE_LZ4_FRAME_START_LEN, the_file_handler) != FILE_LZ4_FRAME_START_LEN)
+		{
+			return FILE_LOAD_ERROR_DAMAGED;
+		}
+		
+		the_flags = the_header[FILE_LZ4_FLG_OFFSET];
+		
+		if (memcmp(the_header, FILE_LZ4_MAGIC, FILE_LZ4_MAGIC_LEN) != 0 || (the_flags & FILE_LZ4_FLG_VERSION_MASK) != FILE_LZ4_FLG_VERSION || (the_flags & FILE_LZ4_FLG_DICT_ID) != 0)
+		{
+			return FILE_LOAD_ERROR_DAMAGED;
+		}
+		
+		// skip the content size, if there is one, and the header checksum
+		bytes_to_skip = ((the_flags & FILE_LZ4_FLG_CONTENT_SIZE) ? FILE_LZ4_CONTENT_SIZE_LEN : 0) + 1;
+		
+		if (fread(the_header, sizeof(char), bytes_to_skip, the_file_handler) != bytes_to_skip)
+		{
+			return FILE_LOAD_ERROR_DAMAGED;
+		}
+		
+		the_format = ((the_flags & FILE_LZ4_FLG_BLOCK_CHECKSUMS) ? PARAM_UNPACK_LZ4_CHECKSUMS : PARAM_UNPACK_LZ4);
+	}
+	
+	file_unpack_file_handler = the_file_handler;
+	
+	*(uint8_t*)ZP_SEARCH_LOC_BANK = em_bank_num;
+	*(uint8_t*)ZP_OTHER_PARAM = em_bank_num + max_banks - 1;
+	*(uint8_t*)ZP_TEMP_1 = the_format;
+	the_result = Memory_DecompressStream();
+	last_bank_num = *(uint8_t*)ZP_SEARCH_LOC_BANK;
+	
+	App_MarkBanksChanged((uint32_t)em_bank_num * EM_BULK_WINDOW_LEN, (uint32_t)(last_bank_num - em_bank_num + 1) * EM_BULK_WINDOW_LEN);
+	
+	if (the_result == MEMORY_UNPACK_DAMAGED)
+	{
+		return FILE_LOAD_ERROR_DAMAGED;
+	}
+	else if (the_result == MEMORY_UNPACK_NO_ROOM)
+	{
+		return FILE_LOAD_ERROR_NO_ROOM;
+	}
+	
+	return (last_bank_num - em_bank_num) + 1;
+}
+
+
 
 /*****************************************************************************/
 /*                        Public Function Definitions                        */
@@ -318,6 +496,9 @@ WB2KFileObject* File_New(uint8_t the_panel_id, const char* the_file_name, bool i
 	// file is brand new: not selected yet.
 	the_file->selected_ = false;
 	
+	// haven't looked at the file's contents yet. that only happens (if needed) when the file is first selected.
+	the_file->sniffed_ = false;
+	
 	// remember date stamp, for sorting, display to user, etc.
 	the_file->datetime_.year = the_datetime->year;
 	the_file->datetime_.month = the_datetime->month;
@@ -413,6 +594,7 @@ WB2KFileObject* File_Duplicate(WB2KFileObject* the_original_file)
 	// get filetype
 	the_duplicate_file->is_directory_ = the_original_file->is_directory_;
 	the_duplicate_file->file_type_ = the_original_file->file_type_; // ok to use same one, as both are just pointing to the same file type object anyway.
+	the_duplicate_file->sniffed_ = the_original_file->sniffed_;	// same contents, so no need to sniff the copy again
 
 	// file is brand new: not selected yet.
 	the_duplicate_file->selected_ = false;
@@ -735,25 +917,30 @@ error:
 
 
 // Load the selected file into EM, starting at the address associated with the specified em_bank_num
-// Returns false on any error
-bool File_LoadFileToEM(char* the_file_path, uint8_t em_bank_num)
+// fills as many consecutive banks as the file needs, but never more than max_banks: anything past that is not loaded
+// if the_file_type is FNX_FILETYPE_LZ4 or FNX_FILETYPE_ZX0, the file is unpacked as it is read, and it is the unpacked data that fills the banks
+// pass PARAM_LOAD_AS_IS to load any file exactly as it is on disk
+// Returns the number of banks filled, FILE_LOAD_ERROR_DAMAGED or FILE_LOAD_ERROR_NO_ROOM if a packed file can't be unpacked, or FILE_LOAD_ERROR on any other error
+int16_t File_LoadFileToEM(char* the_file_path, uint8_t em_bank_num, uint8_t max_banks, uint8_t the_file_type)
 {
 	// LOGIC
 	//   does not care about file type: any time of file will allowed
-	//   loads all data into $28000 using DMA calls. 
+	//   loads all data straight into EM, one bank at a time, starting at em_bank_num. 
+	//   file can be any size: the bank count has no upper limit other than max_banks.
+	//   packed files are unpacked in the same single pass: there is never a packed copy in memory, only the unpacked data.
+	//   it is up to the caller to work out how many banks, from em_bank_num on, are safe to fill.
 	//   does not display anything
-	//   return false on any error
+	//   return FILE_LOAD_ERROR on any error
 	
 	FILE*		the_file_handler;
-	bool		keep_going = true;
-	uint8_t		page_num = 0;
-	int16_t		s_bytes_read_from_disk;
-	char*		the_buffer = (char*)STORAGE_FILE_BUFFER_1;
+	uint8_t		banks_loaded = 0;
+	uint16_t	bytes_read_from_disk;
+	int16_t		banks_unpacked;
 
-	if (the_file_path == NULL)
+	if (the_file_path == NULL || max_banks == 0)
 	{
 		//LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
-		return false;
+		return FILE_LOAD_ERROR;
 	}
 
 	the_file_handler = fopen((char*)the_file_path, "r");
@@ -766,121 +953,135 @@ bool File_LoadFileToEM(char* the_file_path, uint8_t em_bank_num)
 		goto error;
 	}
 	
+	if (the_file_type == FNX_FILETYPE_LZ4 || the_file_type == FNX_FILETYPE_ZX0)
+	{
+		banks_unpacked = File_UnpackFileToEM(the_file_handler, em_bank_num, max_banks, the_file_type);
+		fclose(the_file_handler);
+		return banks_unpacked;
+	}
 
-	// loop until file is all read
+	// loop until file is all read, or every bank we were allowed has been filled
+	// a file that is an exact multiple of 8K ends with a read that gets nothing: that bank wasn't filled, so it doesn't count
 	do
 	{
-		// clear buffer so that on whatever the last read is, when data is smaller than buffer, it gets zero-terminated
-		memset(the_buffer,0,STORAGE_FILE_BUFFER_1_LEN);
+		bytes_read_from_disk = App_EMReadFromFile(the_file_handler, em_bank_num++);
 		
-		s_bytes_read_from_disk = fread(the_buffer, sizeof(char), STORAGE_FILE_BUFFER_1_LEN, the_file_handler);
-
-		if ( s_bytes_read_from_disk < 0)
+		if (bytes_read_from_disk > 0)
 		{
-			//Buffer_NewMessage("s_bytes_read_from_disk < 0");
-			LOG_ERR(("%s %d: reading file '%s' resulted in error %i", __func__ , __LINE__, the_file_path, s_bytes_read_from_disk));
-			goto error;
-		}
-
-		if ( s_bytes_read_from_disk == 0)
-		{
-			//Buffer_NewMessage("s_bytes_read_from_disk == 0 (end of file)");
-			LOG_ERR(("%s %d: reading file '%s' produced 0 bytes", __func__ , __LINE__, the_file_path));
-			keep_going = false;
-		}
-	
-		if ( s_bytes_read_from_disk < STORAGE_FILE_BUFFER_1_LEN )
-		{
-			// we hit end of file
-			//Buffer_NewMessage("s_bytes_read_from_disk was less than full row");
-			//LOG_ERR(("%s %d: reading file '%s' expected %u bytes, got %i bytes", __func__ , __LINE__, the_file->file_name_, num_bytes_to_read, s_bytes_read_from_disk));
-			
-			// add a final 0 to buffer, to help prevent problems with future consumers of the EM data
-			the_buffer[s_bytes_read_from_disk] = 0;
-			
-			keep_going = false;
+			++banks_loaded;
 		}
-
-		App_EMDataCopy((uint8_t*)STORAGE_FILE_BUFFER_1, em_bank_num, page_num++, PARAM_COPY_TO_EM);
 		
-	} while (keep_going == true);
+	} while (bytes_read_from_disk == EM_BULK_WINDOW_LEN && banks_loaded < max_banks);
 
 	fclose(the_file_handler);	
 	
-	return true;
+	return banks_loaded;
 	
 error:
 	if (the_file_handler) fclose(the_file_handler);
-	return false;
+	return FILE_LOAD_ERROR;
 }
 
 
+// refill STORAGE_FILE_BUFFER_1 from the file File_LoadFileToEM() is unpacking. called from Memory_DecompressStream(), not from C
+// the unpacker maps the DISKSYS overlay back in before calling this. returns the number of bytes read: 0 once the file has run out
+uint8_t File_ReadStreamBuffer(void)
+{
+	return fread((uint8_t*)STORAGE_FILE_BUFFER_1, sizeof(char), STORAGE_FILE_BUFFER_1_LEN - 1, file_unpack_file_handler);
+}
 
-// // get the free disk space on the parent disk of the file
-// // returns -1 in event of error
-// int16_t File_GetFreeBytesOnDisk(WB2KFileObject* the_file)
-// {
-// 	BPTR				the_file_lock;
-// 	int16_t			bytes_free = 0;
-// 	struct InfoData*	the_info_data;
-// 	bool				success;
-// 	
-// 	// LOGIC: 
-// 	//   AmigaDOS needs a lock on any file in a disk to return an Info object with the disk's free and used space.
-// 	//   Info() requires the struct InfoData to be long-word aligned, so we'll use AllocVec
-// 	
-// 	if (the_file == NULL)
-// 	{
-// 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
-// 		return -1;
-// 	}
-// 
-// 	if ( (the_info_data = (struct InfoData*)AllocVec(sizeof(struct InfoData), MEMF_ANY) ) == NULL)
-// 	{
-// 		LOG_ERR(("%s %d: could not allocate memory for the struct InfoData", __func__ , __LINE__));
-// 		goto error;
-// 	}
-// 	LOG_ALLOC(("%s %d:	__ALLOC__	the_info_data	%p	size	%i", __func__ , __LINE__, the_info_data, sizeof(struct InfoData)));
-// 
-// 	// try to get lock on the dictionary file
-// 	if (!(the_file_lock = Lock((CONST_STRPTR)the_file->file_path_, ACCESS_READ)))
-// 	{
-// 		LOG_ERR(("%s %d: Couldn't get lock on file '%s'", __func__ , __LINE__, the_file->file_path_));
-// 		goto error;
-// 	}
-// 	
-// 	success = Info(the_file_lock, the_info_data);
-// 
-// 	if ( success == false)
-// 	{
-// 		LOG_ERR(("%s %d: Couldn't get an InfoData object for disk containing file '%s'", __func__ , __LINE__, the_file->file_path_));
-// 		UnLock(the_file_lock);
-// 		goto error;
-// 	}
-// 	
-// 	bytes_free = (the_info_data->id_NumBlocks - the_info_data->id_NumBlocksUsed) * the_info_data->id_BytesPerBlock;
-// 
-// 	//DEBUG_OUT(("%s %d: Disk containing file '%s' has %li bytes free", __func__ , __LINE__, the_file->file_path_, bytes_free));
-// 	//DEBUG_OUT(("%s %d: Disk containing file '%s' has %li bytes used", __func__ , __LINE__, the_file->file_path_, the_info_data->id_NumBlocksUsed * the_info_data->id_BytesPerBlock));
-// 	
-// 	UnLock(the_file_lock);
-// 	
-// 	LOG_ALLOC(("%s %d:	__FREE__	the_info_data	%p	size	%i", __func__ , __LINE__, the_info_data, sizeof(struct InfoData)));
-// 	FreeVec(the_info_data);
-// 	the_info_data = NULL;
-// 
-// 	return bytes_free;
-// 
-// error:
-// 	if (the_info_data)	FreeVec(the_info_data);
-// 	return -1;
-// }
 
 
+// **** OTHER FUNCTIONS *****
 
 
+// Identify the file type from the file's first bytes, if the file extension did not already identify it
+// the result is remembered in the file object, so any given file is only opened once for this
+// pass check_mod_tag=false to look only at the first bytes: the .mod tag is 1K into the file, and reading that far on an IEC drive takes seconds
+// returns true if a (new) file type was identified
+bool File_SniffFileType(WB2KFileObject* the_file, const char* the_file_path, bool check_mod_tag)
+{
+	// LOGIC:
+	//   only plain files that the extension check left as _CBM_T_REG are worth opening. folders, and anything already identified, are skipped.
+	//   read first FILE_SNIFF_LEN bytes and compare to known signatures
+	//   if no match, caller allows it, and file is big enough to be a .mod, read forward to the .mod tag at FILE_MOD_TAG_OFFSET (there is no seek, so just read past the bytes in between)
+	//   mark the file as sniffed whether anything was found or not, so it never gets opened again for this
 
-// **** OTHER FUNCTIONS *****
+	FILE*		the_file_handler;
+	uint8_t*	the_buffer = (uint8_t*)STORAGE_FILE_BUFFER_1;
+	int16_t		bytes_read;
+	uint16_t	bytes_to_skip;
+	uint8_t		the_file_type;
+
+	if (the_file == NULL)
+	{
+		//LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+	
+	if (the_file->sniffed_ == true || the_file->is_directory_ == true || the_file->file_type_ != _CBM_T_REG)
+	{
+		return false;
+	}
+	
+	the_file->sniffed_ = true;
+	the_file_type = _CBM_T_REG;
+	
+	the_file_handler = fopen(the_file_path, "r");	
+
+	if (the_file_handler == NULL)
+	{
+		LOG_ERR(("%s %d: file '%s' could not be opened for reading", __func__ , __LINE__, the_file_path));
+		return false;
+	}
+
+	// clear buffer so that a file shorter than FILE_SNIFF_LEN can't match on leftover bytes
+	memset(the_buffer, 0, FILE_SNIFF_LEN);
+	
+	bytes_read = fread(the_buffer, sizeof(char), FILE_SNIFF_LEN, the_file_handler);
+
+	if (bytes_read > 0)
+	{
+		the_file_type = File_GetFileTypeFromSignature(_CBM_T_REG, the_buffer);
+	}
+	
+	if (the_file_type == _CBM_T_REG && check_mod_tag == true && bytes_read == FILE_SNIFF_LEN && the_file->size_ >= (FILE_MOD_TAG_OFFSET + FILE_MOD_TAG_LEN))
+	{
+		bytes_to_skip = FILE_MOD_TAG_OFFSET - FILE_SNIFF_LEN;
+		
+		while (bytes_to_skip > 0)
+		{
+			bytes_read = fread(the_buffer, sizeof(char), (bytes_to_skip > STORAGE_FILE_BUFFER_1_LEN ? STORAGE_FILE_BUFFER_1_LEN : bytes_to_skip), the_file_handler);
+			
+			if (bytes_read <= 0)
+			{
+				break;
+			}
+			
+			bytes_to_skip -= bytes_read;
+		}
+		
+		if (bytes_to_skip == 0 && fread(the_buffer, sizeof(char), FILE_MOD_TAG_LEN, the_file_handler) == FILE_MOD_TAG_LEN)
+		{
+			// 4-channel Protracker/Soundtracker style tags. these are the ones ModoJR can play.
+			if (memcmp(the_buffer, "M.K.", FILE_MOD_TAG_LEN) == 0 || memcmp(the_buffer, "M!K!", FILE_MOD_TAG_LEN) == 0 || memcmp(the_buffer, "FLT4", FILE_MOD_TAG_LEN) == 0 || memcmp(the_buffer, "4CHN", FILE_MOD_TAG_LEN) == 0)
+			{
+				the_file_type = FNX_FILETYPE_MUSIC;
+			}
+		}
+	}
+
+	fclose(the_file_handler);
+	
+	if (the_file_type == _CBM_T_REG)
+	{
+		return false;
+	}
+	
+	the_file->file_type_ = the_file_type;
+		
+	return true;
+}
 
 
 // Checks if the file at the passed path can be opened for reading
@@ -1037,6 +1238,9 @@ bool File_Rename(WB2KFileObject* the_file, const char* new_file_name, const char
 		}
 		
 		the_file->file_type_ = File_GetFileTypeFromExtension(_CBM_T_REG, new_file_name);
+		
+		// type came from the new extension: if that didn't identify it, allow the contents to be checked again next time it is selected
+		the_file->sniffed_ = false;
 	}
 
 	return true;
@@ -1115,7 +1319,11 @@ void File_Render(WB2KFileObject* the_file, bool as_selected, int8_t y_offset, bo
 		return;
 	}
 
-	if (as_active)
+	if (Folder_IsFileMarked(the_file))
+	{
+		the_color = (as_active ? LIST_MARKED_COLOR : LIST_MARKED_INACTIVE_COLOR);
+	}
+	else if (as_active)
 	{
 		the_color = LIST_ACTIVE_COLOR;
 	}
@@ -45,6 +45,39 @@
 
 #define FILE_MAX_EXTENSION_SIZE			8		// probably larger than needed, but... 
 
+#define FILE_SNIFF_LEN					16		// number of bytes read from the start of a file when checking for a known signature
+#define FILE_MOD_TAG_OFFSET				1080	// .mod files have no signature at the start: the "M.K." (etc) tag is at this offset
+#define FILE_MOD_TAG_LEN				4
+
+// pgZ: 'Z' (24 bit) or 'z' (32 bit), then segments, each an address and a length, little-endian, followed by that many bytes
+#define FILE_PGZ_RAM_SIZE				0x80000UL	// every segment has to load into RAM ($00000-$7FFFF)
+
+// MPEG audio frame header: 11 sync bits, then version, layer, bitrate and sample rate fields. reserved/invalid values rule a frame out
+#define FILE_MP3_VERSION(b1)			(((b1) >> 3) & 0x03)	// 1 is reserved
+#define FILE_MP3_LAYER(b1)				(((b1) >> 1) & 0x03)	// 0 is reserved
+#define FILE_MP3_BITRATE(b2)			((b2) >> 4)				// 0 (free format) and 15 are not playable
+#define FILE_MP3_SAMPLE_RATE(b2)		(((b2) >> 2) & 0x03)	// 3 is reserved
+
+#define FILE_EM_STORAGE_MAX_BANKS		(FILENAME_STORAGE_EM_SLOT - EM_STORAGE_START_PHYS_BANK_NUM)	// banks free for file data at $28000 before f/manager's filename bank (7 = 56K)
+
+#define PARAM_LOAD_AS_IS				_CBM_T_REG	// File_LoadFileToEM() parameter: load the file exactly as it is on disk, even if it is packed
+
+#define FILE_LOAD_ERROR					-1		// File_LoadFileToEM() result: the file couldn't be read
+#define FILE_LOAD_ERROR_DAMAGED			-2		// File_LoadFileToEM() result: a packed file is damaged, or needs something the unpacker doesn't support
+#define FILE_LOAD_ERROR_NO_ROOM			-3		// File_LoadFileToEM() result: a packed file unpacks into more banks than it was allowed
+
+// LZ4 frame header: magic number, FLG, BD, then optional content size, then a header checksum. see lz4_Frame_format.md
+#define FILE_LZ4_MAGIC					"\x04\x22\x4D\x18"	// 0x184D2204, little-endian
+#define FILE_LZ4_MAGIC_LEN				4
+#define FILE_LZ4_FRAME_START_LEN		6		// bytes of the frame header that are always there: magic number, FLG, BD
+#define FILE_LZ4_FLG_OFFSET				4
+#define FILE_LZ4_FLG_VERSION_MASK		0xC0
+#define FILE_LZ4_FLG_VERSION			0x40	// version 01 is the only one there is
+#define FILE_LZ4_FLG_BLOCK_CHECKSUMS	0x10	// each block is followed by a 4 byte checksum
+#define FILE_LZ4_FLG_CONTENT_SIZE		0x08	// an 8 byte unpacked size follows BD
+#define FILE_LZ4_FLG_DICT_ID			0x01	// a 4 byte dictionary ID comes before the header checksum. the frame can't be unpacked without that dictionary
+#define FILE_LZ4_CONTENT_SIZE_LEN		8
+
 
 /*****************************************************************************/
 /*                               Enumerations                                */
@@ -67,6 +100,7 @@ typedef struct WB2KFileObject
 	uint8_t				x_;
 	uint8_t				row_;				// row_ is relative to the first file in the folder. changes on sort.
 	int8_t				display_row_;		// offset from the first displayed row of parent panel. -1 if not to be visible.
+	bool				sniffed_;			// true once the file's first bytes have been checked for a known signature. never open a file twice for this.
 	//char*				file_name_;
 	//char*				file_size_string_;	// human-readable version of file size
 } WB2KFileObject;
@@ -136,16 +170,27 @@ char* File_GetFileSizeStringCopy(WB2KFileObject* the_file);
 bool File_ReadFontData(char* the_file_path);
 
 // Load the selected file into EM, starting at the address associated with the specified em_bank_num
-// Returns false on any error
-bool File_LoadFileToEM(char* the_file_path, uint8_t em_bank_num);
+// fills as many consecutive banks as the file needs, but never more than max_banks: anything past that is not loaded
+// if the_file_type is FNX_FILETYPE_LZ4 or FNX_FILETYPE_ZX0, the file is unpacked as it is read, and it is the unpacked data that fills the banks
+// pass PARAM_LOAD_AS_IS to load any file exactly as it is on disk
+// Returns the number of banks filled, FILE_LOAD_ERROR_DAMAGED or FILE_LOAD_ERROR_NO_ROOM if a packed file can't be unpacked, or FILE_LOAD_ERROR on any other error
+int16_t File_LoadFileToEM(char* the_file_path, uint8_t em_bank_num, uint8_t max_banks, uint8_t the_file_type);
 
-// get the free disk space on the parent disk of the file
-// returns -1 in event of error
-int16_t File_GetFreeBytesOnDisk(WB2KFileObject* the_file);
+// refill STORAGE_FILE_BUFFER_1 from the file File_LoadFileToEM() is unpacking. called from Memory_DecompressStream(), not from C
+// the unpacker maps the DISKSYS overlay back in before calling this. returns the number of bytes read: 0 once the file has run out
+uint8_t File_ReadStreamBuffer(void);
+
+// free disk space and room checks are in the FILEOPS overlay: see overlay_fileops.h
 
 
 // **** OTHER FUNCTIONS *****
 
+// Identify the file type from the file's first bytes, if the file extension did not already identify it
+// the result is remembered in the file object, so any given file is only opened once for this
+// pass check_mod_tag=false to look only at the first bytes: the .mod tag is 1K into the file, and reading that far on an IEC drive takes seconds
+// returns true if a (new) file type was identified
+bool File_SniffFileType(WB2KFileObject* the_file, const char* the_file_path, bool check_mod_tag);
+
 // Checks if the file at the passed path can be opened for reading
 // if the file is not found/cannot be opened, the error message represented by feedback_string_id will be shown
 // returns false on any error, or if the file cannot be found/opened.
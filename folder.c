@@ -51,11 +51,18 @@
 static char			folder_temp_filename_buffer[FILE_MAX_FILENAME_SIZE];
 static char*		folder_temp_filename = folder_temp_filename_buffer;
 
+// number of bits set in each value 0-15. used to count marked files 4 at a time.
+static const uint8_t	folder_bits_in_nibble[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
 
 /*****************************************************************************/
 /*                             Global Variables                              */
 /*****************************************************************************/
 
+// multi-select: 1 bit per file id, 1 bitset per panel. see Folder_SetFileMark(). the FILEOPS overlay works on them too.
+uint8_t				global_marked_files[NUM_PANELS][FOLDER_MARK_BITSET_SIZE];
+uint8_t				global_unmarkable_files[NUM_PANELS][FOLDER_MARK_BITSET_SIZE];	// '..' and other navigation-only entries
+
 extern char*		global_temp_path_1;
 extern char*		global_temp_path_2;
 
@@ -76,6 +83,12 @@ extern char*		global_string_buff1;
 // Returns NULL if nothing matches, or returns pointer to first matching list item
 WB2KList* Folder_FindListItemByFileName(WB2KFolderObject* the_folder, char* the_file_name);
 
+// marks the passed file as a navigation entry ('..', '^') that can never be marked
+void Folder_SetFileUnmarkable(uint8_t the_panel_id, WB2KFileObject* the_file);
+
+// marks every file id from the_first_unused_id to the end of the bitset as unmarkable, so mark all/invert can work on whole bytes
+void Folder_SetUnusedFileIdsUnmarkable(uint8_t the_panel_id, uint16_t the_first_unused_id);
+
 // looks through all files in the file list, comparing the passed string to the filepath of each file.
 // Returns NULL if nothing matches, or returns pointer to first matching list item
 WB2KList* Folder_FindListItemByFilePath(WB2KFolderObject* the_folder, char* the_file_path, short the_compare_len);
@@ -221,6 +234,36 @@ error:
 // }
 
 
+// marks the passed file as a navigation entry ('..', '^') that can never be marked
+void Folder_SetFileUnmarkable(uint8_t the_panel_id, WB2KFileObject* the_file)
+{
+	global_unmarkable_files[the_panel_id][the_file->id_ >> 3] |= (1 << (the_file->id_ & 0x07));
+}
+
+
+// marks every file id from the_first_unused_id to the end of the bitset as unmarkable, so mark all/invert can work on whole bytes
+void Folder_SetUnusedFileIdsUnmarkable(uint8_t the_panel_id, uint16_t the_first_unused_id)
+{
+	uint8_t		the_byte;
+	uint8_t*	the_unmarkables = global_unmarkable_files[the_panel_id];
+
+	if (the_first_unused_id >= (FOLDER_MARK_BITSET_SIZE * 8))
+	{
+		return;
+	}
+	
+	the_byte = the_first_unused_id >> 3;
+	
+	// bits above the first unused id in its byte, then every byte after it
+	the_unmarkables[the_byte] |= (uint8_t)(0xFF << (the_first_unused_id & 0x07));
+	
+	while (++the_byte < FOLDER_MARK_BITSET_SIZE)
+	{
+		the_unmarkables[the_byte] = 0xFF;
+	}
+}
+
+
 // looks through all files in the file list, comparing the passed string to the filename of each file.
 // Returns NULL if nothing matches, or returns pointer to first matching list item
 WB2KList* Folder_FindListItemByFileName(WB2KFolderObject* the_folder, char* the_file_name)
@@ -877,6 +920,81 @@ WB2KFileObject* Folder_FindFileByRow(WB2KFolderObject* the_folder, uint8_t the_r
 }
 
 
+// returns true if the passed file is marked (part of the multi-file selection)
+bool Folder_IsFileMarked(WB2KFileObject* the_file)
+{
+	if (the_file == NULL)
+	{
+		return false;
+	}
+	
+	return ((global_marked_files[the_file->panel_id_][the_file->id_ >> 3] & (1 << (the_file->id_ & 0x07))) != 0);
+}
+
+
+// returns number of marked files in the folder. 
+uint16_t Folder_GetCountMarkedFiles(WB2KFolderObject* the_folder)
+{
+	uint8_t		i;
+	uint8_t		this_byte;
+	uint8_t*	the_marks;
+	uint16_t	the_count = 0;
+	
+	if (the_folder == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		App_Exit(ERROR_FOLDER_WAS_NULL);	// crash early, crash often
+	}
+	
+	the_marks = global_marked_files[the_folder->panel_id_];
+	
+	for (i = 0; i < FOLDER_MARK_BITSET_SIZE; i++)
+	{
+		this_byte = the_marks[i];
+		the_count += folder_bits_in_nibble[this_byte & 0x0F] + folder_bits_in_nibble[this_byte >> 4];
+	}
+	
+	return the_count;
+}
+
+
+
+// **** MARKING (MULTI-SELECT) FUNCTIONS *****
+
+
+// marks or unmarks the passed file. does not re-render.
+// returns false if the file can't be marked (eg, it is the '..' entry)
+bool Folder_SetFileMark(WB2KFileObject* the_file, bool mark_it)
+{
+	uint8_t		the_byte;
+	uint8_t		the_mask;
+	
+	if (the_file == NULL)
+	{
+		LOG_ERR(("%s %d: passed file was null", __func__ , __LINE__));
+		App_Exit(ERROR_FILE_WAS_NULL);	// crash early, crash often
+	}
+	
+	the_byte = the_file->id_ >> 3;
+	the_mask = 1 << (the_file->id_ & 0x07);
+	
+	if (mark_it == false)
+	{
+		global_marked_files[the_file->panel_id_][the_byte] &= ~the_mask;
+		return true;
+	}
+	
+	if (global_unmarkable_files[the_file->panel_id_][the_byte] & the_mask)
+	{
+		return false;
+	}
+	
+	global_marked_files[the_file->panel_id_][the_byte] |= the_mask;
+	
+	return true;
+}
+
+
 
 
 
@@ -925,6 +1043,11 @@ uint8_t Folder_PopulateFiles(uint8_t the_panel_id, WB2KFolderObject* the_folder)
 
 	// reset panel's file count, as we will be starting over from zero
 	the_folder->file_count_ = 0;
+	
+	// file ids will be handed out again from 0, so any marks from the previous listing are meaningless now
+	the_folder->panel_id_ = the_panel_id;
+	memset(global_marked_files[the_panel_id], 0, FOLDER_MARK_BITSET_SIZE);
+	memset(global_unmarkable_files[the_panel_id], 0, FOLDER_MARK_BITSET_SIZE);
 
 	// account for FAT32 sectors vs IEC blocks when estimating file szie
 	if (the_folder->device_number_ == 0)
@@ -1054,6 +1177,7 @@ uint8_t Folder_PopulateFiles(uint8_t the_panel_id, WB2KFolderObject* the_folder)
 				
 						// Add this file to the list of files
 						file_added = Folder_AddNewFile(the_folder, this_file);
+						Folder_SetFileUnmarkable(the_panel_id, this_file);
 						++file_cnt;						
 					}
 					
@@ -1114,6 +1238,12 @@ uint8_t Folder_PopulateFiles(uint8_t the_panel_id, WB2KFolderObject* the_folder)
 					// Add this file to the list of files
 					file_added = Folder_AddNewFile(the_folder, this_file);
 		
+					// the parent folder entry is for navigation only: it can't be part of a multi-file selection
+					if (this_file_name[0] == '.')
+					{
+						Folder_SetFileUnmarkable(the_panel_id, this_file);
+					}
+					
 					// if this is first file in scan, preselect it
 					if (file_cnt == 0)
 					{
@@ -1259,9 +1389,12 @@ uint8_t Folder_PopulateFiles(uint8_t the_panel_id, WB2KFolderObject* the_folder)
 
 		// Add this file to the list of files
 		file_added = Folder_AddNewFile(the_folder, this_file);
+		Folder_SetFileUnmarkable(the_panel_id, this_file);
 		++file_cnt;						
 	}
 
+	Folder_SetUnusedFileIdsUnmarkable(the_panel_id, file_cnt);
+	
 
 	// set current row to first file, or -1
 	the_folder->cur_row_ = (file_cnt > 0 ? 0 : -1);
@@ -1302,6 +1435,47 @@ bool Folder_CopyCurrentFile(WB2KFolderObject* the_folder, WB2KFolderObject* the_
 }
 
 
+// copies every marked file to the target folder
+// returns -1 in event of error, or count of files copied
+int16_t Folder_CopyMarkedFiles(WB2KFolderObject* the_folder, WB2KFolderObject* the_target_folder)
+{
+	int16_t		num_files = 0;
+	WB2KList*	the_item;
+
+	if (the_folder == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		App_Exit(ERROR_COPY_FILE_SOURCE_FOLDER_WAS_NULL);	// crash early, crash often
+	}
+
+	// LOGIC:
+	//   Folder_CopyFile does not (yet) copy folders, so marked folders are skipped rather than counted as copied.
+	//   each file gets its own progress bar from Folder_CopyFileBytes. 
+	//   stop on the first failure: the most likely cause is a full disk, and every following file would fail the same way.
+	
+	the_item = *(the_folder->list_);
+
+	while (the_item != NULL)
+	{
+		WB2KFileObject*		this_file = (WB2KFileObject*)(the_item->payload_);
+
+		if (this_file->is_directory_ == false && Folder_IsFileMarked(this_file) == true)
+		{
+			if (Folder_CopyFile(the_folder, this_file, the_target_folder) == false)
+			{
+				return -1;
+			}
+			
+			++num_files;
+		}
+
+		the_item = the_item->next_item_;
+	}
+	
+	return num_files;
+}
+
+
 // copies the passed file/folder. If a folder, it will create directory on the target volume if it doesn't already exist
 bool Folder_CopyFile(WB2KFolderObject* the_folder, WB2KFileObject* the_file, WB2KFolderObject* the_target_folder)
 {
@@ -1461,89 +1635,66 @@ bool Folder_CopyFile(WB2KFolderObject* the_folder, WB2KFileObject* the_file, WB2
 }
 
 
-// // deletes the passed file/folder. If a folder, it must have been previously emptied of files.
-// bool Folder_DeleteFile(WB2KFolderObject* the_folder, WB2KList* the_item, WB2KFolderObject* not_needed)
-// {
-// 	WB2KFileObject*		the_file;
-// 	//bool				result_doesnt_matter;
-// 
-// 	if (the_folder == NULL)
-// 	{
-// 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
-// 		App_Exit(ERROR_DEFINE_ME);	// crash early, crash often
-// 	}
-// 
-// 	the_file = (WB2KFileObject*)the_item->payload_;
-// 
-// 	General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_folder->file_path_, App_GetFilenameFromEM(the_file));
-// 	
-// // 	FileMover_SetCurrentFileName(App_GetFileMover(global_app), App_GetFilenameFromEM(the_file));
-// 	
-// 	// delete the files
-// 	if (File_Delete(global_temp_path_1, the_file->is_directory_) == false)
-// 	{
-// 		return false;
-// 	}
-// 
-// // 	FileMover_IncrementProcessedFileCount(App_GetFileMover(global_app));
-// 
-// 	LOG_INFO(("%s %d: deleted file '%s' from disk", __func__ , __LINE__, App_GetFilenameFromEM(the_file)));
-// 
-// // 	// if this was a folder file, check if any open windows were representing its contents, and close them. 
-// // 	if (the_file->is_directory_)
-// // 	{
-// // 		WB2KList*			the_window_item;
-// // 	
-// // 		while ((the_window_item = App_FindSurfaceListItemByFilePath(global_app, the_file->file_path_)) != NULL)
-// // 		{
-// // 			// a window was open with this volume / file as its root folder. close the window
-// // 			App_CloseOneWindow(global_app, the_window_item);
-// // 		}
-// // 	}
-// // 
-// 	// update the count of files and remove this item from the folder's list of files
-// 	Folder_RemoveFileListItem(the_folder, the_item, DESTROY_FILE_OBJECT);
-// 	
-// 	return true;
-// }
+// removes the first the_count marked files from the folder's list of files. Does NOT delete anything from disk.
+// use after FileOps_DeleteMarkedFiles(), which deletes marked files from disk in list order, and stops at the first failure.
+// files past the_count stay marked, so user can try again.
+void Folder_RemoveMarkedFiles(WB2KFolderObject* the_folder, uint16_t the_count)
+{
+	WB2KList*	the_item;
+	WB2KList*	next_item;
 
+	if (the_folder == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		App_Exit(ERROR_FOLDER_WAS_NULL);	// crash early, crash often
+	}
+
+	the_item = *(the_folder->list_);
+
+	while (the_item != NULL && the_count > 0)
+	{
+		next_item = the_item->next_item_;
+		
+		if (Folder_IsFileMarked((WB2KFileObject*)(the_item->payload_)) == true)
+		{
+			Folder_RemoveFileListItem(the_folder, the_item, DESTROY_FILE_OBJECT);
+			--the_count;
+		}
+
+		the_item = next_item;
+	}
+}
 
-// // removes the passed list item from the list of files in the folder. Does NOT delete file from disk. Optionally frees the file object.
-// void Folder_RemoveFileListItem(WB2KFolderObject* the_folder, WB2KList* the_item, bool destroy_the_file_object)
-// {
-// 	WB2KFileObject*		the_file;
-// 	uint32_t			bytes_removed = 0;
-// 	uint16_t			blocks_removed = 0;
-// 
-// 	if (the_folder == NULL)
-// 	{
-// 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
-// 		App_Exit(ERROR_DEFINE_ME);	// crash early, crash often
-// 	}
-// 
-// 	the_file = (WB2KFileObject*)(the_item->payload_);
-// 	
-// 	// before removing, count up the bytes for the file and it's info file, if any. 
-// // 	bytes_removed = the_file->size_;
-// // 	blocks_removed = the_file->num_blocks_;
-// 	
-// 	//DEBUG_OUT(("%s %d: file '%s' is being removed from folder '%s' (current bytes=%lu, bytes being removed=%lu)", __func__ , __LINE__, App_GetFilenameFromEM(the_file), the_folder->folder_file_->file_name_, the_folder->total_bytes_, bytes_removed));
-// 	
-// 	if (destroy_the_file_object)
-// 	{
-// 		File_Destroy(&the_file);
-// 	}
-// 	
-// 	--the_folder->file_count_;
-// // 	the_folder->total_bytes_ -= bytes_removed;
-// // 	the_folder->total_blocks_ -= blocks_removed;
-// 	List_RemoveItem(the_folder->list_, the_item);
-// 	LOG_ALLOC(("%s %d:	__FREE__	the_item	%p	size	%i", __func__ , __LINE__, the_item, sizeof(WB2KList)));
-// 	free(the_item);
-// 	the_item = NULL;
-// 	
-// 	return;
-// }
+
+// removes the passed list item from the list of files in the folder. Does NOT delete file from disk. Optionally frees the file object.
+void Folder_RemoveFileListItem(WB2KFolderObject* the_folder, WB2KList* the_item, bool destroy_the_file_object)
+{
+	WB2KFileObject*		the_file;
+
+	if (the_folder == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		App_Exit(ERROR_FOLDER_WAS_NULL);	// crash early, crash often
+	}
+
+	the_file = (WB2KFileObject*)(the_item->payload_);
+	
+	// the id is no longer in use: take it out of the selection, and don't let mark all/invert pick it up again
+	Folder_SetFileMark(the_file, false);
+	Folder_SetFileUnmarkable(the_file->panel_id_, the_file);
+	
+	if (destroy_the_file_object)
+	{
+		File_Destroy(&the_file);
+	}
+	
+	--the_folder->file_count_;
+	List_RemoveItem(the_folder->list_, the_item);
+	LOG_ALLOC(("%s %d:	__FREE__	the_item	%p	size	%i", __func__ , __LINE__, the_item, sizeof(WB2KList)));
+	free(the_item);
+	
+	return;
+}
 
 
 // // removes the passed list item from the list of files in the folder. Does NOT delete file from disk. Does NOT delete the file object.
@@ -2067,221 +2218,58 @@ bool Folder_AddNewFileAsCopy(WB2KFolderObject* the_folder, WB2KFileObject* the_f
 // }
 
 
-// move every currently selected file into the specified folder. Use when you DO have a folder object to work with
+// move every marked file into the specified folder, by copying it and deleting the original. Use when you DO have a folder object to work with
+// on the same device, FileOps_MoveMarkedFilesByRename() should be called first: it unmarks what it could move, and this does the rest.
 // returns -1 in event of error, or count of files moved
-// //   NOTE: calling function must have already checked that folders are on the same device!
-// int Folder_MoveSelectedFiles(WB2KFolderObject* the_folder, WB2KFolderObject* the_target_folder)
-// {
-// 	// LOGIC:
-// 	//   iterate through all files in the source folder's list
-// 	//   for any file that is listed as selected, move it (via rename) to the specified target folder
-// 
-// 	int				num_files = 0;
-// 	WB2KList*		the_item;
-// 	WB2KList*		temp_item;
-// 
-// 	if (the_folder == NULL || the_target_folder == NULL)
-// 	{
-// 		LOG_ERR(("%s %d: the source and/or target folder was NULL", __func__ , __LINE__));
-// 		goto error;
-// 	}
-// 
-// 	the_item = *(the_folder->list_);
-// 
-// 	if (the_item == NULL)
-// 	{
-// 		return -1;
-// 	}
-// 
-// 	while (the_item != NULL)
-// 	{
-// 		WB2KFileObject*		this_file = (WB2KFileObject*)(the_item->payload_);
-// 
-// 		if (File_IsSelected(this_file) == true)
-// 		{
-// 			WB2KFileObject*		same_named_file_in_target;
-// 			char				target_file_path_buffer[FILE_MAX_PATHNAME_SIZE];
-// 			char*				target_file_path = target_file_path_buffer;
-// 
-// 
-// 			// check that files are not being moved/copied into a sub-folder
-// 			
-// 			// LOGIC:
-// 			//   If source folder path is found, in its entirety, in the target path, we must block the copy/move
-// 			//   We only do this check with the target file is a directory
-// 			//   We have to ensure the source path ends with : or /, or it can find a partial name. (eg, RAM:folder would show as bad match for RAM:folder1/some folder)
-// 			//   We have to compare with whatever the shortest of the 2 paths is
-// 			//     case A: "RAM:AcmeTest/" > "RAM:AcmeTest/lvl1/" (into a subfolder)
-// 			//     case B: "RAM:AcmeTest/" > "RAM:AcmeTest/" (into itself)
-// 			
-// 			if (this_file->is_directory_)
-// 			{
-// 				int32_t			src_file_path_len;
-// 				int32_t			tgt_folder_path_len;
-// 				int32_t			shortest_path;
-// 				char			temp_source_path[FILE_MAX_PATHNAME_SIZE];
-// 				char*			source_path_for_compare = temp_source_path;
-// 
-// 				// prep source file path for comparison
-// 			
-// 				src_file_path_len = strlen((char*)this_file->file_path_);
-// 			
-// 				General_Strlcpy(source_path_for_compare, this_file->file_path_, FILE_MAX_PATHNAME_SIZE);
-// 
-// 				if ( source_path_for_compare[src_file_path_len - 1] != ':')
-// 				{
-// 					General_Strlcat(source_path_for_compare, (char*)"/", FILE_MAX_PATHNAME_SIZE); // TODO: replace hard-coded
-// 					src_file_path_len++;
-// 				}
-// 			
-// 				// compare prepped source folder path to target folder path
-// 
-// 				tgt_folder_path_len = strlen((char*)the_target_folder->folder_file_->file_path_);
-// 				shortest_path = src_file_path_len < tgt_folder_path_len ? src_file_path_len : tgt_folder_path_len;
-// 			
-// 				if (General_Strncasecmp(source_path_for_compare, the_target_folder->folder_file_->file_path_, shortest_path) == 0)
-// 				{
-// 					// TODO: implement this once I add back the text-based-dialog window functions
-// // 					General_ShowAlert(App_GetBackdropSurface(global_app)->window_, MSG_StatusMovingFiles, ALERT_DIALOG_SHOW_AS_ERROR, ALERT_DIALOG_NO_CANCEL_BTN, (char*)MSG_StatusMovingFilesIntoChildError);
-// 					DEBUG_OUT(("%s %d: **NOT safe to move folder** (%s > %s)", __func__ , __LINE__, this_file->file_path_, the_target_folder->folder_file_->file_path_));
-// 					return -1;	
-// 				}
-// 				else
-// 				{
-// 					//DEBUG_OUT(("%s %d: (safe to move folder) (%s > %s) (%lu, %lu)", __func__ , __LINE__, this_file->file_path_, the_target_folder->folder_file_->file_path_, tgt_folder_path_len, src_file_path_len));
-// 				}
-// 			}
-// 
-// 
-// 			// compare new path to existing paths in target dir to see if (same-named) file already exists there
-// 
-// 			General_CreateFilePathFromFolderAndFile(target_file_path, the_target_folder->folder_file_->file_path_, App_GetFilenameFromEM(this_file->id_));
-// 			same_named_file_in_target = Folder_FindFileByFilePath(the_target_folder, target_file_path, strlen((char*)target_file_path));
-// 
-// 			if (same_named_file_in_target != NULL)
-// 			{
-// 				// do what, exactly? warn user one file at a time? With a dialogue box? fail/stop? ignore this file, and continue with the rest? 
-// 				DEBUG_OUT(("%s %d: File '%s' already exists in the destination folder. This file will not be moved.", __func__ , __LINE__, App_GetFilenameFromEM(this_file->id_)));
-// 			
-// 				the_item = the_item->next_item_;
-// 			}
-// 			else
-// 			{
-// 				bool		result_doesnt_matter;
-// 				
-// 				if ( File_Rename(this_file, App_GetFilenameFromEM(this_file->id_), target_file_path) == false)
-// 				{
-// 					LOG_ERR(("%s %d: Move action failed with file '%s' -> '%s'", __func__ , __LINE__, this_file->file_path_, target_file_path));
-// 					goto error;
-// 				}
-// 
-// 				// mark the file as not selected in its new location
-// 				File_SetSelected(this_file, false);
-// 
-// 				// add a copy of the file to any open panels match the target folder (but aren't it), then add the original to this target folder
-// 				//DEBUG_OUT(("%s %d: Adding file '%s' to any matching open windows/panels...", __func__ , __LINE__, App_GetFilenameFromEM(this_file->id_)));
-// 				// NOTE Jan 14, 2023: think about having something to handle when same disk is open in both panels. TODO
-// // 				result_doesnt_matter = App_ModifyOpenFolders(global_app, the_target_folder, this_file, &Folder_AddNewFileAsCopy);
-// 				result_doesnt_matter = Folder_AddNewFile(the_target_folder, this_file);
-// 				
-// 				++num_files;
-// 				
-// 				// remove file from any open panels match the source folder (but aren't it), then remove from this source folder
-// 				//DEBUG_OUT(("%s %d: Removing file '%s' from any matching open windows/panels...", __func__ , __LINE__, App_GetFilenameFromEM(this_file->id_)));
-// 				// NOTE Jan 14, 2023: think about having something to handle when same disk is open in both panels. TODO
-// // 				result_doesnt_matter = App_ModifyOpenFolders(global_app, the_folder, this_file, &Folder_RemoveFile);
-// 				temp_item = the_item->next_item_;
-// 				Folder_RemoveFileListItem(the_folder, the_item, DO_NOT_DESTROY_FILE_OBJECT);
-// 				the_item = temp_item;
-// 			}
-// 		}
-// 		else
-// 		{
-// 			the_item = the_item->next_item_;
-// 		}
-// 	}
-// 
-// 	return num_files;
-// 	
-// error:
-// 	return -1;
-// }
+int Folder_MoveSelectedFiles(WB2KFolderObject* the_folder, WB2KFolderObject* the_target_folder)
+{
+	// LOGIC:
+	//   each file is copied, and the original deleted only once the copy succeeded.
+	//   folders are skipped, as Folder_CopyFile can't copy them yet.
 
+	int				num_files = 0;
+	WB2KList*		the_item;
 
-// // move every currently selected file into the specified folder file. Use when you only have a target folder file, not a full folder object to work with.
-// // returns -1 in event of error, or count of files moved
-// int Folder_MoveSelectedFilesToFolderFile(WB2KFolderObject* the_folder, WB2KFileObject* the_target_folder_file)
-// {
-// 	// LOGIC:
-// 	//   iterate through all files in the folder's list
-// 	//   for any file that is listed as selected, move it (via rename) to the specified target folder
-// 
-// 	int				num_files = 0;
-// 	char	target_file_path_buffer[FILE_MAX_PATHNAME_SIZE];
-// 	char*	target_file_path = target_file_path_buffer;
-// 	WB2KList*		the_item;
-// 	WB2KList*		temp_item;
-// 
-// 	if (the_folder == NULL)
-// 	{
-// 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
-// 		App_Exit(ERROR_DEFINE_ME);	// crash early, crash often
-// 	}
-// 
-// 	if (the_target_folder_file == NULL)
-// 	{
-// 		LOG_ERR(("%s %d: the target folder file was NULL", __func__ , __LINE__));
-// 		goto error;
-// 	}
-// 
-// 	the_item = *(the_folder->list_);
-// 
-// 	if (the_item == NULL)
-// 	{
-// 		return false;
-// 	}
-// 
-// 	while (the_item != NULL)
-// 	{
-// 		WB2KFileObject*		this_file = (WB2KFileObject*)(the_item->payload_);
-// 
-// 		if (File_IsSelected(this_file) == true)
-// 		{
-// 			// move file
-// 			General_CreateFilePathFromFolderAndFile(target_file_path, the_target_folder_file->file_path_, App_GetFilenameFromEM(this_file->id_));
-// 
-// 			if ( rename( this_file->file_path_, target_file_path ) == 0)
-// 			{
-// 				LOG_ERR(("%s %d: Move action failed with file '%s'", __func__ , __LINE__, App_GetFilenameFromEM(this_file->id_)));
-// 				goto error;
-// 			}
-// 
-// 			// mark the file as not selected (in its new location, it wouldn't be selected()
-// 			// no point in doing this, as we are going to destroy this file object shortly anyway
-// 			//File_SetSelected(this_file, false);
-// 
-// 			++num_files;
-// 
-// 			// remove file from the parent panel's list of files
-// 			--the_folder->file_count_;
-// 			temp_item = the_item->next_item_;
-// 			File_Destroy(&this_file);
-// 			List_RemoveItem(the_folder->list_, the_item);
-// 			LOG_ALLOC(("%s %d:	__FREE__	the_item	%p	size	%i", __func__ , __LINE__, the_item, sizeof(WB2KList)));
-// 			free(the_item);
-// 			the_item = temp_item;
-// 		}
-// 		else
-// 		{
-// 			the_item = the_item->next_item_;
-// 		}
-// 	}
-// 
-// 	return num_files;
-// 	
-// error:
-// 	return -1;
-// }
+	if (the_folder == NULL || the_target_folder == NULL)
+	{
+		LOG_ERR(("%s %d: the source and/or target folder was NULL", __func__ , __LINE__));
+		goto error;
+	}
+
+	the_item = *(the_folder->list_);
+
+	while (the_item != NULL)
+	{
+		WB2KFileObject*		this_file = (WB2KFileObject*)(the_item->payload_);
+
+		if (this_file->is_directory_ == false && Folder_IsFileMarked(this_file) == true)
+		{
+			if (Folder_CopyFile(the_folder, this_file, the_target_folder) == false)
+			{
+				LOG_ERR(("%s %d: Move action failed with file '%s'", __func__ , __LINE__, App_GetFilenameFromEM(this_file)));
+				goto error;
+			}
+
+			// copy built the source path in global_temp_path_1, but build it again rather than count on that
+			General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_folder->file_path_, App_GetFilenameFromEM(this_file));
+
+			if (File_Delete(global_temp_path_1, false) == false)
+			{
+				goto error;
+			}
+
+			Folder_SetFileMark(this_file, false);
+			++num_files;
+		}
+
+		the_item = the_item->next_item_;
+	}
+
+	return num_files;
+	
+error:
+	return -1;
+}
 
 
 // select or unselect 1 file by row id, and change cur_row_ accordingly
@@ -2322,6 +2310,15 @@ WB2KFileObject* Folder_SetFileSelectionByRow(WB2KFolderObject* the_folder, uint1
 
 		the_folder->cur_row_ = the_row;
 
+		// if the extension didn't tell us what kind of file this is, check its first few bytes (once only: result is kept in the file object)
+		// don't do this for meatloaf: opening a "file" there can have side effects, like changing directory
+		// only read ahead to the .mod tag on the SD card: on a 1541/1581, reading 1K just to look at 4 bytes stalls the UI
+		if (the_file->sniffed_ == false && the_folder->is_meatloaf_ == false)
+		{
+			General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_folder->file_path_, App_GetFilenameFromEM(the_file));
+			File_SniffFileType(the_file, global_temp_path_1, the_folder->device_number_ == DEVICE_SD_CARD);
+		}
+
 		if (File_MarkSelected(the_file, y_offset) == false)
 		{
 			// the passed file was null. do anything?
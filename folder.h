@@ -50,8 +50,8 @@
 
 #define FOLDER_SYSTEM_ROOT_NAME		(char*)"[ROOT]"
 
-// #define DO_NOT_DESTROY_FILE_OBJECT	false	// for Folder_RemoveFileListItem()
-// #define DESTROY_FILE_OBJECT			true	// for Folder_RemoveFileListItem()
+#define DO_NOT_DESTROY_FILE_OBJECT	false	// for Folder_RemoveFileListItem()
+#define DESTROY_FILE_OBJECT			true	// for Folder_RemoveFileListItem()
 
 #define PROCESS_FOLDER_FILE_BEFORE_CHILDREN	true	// for Folder_ProcessContents()
 #define PROCESS_FOLDER_FILE_AFTER_CHILDREN	false	// for Folder_ProcessContents()
@@ -61,6 +61,8 @@
 
 #define FOLDER_MAX_TRIES_AT_FOLDER_CREATION		128		// arbitrary, for use with Folder_CreateNewFolder; stop at "unnamed folder 128"
 
+#define FOLDER_MARK_BITSET_SIZE		32		// 1 bit per file id. file ids are uint8_t, so 256 files = 32 bytes per panel.
+
 #define _CBM_T_DEL      0x00U	// deleted file
 #define _CBM_T_CBM      0x01U   /* 1581 sub-partition */
 #define _CBM_T_DIR      0x02U   /* IDE64 and CMD sub-directory */
@@ -84,6 +86,8 @@
 #define FNX_FILETYPE_MP3	207 // a .mp3 file that f/manager will try to pass to audioplayer.pgz
 #define FNX_FILETYPE_OGG	208 // a .ogg file that f/manager will try to pass to audioplayer.pgz
 #define FNX_FILETYPE_WAV	209 // a .wav file that f/manager will try to pass to audioplayer.pgz
+#define FNX_FILETYPE_LZ4	210 // a .lz4 file (LZ4 frame) that f/manager unpacks when loading it into memory
+#define FNX_FILETYPE_ZX0	211 // a .zx0 file that f/manager unpacks when loading it into memory
 
 
 
@@ -128,6 +132,7 @@ typedef struct WB2KFolderObject
 // 	uint16_t			selected_blocks_;
 	bool				is_meatloaf_;						// flag set if the folder is currently configured in meatloaf mode. 
 	uint8_t				device_number_;						// For CBM, 8-9-10-11. for fnx, 0-1-2
+	uint8_t				panel_id_;							// set on populate. needed to find the panel's file mark bitset.
 } WB2KFolderObject;
 
 
@@ -212,6 +217,27 @@ uint8_t Folder_GetCurrentFileType(WB2KFolderObject* the_folder);
 // Returns NULL if nothing matches, or returns pointer to first matching FileObject
 WB2KFileObject* Folder_FindFileByRow(WB2KFolderObject* the_folder, uint8_t the_row);
 
+// returns true if the passed file is marked (part of the multi-file selection)
+bool Folder_IsFileMarked(WB2KFileObject* the_file);
+
+// returns number of marked files in the folder. 
+uint16_t Folder_GetCountMarkedFiles(WB2KFolderObject* the_folder);
+
+
+// **** MARKING (MULTI-SELECT) FUNCTIONS *****
+
+// LOGIC:
+//   "selected" (File_IsSelected) is the cursor row: there is only ever 1.
+//   "marked" files are the multi-file selection that batch copy/delete/move work on.
+//   marks are kept in a bitset per panel, indexed by file id_, not in the file objects, so mark all/invert/count are done 8 files at a time.
+//   navigation entries such as '..' can never be marked. neither can ids not (or no longer) used by any file in the folder.
+
+// marks or unmarks the passed file. does not re-render.
+// returns false if the file can't be marked (eg, it is the '..' entry)
+bool Folder_SetFileMark(WB2KFileObject* the_file, bool mark_it);
+
+// mark all, invert, and mark by pattern are in the FILEOPS overlay: see overlay_fileops.h
+
 // **** OTHER FUNCTIONS *****
 
 // Add a file object to the list of files without checking for duplicates.
@@ -228,11 +254,13 @@ bool Folder_AddNewFileAsCopy(WB2KFolderObject* the_folder, WB2KFileObject* the_f
 // // NOTE: this is part of series of functions designed to be called by Window_ModifyOpenFolders(), and all need to return bools.
 // bool Folder_RemoveFile(WB2KFolderObject* the_folder, WB2KFileObject* the_file);
 
-// // deletes the passed file/folder. If a folder, it must have been previously emptied of files.
-// bool Folder_DeleteFile(WB2KFolderObject* the_folder, WB2KList* the_item, WB2KFolderObject* not_needed);
+// removes the passed list item from the list of files in the folder. Does NOT delete file from disk. Optionally frees the file object.
+void Folder_RemoveFileListItem(WB2KFolderObject* the_folder, WB2KList* the_item, bool destroy_the_file_object);
 
-// // removes the passed list item from the list of files in the folder. Does NOT delete file from disk. Optionally frees the file object.
-// void Folder_RemoveFileListItem(WB2KFolderObject* the_folder, WB2KList* the_item, bool destroy_the_file_object);
+// removes the first the_count marked files from the folder's list of files. Does NOT delete anything from disk.
+// use after FileOps_DeleteMarkedFiles(), which deletes marked files from disk in list order, and stops at the first failure.
+// files past the_count stay marked, so user can try again.
+void Folder_RemoveMarkedFiles(WB2KFolderObject* the_folder, uint16_t the_count);
 
 // // Create a new folder on disk, and a new file object for it, and assign it to this folder. 
 // // if try_until_successful is set, will rename automatically with trailing number until it can make a new folder (by avoiding already-used names)
@@ -244,6 +272,12 @@ bool Folder_CopyFile(WB2KFolderObject* the_folder, WB2KFileObject* the_file, WB2
 // copies the currently selected file
 bool Folder_CopyCurrentFile(WB2KFolderObject* the_folder, WB2KFolderObject* the_target_folder);
 
+// copies every marked file to the target folder
+// returns -1 in event of error, or count of files copied
+int16_t Folder_CopyMarkedFiles(WB2KFolderObject* the_folder, WB2KFolderObject* the_target_folder);
+
+// deleting marked files (and whole folder trees) is in the FILEOPS overlay: see overlay_fileops.h
+
 // compare 2 folder objects. When done, the original_root_folder will have been updated with removals/additions as necessary to match the updated file list
 // returns true if any changes were detected, or false if files appear to be identical
 bool Folder_SyncFolderContentsByFilePath(WB2KFolderObject* original_root_folder, WB2KFolderObject* updated_root_folder);
@@ -258,13 +292,12 @@ bool Folder_CountBytes(WB2KFolderObject* the_folder, WB2KList* the_item, WB2KFol
 // returns -1 in event of error, or count of files affected
 int Folder_ProcessContents(WB2KFolderObject* the_folder, WB2KFolderObject* the_target_folder, uint8_t the_scope, bool do_folder_before_children, bool (* action_function)(WB2KFolderObject*, WB2KList*, WB2KFolderObject*));
 
-// move every currently selected file into the specified folder. Use when you DO have a folder object to work with
+// move every marked file into the specified folder, by copying it and deleting the original. Use when you DO have a folder object to work with
+// on the same device, FileOps_MoveMarkedFilesByRename() should be called first: it unmarks what it could move, and this does the rest.
 // returns -1 in event of error, or count of files moved
 int Folder_MoveSelectedFiles(WB2KFolderObject* the_folder, WB2KFolderObject* the_target_folder);
 
-// move every currently selected file into the specified folder file. Use when you only have a target folder file, not a full folder object to work with.
-// returns -1 in event of error, or count of files moved
-int Folder_MoveSelectedFilesToFolderFile(WB2KFolderObject* the_folder, WB2KFileObject* the_target_folder_file);
+// moving files by renaming them is in the FILEOPS overlay: see overlay_fileops.h
 
 // select or unselect 1 file by row id, and change cur_row_ accordingly
 WB2KFileObject* Folder_SetFileSelectionByRow(WB2KFolderObject* the_folder, uint16_t the_row, bool do_selection, uint8_t y_offset);
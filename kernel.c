@@ -51,11 +51,15 @@ static char row = 0;
 static char col = 0;
 static char *line = (char*) 0xc000;
 
+static int32_t dir_free_blocks[MAX_DRIVES];	// free block count reported at the end of the last directory read on each drive, or -1
+static struct dir_ext_t dir_ext;
+
  
 void
 kernel_init(void)
 {
     args.events.event = &event;
+    memset(dir_free_blocks, 0xFF, sizeof(dir_free_blocks));	// -1 = free space not known yet
 }
 
 static void
@@ -408,6 +412,9 @@ Kernel_OpenDir(const char* name)
         return NULL;  // Only one at a time.
     }
     
+    // forget any free space count from a previous read: this one will report it anew (if the device supports it)
+    dir_free_blocks[drive] = -1;
+    
     args.directory.open.drive = drive;
     args.common.buf = name;
     args.common.buflen = strlen(name);
@@ -480,7 +487,12 @@ Kernel_ReadDir(DIR* dir)
             break;
                 
         case EVENT(directory.FREE):
-            // dirent doesn't care about these types of records.
+            // dirent doesn't care about these types of records, but the free block count is worth keeping for Kernel_GetFreeBlocks().
+            args.common.buf = &dir_ext;
+            args.common.buflen = sizeof(dir_ext);
+            CALL(ReadExt);
+            dir_free_blocks[(char*)dir - dir_stream] = (dir_ext.free > 0x7FFFFFFF ? 0x7FFFFFFF : dir_ext.free);
+            
             args.directory.read.stream = *(char*)dir;
             CALL(Directory.Read);
             if (!error) {
@@ -513,6 +525,19 @@ Kernel_ReadDir(DIR* dir)
 }
     
     
+// returns the free block count the kernel reported the last time a directory on the specified drive was read to the end
+// returns -1 if the drive didn't report one (not all devices do), or if no directory has been fully read since it was opened
+int32_t __fastcall__ 
+Kernel_GetFreeBlocks(uint8_t drive)
+{
+    if (drive >= MAX_DRIVES) {
+        return -1;
+    }
+    
+    return dir_free_blocks[drive];
+}
+    
+    
 int __fastcall__ 
 Kernel_CloseDir (DIR* dir)
 {
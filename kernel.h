@@ -34,6 +34,10 @@ bool __fastcall__ Kernel_DeleteFile(const char* name);
 // returns false in all error conditions
 bool __fastcall__ Kernel_DeleteFolder(const char* name);
 
+// returns the free block count the kernel reported the last time a directory on the specified drive was read to the end
+// returns -1 if the drive didn't report one (not all devices do), or if no directory has been fully read since it was opened
+int32_t __fastcall__ Kernel_GetFreeBlocks(uint8_t drive);
+
 // check for any kernel key press. return true if any key was pressed, otherwise false
 // NOTE: the key press in question will be lost! only use when you want to check, but not wait for, a user key press
 bool Kernal_AnyKeyEvent();
@@ -40,6 +40,7 @@
 /*****************************************************************************/
 
 #define MINUTE_TIMER_COOKIE		127		// hard-coded. just don't want it to start with 0, as that's what the keyboard cookie will start with
+#define TICK_TIMER_COOKIE		(MINUTE_TIMER_COOKIE + 1)	// also hard-coded. right after the minute hand's, so the repeat cookie can skip both at once
 
 #define KEYBOARD_QUEUE_SIZE		8
 
@@ -59,6 +60,7 @@
 static uint8_t			keyboard_queue_entries;
 static uint8_t			keyboard_queue[KEYBOARD_QUEUE_SIZE];
 static KeyRepeater		keyboard_repeater;
+static bool				keyboard_tick_elapsed;	// set when the timer started by Keyboard_StartTick() goes off
 
 
 /*****************************************************************************/
@@ -209,10 +211,10 @@ uint8_t Keyboard_ProcessKeyEvent(void)
 		// jmp     StopRepeat WHICH IS "inc     repeat.cookie -> rts"
 		keyboard_repeater.cookie++;
 
-		// prevent collision with the permanent minute hand cookie		
+		// prevent collision with the permanent minute hand cookie, and the tick cookie after it
 		if (keyboard_repeater.cookie == MINUTE_TIMER_COOKIE)
 		{
-			keyboard_repeater.cookie++;
+			keyboard_repeater.cookie += 2;
 		}
 	}
 
@@ -228,10 +230,10 @@ void Keyboard_StartTimerForKey(uint8_t the_key)
 	keyboard_repeater.key = the_key;
 	keyboard_repeater.cookie++;			// set a new ID
 		
-	// prevent collision with the permanent minute hand cookie
+	// prevent collision with the permanent minute hand cookie, and the tick cookie after it
 	if (keyboard_repeater.cookie == MINUTE_TIMER_COOKIE)
 	{
-		keyboard_repeater.cookie++;
+		keyboard_repeater.cookie += 2;
 	}
 	
 	// Get the current frame counter
@@ -287,6 +289,13 @@ uint8_t Keyboard_HandleRepeatTimerEvent(void)
 		return 0;
 	}
 
+	// the tick is one-shot: whoever started it starts the next one once they have seen this one
+	if (event.timer.cookie == TICK_TIMER_COOKIE)
+	{
+		keyboard_tick_elapsed = true;
+		return 0;
+	}
+
 	// ignore retired timers
 	if (event.timer.cookie != keyboard_repeater.cookie)
 	{
@@ -374,6 +383,40 @@ char Keyboard_GetChar(void)
 }
 
 
+// start a one-shot timer that goes off num_frames frames from now. Keyboard_TickElapsed() reports when it has
+void Keyboard_StartTick(uint8_t num_frames)
+{
+	uint8_t		current_timer_value;
+	
+	keyboard_tick_elapsed = false;
+	
+	// including query makes the SetTimer call return the value of the current timer (in A)
+	args.timer.units = (TIMER_FRAMES | TIMER_QUERY);
+	current_timer_value = CALL(Clock.SetTimer);
+	
+	args.timer.absolute = current_timer_value + num_frames;
+	args.timer.units = TIMER_FRAMES;
+	args.timer.cookie = TICK_TIMER_COOKIE;
+	
+	CALL(Clock.SetTimer);
+}
+
+
+// returns true, once, if the timer started by Keyboard_StartTick() has gone off. does not wait
+// events are only read in when the key queue is empty, so call Keyboard_GetKeyIfPressed() until it returns 0 first
+bool Keyboard_TickElapsed(void)
+{
+	if (keyboard_tick_elapsed == false)
+	{
+		return false;
+	}
+	
+	keyboard_tick_elapsed = false;
+	
+	return true;
+}
+
+
 // Check to see if keystroke events pending - does not wait for a key
 uint8_t Keyboard_GetKeyIfPressed(void)
 {
@@ -140,5 +140,12 @@ void Keyboard_ProcessEvents(void);
 // initiate the minute hand timer
 void Keyboard_InitiateMinuteHand(void);
 
+// start a one-shot timer that goes off num_frames frames from now. Keyboard_TickElapsed() reports when it has
+void Keyboard_StartTick(uint8_t num_frames);
+
+// returns true, once, if the timer started by Keyboard_StartTick() has gone off. does not wait
+// events are only read in when the key queue is empty, so call Keyboard_GetKeyIfPressed() until it returns 0 first
+bool Keyboard_TickElapsed(void);
+
 
 #endif /* KEYBOARD_H_ */
@@ -29,7 +29,12 @@
 #include "keyboard.h"
 #include "list.h"
 #include "memory.h"
+#include "overlay_bankops.h"
 #include "overlay_em.h"
+#include "overlay_hex.h"
+#include "overlay_fileops.h"
+#include "overlay_patch.h"
+#include "overlay_snapshot.h"
 #include "screen.h"
 #include "strings.h"
 #include "sys.h"
@@ -78,9 +83,14 @@ extern char*		global_temp_path_2;
 extern bool					global_find_next_enabled;
 
 extern int8_t				global_connected_device[DEVICE_MAX_DEVICE_COUNT];	// will be 8, 9, etc, if connected, or -1 if not..
+extern int32_t				global_free_bytes_on_disk[DEVICE_MAX_DEVICE_COUNT];
 extern char*				global_search_phrase;
+extern uint8_t*				global_search_mask;
 extern char*				global_search_phrase_human_readable;
 extern uint8_t				global_search_phrase_len;
+extern char*				global_multi_search_human_readable;
+extern uint8_t*				global_multi_search_phrases;
+extern uint8_t				global_snapshot_count;
 
 extern TextDialogTemplate	global_dlg;	// dialog we'll configure and re-use for different purposes
 extern char					global_dlg_title[36];	// arbitrary
@@ -125,6 +135,16 @@ void Panel_ReflowContentForDisk(WB2KViewPanel* the_panel);
 // note: this also sets/resets the surface's required_inner_width_ property (logical internal width vs physical internal width)
 void Panel_ReflowContentForMemory(WB2KViewPanel* the_panel);
 
+// ask user what to search memory for, and set up global_search_phrase/len with it
+// the previous phrase is offered as the starting point. a phrase starting with # is a series of hex bytes, which may include ?? wildcards and /masks
+// returns false if user cancels
+bool Panel_GetSearchPhrase(void);
+
+// ask user for up to MAX_SEARCH_PHRASES phrases to search memory for at once, and set up global_multi_search_phrases with them
+// the previous phrases are offered as the starting point. phrases are separated by |. each may be text, or # and a series of hex bytes
+// returns false if user cancels, or if the phrases can't be used (user has been told why)
+bool Panel_GetMultiSearchPhrases(void);
+
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
@@ -322,6 +342,129 @@ void Panel_RenderTitleOnly(WB2KViewPanel* the_panel);
 
 
 
+// ask user what to search memory for, and set up global_search_phrase/len with it
+// the previous phrase is offered as the starting point. a phrase starting with # is a series of hex bytes, which may include ?? wildcards and /masks
+// returns false if user cancels
+bool Panel_GetSearchPhrase(void)
+{
+	char*		search_phrase;
+	
+	// set up a 'enter search search phrase' dialog box
+	General_Strlcpy(global_string_buff1, General_GetString(ID_STR_DLG_SEARCH_BANK_TITLE), 70);
+
+	// copy the previous human-readable version of global search phrase into a temp buffer
+	General_Strlcpy(global_string_buff2, global_search_phrase_human_readable, MAX_SEARCH_PHRASE_LEN + 1);
+
+	// ask user what they want to search for, showing them the previous thing they searched for, if any		
+	App_LoadOverlay(OVERLAY_SCREEN);	
+	search_phrase = Screen_GetStringFromUser(global_string_buff1, General_GetString(ID_STR_DLG_SEARCH_BANK_BODY), global_string_buff2, MAX_SEARCH_PHRASE_LEN);
+	
+	if (search_phrase == NULL)
+	{
+		global_search_phrase_len = 0;
+		*global_search_phrase = 0;
+		return false;
+	}
+
+	// get a copy of the phrase as  entered, to keep as the human-readable version. for hex bytes, this matters. for normal strings, it will be same thing user entered.
+	General_Strlcpy(global_search_phrase_human_readable, search_phrase, MAX_SEARCH_PHRASE_LEN + 1);
+	
+	// Process user entry to see if they typed in a direct search phrase, or enter a string of numbers
+	//   LOGIC:
+	//      if user start phrase with "#", then assume it will be string of hex numbers. these need to be converted to raw bytes.
+	//      if search phrase didn't start with #, then it will be left alone and just the len returned
+	
+	global_search_phrase_len = ScreenEvaluateUserStringForHexSeries(&search_phrase, global_search_mask);
+
+	memcpy(global_search_phrase, search_phrase, global_search_phrase_len);
+	
+	return true;
+}
+
+
+// ask user for up to MAX_SEARCH_PHRASES phrases to search memory for at once, and set up global_multi_search_phrases with them
+// the previous phrases are offered as the starting point. phrases are separated by |. each may be text, or # and a series of hex bytes
+// returns false if user cancels, or if the phrases can't be used (user has been told why)
+bool Panel_GetMultiSearchPhrases(void)
+{
+	char*		the_input;
+	char*		this_phrase;
+	char*		the_separator;
+	uint8_t*	packed_phrase = global_multi_search_phrases;
+	uint8_t		the_mask[MAX_MULTI_SEARCH_INPUT_LEN];
+	uint8_t		the_len;
+	uint8_t		num_phrases = 0;
+	uint8_t		i;
+	
+	// set up a 'enter search phrases' dialog box
+	General_Strlcpy(global_string_buff1, General_GetString(ID_STR_DLG_SEARCH_MULTI_TITLE), 70);
+
+	App_LoadOverlay(OVERLAY_SCREEN);	
+	the_input = Screen_GetStringFromUser(global_string_buff1, General_GetString(ID_STR_DLG_SEARCH_MULTI_BODY), global_multi_search_human_readable, MAX_MULTI_SEARCH_INPUT_LEN);
+	
+	if (the_input == NULL)
+	{
+		return false;
+	}
+
+	General_Strlcpy(global_multi_search_human_readable, the_input, MAX_MULTI_SEARCH_INPUT_LEN + 1);
+	
+	// LOGIC:
+	//   each phrase is cut off at its |, and converted the same way as a single search phrase, so it can be text or #hex bytes.
+	//   the automaton only matches exact bytes, so a hex phrase with ?? or a /mask in it is refused, as is an empty phrase.
+	//   phrases are packed one after another as a length byte and then the bytes. a 0 length ends the list.
+	
+	this_phrase = the_input;
+	
+	do
+	{
+		the_separator = strchr(this_phrase, '|');
+		
+		if (the_separator != NULL)
+		{
+			*the_separator = 0;
+		}
+		
+		if (++num_phrases > MAX_SEARCH_PHRASES)
+		{
+			goto bad_phrases;
+		}
+		
+		the_len = ScreenEvaluateUserStringForHexSeries(&this_phrase, the_mask);
+		
+		if (the_len == 0)
+		{
+			goto bad_phrases;
+		}
+		
+		for (i = 0; i < the_len; i++)
+		{
+			if (the_mask[i] != 0xFF)
+			{
+				goto bad_phrases;
+			}
+		}
+		
+		*packed_phrase++ = the_len;
+		memcpy(packed_phrase, this_phrase, the_len);
+		packed_phrase += the_len;
+		
+		this_phrase = (the_separator == NULL) ? NULL : the_separator + 1;
+	} while (this_phrase != NULL);
+	
+	*packed_phrase = 0;
+	
+	return true;
+	
+bad_phrases:
+	*global_multi_search_phrases = 0;
+	Buffer_NewMessage(General_GetString(ID_STR_ERROR_SEARCH_MULTI_PHRASES));
+	return false;
+}
+
+
+
+
 /*****************************************************************************/
 /*                        Public Function Definitions                        */
 /*****************************************************************************/
@@ -658,6 +801,10 @@ bool Panel_Refresh(WB2KViewPanel* the_panel)
 			//Panel_ClearDisplay(the_panel);	// clear out the list, visually at least
 			return false;
 		}
+		
+		// the directory was read to the end, so the kernel has told us the drive's free space along the way
+		App_LoadOverlay(OVERLAY_FILEOPS);
+		FileOps_RememberFreeBytesOnDisk(the_panel->root_folder_->device_number_);
 	}
 	else
 	{
@@ -912,7 +1059,15 @@ bool Panel_FillCurrentBank(WB2KViewPanel* the_panel)
 		return false;
 	}
 	
-	return (MemSys_FillCurrentBank(the_panel->memory_system_));
+	if (MemSys_FillCurrentBank(the_panel->memory_system_) == false)
+	{
+		return false;
+	}
+	
+	// redraw to show the bank's new checksum
+	Panel_RenderContents(the_panel);
+	
+	return true;
 }						
 
 	
@@ -928,124 +1083,638 @@ bool Panel_ClearCurrentBank(WB2KViewPanel* the_panel)
 		return false;
 	}
 	
-	return (MemSys_ClearCurrentBank(the_panel->memory_system_));
+	if (MemSys_ClearCurrentBank(the_panel->memory_system_) == false)
+	{
+		return false;
+	}
+	
+	// redraw to show the bank's new checksum
+	Panel_RenderContents(the_panel);
+	
+	return true;
 }						
 
 
-// rename the currently selected file
-bool Panel_RenameCurrentFile(WB2KViewPanel* the_panel)
+// copy a range of physical memory, entered by the user as hex from,to,length, to anywhere else in RAM
+// the range can be any length, doesn't need to line up with banks, and source and destination may overlap
+// returns false if user cancels, or if the range isn't allowed
+bool Panel_CopyMemoryRange(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel)
 {
-	WB2KFileObject*		the_file;
-	bool				success;
-	char*				new_file_name;
+	uint8_t		src_bank_num;
+	uint8_t		dst_bank_num;
+	uint8_t		writeable_banks[MEMORY_BANK_COUNT / 8];
+	char*		the_string;
 	
-	App_LoadOverlay(OVERLAY_DISKSYS);
+	if (the_panel->for_disk_ == true)
+	{
+		return false;
+	}
 	
-	the_file = Folder_GetCurrentFile(the_panel->root_folder_);
-
-	if (the_file == NULL)
+	// LOGIC:
+	//   suggest copying the current bank to the bank selected in the other panel (or to the next bank, if the other panel shows a disk)
+	//   user can change that to any from, to, and length: 3 hex numbers, separated by commas.
+	//   BANKOPS checks and does the copy, but can't call MEMSYSTEM: get the list of banks the user may write to first.
+	
+	App_LoadOverlay(OVERLAY_MEMSYSTEM);
+	src_bank_num = MemSys_GetCurrentBankNum(the_panel->memory_system_);
+	
+	if (the_other_panel->for_disk_ == false)
+	{
+		dst_bank_num = MemSys_GetCurrentBankNum(the_other_panel->memory_system_);
+	}
+	else
+	{
+		dst_bank_num = src_bank_num + 1;
+	}
+	
+	MemSys_GetWriteableBanks(writeable_banks);
+	
+	sprintf(global_string_buff2, "%05lX,%05lX,%04X", (uint32_t)src_bank_num * BYTES_PER_BANK, (uint32_t)dst_bank_num * BYTES_PER_BANK, BYTES_PER_BANK);
+	General_Strlcpy(global_string_buff1, General_GetString(ID_STR_DLG_COPY_RANGE_TITLE), 70);
+	
+	App_LoadOverlay(OVERLAY_SCREEN);
+	the_string = Screen_GetStringFromUser(global_string_buff1, General_GetString(ID_STR_DLG_ENTER_COPY_RANGE), global_string_buff2, 17); // "FFFFF,FFFFF,80000"
+	
+	if (the_string == NULL)
+	{
+		return false;
+	}
+	
+	App_LoadOverlay(OVERLAY_BANKOPS);
+	
+	if (BankOps_CopyRange(the_string, writeable_banks) == false)
 	{
 		return false;
 	}
 
-	//sprintf(global_string_buff1, "file to rename='%s'", App_GetFilenameFromEM(the_file));
-	//Buffer_NewMessage(global_string_buff1);
-
-	sprintf(global_string_buff1, General_GetString(ID_STR_DLG_RENAME_TITLE), App_GetFilenameFromEM(the_file));
+	// banks may have gained or lost a KUP header
+	Panel_Refresh(the_panel);
+	
+	if (the_other_panel != the_panel && the_other_panel->for_disk_ == false)
+	{
+		Panel_Refresh(the_other_panel);
+	}
+	
+	return true;
+}
 
-	// copy the current file name into the edit buffer so user can edit
-	General_Strlcpy(global_string_buff2, App_GetFilenameFromEM(the_file), FILE_MAX_FILENAME_SIZE);
 
+// save a range of banks, entered by the user as hex bank,count[,offset], to one file on the disk shown in the other panel
+// the range can be any number of banks, as long as they are all in the RAM or flash shown by this panel
+// returns false if user cancels, if the range isn't allowed, or on any disk error
+bool Panel_SaveMemoryRange(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel)
+{
+	uint8_t		first_bank_num;
+	uint8_t		the_bank_num;
+	uint32_t	start_addr;
+	uint32_t	the_len;
+	char*		the_string;
+	char*		the_name;
+	FILE*		the_target_handle;
+	bool		success;
+	
+	if (the_panel->for_disk_ == true)
+	{
+		return false;
+	}
+	
+	if (the_other_panel->for_disk_ == false)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_SAVE_RANGE_NEEDS_DISK));
+		return false;
+	}
+	
+	// LOGIC:
+	//   suggest saving just the current bank. user can change that to any start bank and bank count, plus an optional offset into the first bank.
+	//   the banks must all belong to the panel's own memory system: 00-3F for RAM, 40-7F for flash.
+	//   BANKOPS checks the range and writes the file; this function only asks for input, checks for room, and opens the file.
+	
+	App_LoadOverlay(OVERLAY_MEMSYSTEM);
+	the_bank_num = MemSys_GetCurrentBankNum(the_panel->memory_system_);
+	first_bank_num = (the_panel->memory_system_->is_flash_ == true) ? MEMORY_BANK_COUNT : 0;
+	
+	sprintf(global_string_buff2, "%02X,01", the_bank_num);
+	General_Strlcpy(global_string_buff1, General_GetString(ID_STR_DLG_SAVE_RANGE_TITLE), 70);
+	
 	App_LoadOverlay(OVERLAY_SCREEN);
-	new_file_name = Screen_GetStringFromUser(global_string_buff1, General_GetString(ID_STR_DLG_ENTER_NEW_NAME), global_string_buff2, FILE_MAX_FILENAME_SIZE);
-	App_LoadOverlay(OVERLAY_DISKSYS);
+	the_string = Screen_GetStringFromUser(global_string_buff1, General_GetString(ID_STR_DLG_ENTER_SAVE_RANGE), global_string_buff2, 11); // "7F,40,7FFFF"
 	
-	if (new_file_name == NULL)
+	if (the_string == NULL)
 	{
-		//sprintf(global_string_buff1, "user canceled out of rename dialog");
-		//Buffer_NewMessage(global_string_buff1);
 		return false;
 	}
 	
-	General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_panel->root_folder_->file_path_, App_GetFilenameFromEM(the_file));
-	General_CreateFilePathFromFolderAndFile(global_temp_path_2, the_panel->root_folder_->file_path_, global_string_buff2);
+	App_LoadOverlay(OVERLAY_BANKOPS);
+	
+	if (BankOps_ParseSaveRange(the_string, first_bank_num, &start_addr, &the_len) == false)
+	{
+		return false;
+	}
+	
+	// get a name for the file. suggest one that says which banks are in it
+	General_Strlcpy(global_string_buff1, General_GetString(ID_STR_DLG_COPY_TO_FILE_TITLE), 70);
+	sprintf(global_string_buff2, "Banks_%02X-%02X.bin", (uint8_t)(start_addr / BYTES_PER_BANK), (uint8_t)((start_addr + the_len - 1) / BYTES_PER_BANK));
+	
+	App_LoadOverlay(OVERLAY_SCREEN);
+	the_name = Screen_GetStringFromUser(global_string_buff1, General_GetString(ID_STR_DLG_ENTER_FILE_NAME), global_string_buff2, FILE_MAX_FILENAME_SIZE);
+	App_LoadOverlay(OVERLAY_DISKSYS);
+	
+	if (the_name == NULL)
+	{
+		return false;
+	}
 
-// 	sprintf(global_string_buff1, "new path='%s'", global_temp_path_1);
-// 	Buffer_NewMessage(global_string_buff1);
-// 	sprintf(global_string_buff1, "new filename='%s'", global_string_buff2);
-// 	Buffer_NewMessage(global_string_buff1);
+	General_CreateFilePathFromFolderAndFile(global_temp_path_2, the_other_panel->root_folder_->file_path_, the_name);
 
-	strcpy(global_string_buff1, global_string_buff2); // get a copy of the filename because it won't be available after rename
+	App_LoadOverlay(OVERLAY_FILEOPS);
 	
-	success = File_Rename(the_file, global_string_buff2, global_temp_path_1, global_temp_path_2);
+	if (FileOps_CheckRoomOnDisk(the_other_panel->root_folder_->device_number_, FileOps_GetSizeOnDisk(the_other_panel->root_folder_->device_number_, the_len)) == false)
+	{
+		return false;
+	}
 	
-	if (success == false)
+	App_LoadOverlay(OVERLAY_DISKSYS);
+	
+	if ( (the_target_handle = Folder_GetTargetHandleForWriting(global_temp_path_2)) == NULL)
 	{
 		return false;
 	}
+
+	App_LoadOverlay(OVERLAY_BANKOPS);
+	success = BankOps_SaveRange(the_target_handle, start_addr, the_len);
 	
-	// renew file listing
-	Panel_RenderContents(the_panel);
+	fclose(the_target_handle);
 	
-// 	sprintf(global_string_buff2, General_GetString(ID_STR_MSG_RENAME_SUCCESS), global_string_buff1, App_GetFilenameFromEM(the_file));
-// 	Buffer_NewMessage(global_string_buff2);
+	if (success == false)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_GENERIC_DISK));
+	}
+	else
+	{
+		sprintf(global_string_buff1, General_GetString(ID_STR_MSG_N_BYTES_SAVED_FROM), the_len, start_addr);
+		Buffer_NewMessage(global_string_buff1);
+	}
+	
+	Panel_Refresh(the_other_panel);
 	
 	return success;
 }
 
 
-// Launch current file if EXE, or load font if FNT, open directory if dir, etc.
-bool Panel_OpenCurrentFileOrFolder(WB2KViewPanel* the_panel)
+// save every bank of RAM the user can write to, packed, to one snapshot file on the disk shown in the other panel
+// the first snapshot since f/manager started stores every bank. after that, only banks that changed since the last snapshot made or restored are stored
+// returns false if user cancels, if nothing has changed, or on any disk error
+bool Panel_SnapshotMemory(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel)
 {
-	WB2KFileObject*		the_file;
-	bool				success;
-
+	uint8_t		num_banks;
+	uint8_t		banks_to_save[MEMORY_BANK_COUNT / 8];
+	uint32_t	file_len;
+	char*		the_name;
+	FILE*		the_target_handle;
+	bool		success;
+	
 	if (the_panel->for_disk_ == true)
 	{
-		App_LoadOverlay(OVERLAY_DISKSYS);
-		
-		the_file = Folder_GetCurrentFile(the_panel->root_folder_);
+		return false;
+	}
 	
-		if (the_file == NULL)
-		{
-			return false;
-		}
-		
-		General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_panel->root_folder_->file_path_, App_GetFilenameFromEM(the_file));
-		
-		if (the_file->file_type_ == _CBM_T_DIR)
-		{
-			if (the_panel->root_folder_->is_meatloaf_ == false)
-			{
-				// normal "go up" behavior pretty straightforward: just feed it the path.
-				if ( (the_panel->root_folder_ = Folder_NewOrReset(the_panel->root_folder_, the_panel->device_number_, global_temp_path_1)) == NULL )
-				{
-					LOG_ERR(("%s %d: could not reset the panel's root folder", __func__ , __LINE__));
-					App_Exit(ERROR_DEFINE_ME);	// crash early, crash often
-				}
-			}
-			else
-			{
-				// meatloaf go up is different: to go "up", it will accept "_" (<- on C-64), or "..", but you have to "load" it as if loading a file. 
-				//   This is the mechanism MEATLOAF appears to key off of. Nothing will be loaded, it will "fail" from f/m point of view, but meatloaf will have changed dirs
-				//   for a regular file, just pass the filename, and "load" it. 
-				//   for anything, it needs the "1:" or "2:" prefix, or microkernel will not do it. 
-				// then force f/manager to refresh
-				
-				// try to change directory by "loading" the file. 
-				sprintf(global_temp_path_1, "%u:%s", the_panel->root_folder_->device_number_, App_GetFilenameFromEM(the_file));
-				success = File_LoadFileToEM(global_temp_path_1, EM_STORAGE_START_PHYS_BANK_NUM);
-				
-				//sprintf(global_string_buff1, "Trying to change meatloaf dirs with '%s'...", global_temp_path_1);
-				//Buffer_NewMessage(global_string_buff1);
-			}
+	if (the_other_panel->for_disk_ == false)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_SAVE_RANGE_NEEDS_DISK));
+		return false;
+	}
 	
-			Panel_Refresh(the_panel);
-			success = true;
-		}
-		else if (the_file->file_type_ == FNX_FILETYPE_FONT)
-		{
-			success = File_ReadFontData(global_temp_path_1);
+	// get a name for the file. suggest one that counts up through the session's snapshots
+	General_Strlcpy(global_string_buff1, General_GetString(ID_STR_DLG_SNAPSHOT_TITLE), 70);
+	sprintf(global_string_buff2, "Snapshot_%02u.snp", global_snapshot_count + 1);
+	
+	App_LoadOverlay(OVERLAY_SCREEN);
+	the_name = Screen_GetStringFromUser(global_string_buff1, General_GetString(ID_STR_DLG_ENTER_FILE_NAME), global_string_buff2, FILE_MAX_FILENAME_SIZE);
+	
+	if (the_name == NULL)
+	{
+		return false;
+	}
+
+	General_CreateFilePathFromFolderAndFile(global_temp_path_2, the_other_panel->root_folder_->file_path_, the_name);
+	
+	Buffer_NewMessage(General_GetString(ID_STR_MSG_SNAPSHOT_CHECKING));
+	
+	App_LoadOverlay(OVERLAY_MEMSYSTEM);
+	MemSys_GetWriteableBanks(banks_to_save);
+	
+	App_LoadOverlay(OVERLAY_SNAPSHOT);
+	num_banks = Snapshot_FindChangedBanks(banks_to_save);
+	
+	if (num_banks == 0)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_MSG_SNAPSHOT_NOTHING_CHANGED));
+		return false;
+	}
+	
+	// make sure there is room for the worst case, where no bank packs at all
+	App_LoadOverlay(OVERLAY_FILEOPS);
+	file_len = BANK_SNAPSHOT_HEADER_LEN + BANK_SNAPSHOT_CHECKSUMS_LEN + (uint32_t)num_banks * (BANK_SNAPSHOT_RECORD_LEN + BYTES_PER_BANK);
+
+	if (FileOps_CheckRoomOnDisk(the_other_panel->root_folder_->device_number_, FileOps_GetSizeOnDisk(the_other_panel->root_folder_->device_number_, file_len)) == false)
+	{
+		return false;
+	}
+	
+	App_LoadOverlay(OVERLAY_DISKSYS);
+	
+	if ( (the_target_handle = Folder_GetTargetHandleForWriting(global_temp_path_2)) == NULL)
+	{
+		return false;
+	}
+
+	App_LoadOverlay(OVERLAY_SNAPSHOT);
+	success = Snapshot_Save(the_target_handle, banks_to_save, num_banks);
+	
+	Panel_Refresh(the_other_panel);
+	
+	return success;
+}
+
+
+// restore RAM from the snapshot file selected in this panel. the other panel must show memory
+// only the banks stored in the file are written: restore an incremental snapshot on top of the snapshot that came before it
+// every bank written is checked against the checksum the snapshot recorded for it
+// returns false if user cancels, if the file is not a snapshot, if a bank fails its check, or on any disk error
+bool Panel_RestoreMemorySnapshot(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel)
+{
+	uint8_t			num_banks;
+	uint8_t			writeable_banks[MEMORY_BANK_COUNT / 8];
+	WB2KFileObject*	the_file;
+	FILE*			the_source_handle;
+	bool			success;
+	
+	if (the_panel->for_disk_ == false || the_other_panel->for_disk_ == true)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_RESTORE_NEEDS_RAM));
+		return false;
+	}
+	
+	App_LoadOverlay(OVERLAY_DISKSYS);
+	the_file = Folder_GetCurrentFile(the_panel->root_folder_);
+	
+	if (the_file == NULL)
+	{
+		return false;
+	}
+	
+	General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_panel->root_folder_->file_path_, App_GetFilenameFromEM(the_file));
+	
+	if ( (the_source_handle = fopen(global_temp_path_1, "r")) == NULL)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_GENERIC_DISK));
+		return false;
+	}
+	
+	// LOGIC:
+	//   check the header before asking: then the user can be told how many banks will be overwritten, and a file that isn't a snapshot is never touched.
+	//   the snapshot's checksums go where a new snapshot's would, and become the basis for the next snapshot once every bank is back.
+	
+	App_LoadOverlay(OVERLAY_SNAPSHOT);
+	
+	if (Snapshot_Open(the_source_handle, &num_banks) == false)
+	{
+		fclose(the_source_handle);
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_NOT_A_SNAPSHOT));
+		return false;
+	}
+	
+	sprintf(global_string_buff1, General_GetString(ID_STR_DLG_RESTORE_SNAPSHOT_TITLE), num_banks);
+	
+	App_LoadOverlay(OVERLAY_SCREEN);
+
+	if (Screen_ShowUserTwoButtonDialog(
+		global_string_buff1, 
+		ID_STR_DLG_ARE_YOU_SURE, 
+		ID_STR_DLG_YES, 
+		ID_STR_DLG_NO
+		) != 1)
+	{
+		fclose(the_source_handle);
+		return false;
+	}
+
+	App_LoadOverlay(OVERLAY_MEMSYSTEM);
+	MemSys_GetWriteableBanks(writeable_banks);
+	
+	App_LoadOverlay(OVERLAY_SNAPSHOT);
+	success = Snapshot_Restore(the_source_handle, writeable_banks, num_banks);
+	
+	// show the restored banks' new checksums and KUP names, and re-read the folder, whose filenames are kept in EM
+	Panel_Refresh(the_other_panel);
+	Panel_Refresh(the_panel);
+	
+	return success;
+}
+
+
+// apply the IPS or BPS patch selected in this panel to what is selected in the other panel
+// if the other panel shows RAM, the patch is applied in place, starting at the selected bank. the user is asked first
+// if the other panel shows a disk, the selected file is patched into a new file in the same folder. the user is asked for its name
+// a BPS patch is checked against its CRCs for the source, the result, and itself: if any check fails, nothing is changed
+// returns false if user cancels, if the file is not a patch, if the patch can't be applied, or on any disk error
+bool Panel_ApplyPatch(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel)
+{
+	uint8_t				the_format = PATCH_FORMAT_UNKNOWN;
+	uint8_t				the_result;
+	uint8_t				the_bank_num;
+	uint8_t				banks_free;
+	uint32_t			src_addr;
+	uint32_t			dst_addr;
+	uint32_t			src_len = 0;
+	uint32_t			dst_len = 0;
+	uint32_t			max_len;
+	char*				the_name;
+	char*				the_end;
+	WB2KFileObject*		the_file;
+	WB2KFileObject*		the_source_file = NULL;
+	FILE*				the_handle;
+	bool				success;
+	
+	if (the_panel->for_disk_ == false)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_PATCH_NEEDS_FILES));
+		return false;
+	}
+	
+	App_LoadOverlay(OVERLAY_DISKSYS);
+	the_file = Folder_GetCurrentFile(the_panel->root_folder_);
+	
+	if (the_other_panel->for_disk_ == true)
+	{
+		the_source_file = Folder_GetCurrentFile(the_other_panel->root_folder_);
+	}
+	
+	if (the_file == NULL || the_file->is_directory_ == true || 
+		(the_other_panel->for_disk_ == true && (the_source_file == NULL || the_source_file->is_directory_ == true)))
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_PATCH_NEEDS_FILES));
+		return false;
+	}
+	
+	// LOGIC:
+	//   the patch is only ever read front to back, a bank at a time, so it can be any size (see Patch_Open()).
+	//   there is no seeking in a file, and BPS copies from anywhere in the source and anywhere in the result so far, so both have to be in memory.
+	//   patching a file: the file is read into the EM storage area at $28000, the result is built there too, then it is written to the new file.
+	//   patching RAM: IPS writes straight into the banks. BPS builds the result in the EM storage area, 
+	//     and only copies it over the source once the source, the result, and the patch itself have all passed their CRC checks.
+	//   this asks the user, opens the files, and refreshes the panel: the patch overlay does the rest.
+	
+	if (the_other_panel->for_disk_ == false)
+	{
+		App_LoadOverlay(OVERLAY_MEMSYSTEM);
+		the_bank_num = MemSys_GetCurrentBankNum(the_other_panel->memory_system_);
+		banks_free = MemSys_CountWriteableBanks(the_bank_num, MEMORY_BANK_COUNT);
+		
+		src_addr = (uint32_t)the_bank_num * BYTES_PER_BANK;
+		max_len = (uint32_t)banks_free * BYTES_PER_BANK;
+		
+		if (banks_free == 0)
+		{
+			sprintf(global_string_buff1, General_GetString(ID_STR_ERROR_PATCH_TOO_BIG), max_len);
+			Buffer_NewMessage(global_string_buff1);
+			return false;
+		}
+		
+		sprintf(global_string_buff1, General_GetString(ID_STR_DLG_PATCH_RAM_TITLE), the_bank_num);
+		
+		App_LoadOverlay(OVERLAY_SCREEN);
+	
+		if (Screen_ShowUserTwoButtonDialog(
+			global_string_buff1, 
+			ID_STR_DLG_ARE_YOU_SURE, 
+			ID_STR_DLG_YES, 
+			ID_STR_DLG_NO
+			) != 1)
+		{
+			return false;
+		}
+	}
+	else
+	{
+		// get a name for the new file. suggest the patch's name, without its extension
+		General_Strlcpy(global_string_buff2, App_GetFilenameFromEM(the_file), FILE_MAX_FILENAME_SIZE);
+		the_end = strrchr(global_string_buff2, '.');
+		
+		if (the_end != NULL && the_end != global_string_buff2)
+		{
+			*the_end = '\0';
+		}
+		
+		General_Strlcpy(global_string_buff1, General_GetString(ID_STR_DLG_PATCH_TO_FILE_TITLE), 70);
+		
+		App_LoadOverlay(OVERLAY_SCREEN);
+		the_name = Screen_GetStringFromUser(global_string_buff1, General_GetString(ID_STR_DLG_ENTER_FILE_NAME), global_string_buff2, FILE_MAX_FILENAME_SIZE);
+		App_LoadOverlay(OVERLAY_DISKSYS);
+		
+		if (the_name == NULL)
+		{
+			return false;
+		}
+		
+		General_CreateFilePathFromFolderAndFile(global_temp_path_2, the_other_panel->root_folder_->file_path_, the_name);
+		
+		// read the file to patch into the EM storage area
+		General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_other_panel->root_folder_->file_path_, App_GetFilenameFromEM(the_source_file));
+		
+		if ( (the_handle = fopen(global_temp_path_1, "r")) == NULL)
+		{
+			Buffer_NewMessage(General_GetString(ID_STR_ERROR_GENERIC_DISK));
+			return false;
+		}
+		
+		src_addr = EM_STORAGE_START_PHYS_ADDR;
+		max_len = (uint32_t)FILE_EM_STORAGE_MAX_BANKS * BYTES_PER_BANK;
+		
+		App_LoadOverlay(OVERLAY_PATCH);
+		the_result = Patch_LoadSource(the_handle, &src_len);
+		
+		fclose(the_handle);
+		
+		if (the_result != PATCH_OK)
+		{
+			Patch_ShowResult(the_format, the_result, src_len, max_len);
+			return false;
+		}
+	}
+	
+	General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_panel->root_folder_->file_path_, App_GetFilenameFromEM(the_file));
+	
+	if ( (the_handle = fopen(global_temp_path_1, "r")) == NULL)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_GENERIC_DISK));
+		return false;
+	}
+	
+	App_LoadOverlay(OVERLAY_PATCH);
+	the_result = Patch_ApplyToData(the_handle, the_other_panel->for_disk_, src_addr, src_len, &max_len, &dst_addr, &dst_len, &the_format);
+	
+	fclose(the_handle);
+	
+	if (the_result == PATCH_ERROR_NOT_A_PATCH || the_result == PATCH_ERROR_USES_STAGING)
+	{
+		// nothing was changed
+		Patch_ShowResult(the_format, the_result, dst_len, max_len);
+		return false;
+	}
+	
+	if (the_result == PATCH_OK && the_other_panel->for_disk_ == true)
+	{
+		App_LoadOverlay(OVERLAY_FILEOPS);
+		
+		if (FileOps_CheckRoomOnDisk(the_other_panel->root_folder_->device_number_, FileOps_GetSizeOnDisk(the_other_panel->root_folder_->device_number_, dst_len)) == false)
+		{
+			return false;
+		}
+		
+		App_LoadOverlay(OVERLAY_DISKSYS);
+		
+		if ( (the_handle = Folder_GetTargetHandleForWriting(global_temp_path_2)) == NULL)
+		{
+			return false;
+		}
+		
+		App_LoadOverlay(OVERLAY_PATCH);
+		success = Patch_WriteResult(the_handle, dst_addr, dst_len);
+		
+		fclose(the_handle);
+		
+		if (success == false)
+		{
+			Buffer_NewMessage(General_GetString(ID_STR_ERROR_GENERIC_DISK));
+			Panel_Refresh(the_other_panel);
+			return false;
+		}
+	}
+	
+	Patch_ShowResult(the_format, the_result, dst_len, max_len);
+	
+	// show the new file, or the patched banks' new checksums and KUP names
+	Panel_Refresh(the_other_panel);
+	
+	return (the_result == PATCH_OK);
+}
+
+
+// rename the currently selected file
+bool Panel_RenameCurrentFile(WB2KViewPanel* the_panel)
+{
+	WB2KFileObject*		the_file;
+	bool				success;
+	char*				new_file_name;
+	
+	App_LoadOverlay(OVERLAY_DISKSYS);
+	
+	the_file = Folder_GetCurrentFile(the_panel->root_folder_);
+
+	if (the_file == NULL)
+	{
+		return false;
+	}
+
+	//sprintf(global_string_buff1, "file to rename='%s'", App_GetFilenameFromEM(the_file));
+	//Buffer_NewMessage(global_string_buff1);
+
+	sprintf(global_string_buff1, General_GetString(ID_STR_DLG_RENAME_TITLE), App_GetFilenameFromEM(the_file));
+
+	// copy the current file name into the edit buffer so user can edit
+	General_Strlcpy(global_string_buff2, App_GetFilenameFromEM(the_file), FILE_MAX_FILENAME_SIZE);
+
+	App_LoadOverlay(OVERLAY_SCREEN);
+	new_file_name = Screen_GetStringFromUser(global_string_buff1, General_GetString(ID_STR_DLG_ENTER_NEW_NAME), global_string_buff2, FILE_MAX_FILENAME_SIZE);
+	App_LoadOverlay(OVERLAY_DISKSYS);
+	
+	if (new_file_name == NULL)
+	{
+		//sprintf(global_string_buff1, "user canceled out of rename dialog");
+		//Buffer_NewMessage(global_string_buff1);
+		return false;
+	}
+	
+	General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_panel->root_folder_->file_path_, App_GetFilenameFromEM(the_file));
+	General_CreateFilePathFromFolderAndFile(global_temp_path_2, the_panel->root_folder_->file_path_, global_string_buff2);
+
+// 	sprintf(global_string_buff1, "new path='%s'", global_temp_path_1);
+// 	Buffer_NewMessage(global_string_buff1);
+// 	sprintf(global_string_buff1, "new filename='%s'", global_string_buff2);
+// 	Buffer_NewMessage(global_string_buff1);
+
+	strcpy(global_string_buff1, global_string_buff2); // get a copy of the filename because it won't be available after rename
+	
+	success = File_Rename(the_file, global_string_buff2, global_temp_path_1, global_temp_path_2);
+	
+	if (success == false)
+	{
+		return false;
+	}
+	
+	// renew file listing
+	Panel_RenderContents(the_panel);
+	
+// 	sprintf(global_string_buff2, General_GetString(ID_STR_MSG_RENAME_SUCCESS), global_string_buff1, App_GetFilenameFromEM(the_file));
+// 	Buffer_NewMessage(global_string_buff2);
+	
+	return success;
+}
+
+
+// Launch current file if EXE, or load font if FNT, open directory if dir, etc.
+bool Panel_OpenCurrentFileOrFolder(WB2KViewPanel* the_panel)
+{
+	WB2KFileObject*		the_file;
+	bool				success;
+
+	if (the_panel->for_disk_ == true)
+	{
+		App_LoadOverlay(OVERLAY_DISKSYS);
+		
+		the_file = Folder_GetCurrentFile(the_panel->root_folder_);
+	
+		if (the_file == NULL)
+		{
+			return false;
+		}
+		
+		General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_panel->root_folder_->file_path_, App_GetFilenameFromEM(the_file));
+		
+		if (the_file->file_type_ == _CBM_T_DIR)
+		{
+			if (the_panel->root_folder_->is_meatloaf_ == false)
+			{
+				// normal "go up" behavior pretty straightforward: just feed it the path.
+				if ( (the_panel->root_folder_ = Folder_NewOrReset(the_panel->root_folder_, the_panel->device_number_, global_temp_path_1)) == NULL )
+				{
+					LOG_ERR(("%s %d: could not reset the panel's root folder", __func__ , __LINE__));
+					App_Exit(ERROR_DEFINE_ME);	// crash early, crash often
+				}
+			}
+			else
+			{
+				// meatloaf go up is different: to go "up", it will accept "_" (<- on C-64), or "..", but you have to "load" it as if loading a file. 
+				//   This is the mechanism MEATLOAF appears to key off of. Nothing will be loaded, it will "fail" from f/m point of view, but meatloaf will have changed dirs
+				//   for a regular file, just pass the filename, and "load" it. 
+				//   for anything, it needs the "1:" or "2:" prefix, or microkernel will not do it. 
+				// then force f/manager to refresh
+				
+				// try to change directory by "loading" the file. 
+				sprintf(global_temp_path_1, "%u:%s", the_panel->root_folder_->device_number_, App_GetFilenameFromEM(the_file));
+				success = (File_LoadFileToEM(global_temp_path_1, EM_STORAGE_START_PHYS_BANK_NUM, FILE_EM_STORAGE_MAX_BANKS, PARAM_LOAD_AS_IS) >= 0);
+				
+				//sprintf(global_string_buff1, "Trying to change meatloaf dirs with '%s'...", global_temp_path_1);
+				//Buffer_NewMessage(global_string_buff1);
+			}
+	
+			Panel_Refresh(the_panel);
+			success = true;
+		}
+		else if (the_file->file_type_ == FNX_FILETYPE_FONT)
+		{
+			success = File_ReadFontData(global_temp_path_1);
 		}
 		else if (the_file->file_type_ == FNX_FILETYPE_EXE || the_file->file_type_ == FNX_FILETYPE_IMAGE)
 		{
@@ -1107,7 +1776,7 @@ bool Panel_OpenCurrentFileOrFolder(WB2KViewPanel* the_panel)
 		else if (the_file->file_type_ == FNX_FILETYPE_BASIC)
 		{
 			// until SuperBASIC will accept a file path, only thing we can do is load file into $28000, tell user to type "XGO" once basic loads, then switch to basic.
-			success = File_LoadFileToEM(global_temp_path_1, EM_STORAGE_START_PHYS_BANK_NUM);
+			success = (File_LoadFileToEM(global_temp_path_1, EM_STORAGE_START_PHYS_BANK_NUM, FILE_EM_STORAGE_MAX_BANKS, PARAM_LOAD_AS_IS) >= 0);
 			
 			if (success)
 			{
@@ -1135,15 +1804,22 @@ bool Panel_OpenCurrentFileOrFolder(WB2KViewPanel* the_panel)
 }
 
 
-// delete the currently selected file
+// delete the currently selected file, or all marked files if any are marked. folders are deleted along with everything in them.
 bool Panel_DeleteCurrentFile(WB2KViewPanel* the_panel)
 {
 	WB2KFileObject*		the_file;
 	int16_t				the_current_row;
-	bool				success;
+	uint16_t			num_to_delete;
+	uint16_t			num_deleted;
+	uint16_t			the_marked_count;
 	char				delete_file_name_buff[FILE_MAX_FILENAME_SIZE];
 	char*				delete_file_name = delete_file_name_buff;
 	
+	// LOGIC:
+	//   if nothing is marked, the current file is marked for the duration, so single and batch deletes take the same path.
+	//   1 confirmation for the whole job, then FILEOPS deletes from disk, and DISKSYS takes what was deleted out of the file list.
+	//   the directory isn't re-read afterwards: the panel just re-displays what is left of the list.
+	
 	App_LoadOverlay(OVERLAY_DISKSYS);
 	
 	the_current_row = Folder_GetCurrentRow(the_panel->root_folder_);
@@ -1153,9 +1829,26 @@ bool Panel_DeleteCurrentFile(WB2KViewPanel* the_panel)
 		return false;
 	}
 	
-	the_file = Folder_FindFileByRow(the_panel->root_folder_, the_current_row);
-	strcpy(delete_file_name, App_GetFilenameFromEM(the_file));
-	sprintf(global_string_buff1, General_GetString(ID_STR_DLG_DELETE_TITLE), delete_file_name);
+	the_marked_count = Folder_GetCountMarkedFiles(the_panel->root_folder_);
+	
+	if (the_marked_count == 0)
+	{
+		the_file = Folder_FindFileByRow(the_panel->root_folder_, the_current_row);
+
+		if (Folder_SetFileMark(the_file, true) == false)
+		{
+			return false;
+		}
+		
+		num_to_delete = 1;
+		strcpy(delete_file_name, App_GetFilenameFromEM(the_file));
+		sprintf(global_string_buff1, General_GetString(ID_STR_DLG_DELETE_TITLE), delete_file_name);
+	}
+	else
+	{
+		num_to_delete = the_marked_count;
+		sprintf(global_string_buff1, General_GetString(ID_STR_DLG_DELETE_MARKED_TITLE), the_marked_count);
+	}
 
 	App_LoadOverlay(OVERLAY_SCREEN);
 
@@ -1166,39 +1859,54 @@ bool Panel_DeleteCurrentFile(WB2KViewPanel* the_panel)
 		ID_STR_DLG_NO
 		) != 1)
 	{
+		if (the_marked_count == 0)
+		{
+			App_LoadOverlay(OVERLAY_DISKSYS);
+			Folder_SetFileMark(the_file, false);
+		}
+		
 		return false;
 	}
 
-	App_LoadOverlay(OVERLAY_DISKSYS);
-	General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_panel->root_folder_->file_path_, App_GetFilenameFromEM(the_file));
+	Buffer_NewMessage(General_GetString(ID_STR_MSG_DELETING));
 
-	success = File_Delete(global_temp_path_1, the_file->is_directory_);
+	App_LoadOverlay(OVERLAY_FILEOPS);
+	num_deleted = FileOps_DeleteMarkedFiles(the_panel->root_folder_, num_to_delete, the_panel->y_);
 	
-	if (success == false)
+	// show what's left, even if something failed part way: some files may have been deleted before the failure
+	App_LoadOverlay(OVERLAY_DISKSYS);
+	Folder_RemoveMarkedFiles(the_panel->root_folder_, num_deleted);
+	
+	// a single file that couldn't be deleted shouldn't stay marked: the user never marked it
+	if (the_marked_count == 0 && num_deleted == 0)
 	{
-		if (the_file->is_directory_)
-		{
-			Buffer_NewMessage(General_GetString(ID_STR_MSG_DELETE_DIR_FAILURE));
-		}
-		else
-		{
-			Buffer_NewMessage(General_GetString(ID_STR_MSG_DELETE_FILE_FAILURE));
-		}
-		
-		return false;
+		Folder_SetFileMark(the_file, false);
 	}
 	
-	// renew file listing
-	Panel_Refresh(the_panel);
+	Panel_SortAndDisplay(the_panel);
 
 	// try to select the file that was selected before the deleted one
 	Panel_SetFileSelectionByRow(the_panel, the_current_row, true);
 	
+	if (num_deleted < num_to_delete)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_MSG_DELETE_FILE_FAILURE));
+		return false;
+	}
+	
 	// now send the message
-	sprintf(global_string_buff1, General_GetString(ID_STR_MSG_DELETE_SUCCESS), delete_file_name);
+	if (the_marked_count == 0)
+	{
+		sprintf(global_string_buff1, General_GetString(ID_STR_MSG_DELETE_SUCCESS), delete_file_name);
+	}
+	else
+	{
+		sprintf(global_string_buff1, General_GetString(ID_STR_MSG_N_FILES_DELETED), num_deleted);
+	}
+	
 	Buffer_NewMessage(global_string_buff1);
 	
-	return success;
+	return true;
 }
 
 
@@ -1209,6 +1917,12 @@ bool Panel_CopyCurrentFile(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_pa
 	uint8_t				src_bank_num;
 	uint8_t				dst_bank_num;
 	uint32_t			percent_read;
+	uint16_t			bank_offset;
+	uint32_t			banks_needed;
+	uint8_t				banks_free;
+	int16_t				banks_loaded;
+	uint8_t				the_string_id;
+	int16_t				num_copied;
 	bool				success = false;
 	FILE*				the_target_handle;
 	WB2KFileObject*		the_file;
@@ -1238,25 +1952,94 @@ bool Panel_CopyCurrentFile(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_pa
 	if (the_panel->for_disk_ == true && the_other_panel->for_disk_ == true)
 	{
 		// copy a file from disk to disk
+		
+		// don't start a long copy that can't fit on the target disk
+		App_LoadOverlay(OVERLAY_FILEOPS);
+		
+		if (FileOps_CheckRoomForMarkedFiles(the_panel->root_folder_, the_other_panel->root_folder_) == false)
+		{
+			return false;
+		}
+		
 		App_LoadOverlay(OVERLAY_DISKSYS);
-		success = Folder_CopyCurrentFile(the_panel->root_folder_, the_other_panel->root_folder_);
 		
-		if (success)
+		if (Folder_GetCountMarkedFiles(the_panel->root_folder_) > 0)
 		{
-			Buffer_NewMessage(General_GetString(ID_STR_MSG_DONE));
+			// copy all marked files instead of the current file. clear the marks once they've all been copied.
+			num_copied = Folder_CopyMarkedFiles(the_panel->root_folder_, the_other_panel->root_folder_);
+			success = (num_copied >= 0);
+			
+			if (success)
+			{
+				App_LoadOverlay(OVERLAY_FILEOPS);
+				FileOps_SetAllFileMarks(the_panel->root_folder_, PARAM_MARK_NONE);
+				Panel_RenderContents(the_panel);
+				sprintf(global_string_buff1, General_GetString(ID_STR_MSG_N_FILES_COPIED), num_copied);
+				Buffer_NewMessage(global_string_buff1);
+			}
 		}
 		else
+		{
+			success = Folder_CopyCurrentFile(the_panel->root_folder_, the_other_panel->root_folder_);
+			
+			if (success)
+			{
+				Buffer_NewMessage(General_GetString(ID_STR_MSG_DONE));
+			}
+		}
+		
+		if (success == false)
 		{
 			Buffer_NewMessage(General_GetString(ID_STR_ERROR_GENERIC_DISK));
 		}
 	}
 	else if (the_panel->for_disk_ == true && the_other_panel->for_disk_ == false)
 	{
-		// load a file from disk into memory
+		// load a file from disk into memory, filling as many banks as it needs from the selected one on
 		App_LoadOverlay(OVERLAY_DISKSYS);
 		the_file = Folder_GetCurrentFile(the_panel->root_folder_);
 		General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_panel->root_folder_->file_path_, App_GetFilenameFromEM(the_file));
-		success = File_LoadFileToEM(global_temp_path_1, dst_bank_num);
+		
+		// LOGIC:
+		//   refuse up front if the file would run into flash or f/manager's own banks: check before anything is overwritten.
+		//   the size in the directory is only a guide for some devices, so the loader also gets told to stop at the last free bank.
+		//   LZ4 and ZX0 files are unpacked as they load. their size on disk is only the least they can need: the unpacker stops at the last free bank too.
+		banks_needed = (the_file->size_ + (BYTES_PER_BANK - 1)) / BYTES_PER_BANK;
+		
+		if (banks_needed == 0)
+		{
+			banks_needed = 1;
+		}
+		
+		App_LoadOverlay(OVERLAY_MEMSYSTEM);
+		banks_free = MemSys_CountWriteableBanks(dst_bank_num, MEMORY_BANK_COUNT);
+		
+		if (banks_needed > banks_free)
+		{
+			sprintf(global_string_buff1, General_GetString(ID_STR_ERROR_LOAD_NEEDS_PROTECTED_BANKS), banks_needed, dst_bank_num, banks_free);
+			Buffer_NewMessage(global_string_buff1);
+			return false;
+		}
+		
+		App_LoadOverlay(OVERLAY_DISKSYS);
+		banks_loaded = File_LoadFileToEM(global_temp_path_1, dst_bank_num, banks_free, the_file->file_type_);
+		success = (banks_loaded >= 0);
+		
+		if (success)
+		{
+			the_string_id = (the_file->file_type_ == FNX_FILETYPE_LZ4 || the_file->file_type_ == FNX_FILETYPE_ZX0) ? ID_STR_MSG_N_BANKS_UNPACKED : ID_STR_MSG_N_BANKS_LOADED;
+			sprintf(global_string_buff1, General_GetString(the_string_id), banks_loaded, dst_bank_num);
+			Buffer_NewMessage(global_string_buff1);
+		}
+		else if (banks_loaded == FILE_LOAD_ERROR_DAMAGED)
+		{
+			Buffer_NewMessage(General_GetString(ID_STR_ERROR_PACKED_FILE_DAMAGED));
+		}
+		else if (banks_loaded == FILE_LOAD_ERROR_NO_ROOM)
+		{
+			sprintf(global_string_buff1, General_GetString(ID_STR_ERROR_UNPACK_NO_ROOM), banks_free, dst_bank_num);
+			Buffer_NewMessage(global_string_buff1);
+		}
 	}
 	else if (the_panel->for_disk_ == false && the_other_panel->for_disk_ == true)
 	{
@@ -1279,6 +2062,15 @@ bool Panel_CopyCurrentFile(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_pa
 
 		General_CreateFilePathFromFolderAndFile(global_temp_path_2, the_other_panel->root_folder_->file_path_, the_name);
 	
+		App_LoadOverlay(OVERLAY_FILEOPS);
+		
+		if (FileOps_CheckRoomOnDisk(the_other_panel->root_folder_->device_number_, FileOps_GetSizeOnDisk(the_other_panel->root_folder_->device_number_, (uint32_t)PAGES_PER_BANK * STORAGE_FILE_BUFFER_1_LEN)) == false)
+		{
+			return false;
+		}
+		
+		App_LoadOverlay(OVERLAY_DISKSYS);
+		
 		// get a target handle for writing
 		if ( (the_target_handle = Folder_GetTargetHandleForWriting(global_temp_path_2)) == NULL)
 		{
@@ -1288,14 +2080,14 @@ bool Panel_CopyCurrentFile(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_pa
 		// prepare to use progress bar
 		App_ShowProgressBar();
 
-		// loop until all 8192 bytes of source bank have been witten out, writing STORAGE_FILE_BUFFER_1_LEN bytes per loop (sized to available buffer)
-		for (i = 0; i < PAGES_PER_BANK; i++)
+		// loop until all 8192 bytes of source bank have been witten out, writing straight from the bank, BANK_SAVE_CHUNK_LEN bytes per loop
+		success = true;
+		
+		for (bank_offset = 0; bank_offset < BYTES_PER_BANK && success == true; bank_offset += BANK_SAVE_CHUNK_LEN)
 		{
-			App_EMDataCopy(the_buffer, src_bank_num, i, PARAM_COPY_FROM_EM);
-
-			fwrite(the_buffer, 1, STORAGE_FILE_BUFFER_1_LEN, the_target_handle);
+			success = App_EMWriteToFile(the_target_handle, src_bank_num, bank_offset, BANK_SAVE_CHUNK_LEN);
 			
-			percent_read = ((uint32_t)i * 100) / (uint32_t)PAGES_PER_BANK;
+			percent_read = ((uint32_t)(bank_offset + BANK_SAVE_CHUNK_LEN) * 100) / (uint32_t)BYTES_PER_BANK;
 			
 			App_UpdateProgressBar((uint8_t)percent_read);		
 		}
@@ -1305,7 +2097,10 @@ bool Panel_CopyCurrentFile(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_pa
 		// clear the progress bar
 		App_HideProgressBar();
 		
-		success = true;
+		if (success == false)
+		{
+			Buffer_NewMessage(General_GetString(ID_STR_ERROR_GENERIC_DISK));
+		}
 	}
 	else if (the_panel->for_disk_ == false && the_other_panel->for_disk_ == false)
 	{
@@ -1327,10 +2122,18 @@ bool Panel_CopyCurrentFile(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_pa
 		}
 				
 		// ok, safe to proceed
-		for (i = 0; i < PAGES_PER_BANK; i++)
+		// DMA can copy RAM to RAM in one operation, but can't read flash: flash banks still go through the interbank buffer page by page
+		if (src_bank_num < MEMORY_BANK_COUNT)
+		{
+			App_MoveMemoryWithDMA((uint32_t)dst_bank_num * BYTES_PER_BANK, (uint32_t)src_bank_num * BYTES_PER_BANK, BYTES_PER_BANK);
+		}
+		else
 		{
-			App_EMDataCopy(the_buffer, src_bank_num, i, PARAM_COPY_FROM_EM);
-			App_EMDataCopy(the_buffer, dst_bank_num, i, PARAM_COPY_TO_EM);
+			for (i = 0; i < PAGES_PER_BANK; i++)
+			{
+				App_EMDataCopy(the_buffer, src_bank_num, i, PARAM_COPY_FROM_EM);
+				App_EMDataCopy(the_buffer, dst_bank_num, i, PARAM_COPY_TO_EM);
+			}
 		}
 
 		success = true;
@@ -1380,9 +2183,19 @@ bool Panel_ViewCurrentFile(WB2KViewPanel* the_panel, uint8_t the_viewer_type)
 		the_file = Folder_FindFileByRow(the_panel->root_folder_, the_current_row);
 		the_name = App_GetFilenameFromEM(the_file);
 		General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_panel->root_folder_->file_path_, the_name);
-		num_pages = the_file->size_/256;
+		
+		// the viewers count in 256b pages, and only the EM storage area is loaded
+		if (the_file->size_ < (uint32_t)FILE_EM_STORAGE_MAX_BANKS * BYTES_PER_BANK)
+		{
+			num_pages = the_file->size_/256;
+		}
+		else
+		{
+			num_pages = FILE_EM_STORAGE_MAX_BANKS * PAGES_PER_BANK;
+		}
+		
 		bank_num = EM_STORAGE_START_PHYS_BANK_NUM;
-		success = File_LoadFileToEM(global_temp_path_1, bank_num);
+		success = (File_LoadFileToEM(global_temp_path_1, bank_num, FILE_EM_STORAGE_MAX_BANKS, PARAM_LOAD_AS_IS) >= 0);
 	}
 	else
 	{
@@ -1395,14 +2208,14 @@ bool Panel_ViewCurrentFile(WB2KViewPanel* the_panel, uint8_t the_viewer_type)
 	
 	if (success)
 	{
-		App_LoadOverlay(OVERLAY_EM);
-		
 		if (the_viewer_type == PARAM_VIEW_AS_HEX)
 		{
-			EM_DisplayAsHex(bank_num, num_pages, the_name);
+			App_LoadOverlay(OVERLAY_HEX);
+			Hex_DisplayAsHex(bank_num, 0, num_pages, the_name, PARAM_NO_COMPARE_BANK);
 		}
 		else
 		{
+			App_LoadOverlay(OVERLAY_EM);
 			EM_DisplayAsText(bank_num, num_pages, the_name);
 		}
 	}
@@ -1546,6 +2359,101 @@ bool Panel_SetFileSelectionByRow(WB2KViewPanel* the_panel, uint16_t the_row, boo
 }
 
 
+// mark or unmark the currently selected file, then move the selection down 1 row
+bool Panel_ToggleCurrentFileMark(WB2KViewPanel* the_panel)
+{
+	WB2KFileObject*		the_file;
+
+	if (the_panel->for_disk_ == false)
+	{
+		return false;
+	}
+	
+	App_LoadOverlay(OVERLAY_DISKSYS);
+	
+	the_file = Folder_GetCurrentFile(the_panel->root_folder_);
+
+	if (the_file == NULL)
+	{
+		return false;
+	}
+	
+	if (Folder_SetFileMark(the_file, !Folder_IsFileMarked(the_file)) == false)
+	{
+		return false;
+	}
+	
+	// re-render now: if this was the last file, selecting the next file won't do it for us
+	File_Render(the_file, true, the_panel->y_, the_panel->active_);
+	Panel_SelectNextFile(the_panel);
+	
+	return true;
+}
+
+
+// mark all, unmark all, or invert marks on all files in the panel (PARAM_MARK_ALL, etc.), and re-render
+bool Panel_SetAllFileMarks(WB2KViewPanel* the_panel, uint8_t the_mark_action)
+{
+	uint16_t	the_marked_count;
+	
+	if (the_panel->for_disk_ == false)
+	{
+		return false;
+	}
+	
+	App_LoadOverlay(OVERLAY_FILEOPS);
+	FileOps_SetAllFileMarks(the_panel->root_folder_, the_mark_action);
+	App_LoadOverlay(OVERLAY_DISKSYS);
+	the_marked_count = Folder_GetCountMarkedFiles(the_panel->root_folder_);
+
+	Panel_RenderContents(the_panel);
+
+	sprintf(global_string_buff1, General_GetString(ID_STR_MSG_N_FILES_MARKED), the_marked_count);
+	Buffer_NewMessage(global_string_buff1);
+	
+	return true;
+}
+
+
+// ask user for a wildcard pattern, and mark every file in the panel whose name matches it
+bool Panel_MarkFilesByPattern(WB2KViewPanel* the_panel)
+{
+	uint16_t	the_marked_count;
+	char*		the_pattern;
+	
+	if (the_panel->for_disk_ == false)
+	{
+		return false;
+	}
+	
+	global_string_buff2[0] = '*';
+	global_string_buff2[1] = 0;
+	
+	// General_GetString() always returns the same buffer, so the title needs to be copied out before getting the body text
+	General_Strlcpy(global_string_buff1, General_GetString(ID_STR_DLG_MARK_PATTERN_TITLE), 70);
+	
+	App_LoadOverlay(OVERLAY_SCREEN);
+	the_pattern = Screen_GetStringFromUser(global_string_buff1, General_GetString(ID_STR_DLG_ENTER_MARK_PATTERN), global_string_buff2, FILE_MAX_FILENAME_SIZE);
+	
+	if (the_pattern == NULL)
+	{
+		return false;
+	}
+
+	App_LoadOverlay(OVERLAY_FILEOPS);
+	FileOps_MarkFilesByPattern(the_panel->root_folder_, the_pattern);
+	App_LoadOverlay(OVERLAY_DISKSYS);
+	the_marked_count = Folder_GetCountMarkedFiles(the_panel->root_folder_);
+
+	Panel_RenderContents(the_panel);
+
+	sprintf(global_string_buff1, General_GetString(ID_STR_MSG_N_FILES_MARKED), the_marked_count);
+	Buffer_NewMessage(global_string_buff1);
+	
+	return true;
+}
+
+
 // // de-select all files
 // bool Panel_UnSelectAllFiles(WB2KViewPanel* the_panel)
 // {
@@ -1676,24 +2584,99 @@ bool Panel_SetFileSelectionByRow(WB2KViewPanel* the_panel, uint16_t the_row, boo
 // }
 
 
-// // move every currently selected file into the specified folder
-// // returns -1 in event of error, or count of files moved
-// int16_t Panel_MoveSelectedFiles(WB2KViewPanel* the_panel, WB2KFolderObject* the_target_folder)
-// {
-// 	if (the_panel == NULL)
-// 	{
-// 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
-// 		App_Exit(ERROR_PANEL_WAS_NULL); // crash early, crash often
-// 	}
-// 
-// 	if (the_target_folder == NULL)
-// 	{
-// 		LOG_ERR(("%s %d: passed the_target_folder was null", __func__ , __LINE__));
-// 		App_Exit(ERROR_PANEL_TARGET_FOLDER_WAS_NULL); // crash early, crash often
-// 	}
-// 
-// 	return Folder_MoveSelectedFiles(the_panel->root_folder_, the_target_folder);
-// }
+// move every marked file (or the current file, if none are marked) into the folder shown in the other panel
+// returns false if nothing could be moved
+bool Panel_MoveSelectedFiles(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel)
+{
+	int16_t				num_moved = 0;
+	int16_t				num_copied;
+	WB2KFileObject*		the_file;
+	WB2KFileObject*		the_target_folder_file;
+	
+	if (the_panel == NULL || the_other_panel == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		App_Exit(ERROR_PANEL_WAS_NULL); // crash early, crash often
+	}
+
+	// LOGIC:
+	//   moving only makes sense between disk folders.
+	//   meatloaf folders can't have files deleted from them, so can't be a move source, and are not a reliable target either.
+	//   if the user hasn't marked anything, treat the current file as the (only) marked file, same as copy and delete do.
+	//   if both panels show the same folder, move into the folder that is selected in the other panel instead: that is all renames.
+	//   otherwise, on the same device FILEOPS renames what it can, then DISKSYS copies+deletes whatever is still marked.
+	
+	if (the_panel->for_disk_ == false || the_other_panel->for_disk_ == false || 
+		the_panel->root_folder_->is_meatloaf_ == true || the_other_panel->root_folder_->is_meatloaf_ == true)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_MOVE_NEEDS_2_DISK_PANELS));
+		return false;
+	}
+
+	App_LoadOverlay(OVERLAY_DISKSYS);
+	
+	if (Folder_GetCountMarkedFiles(the_panel->root_folder_) == 0)
+	{
+		the_file = Folder_GetCurrentFile(the_panel->root_folder_);
+		
+		if (the_file == NULL || Folder_SetFileMark(the_file, true) == false)
+		{
+			return false;
+		}
+	}
+	
+	if (strcmp(the_panel->root_folder_->file_path_, the_other_panel->root_folder_->file_path_) == 0)
+	{
+		the_target_folder_file = Folder_GetCurrentFile(the_other_panel->root_folder_);
+		
+		if (the_target_folder_file == NULL || the_target_folder_file->is_directory_ == false)
+		{
+			Buffer_NewMessage(General_GetString(ID_STR_ERROR_MOVE_NEEDS_2_DISK_PANELS));
+			return false;
+		}
+		
+		Buffer_NewMessage(General_GetString(ID_STR_MSG_MOVING));
+		App_LoadOverlay(OVERLAY_FILEOPS);
+		num_moved = FileOps_MoveMarkedFilesToFolderFile(the_panel->root_folder_, the_target_folder_file);
+	}
+	else
+	{
+		App_LoadOverlay(OVERLAY_FILEOPS);
+		
+		// between drives, files are copied before the originals are deleted: don't start if they can't all fit
+		if (the_panel->root_folder_->device_number_ != the_other_panel->root_folder_->device_number_ && 
+			FileOps_CheckRoomForMarkedFiles(the_panel->root_folder_, the_other_panel->root_folder_) == false)
+		{
+			return false;
+		}
+		
+		Buffer_NewMessage(General_GetString(ID_STR_MSG_MOVING));
+		
+		if (the_panel->root_folder_->device_number_ == the_other_panel->root_folder_->device_number_)
+		{
+			num_moved = FileOps_MoveMarkedFilesByRename(the_panel->root_folder_, the_other_panel->root_folder_);
+		}
+		
+		App_LoadOverlay(OVERLAY_DISKSYS);
+		num_copied = Folder_MoveSelectedFiles(the_panel->root_folder_, the_other_panel->root_folder_);
+		num_moved = (num_copied < 0 ? -1 : num_moved + num_copied);
+	}
+	
+	// renew both file listings even if something failed: some files may have been moved before the failure
+	Panel_Refresh(the_other_panel);
+	Panel_Refresh(the_panel);
+
+	if (num_moved < 0)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_GENERIC_DISK));
+		return false;
+	}
+	
+	sprintf(global_string_buff1, General_GetString(ID_STR_MSG_N_FILES_MOVED), num_moved);
+	Buffer_NewMessage(global_string_buff1);
+
+	return (num_moved > 0);
+}
 
 
 // calculate and set positions for the panel's files, when viewed as list
@@ -1768,6 +2751,9 @@ void Panel_RenderContents(WB2KViewPanel* the_panel)
 		
 		App_LoadOverlay(OVERLAY_MEMSYSTEM);
 		
+		// only banks written to since the last time around get checksummed again
+		MemSys_UpdateChecksums(the_panel->memory_system_);
+		
 		for (row = 0; row < MEMORY_BANK_COUNT; row++)
 		{
 			FMBankObject*	this_bank;
@@ -1790,6 +2776,8 @@ void Panel_RenderTitleOnly(WB2KViewPanel* the_panel)
 {
 	uint8_t		back_color;
 	uint8_t		fore_color;
+	uint32_t	free_kb;
+	char		free_string[16];
 
 	if (the_panel->active_ == true)
 	{
@@ -1807,6 +2795,23 @@ void Panel_RenderTitleOnly(WB2KViewPanel* the_panel)
 	if (the_panel->for_disk_ == true)
 	{
 		Text_DrawStringAtXY( the_panel->x_, the_panel->y_ - 3, the_panel->root_folder_->file_name_, fore_color, back_color);
+		
+		// show free space on the drive, right-aligned in the tab, if the drive reported any
+		if (the_panel->device_number_ < DEVICE_MAX_DEVICE_COUNT && global_free_bytes_on_disk[the_panel->device_number_] >= 0)
+		{
+			free_kb = (uint32_t)global_free_bytes_on_disk[the_panel->device_number_] / 1024;
+			
+			if (free_kb < 10000)
+			{
+				sprintf(free_string, General_GetString(ID_STR_LBL_N_KB_FREE), free_kb);
+			}
+			else
+			{
+				sprintf(free_string, General_GetString(ID_STR_LBL_N_MB_FREE), free_kb / 1024);
+			}
+			
+			Text_DrawStringAtXY( the_panel->x_ + (UI_PANEL_TAB_WIDTH - 2) - strlen(free_string), the_panel->y_ - 3, free_string, fore_color, back_color);
+		}
 	}
 	else if (the_panel->device_number_ == DEVICE_RAM)
 	{
@@ -1880,7 +2885,6 @@ void Panel_SortAndDisplay(WB2KViewPanel* the_panel)
 bool Panel_SearchCurrentBank(WB2KViewPanel* the_panel)
 {
 	uint8_t		the_bank_num;
-	char*		search_phrase;
 	
 	if (the_panel->for_disk_ == true)
 	{
@@ -1890,35 +2894,12 @@ bool Panel_SearchCurrentBank(WB2KViewPanel* the_panel)
 	App_LoadOverlay(OVERLAY_MEMSYSTEM);
 	the_bank_num = MemSys_GetCurrentBankNum(the_panel->memory_system_);
 	
-	// set up a 'enter search search phrase' dialog box
-	General_Strlcpy(global_string_buff1, General_GetString(ID_STR_DLG_SEARCH_BANK_TITLE), 70);
-
-	// copy the previous human-readable version of global search phrase into a temp buffer
-	General_Strlcpy(global_string_buff2, global_search_phrase_human_readable, MAX_SEARCH_PHRASE_LEN + 1);
-
-	// ask user what they want to search for, showing them the previous thing they searched for, if any		
-	App_LoadOverlay(OVERLAY_SCREEN);	
-	search_phrase = Screen_GetStringFromUser(global_string_buff1, General_GetString(ID_STR_DLG_SEARCH_BANK_BODY), global_string_buff2, MAX_SEARCH_PHRASE_LEN);
-	
-	if (search_phrase == NULL)
+	if (Panel_GetSearchPhrase() == false)
 	{
-		global_search_phrase_len = 0;
-		*global_search_phrase = 0;
 		return false;
 	}
 
-	// get a copy of the phrase as  entered, to keep as the human-readable version. for hex bytes, this matters. for normal strings, it will be same thing user entered.
-	General_Strlcpy(global_search_phrase_human_readable, search_phrase, MAX_SEARCH_PHRASE_LEN + 1);
-	
-	// Process user entry to see if they typed in a direct search phrase, or enter a string of numbers
-	//   LOGIC:
-	//      if user start phrase with "#", then assume it will be string of hex numbers. these need to be converted to raw bytes.
-	//      if search phrase didn't start with #, then it will be left alone and just the len returned
-	
-	global_search_phrase_len = ScreenEvaluateUserStringForHexSeries(&search_phrase);
-
 	// prepare for search
-	memcpy(global_search_phrase, search_phrase, global_search_phrase_len);
 	*(uint8_t*)ZP_SEARCH_LOC_BYTE = 0;	// start at begining of page
 	*(uint8_t*)ZP_SEARCH_LOC_PAGE = 0;	// start at first page in bank
 	*(uint8_t*)ZP_SEARCH_LOC_BANK = the_bank_num;	// start at the currently selected bank
@@ -1940,6 +2921,119 @@ bool Panel_SearchCurrentBank(WB2KViewPanel* the_panel)
 }
 
 
+// search every bank from the currently selected one to the last bank of this panel's RAM or flash, and list all the matches
+// returns false if user cancels, or if nothing was found
+bool Panel_SearchAllFromCurrentBank(WB2KViewPanel* the_panel)
+{
+	uint8_t		the_bank_num;
+	uint8_t		last_bank_num;
+	uint16_t	num_hits;
+	
+	if (the_panel->for_disk_ == true)
+	{
+		return false;
+	}
+
+	App_LoadOverlay(OVERLAY_MEMSYSTEM);
+	the_bank_num = MemSys_GetCurrentBankNum(the_panel->memory_system_);
+	last_bank_num = (the_panel->memory_system_->is_flash_ == true) ? NUM_MEMORY_BANKS - 1 : MEMORY_BANK_COUNT - 1;
+	
+	if (Panel_GetSearchPhrase() == false)
+	{
+		return false;
+	}
+
+	App_LoadOverlay(OVERLAY_EM);
+	num_hits = EM_SearchMemoryForAll(the_bank_num, last_bank_num);
+	
+	if (num_hits == 0)
+	{
+		return false;
+	}
+	
+	App_LoadOverlay(OVERLAY_HEX);
+	Hex_DisplaySearchResults(num_hits, global_search_phrase_human_readable);
+	
+	return true;
+}
+
+
+// search every bank from the currently selected one to the last bank of this panel's RAM or flash for several phrases at once, and list all the matches
+// returns false if user cancels, or if nothing was found
+bool Panel_SearchPhrasesFromCurrentBank(WB2KViewPanel* the_panel)
+{
+	uint8_t		the_bank_num;
+	uint8_t		last_bank_num;
+	uint16_t	num_hits;
+	bool		ignore_case;
+	
+	if (the_panel->for_disk_ == true)
+	{
+		return false;
+	}
+
+	App_LoadOverlay(OVERLAY_MEMSYSTEM);
+	the_bank_num = MemSys_GetCurrentBankNum(the_panel->memory_system_);
+	last_bank_num = (the_panel->memory_system_->is_flash_ == true) ? NUM_MEMORY_BANKS - 1 : MEMORY_BANK_COUNT - 1;
+	
+	if (Panel_GetMultiSearchPhrases() == false)
+	{
+		return false;
+	}
+
+	General_Strlcpy(global_string_buff1, General_GetString(ID_STR_DLG_SEARCH_MULTI_TITLE), 70);
+	App_LoadOverlay(OVERLAY_SCREEN);
+	ignore_case = Screen_ShowUserTwoButtonDialog(global_string_buff1, ID_STR_DLG_SEARCH_IGNORE_CASE, ID_STR_DLG_YES, ID_STR_DLG_NO);
+
+	App_LoadOverlay(OVERLAY_EM);
+	num_hits = EM_SearchMemoryForAllPhrases(the_bank_num, last_bank_num, ignore_case);
+	
+	if (num_hits == 0)
+	{
+		return false;
+	}
+	
+	App_LoadOverlay(OVERLAY_HEX);
+	Hex_DisplaySearchResults(num_hits, global_multi_search_human_readable);
+	
+	return true;
+}
+
+
+// compare the bank selected in this panel with the bank selected in the other panel, and list the ranges where they differ
+// both panels must be showing RAM or flash
+// returns false if the banks can't be compared, or if they are identical
+bool Panel_CompareBanks(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel)
+{
+	uint8_t		the_bank_num;
+	uint8_t		other_bank_num;
+	uint16_t	num_ranges;
+	
+	if (the_panel->for_disk_ == true || the_other_panel->for_disk_ == true)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_COMPARE_NEEDS_MEMORY));
+		return false;
+	}
+
+	App_LoadOverlay(OVERLAY_MEMSYSTEM);
+	the_bank_num = MemSys_GetCurrentBankNum(the_panel->memory_system_);
+	other_bank_num = MemSys_GetCurrentBankNum(the_other_panel->memory_system_);
+	
+	App_LoadOverlay(OVERLAY_EM);
+	num_ranges = EM_CompareBanks(the_bank_num, other_bank_num);
+	
+	if (num_ranges == 0)
+	{
+		return false;
+	}
+	
+	App_LoadOverlay(OVERLAY_HEX);
+	Hex_DisplayCompareResults(num_ranges, the_bank_num, other_bank_num);
+	
+	return true;
+}
+
+
 // ask user for a Meatloaf URL they want to open as a directory
 bool Panel_OpenMeatloafURL(WB2KViewPanel* the_panel)
 {
@@ -1986,7 +3080,7 @@ bool Panel_OpenMeatloafURL(WB2KViewPanel* the_panel)
 	// user entered a URL, now try to "load" it. It will be in global_string_buff2
 	sprintf(global_temp_path_1, "%u:%s", the_panel->root_folder_->device_number_, global_string_buff2);
 	App_LoadOverlay(OVERLAY_DISKSYS);
-	File_LoadFileToEM(global_temp_path_1, EM_STORAGE_START_PHYS_BANK_NUM);
+	File_LoadFileToEM(global_temp_path_1, EM_STORAGE_START_PHYS_BANK_NUM, FILE_EM_STORAGE_MAX_BANKS, PARAM_LOAD_AS_IS);
 	Panel_Refresh(the_panel);
 
 
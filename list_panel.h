@@ -155,13 +155,13 @@ bool Panel_OwnsX(WB2KViewPanel* the_panel, int16_t x);
 // rename the currently selected file
 bool Panel_RenameCurrentFile(WB2KViewPanel* the_panel);
 
-// delete the currently selected file
+// delete the currently selected file, or all marked files if any are marked
 bool Panel_DeleteCurrentFile(WB2KViewPanel* the_panel);
 
 // Launch current file if EXE, or load font if FNT, open directory if dir, etc.
 bool Panel_OpenCurrentFileOrFolder(WB2KViewPanel* the_panel);
 
-// copy the currently selected file to the other panel
+// copy the currently selected file (or all marked files, if any are marked) to the other panel
 bool Panel_CopyCurrentFile(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel);
 
 // show the contents of the currently selected file using the selected type of viewer
@@ -179,15 +179,24 @@ bool Panel_SelectNextFile(WB2KViewPanel* the_panel);
 // select or unselect 1 file by row id
 bool Panel_SetFileSelectionByRow(WB2KViewPanel* the_panel, uint16_t the_row, bool do_selection);
 
+// mark or unmark the currently selected file, then move the selection down 1 row
+bool Panel_ToggleCurrentFileMark(WB2KViewPanel* the_panel);
+
+// mark all, unmark all, or invert marks on all files in the panel (PARAM_MARK_ALL, etc.), and re-render
+bool Panel_SetAllFileMarks(WB2KViewPanel* the_panel, uint8_t the_mark_action);
+
+// ask user for a wildcard pattern, and mark every file in the panel whose name matches it
+bool Panel_MarkFilesByPattern(WB2KViewPanel* the_panel);
+
 // de-select all files
 bool Panel_UnSelectAllFiles(WB2KViewPanel* the_panel);
 
 // Performs an "Open" action on any files in the panel that are marked as selected
 bool Panel_OpenSelectedFiles(WB2KViewPanel* the_panel);
 
-// move every currently selected file into the specified folder
-// returns -1 in event of error, or count of files moved
-int16_t Panel_MoveSelectedFiles(WB2KViewPanel* the_panel, WB2KFolderObject* the_target_folder);
+// move every marked file (or the current file, if none are marked) into the folder shown in the other panel
+// returns false if nothing could be moved
+bool Panel_MoveSelectedFiles(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel);
 
 // repositions the all elements of the display (without re-rendering it, and without recalculating available height/width), calling the appropriate internal function for list view, icon view, or column view
 void Panel_ReflowContent(WB2KViewPanel* the_panel);
@@ -208,9 +217,51 @@ bool Panel_FillCurrentBank(WB2KViewPanel* the_panel);
 // fill the currently selected memory bank with zeros
 bool Panel_ClearCurrentBank(WB2KViewPanel* the_panel);
 
+// copy a range of physical memory, entered by the user as hex from,to,length, to anywhere else in RAM
+// the range can be any length, doesn't need to line up with banks, and source and destination may overlap
+// returns false if user cancels, or if the range isn't allowed
+bool Panel_CopyMemoryRange(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel);
+
+// save a range of banks, entered by the user as hex bank,count[,offset], to one file on the disk shown in the other panel
+// the range can be any number of banks, as long as they are all in the RAM or flash shown by this panel
+// the optional offset skips that many bytes at the start of the first bank
+// returns false if user cancels, if the range isn't allowed, or on any disk error
+bool Panel_SaveMemoryRange(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel);
+
+// save every bank of RAM the user can write to, packed, to one snapshot file on the disk shown in the other panel
+// the first snapshot since f/manager started stores every bank. after that, only banks that changed since the last snapshot made or restored are stored
+// returns false if user cancels, if nothing has changed, or on any disk error
+bool Panel_SnapshotMemory(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel);
+
+// restore RAM from the snapshot file selected in this panel. the other panel must show memory
+// only the banks stored in the file are written: restore an incremental snapshot on top of the snapshot that came before it
+// every bank written is checked against the checksum the snapshot recorded for it
+// returns false if user cancels, if the file is not a snapshot, if a bank fails its check, or on any disk error
+bool Panel_RestoreMemorySnapshot(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel);
+
+// apply the IPS or BPS patch selected in this panel to what is selected in the other panel
+// if the other panel shows RAM, the patch is applied in place, starting at the selected bank. the user is asked first
+// if the other panel shows a disk, the selected file is patched into a new file in the same folder. the user is asked for its name
+// a BPS patch is checked against its CRCs for the source, the result, and itself: if any check fails, nothing is changed
+// returns false if user cancels, if the file is not a patch, if the patch can't be applied, or on any disk error
+bool Panel_ApplyPatch(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel);
+
 // initiate a memory search at the start of the currently selected bank
 bool Panel_SearchCurrentBank(WB2KViewPanel* the_panel);
 
+// search every bank from the currently selected one to the last bank of this panel's RAM or flash, and list all the matches
+// returns false if user cancels, or if nothing was found
+bool Panel_SearchAllFromCurrentBank(WB2KViewPanel* the_panel);
+
+// search every bank from the currently selected one to the last bank of this panel's RAM or flash for several phrases at once, and list all the matches
+// returns false if user cancels, or if nothing was found
+bool Panel_SearchPhrasesFromCurrentBank(WB2KViewPanel* the_panel);
+
+// compare the bank selected in this panel with the bank selected in the other panel, and list the ranges where they differ
+// both panels must be showing RAM or flash
+// returns false if the banks can't be compared, or if they are identical
+bool Panel_CompareBanks(WB2KViewPanel* the_panel, WB2KViewPanel* the_other_panel);
+
 // ask user for a Meatloaf URL they want to open as a directory
 bool Panel_OpenMeatloafURL(WB2KViewPanel* the_panel);
 
@@ -13,14 +13,26 @@
 	
 ; import from lich king .c
 ;	.import _some_variable
+	.import _File_ReadStreamBuffer
 
 ; export to lich king .c
 	.export	_Memory_SwapInNewBank
 	.export	_Memory_RestorePreviousBank
 	.export _Memory_GetMappedBankNum
 ;	.export _Memory_Copy
-;	.export _Memory_CopyWithDMA
-;	.export _Memory_FillWithDMA
+	.export _Memory_CopyWithDMA
+	.export _Memory_FillWithDMA
+	.export _Memory_FillWithDMA2D
+	.export _Memory_SearchBank
+	.export _Memory_SearchBankForPhrases
+	.export _Memory_CompareBanks
+	.export _Memory_ChecksumBank
+	.export _Memory_ProfileBank
+	.export _Memory_CompressBank
+	.export _Memory_DecompressBank
+	.export _Memory_DecompressStream
+	.export _Memory_MakeCrc32Table
+	.export _Memory_Crc32
 ;	.export _Memory_DebugOut
 
 ; ZP_LK exports:
@@ -61,6 +73,10 @@ DMA_FILL_VAL = $DF01	; Byte value to use for fill operations
 DMA_SRC_ADDR = $DF04	; Source address (system bus - 3 byte)
 DMA_DST_ADDR = $DF08	; Destination address (system bus - 3 byte)
 DMA_COUNT = $DF0C		; Number of bytes to fill or copy
+DMA_WIDTH = $DF0C		; 2D operations: width of the rectangle, in bytes (2 byte)
+DMA_HEIGHT = $DF0E		; 2D operations: height of the rectangle, in rows (2 byte)
+DMA_STRIDE_SRC = $DF10	; 2D operations: bytes from the start of one source row to the next (2 byte)
+DMA_STRIDE_DST = $DF12	; 2D operations: bytes from the start of one destination row to the next (2 byte)
 
 
 
@@ -288,114 +304,67 @@ _global_string_buffer2:			.res 2;
 
 
 ; ---------------------------------------------------------------
-; void __fastcall__ Memory_CopyWithDMA(void)
+; void __fastcall__ Memory_CopyWithDMA(bool wait_for_vblank)
 ; ---------------------------------------------------------------
 ;// call to a routine in memory.asm that copies specified number of bytes from src to dst
 ;// set zp_to_addr, zp_from_addr, zp_copy_len before calling.
 ;// this version uses the F256's DMA capabilities to copy, so addresses can be 24 bit (system memory, not CPU memory)
 ;// in other words, no need to page either dst or src into CPU space
+;// DMA always copies upwards: if the ranges overlap and dst is above src, use App_MoveMemoryWithDMA(), which splits the job up safely
+;// the DMA registers are in IO page 0: caller must have swapped that in
+;// wait_for_vblank (in A) is false only for an operation that follows another one straight away, as part of the same job
 
 ; status - 2024-03-17: DMA works (1 out of 5 or so times), but very unstable. others report same instability. commenting out until a more stable way can be identified. 
+; status - back in use, with the same engine setup as fill (see notes at Memory_FillWithDMA).
 
 
-;.segment	"CODE"
-;
-;.proc	_Memory_CopyWithDMA: near
-;
-;.segment	"CODE"
-;
-;			SEI					; disable interrupts
-;
-;			; Wait for VBlank period
-;LINE_NO = 261*2  ; 240+21
-;        	LDA #<LINE_NO
-;        	LDX #>LINE_NO
-;wait1:
-;        	CPX $D01B
-;       	 	BEQ wait1
-;wait2:
-;        	cmp $D01A
-;        	CMP wait2
-;
-;wait3:
-;        	CPX $D01B
-;        	BNE wait3
-;wait4:
-;        	CMP $D01A
-;        	BNE wait4
-;
-;
-;			STZ DMA_CTRL			; Turn off the DMA engine
-;
-;			NOP						; random experimenting with trying to prevent timing issue
-;			NOP
-;			NOP
-;			NOP
-;			NOP
-;			
-;			; Enable the DMA engine and set it up for a (1D) copy operation:
-;			LDA #DMA_CTRL_ENABLE
-;			STA DMA_CTRL
-;
-;			NOP						; random experimenting with trying to prevent timing issue
-;			NOP
-;			NOP
-;			NOP
-;			NOP
-;			
-;			;Source address (3 byte):
-;			LDA _zp_from_addr
-;			STA DMA_SRC_ADDR
-;			LDA _zp_from_addr+1
-;			STA DMA_SRC_ADDR+1
-;			LDA _zp_from_addr+2
-;			AND #$07
-;			STA DMA_SRC_ADDR+2
-;
-;			;Destination address (3 byte):
-;			LDA _zp_to_addr
-;			STA DMA_DST_ADDR
-;			LDA _zp_to_addr+1
-;			STA DMA_DST_ADDR+1
-;			LDA _zp_to_addr+2
-;			AND #$07
-;			STA DMA_DST_ADDR+2
-;
-;			; Num bytes to copy
-;			LDA _zp_copy_len
-;			STA DMA_COUNT
-;			LDA _zp_copy_len+1
-;			STA DMA_COUNT+1
-;			LDA _zp_copy_len+2
-;			STA DMA_COUNT+2
-;
-;			; flip the START flag to trigger the DMA operation
-;			LDA DMA_CTRL
-;			ORA #DMA_CTRL_START
-;			STA DMA_CTRL
-;			; wait for it to finish
-;
-;wait_dma:	LDA DMA_STATUS
-;			BMI wait_dma            ; Wait until DMA is not busy 
-;			
-;			NOP
-;			NOP
-;			NOP
-;			NOP
-;			NOP
-;
-;			STZ DMA_CTRL			; Turn off the DMA engine
-;			
-;			NOP
-;			NOP
-;			NOP
-;			NOP
-;			NOP
-;			
-;			CLI						; re-enable interrupts
-;			
-;			RTS
-;.endproc
+.segment	"CODE"
+
+.proc	_Memory_CopyWithDMA: near
+
+.segment	"CODE"
+
+			SEI						; disable interrupts: nothing else may touch the DMA registers or the IO page while we work
+
+			CMP #0
+			BEQ skip_vblank			; caller already waited for this job
+			JSR dma_wait_for_vblank
+
+skip_vblank:
+			STZ DMA_CTRL			; Turn off the DMA engine
+			
+			; Enable the DMA engine and set it up for a (1D) copy operation:
+			LDA #DMA_CTRL_ENABLE
+			STA DMA_CTRL
+			
+			;Source address (3 byte):
+			LDA _zp_from_addr
+			STA DMA_SRC_ADDR
+			LDA _zp_from_addr+1
+			STA DMA_SRC_ADDR+1
+			LDA _zp_from_addr+2
+			AND #$07
+			STA DMA_SRC_ADDR+2
+
+			;Destination address (3 byte):
+			LDA _zp_to_addr
+			STA DMA_DST_ADDR
+			LDA _zp_to_addr+1
+			STA DMA_DST_ADDR+1
+			LDA _zp_to_addr+2
+			AND #$07
+			STA DMA_DST_ADDR+2
+
+			; Num bytes to copy
+			LDA _zp_copy_len
+			STA DMA_COUNT
+			LDA _zp_copy_len+1
+			STA DMA_COUNT+1
+			LDA _zp_copy_len+2
+			STA DMA_COUNT+2
+
+			JMP dma_start_and_wait	; common tail: starts the operation, waits for it, turns engine off, re-enables interrupts
+.endproc
 
 
 ; ---------------------------------------------------------------
@@ -405,86 +374,2190 @@ _global_string_buffer2:			.res 2;
 ;// set zp_to_addr, zp_copy_len to num bytes to fill, and zp_other_byte to the fill value before calling.
 ;// this version uses the F256's DMA capabilities to fill, so addresses can be 24 bit (system memory, not CPU memory)
 ;// in other words, no need to page either dst into CPU space
+;// the DMA registers are in IO page 0: caller must have swapped that in
 
+; notes on the instability seen with DMA (see Memory_CopyWithDMA):
+;   the old version never made sure IO page 0 was in, and set START without checking the engine was idle.
+;   fill and copy now get a clean disable/enable, have every register written before START is set, and poll busy before and after.
+
+
+.segment	"CODE"
+
+.proc	_Memory_FillWithDMA: near
+
+.segment	"CODE"
+
+			SEI						; disable interrupts: nothing else may touch the DMA registers or the IO page while we work
+
+			JSR dma_wait_for_vblank
+
+			STZ DMA_CTRL			; Turn off the DMA engine
+			
+			; Enable the DMA engine and set it up for a (1D) FILL operation:
+			LDA #DMA_CTRL_FILL | DMA_CTRL_ENABLE
+			STA DMA_CTRL
+
+			; the fill value
+			LDA _zp_other_byte
+			STA DMA_FILL_VAL
+            
+			;Destination address (3 byte):
+			LDA _zp_to_addr
+			STA DMA_DST_ADDR
+			LDA _zp_to_addr+1
+			STA DMA_DST_ADDR+1
+			LDA _zp_to_addr+2
+			AND #$07
+			STA DMA_DST_ADDR+2
+
+			; Num bytes to fill
+			LDA _zp_copy_len
+			STA DMA_COUNT
+			LDA _zp_copy_len+1
+			STA DMA_COUNT+1
+			LDA _zp_copy_len+2
+			STA DMA_COUNT+2
+
+			JMP dma_start_and_wait	; common tail: starts the operation, waits for it, turns engine off, re-enables interrupts
+.endproc
+
+
+; ---------------------------------------------------------------
+; void __fastcall__ Memory_FillWithDMA2D(void)
+; ---------------------------------------------------------------
+;// call to a routine in memory.asm that fills a rectangle of bytes at the dst: height rows of width bytes, each row starting stride bytes after the previous
+;// set zp_to_addr to the top left corner, zp_copy_len (2 bytes) to the width, zp_copy_len+2 to the height (1-255 rows), 
+;//   zp_from_addr (2 bytes) to the destination stride, and zp_other_byte to the fill value before calling.
+;//   (a fill has no source, so zp_from_addr is free to carry the stride)
+;// uses the F256's DMA capabilities to fill, so addresses can be 24 bit (system memory, not CPU memory)
+;// the DMA registers are in IO page 0: caller must have swapped that in
+
+.segment	"CODE"
+
+.proc	_Memory_FillWithDMA2D: near
+
+.segment	"CODE"
+
+			SEI						; disable interrupts: nothing else may touch the DMA registers or the IO page while we work
+
+			JSR dma_wait_for_vblank
+
+			STZ DMA_CTRL			; Turn off the DMA engine
+			
+			; Enable the DMA engine and set it up for a 2D FILL operation:
+			LDA #DMA_CTRL_FILL | DMA_CTRL_2D | DMA_CTRL_ENABLE
+			STA DMA_CTRL
+
+			; the fill value
+			LDA _zp_other_byte
+			STA DMA_FILL_VAL
+            
+			;Destination address (3 byte):
+			LDA _zp_to_addr
+			STA DMA_DST_ADDR
+			LDA _zp_to_addr+1
+			STA DMA_DST_ADDR+1
+			LDA _zp_to_addr+2
+			AND #$07
+			STA DMA_DST_ADDR+2
+
+			; width of each row (2 byte)
+			LDA _zp_copy_len
+			STA DMA_WIDTH
+			LDA _zp_copy_len+1
+			STA DMA_WIDTH+1
+
+			; number of rows (2 byte register, we only ever need 1)
+			LDA _zp_copy_len+2
+			STA DMA_HEIGHT
+			STZ DMA_HEIGHT+1
+
+			; distance from start of one row to start of next (2 byte)
+			LDA _zp_from_addr
+			STA DMA_STRIDE_DST
+			LDA _zp_from_addr+1
+			STA DMA_STRIDE_DST+1
+
+			JMP dma_start_and_wait	; common tail: starts the operation, waits for it, turns engine off, re-enables interrupts
+.endproc
+
+
+; ---------------------------------------------------------------
+; uint8_t __fastcall__ Memory_SearchBank(void)
+; ---------------------------------------------------------------
+;// call to a routine in memory.asm that searches one bank of memory, in place, for a phrase, using Boyer-Moore-Horspool
+;// the bank is mapped in at $A000, and the bank after it at $C000 (I/O off), so a match can run over the end of the bank without any copying
+;// set before calling:
+;//   zp_search_loc_bank: the bank to search. zp_search_loc_page and zp_search_loc_byte: the first position in it to try
+;//   zp_from_addr (2 bytes): CPU address of the phrase. must not be in $A000-$DFFF. each byte must already be ANDed with its mask
+;//   zp_to_addr (2 bytes): CPU address of the phrase's masks, one per byte: FF=must match exactly, 00=anything matches. same rules as phrase
+;//   zp_other_byte: length of the phrase (1-128)
+;//   zp_temp_1: offset in the phrase of the anchor byte the skip table is built around (normally the last byte with mask FF)
+;//   zp_copy_len (2 bytes): the last position in the bank to try (0-8191). don't let phrase run past the end of memory.
+;//   the skip table at STORAGE_FILE_BUFFER_1: for every byte value, how far to slide the phrase when that byte is under the anchor
+;// returns 1 and sets zp_search_loc_page/byte to the start of the match, or returns 0 if there is no match in this bank
+;// runs with interrupts off, except for a moment between pages, when everything is put back so pending interrupts can be serviced
+;// puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+
+SEARCH_WINDOW = $A000		; the bank being searched goes in slot 5. the next one follows it in slot 6
+SEARCH_SKIP_TABLE = $0500	; STORAGE_FILE_BUFFER_1
+
+.segment	"BSS"
+
+search_io:			.res 1		; what was in $0001, $000D, and $000E on entry
+search_slot_5:		.res 1
+search_slot_6:		.res 1
+
+.segment	"CODE"
+
+.proc	_Memory_SearchBank: near
+
+.segment	"CODE"
+
+			SEI						; nothing else can run while the overlay and I/O are mapped out
+			
+			LDA $0001				; stash the I/O setting
+			STA search_io
+			
+.ifdef _SIMULATOR_
+			LDA #$80				; edit mode (bit 7) + edit lut #4 (bits 4-5 both on) + active lut stays as #4 (bits 0-1 on)
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			LDA $000D				; stash whatever is in slots 5 and 6 (overlay, kernel#2)
+			STA search_slot_5
+			LDA $000E
+			STA search_slot_6
+
+.ifdef _SIMULATOR_
+			LDA #$00				; Select LUT#0 as active, turn off editing
+.else
+			LDA #$33				; Select LUT#3 as active, turn off editing
+.endif
+			STA $0000
+			
+			JSR map_in
+			
+			; ptr1 = where the phrase currently sits in the window
+			LDA _zp_search_loc_byte
+			STA ptr1
+			LDA _zp_search_loc_page
+			CLC
+			ADC #>SEARCH_WINDOW
+			STA ptr1+1
+			
+			; ptr3 = last place the phrase may sit
+			LDA _zp_copy_len
+			STA ptr3
+			LDA _zp_copy_len+1
+			CLC
+			ADC #>SEARCH_WINDOW
+			STA ptr3+1
+			
+			LDA _zp_from_addr
+			STA ptr2
+			LDA _zp_from_addr+1
+			STA ptr2+1
+			
+			LDA _zp_to_addr
+			STA ptr4
+			LDA _zp_to_addr+1
+			STA ptr4+1
+			
+			LDX _zp_other_byte
+			DEX
+			STX tmp1				; offset of the last char of the phrase
+
+try_here:	LDA ptr3				; done once ptr1 has gone past ptr3
+			CMP ptr1
+			LDA ptr3+1
+			SBC ptr1+1
+			BCC not_found
+			
+			LDY tmp1				; compare right to left. only the bits in each byte's mask count
+compare:	LDA (ptr1),y
+			AND (ptr4),y
+			CMP (ptr2),y
+			BNE mismatch
+			DEY
+			BPL compare
+			
+			; every char matched. hand back the position as page/byte
+			LDA ptr1
+			STA _zp_search_loc_byte
+			LDA ptr1+1
+			SEC
+			SBC #>SEARCH_WINDOW
+			STA _zp_search_loc_page
+			LDA #$01
+			BRA put_back
+
+mismatch:	LDY _zp_temp_1			; slide by the skip for whatever byte is under the anchor
+			LDA (ptr1),y
+			TAX
+			LDA SEARCH_SKIP_TABLE,x
+			CLC
+			ADC ptr1
+			STA ptr1
+			BCC try_here
+			INC ptr1+1
+			
+			JSR map_out				; on to a new page: put everything back for a moment so interrupts aren't held off for the whole bank
+			CLI
+			SEI
+			JSR map_in
+			BRA try_here
+
+not_found:	LDA #$00
+
+put_back:	STA tmp2				; keep the result while everything goes back the way it was
+
+			JSR map_out
+			
+			CLI
+			
+			; do the return. cc65 requires functions return a 16 bit value!
+			LDX #$00
+			LDA tmp2
+			
+			RTS
+
+			; ---- helpers ----
+
+; map the bank being searched in at $A000, the one after it at $C000, and turn off I/O. trashes A
+map_in:
+.ifdef _SIMULATOR_
+			LDA #$80
+.else
+			LDA #$B3
+.endif
+			STA $0000
+			
+			LDA _zp_search_loc_bank
+			STA $000D
+			INC A
+			AND #$7F				; after the last bank, the "next" bank is never looked at (see zp_copy_len), so anything will do
+			STA $000E
+
+.ifdef _SIMULATOR_
+			LDA #$00
+.else
+			LDA #$33
+.endif
+			STA $0000
+			
+			LDA #$04				; turn off I/O so the RAM under it is visible
+			STA $0001
+			RTS
+
+; put back whatever was in slots 5 and 6, and the I/O setting. trashes A
+map_out:
+.ifdef _SIMULATOR_
+			LDA #$80
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			LDA search_slot_5
+			STA $000D
+			LDA search_slot_6
+			STA $000E
+
+.ifdef _SIMULATOR_
+			LDA #$00
+.else
+			LDA #$33
+.endif
+			STA $0000
+			
+			LDA search_io
+			STA $0001
+			RTS
+.endproc
+
+
+
+; ---------------------------------------------------------------
+; uint8_t __fastcall__ Memory_SearchBankForPhrases(void)
+; ---------------------------------------------------------------
+;// call to a routine in memory.asm that runs one bank of memory, in place, through a multi-phrase (Aho-Corasick) search automaton
+;// the bank is mapped in at $A000, and the automaton bank at $C000 (I/O off). see SEARCH_AUTOMATON_* in memory.h for its layout.
+;// the automaton's state carries over from one call to the next, so matches that run over the end of a bank are found without any copying
+;// set before calling:
+;//   zp_search_loc_bank: the bank to search. zp_search_loc_page and zp_search_loc_byte: the first position in it to feed to the automaton
+;//   zp_other_byte: the bank number the automaton is stored in
+;//   zp_temp_1: the automaton state to start in (0 at the start of a search, otherwise whatever the previous call left there)
+;// returns the match flags (one bit per phrase) and sets zp_search_loc_page/byte to the last byte of the match(es), 
+;//   or returns 0 once the end of the bank is reached without a match. either way, zp_temp_1 holds the state to carry on from.
+;// runs with interrupts off, and puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+
+AUTOMATON_CLASS_LO = $C000		; for every byte value, low byte of the address of its transition column
+AUTOMATON_CLASS_HI = $C100		; ... and the high byte
+AUTOMATON_MATCHES = $C200		; for every state, a bit for each phrase that ends there
+
+.segment	"CODE"
+
+.proc	_Memory_SearchBankForPhrases: near
+
+.segment	"CODE"
+
+			SEI						; nothing else can run while the overlay and I/O are mapped out
+			
+			LDA $0001				; stash the I/O setting
+			PHA
+			
+.ifdef _SIMULATOR_
+			LDA #$80				; edit mode (bit 7) + edit lut #4 (bits 4-5 both on) + active lut stays as #4 (bits 0-1 on)
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			LDA $000D				; stash whatever is in slots 5 and 6 (overlay, kernel#2)
+			PHA
+			LDA $000E
+			PHA
+			
+			LDA _zp_search_loc_bank
+			STA $000D
+			LDA _zp_other_byte
+			STA $000E
+
+.ifdef _SIMULATOR_
+			LDA #$00				; Select LUT#0 as active, turn off editing
+.else
+			LDA #$33				; Select LUT#3 as active, turn off editing
+.endif
+			STA $0000
+			
+			LDA #$04				; turn off I/O so the RAM under it is visible
+			STA $0001
+			
+			; ptr1 = next byte to feed to the automaton
+			LDA _zp_search_loc_byte
+			STA ptr1
+			LDA _zp_search_loc_page
+			CLC
+			ADC #>SEARCH_WINDOW
+			STA ptr1+1
+			
+			LDY _zp_temp_1			; Y = current state, for the whole loop
+
+next_byte:	LDA (ptr1)				; the byte picks the transition column...
+			TAX
+			LDA AUTOMATON_CLASS_LO,x
+			STA ptr2
+			LDA AUTOMATON_CLASS_HI,x
+			STA ptr2+1
+			LDA (ptr2),y			; ...and the current state picks the next state from it
+			TAY
+			LDA AUTOMATON_MATCHES,y
+			BNE found
+			
+			INC ptr1
+			BNE next_byte
+			INC ptr1+1
+			LDA ptr1+1
+			CMP #>(SEARCH_WINDOW + $2000)
+			BNE next_byte
+			
+			LDA #$00				; ran off the end of the bank
+			BRA put_back
+
+found:		TAX						; keep the match flags
+			LDA ptr1
+			STA _zp_search_loc_byte
+			LDA ptr1+1
+			SEC
+			SBC #>SEARCH_WINDOW
+			STA _zp_search_loc_page
+			TXA
+
+put_back:	STA tmp2				; keep the result while everything goes back the way it was
+			STY _zp_temp_1
+
+.ifdef _SIMULATOR_
+			LDA #$80
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			PLA
+			STA $000E
+			PLA
+			STA $000D
+
+.ifdef _SIMULATOR_
+			LDA #$00
+.else
+			LDA #$33
+.endif
+			STA $0000
+			
+			PLA						; I/O setting
+			STA $0001
+			
+			CLI
+			
+			; do the return. cc65 requires functions return a 16 bit value!
+			LDX #$00
+			LDA tmp2
+			
+			RTS
+.endproc
+
+
+
+; ---------------------------------------------------------------
+; uint8_t __fastcall__ Memory_CompareBanks(void)
+; ---------------------------------------------------------------
+;// call to a routine in memory.asm that compares 2 banks of memory, in place, byte for byte
+;// the first bank is mapped in at $A000, and the second at $C000 (I/O off), so nothing needs to be copied
+;// set before calling:
+;//   zp_search_loc_bank: the first bank. zp_search_loc_page and zp_search_loc_byte: the first position in it to look at
+;//   zp_other_byte: the second bank
+;//   zp_temp_1: 0 to look for the next byte that differs between the banks, or 1 to look for the next byte that is the same in both
+;// returns 1 and sets zp_search_loc_page/byte to the position found, or returns 0 if the end of the bank is reached first
+;// runs with interrupts off, and puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+
+COMPARE_WINDOW_1 = $A000		; first bank goes in slot 5, second in slot 6
+COMPARE_WINDOW_2 = $C000
+
+.segment	"CODE"
+
+.proc	_Memory_CompareBanks: near
+
+.segment	"CODE"
+
+			SEI						; nothing else can run while the overlay and I/O are mapped out
+			
+			LDA $0001				; stash the I/O setting
+			PHA
+			
+.ifdef _SIMULATOR_
+			LDA #$80				; edit mode (bit 7) + edit lut #4 (bits 4-5 both on) + active lut stays as #4 (bits 0-1 on)
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			LDA $000D				; stash whatever is in slots 5 and 6 (overlay, kernel#2)
+			PHA
+			LDA $000E
+			PHA
+			
+			LDA _zp_search_loc_bank
+			STA $000D
+			LDA _zp_other_byte
+			STA $000E
+
+.ifdef _SIMULATOR_
+			LDA #$00				; Select LUT#0 as active, turn off editing
+.else
+			LDA #$33				; Select LUT#3 as active, turn off editing
+.endif
+			STA $0000
+			
+			LDA #$04				; turn off I/O so the RAM under it is visible
+			STA $0001
+			
+			; ptr1/ptr2 = start of the page to begin in, in each bank. Y = byte within the page.
+			STZ ptr1
+			STZ ptr2
+			LDA _zp_search_loc_page
+			CLC
+			ADC #>COMPARE_WINDOW_1
+			STA ptr1+1
+			CLC
+			ADC #>(COMPARE_WINDOW_2 - COMPARE_WINDOW_1)
+			STA ptr2+1
+			LDY _zp_search_loc_byte
+			
+			LDA _zp_temp_1
+			BNE find_same
+
+find_diff:	LDA (ptr1),y			; a page at a time, until a byte differs
+			CMP (ptr2),y
+			BNE found
+			INY
+			BNE find_diff
+			INC ptr2+1
+			INC ptr1+1
+			LDA ptr1+1
+			CMP #>COMPARE_WINDOW_2
+			BNE find_diff
+			BRA not_found
+
+find_same:	LDA (ptr1),y			; a page at a time, until a byte is the same
+			CMP (ptr2),y
+			BEQ found
+			INY
+			BNE find_same
+			INC ptr2+1
+			INC ptr1+1
+			LDA ptr1+1
+			CMP #>COMPARE_WINDOW_2
+			BNE find_same
+
+not_found:	LDA #$00
+			BRA put_back
+
+found:		STY _zp_search_loc_byte
+			LDA ptr1+1
+			SEC
+			SBC #>COMPARE_WINDOW_1
+			STA _zp_search_loc_page
+			LDA #$01
+
+put_back:	STA tmp2				; keep the result while everything goes back the way it was
+
+.ifdef _SIMULATOR_
+			LDA #$80
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			PLA
+			STA $000E
+			PLA
+			STA $000D
+
+.ifdef _SIMULATOR_
+			LDA #$00
+.else
+			LDA #$33
+.endif
+			STA $0000
+			
+			PLA						; I/O setting
+			STA $0001
+			
+			CLI
+			
+			; do the return. cc65 requires functions return a 16 bit value!
+			LDX #$00
+			LDA tmp2
+			
+			RTS
+.endproc
 
-;.segment	"CODE"
-;
-;.proc	_Memory_FillWithDMA: near
-;
-;.segment	"CODE"
-;
-;			SEI					; disable interrupts
-;
-;LINE_NO = 261*2  ; 240+21
-;        lda #<LINE_NO
-;        ldx #>LINE_NO
-;wait1:
-;        cpx $D01B
-;        beq wait1
-;wait2:
-;        cmp $D01A
-;        beq wait2
-;
-;wait3:
-;        cpx $D01B
-;        bne wait3
-;wait4:
-;        cmp $D01A
-;        bne wait4
-;
-;			STZ DMA_CTRL			; Turn off the DMA engine
-;			
-;			; Enable the DMA engine and set it up for a FILL operation:
-;			LDA #DMA_CTRL_FILL | DMA_CTRL_ENABLE
-;			STA DMA_CTRL
-;
-;			; the fill value
-;            lda _zp_other_byte
-;            sta DMA_FILL_VAL
-;            
-;			;Destination address (3 byte):
-;			LDA _zp_to_addr
-;			STA DMA_DST_ADDR
-;			LDA _zp_to_addr+1
-;			STA DMA_DST_ADDR+1
-;			LDA _zp_to_addr+2
-;			AND #$07
-;			STA DMA_DST_ADDR+2
-;
-;			; Num bytes to fill
-;			LDA _zp_copy_len
-;			STA DMA_COUNT
-;			LDA _zp_copy_len+1
-;			STA DMA_COUNT+1
-;			LDA _zp_copy_len+2
-;			STA DMA_COUNT+2
-;
-;			; flip the START flag to trigger the DMA operation
-;			LDA DMA_CTRL
-;			ORA #DMA_CTRL_START
-;			STA DMA_CTRL
-;			; wait for it to finish
-;
-;wait_dma:	LDA DMA_STATUS
-;			BMI wait_dma            ; Wait until DMA is not busy 
-;			
-;			NOP
-;			NOP
-;			NOP
-;			NOP
-;			NOP
-;			NOP
-;			
-;			NOP
-;			NOP
-;
-;			NOP
-;			NOP
-;			
-;			CLI						; re-enable interrupts
-;			
-;			RTS
-;.endproc
 
 
+; ---------------------------------------------------------------
+; uint32_t __fastcall__ Memory_ChecksumBank(void)
+; ---------------------------------------------------------------
+;// call to a routine in memory.asm that calculates the Fletcher-32 checksum of one bank of memory, in place
+;// the bank is mapped in at $A000, and read as 4096 16-bit little-endian words
+;// set zp_search_loc_bank to the bank (0-127) before calling.
+;// returns the checksum: sum of sums in the high word, sum of the words in the low word, each mod 65535
+;// runs with interrupts off, and puts back whatever was mapped at $A000 before returning
+
+CHECKSUM_WINDOW = $A000			; bank goes in slot 5
+
+.segment	"CODE"
+
+.proc	_Memory_ChecksumBank: near
+
+.segment	"CODE"
+
+			SEI						; nothing else can run while the overlay is mapped out
+			
+.ifdef _SIMULATOR_
+			LDA #$80				; edit mode (bit 7) + edit lut #4 (bits 4-5 both on) + active lut stays as #4 (bits 0-1 on)
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			LDA $000D				; stash whatever is in slot 5 (overlay)
+			PHA
+			
+			LDA _zp_search_loc_bank
+			STA $000D
+
+.ifdef _SIMULATOR_
+			LDA #$00				; Select LUT#0 as active, turn off editing
+.else
+			LDA #$33				; Select LUT#3 as active, turn off editing
+.endif
+			STA $0000
+			
+			; ptr2 = sum of the words, sreg = sum of sums. ptr1 = start of the current page. Y = byte within the page.
+			; adding the carry back in after each 16-bit add (end-around carry) keeps both sums mod 65535, without any division.
+			; $FFFF and $0000 are then the same value, and get sorted out at the end.
+			STZ ptr2
+			STZ ptr2+1
+			STZ sreg
+			STZ sreg+1
+			STZ ptr1
+			LDA #>CHECKSUM_WINDOW
+			STA ptr1+1
+			LDY #$00
+
+next_word:	LDA (ptr1),y			; sum1 += next word
+			CLC
+			ADC ptr2
+			STA ptr2
+			INY
+			LDA (ptr1),y
+			ADC ptr2+1
+			STA ptr2+1
+			BCC add_sum2
+			INC ptr2				; can't carry out of the high byte again: the sum without the carry is $FFFE at most
+			BNE add_sum2
+			INC ptr2+1
+
+add_sum2:	LDA ptr2				; sum2 += sum1
+			CLC
+			ADC sreg
+			STA sreg
+			LDA ptr2+1
+			ADC sreg+1
+			STA sreg+1
+			BCC word_done
+			INC sreg
+			BNE word_done
+			INC sreg+1
+
+word_done:	INY
+			BNE next_word
+			INC ptr1+1
+			LDA ptr1+1
+			CMP #>(CHECKSUM_WINDOW + $2000)
+			BNE next_word
+
+			LDA ptr2				; $FFFF is 0 mod 65535
+			AND ptr2+1
+			CMP #$FF
+			BNE sum1_ok
+			STZ ptr2
+			STZ ptr2+1
+sum1_ok:	LDA sreg
+			AND sreg+1
+			CMP #$FF
+			BNE put_back
+			STZ sreg
+			STZ sreg+1
+
+put_back:
+.ifdef _SIMULATOR_
+			LDA #$80
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			PLA
+			STA $000D
+
+.ifdef _SIMULATOR_
+			LDA #$00
+.else
+			LDA #$33
+.endif
+			STA $0000
+			
+			CLI
+			
+			; do the return: cc65 wants a 32 bit value in sreg (high word), X and A (low word)
+			LDX ptr2+1
+			LDA ptr2
+			
+			RTS
+.endproc
+
+
+
+; ---------------------------------------------------------------
+; uint32_t __fastcall__ Memory_ProfileBank(void)
+; ---------------------------------------------------------------
+;// call to a routine in memory.asm that works out how one bank of memory is being used, in place, in one pass over it
+;// a histogram of the bank's byte values is built in a scratch bank, then the $00 and $FF counts and an entropy estimate are taken from that
+;// the bank is mapped in at $A000, and the scratch bank at $C000 (I/O off). see BANK_PROFILE_HISTOGRAM_* in memory.h for where the histogram goes.
+;// set before calling:
+;//   zp_search_loc_bank: the bank to profile (0-127)
+;//   zp_other_byte: the scratch bank. must not be the bank being profiled
+;// returns, from the low byte up: the entropy estimate in 16ths of a bit per byte (0-128), the number of $00 bytes / 64 (0-128), 
+;//   the number of $FF bytes / 64 (0-128), and 0. see BANK_PROFILE_* in memory.h
+;// runs with interrupts off, and puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+
+PROFILE_WINDOW = $A000			; bank goes in slot 5, scratch bank in slot 6
+PROFILE_HIST_LO = $DE00			; for every byte value, the low byte of how many times it appears
+PROFILE_HIST_HI = $DF00			; ... and the high byte
+
+.segment	"CODE"
 
+.proc	_Memory_ProfileBank: near
+
+.segment	"CODE"
+
+			SEI						; nothing else can run while the overlay and I/O are mapped out
+			
+			LDA $0001				; stash the I/O setting
+			PHA
+			
+.ifdef _SIMULATOR_
+			LDA #$80				; edit mode (bit 7) + edit lut #4 (bits 4-5 both on) + active lut stays as #4 (bits 0-1 on)
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			LDA $000D				; stash whatever is in slots 5 and 6 (overlay, kernel#2)
+			PHA
+			LDA $000E
+			PHA
+			
+			LDA _zp_search_loc_bank
+			STA $000D
+			LDA _zp_other_byte
+			STA $000E
+
+.ifdef _SIMULATOR_
+			LDA #$00				; Select LUT#0 as active, turn off editing
+.else
+			LDA #$33				; Select LUT#3 as active, turn off editing
+.endif
+			STA $0000
+			
+			LDA #$04				; turn off I/O so the RAM under it is visible
+			STA $0001
+			
+			LDX #$00				; start every count at 0
+clear:		STZ PROFILE_HIST_LO,x
+			STZ PROFILE_HIST_HI,x
+			INX
+			BNE clear
+			
+			; count every byte. ptr1 = start of the current page. Y = byte within the page.
+			STZ ptr1
+			LDA #>PROFILE_WINDOW
+			STA ptr1+1
+			LDY #$00
+
+count:		LDA (ptr1),y
+			TAX
+			INC PROFILE_HIST_LO,x
+			BNE counted
+			INC PROFILE_HIST_HI,x
+counted:	INY
+			BNE count
+			INC ptr1+1
+			LDA ptr1+1
+			CMP #>(PROFILE_WINDOW + $2000)
+			BNE count
+			
+			; the $00 and $FF counts are 0-8192. /64 brings them into a byte: ptr4 = $00s, ptr4+1 = $FFs
+			LDA PROFILE_HIST_LO
+			STA tmp1
+			LDA PROFILE_HIST_HI
+			ASL tmp1
+			ROL A
+			ASL tmp1
+			ROL A
+			STA ptr4
+			LDA PROFILE_HIST_LO+$FF
+			STA tmp1
+			LDA PROFILE_HIST_HI+$FF
+			ASL tmp1
+			ROL A
+			ASL tmp1
+			ROL A
+			STA ptr4+1
+			
+			; LOGIC:
+			;   entropy = log2(8192) - (sum of count * log2(count), over every byte value) / 8192
+			;   working in 16ths of a bit, that is 208 - (sum of count * L(count)) / 8192, where L(count) = 16 * log2(count) fits in a byte.
+			;   L(count) is found by shifting the count up until its top bit is in bit 15: 16 * that bit's number is the whole part,
+			;   and the 4 bits after it look up the fraction. the sum is at most 8192 * 208, so 3 bytes hold it: tmp2-tmp4.
+			STZ tmp2
+			STZ tmp3
+			STZ tmp4
+			LDX #$00
+
+next_value:	LDA PROFILE_HIST_LO,x
+			STA ptr2
+			STA ptr1
+			LDA PROFILE_HIST_HI,x
+			STA ptr2+1
+			STA ptr1+1
+			ORA ptr2
+			BEQ value_done			; byte values that never appear add nothing
+			
+			LDY #15					; Y = number of the count's top bit
+normalize:	LDA ptr1+1
+			BMI normalized
+			ASL ptr1
+			ROL ptr1+1
+			DEY
+			BRA normalize
+
+normalized:	LSR A					; the 4 bits after the top bit pick the fraction
+			LSR A
+			LSR A
+			AND #$0F
+			STA tmp1
+			TYA
+			ASL A
+			ASL A
+			ASL A
+			ASL A
+			LDY tmp1
+			CLC
+			ADC log2_fraction,y
+			STA tmp1				; tmp1 = L(count)
+			
+			STZ ptr1				; sum += count * L(count). ptr2 + ptr1 = the count, shifted up as L's bits are used up
+multiply:	LSR tmp1
+			BCC no_add
+			LDA tmp2
+			CLC
+			ADC ptr2
+			STA tmp2
+			LDA tmp3
+			ADC ptr2+1
+			STA tmp3
+			LDA tmp4
+			ADC ptr1
+			STA tmp4
+no_add:		ASL ptr2
+			ROL ptr2+1
+			ROL ptr1
+			LDA tmp1
+			BNE multiply
+
+value_done:	INX
+			BNE next_value
+			
+			LDA tmp3				; sum / 8192 = tmp4:tmp3 / 32
+			LDY #$05
+divide:		LSR tmp4
+			ROR A
+			DEY
+			BNE divide
+			STA tmp1
+			
+			LDA #208				; 16 * log2(8192)
+			SEC
+			SBC tmp1
+			BCS not_negative
+			LDA #$00				; the log table rounds, so the ends of the range can overshoot a little
+not_negative:
+			CMP #129
+			BCC put_back
+			LDA #128
+
+put_back:	STA tmp2				; keep the result while everything goes back the way it was
+
+.ifdef _SIMULATOR_
+			LDA #$80
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			PLA
+			STA $000E
+			PLA
+			STA $000D
+
+.ifdef _SIMULATOR_
+			LDA #$00
+.else
+			LDA #$33
+.endif
+			STA $0000
+			
+			PLA						; I/O setting
+			STA $0001
+			
+			CLI
+			
+			; do the return: cc65 wants a 32 bit value in sreg (high word), X and A (low word)
+			LDA ptr4+1
+			STA sreg
+			STZ sreg+1
+			LDX ptr4
+			LDA tmp2
+			
+			RTS
+.endproc
+
+
+.segment	"RODATA"
+
+; 16 * log2(1 + n/16), for n = 0-15: the fractional part of L(count), from the 4 bits after the count's top bit
+log2_fraction:	.byte 0, 1, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 15
+
+
+
+; ---------------------------------------------------------------
+; uint16_t __fastcall__ Memory_CompressBank(void)
+; ---------------------------------------------------------------
+;// call to a routine in memory.asm that packs one bank of memory, in place, with run-length encoding, into another bank
+;// the bank is mapped in at $A000, and the bank to pack it into at $C000 (I/O off). the packed data starts at the beginning of that bank.
+;// the packed data is a series of runs, each starting with a control byte:
+;//   $00-$7F: that many + 1 bytes follow, to be copied as they are
+;//   $80-$FF: the next byte is repeated (control byte - $80) + 3 times
+;// set before calling:
+;//   zp_search_loc_bank: the bank to pack (0-127)
+;//   zp_other_byte: the bank to pack it into. must not be the bank being packed
+;// returns the length of the packed data, or 0 if the bank doesn't pack into less than 7936 bytes (it is not worth packing)
+;// runs with interrupts off, and puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+
+PACK_WINDOW_IN = $A000			; bank goes in slot 5, packed data in slot 6
+PACK_WINDOW_OUT = $C000
+PACK_MAX_RUN = 130				; longest run a control byte can hold
+PACK_MIN_RUN = 3				; shorter runs than this are left in with the literal bytes
+
+.segment	"CODE"
+
+.proc	_Memory_CompressBank: near
+
+.segment	"CODE"
+
+			SEI						; nothing else can run while the overlay and I/O are mapped out
+			
+			LDA $0001				; stash the I/O setting
+			PHA
+			
+.ifdef _SIMULATOR_
+			LDA #$80				; edit mode (bit 7) + edit lut #4 (bits 4-5 both on) + active lut stays as #4 (bits 0-1 on)
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			LDA $000D				; stash whatever is in slots 5 and 6 (overlay, kernel#2)
+			PHA
+			LDA $000E
+			PHA
+			
+			LDA _zp_search_loc_bank
+			STA $000D
+			LDA _zp_other_byte
+			STA $000E
+
+.ifdef _SIMULATOR_
+			LDA #$00				; Select LUT#0 as active, turn off editing
+.else
+			LDA #$33				; Select LUT#3 as active, turn off editing
+.endif
+			STA $0000
+			
+			LDA #$04				; turn off I/O so the RAM under it is visible
+			STA $0001
+			
+			; ptr1 = next byte to pack. ptr2 = next byte of packed data. 
+			; ptr3 = control byte of the literal run being built, tmp1 = number of bytes in it so far (0: none being built)
+			STZ ptr1
+			LDA #>PACK_WINDOW_IN
+			STA ptr1+1
+			STZ ptr2
+			LDA #>PACK_WINDOW_OUT
+			STA ptr2+1
+			STZ tmp1
+
+next:		LDA ptr1+1
+			CMP #>(PACK_WINDOW_IN + $2000)
+			BEQ packed
+			
+			; LOGIC:
+			;   each pass through the loop adds at most 2 bytes of packed data, so checking once per pass is enough to stay inside the bank.
+			;   giving up 256 bytes short of a full bank means a bank that is stored as is instead costs at most 256 bytes more than packing it.
+			LDA ptr2+1
+			CMP #>(PACK_WINDOW_OUT + $1F00)
+			BEQ too_big
+			
+			; how long a run could start here? PACK_MAX_RUN, unless the end of the bank is nearer than that
+			LDA #PACK_MAX_RUN
+			LDX ptr1+1
+			CPX #>(PACK_WINDOW_IN + $1F00)
+			BNE have_max
+			LDX ptr1
+			CPX #(256 - PACK_MAX_RUN + 1)
+			BCC have_max
+			TXA						; 256 - offset in the last page
+			EOR #$FF
+			INC A
+have_max:	STA tmp3
+			
+			LDA (ptr1)				; Y = how many times this byte repeats, up to the max
+			STA tmp2
+			LDY #$00
+count_run:	INY
+			CPY tmp3
+			BEQ run_counted
+			CMP (ptr1),y
+			BEQ count_run
+run_counted:
+			CPY #PACK_MIN_RUN
+			BCC literal
+			
+			TYA						; a run: control byte, then the byte. any literal run being built is finished
+			CLC
+			ADC #($80 - PACK_MIN_RUN)
+			JSR put_byte
+			LDA tmp2
+			JSR put_byte
+			STZ tmp1
+			BRA advance
+
+literal:	LDA tmp1				; a literal byte: add it to the literal run being built, or start a new one if there isn't one, or it is full
+			BEQ new_literal
+			BPL add_literal			; tmp1 = 128 means full
+new_literal:
+			LDA ptr2
+			STA ptr3
+			LDA ptr2+1
+			STA ptr3+1
+			JSR put_byte			; placeholder: the control byte is filled in as bytes are added
+			STZ tmp1
+add_literal:
+			LDA tmp2
+			JSR put_byte
+			LDA tmp1
+			STA (ptr3)
+			INC tmp1
+			LDY #$01
+
+advance:	TYA						; move on past the byte(s) just packed
+			CLC
+			ADC ptr1
+			STA ptr1
+			BCC next
+			INC ptr1+1
+			BRA next
+
+too_big:	STZ ptr2				; report 0: the bank is not worth packing
+			LDA #>PACK_WINDOW_OUT
+			STA ptr2+1
+
+packed:		LDA ptr2+1				; packed length = ptr2 - start of the window
+			SEC
+			SBC #>PACK_WINDOW_OUT
+			STA tmp4
+			LDA ptr2
+			STA tmp3
+
+.ifdef _SIMULATOR_
+			LDA #$80
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			PLA
+			STA $000E
+			PLA
+			STA $000D
+
+.ifdef _SIMULATOR_
+			LDA #$00
+.else
+			LDA #$33
+.endif
+			STA $0000
+			
+			PLA						; I/O setting
+			STA $0001
+			
+			CLI
+			
+			; do the return. cc65 requires functions return a 16 bit value!
+			LDX tmp4
+			LDA tmp3
+			
+			RTS
+
+; add A to the packed data. trashes nothing but ptr2
+put_byte:	STA (ptr2)
+			INC ptr2
+			BNE put_done
+			INC ptr2+1
+put_done:	RTS
+.endproc
+
+
+
+; ---------------------------------------------------------------
+; uint8_t __fastcall__ Memory_DecompressBank(void)
+; ---------------------------------------------------------------
+;// call to a routine in memory.asm that unpacks data packed by Memory_CompressBank(), in place, into one bank of memory
+;// the bank to unpack into is mapped in at $A000, and the bank holding the packed data at $C000 (I/O off). the packed data starts at the beginning of that bank.
+;// set before calling:
+;//   zp_search_loc_bank: the bank to unpack into (0-127)
+;//   zp_other_byte: the bank holding the packed data. must not be the bank being unpacked into
+;//   zp_copy_len (2 bytes): the length of the packed data (1-8191)
+;// returns 1 if the packed data filled exactly one bank, or 0 if it is damaged (nothing is ever written past the end of the bank)
+;// runs with interrupts off, and puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+
+UNPACK_WINDOW_OUT = $A000		; bank goes in slot 5, packed data in slot 6
+UNPACK_WINDOW_IN = $C000
+
+.segment	"CODE"
+
+.proc	_Memory_DecompressBank: near
+
+.segment	"CODE"
+
+			SEI						; nothing else can run while the overlay and I/O are mapped out
+			
+			LDA $0001				; stash the I/O setting
+			PHA
+			
+.ifdef _SIMULATOR_
+			LDA #$80				; edit mode (bit 7) + edit lut #4 (bits 4-5 both on) + active lut stays as #4 (bits 0-1 on)
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			LDA $000D				; stash whatever is in slots 5 and 6 (overlay, kernel#2)
+			PHA
+			LDA $000E
+			PHA
+			
+			LDA _zp_search_loc_bank
+			STA $000D
+			LDA _zp_other_byte
+			STA $000E
+
+.ifdef _SIMULATOR_
+			LDA #$00				; Select LUT#0 as active, turn off editing
+.else
+			LDA #$33				; Select LUT#3 as active, turn off editing
+.endif
+			STA $0000
+			
+			LDA #$04				; turn off I/O so the RAM under it is visible
+			STA $0001
+			
+			; ptr1 = next byte of packed data. ptr4 = end of the packed data. ptr2 = next byte to unpack into.
+			; tmp3 is set if the packed data tries to run past the end of the bank.
+			STZ ptr1
+			LDA #>UNPACK_WINDOW_IN
+			STA ptr1+1
+			LDA _zp_copy_len
+			STA ptr4
+			LDA _zp_copy_len+1
+			CLC
+			ADC #>UNPACK_WINDOW_IN
+			STA ptr4+1
+			STZ ptr2
+			LDA #>UNPACK_WINDOW_OUT
+			STA ptr2+1
+			STZ tmp3
+
+next:		LDA tmp3				; stop at the end of the packed data, or as soon as it overflows the bank
+			BNE done
+			LDA ptr1+1
+			CMP ptr4+1
+			BCC more
+			BNE done
+			LDA ptr1
+			CMP ptr4
+			BCS done
+
+more:		JSR get_byte
+			CMP #$80
+			BCS run
+			
+			INC A					; literal bytes: control byte + 1 of them
+			STA tmp1
+copy_literal:
+			JSR get_byte
+			JSR put_byte
+			DEC tmp1
+			BNE copy_literal
+			BRA next
+
+run:		SEC						; a run: control byte - $80 + 3 copies of the next byte
+			SBC #($80 - PACK_MIN_RUN)
+			STA tmp1
+			JSR get_byte
+			STA tmp2
+fill_run:	LDA tmp2
+			JSR put_byte
+			DEC tmp1
+			BNE fill_run
+			BRA next
+
+done:		LDA #$00				; good only if it didn't overflow, and filled the bank exactly
+			LDX tmp3
+			BNE put_back
+			LDX ptr2
+			BNE put_back
+			LDX ptr2+1
+			CPX #>(UNPACK_WINDOW_OUT + $2000)
+			BNE put_back
+			LDA #$01
+
+put_back:	STA tmp2				; keep the result while everything goes back the way it was
+
+.ifdef _SIMULATOR_
+			LDA #$80
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			PLA
+			STA $000E
+			PLA
+			STA $000D
+
+.ifdef _SIMULATOR_
+			LDA #$00
+.else
+			LDA #$33
+.endif
+			STA $0000
+			
+			PLA						; I/O setting
+			STA $0001
+			
+			CLI
+			
+			; do the return. cc65 requires functions return a 16 bit value!
+			LDX #$00
+			LDA tmp2
+			
+			RTS
+
+; A = next byte of packed data. trashes nothing but ptr1
+get_byte:	LDA (ptr1)
+			INC ptr1
+			BNE got_byte
+			INC ptr1+1
+got_byte:	RTS
+
+; add A to the bank, unless it is already full. trashes X
+put_byte:	LDX ptr2+1
+			CPX #>(UNPACK_WINDOW_OUT + $2000)
+			BEQ overflow
+			STA (ptr2)
+			INC ptr2
+			BNE put_done
+			INC ptr2+1
+put_done:	RTS
+overflow:	LDX #$01				; the byte is dropped
+			STX tmp3
+			RTS
+.endproc
+
+
+
+; ---------------------------------------------------------------
+; uint8_t __fastcall__ Memory_DecompressStream(void)
+; ---------------------------------------------------------------
+;// call to a routine in memory.asm that unpacks a ZX0 stream, or the blocks of an LZ4 frame, straight into consecutive banks of memory
+;// the packed data is read into STORAGE_FILE_BUFFER_1: whenever that runs out, File_ReadStreamBuffer() is called to refill it
+;// the bank being unpacked into is mapped in at $A000. matches are copied from what has already been unpacked, through $C000 (I/O off)
+;// set before calling:
+;//   zp_search_loc_bank: the first bank to unpack into (0-127)
+;//   zp_other_byte: the last bank it may unpack into
+;//   zp_temp_1: PARAM_UNPACK_ZX0, PARAM_UNPACK_LZ4, or PARAM_UNPACK_LZ4_CHECKSUMS. for LZ4, the frame header must already have been read.
+;// returns MEMORY_UNPACK_OK, MEMORY_UNPACK_DAMAGED, or MEMORY_UNPACK_NO_ROOM, and sets zp_search_loc_bank to the last bank unpacked into
+;// the rest of the last page unpacked into is zeroed, as App_EMReadFromFile() does
+;// runs with interrupts off, except while File_ReadStreamBuffer() runs, and puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+
+UNPACK_STREAM_OUT = $A000		; bank being unpacked into goes in slot 5, bank a match is copied from in slot 6
+UNPACK_STREAM_MATCH = $C000
+UNPACK_STREAM_IN = $0500		; STORAGE_FILE_BUFFER_1
+
+UNPACK_ZX0 = 0					; PARAM_UNPACK_* in memory.h
+UNPACK_LZ4_CHECKSUMS = 2
+
+UNPACK_OK = 0					; MEMORY_UNPACK_* in memory.h
+UNPACK_DAMAGED = 1
+UNPACK_NO_ROOM = 2
+
+.segment	"BSS"
+
+unpack_stack:		.res 1		; stack pointer on entry, so a damaged stream can bail out from any depth
+unpack_io:			.res 1		; what was in $0001, $000D, and $000E on entry
+unpack_slot_5:		.res 1
+unpack_slot_6:		.res 1
+unpack_result:		.res 1
+unpack_first_bank:	.res 1
+unpack_last_bank:	.res 1
+unpack_out_bank:	.res 1		; bank mapped in at $A000. ptr2 is the next byte to unpack into
+unpack_match_bank:	.res 1		; bank mapped in at $C000. ptr3 is the next byte of a match
+unpack_in_pos:		.res 1		; next byte of STORAGE_FILE_BUFFER_1 to use
+unpack_in_len:		.res 1		; number of bytes in it
+unpack_block:		.res 3		; packed bytes left in the current LZ4 block (for ZX0, more than there can ever be)
+unpack_len:			.res 2		; length of the literal run or match being copied
+unpack_offset:		.res 2		; how far back the match is copied from
+unpack_pages:		.res 2		; work space: a position in memory, counted in pages
+unpack_format:		.res 1		; zp_temp_1 on entry
+unpack_token:		.res 1		; LZ4: the current sequence's token
+unpack_bits:		.res 1		; ZX0: bits not used yet from the last bit byte, followed by a 1
+unpack_saved_ptrs:	.res 4		; ptr2 and ptr3, while File_ReadStreamBuffer() runs
+
+.segment	"CODE"
+
+.proc	_Memory_DecompressStream: near
+
+.segment	"CODE"
+
+			SEI						; nothing else can run while the overlay and I/O are mapped out
+			
+			TSX
+			STX unpack_stack
+			
+			LDA $0001				; stash the I/O setting
+			STA unpack_io
+			
+.ifdef _SIMULATOR_
+			LDA #$80				; edit mode (bit 7) + edit lut #4 (bits 4-5 both on) + active lut stays as #4 (bits 0-1 on)
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			LDA $000D				; stash whatever is in slots 5 and 6 (overlay, kernel#2)
+			STA unpack_slot_5
+			LDA $000E
+			STA unpack_slot_6
+
+.ifdef _SIMULATOR_
+			LDA #$00				; Select LUT#0 as active, turn off editing
+.else
+			LDA #$33				; Select LUT#3 as active, turn off editing
+.endif
+			STA $0000
+			
+			LDA _zp_search_loc_bank
+			STA unpack_first_bank
+			STA unpack_out_bank
+			STA unpack_match_bank
+			LDA _zp_other_byte
+			STA unpack_last_bank
+			LDA _zp_temp_1
+			STA unpack_format
+			
+			STZ unpack_in_pos		; nothing read yet: the first byte asked for fills the buffer
+			STZ unpack_in_len
+			STZ ptr2
+			LDA #>UNPACK_STREAM_OUT
+			STA ptr2+1
+			
+			JSR map_in
+			
+			LDA unpack_format
+			CMP #UNPACK_ZX0
+			BEQ zx0
+			JMP lz4_block
+
+			; ---- ZX0 ----
+			; LOGIC:
+			;   literals, then either a match at the last offset used, or a match at a new offset, then literals again, and so on.
+			;   lengths are interlaced Elias gamma codes, read from bit bytes that are spread through the stream as they are needed.
+			;   a new offset is a gamma code (its bits inverted) for the high part, 256 to end the stream, then a byte with the low 7 bits.
+			;   the low bit of that byte is the first bit of the match length's gamma code.
+
+zx0:		LDA #$FF				; no blocks: never let the count run out
+			STA unpack_block
+			STA unpack_block+1
+			STA unpack_block+2
+			LDA #$80				; no bits left: the first bit asked for reads a bit byte
+			STA unpack_bits
+			LDA #$01				; the offset to use if the first match is at the last offset
+			STA unpack_offset
+			STZ unpack_offset+1
+
+zx0_literals:
+			JSR get_gamma
+			JSR copy_literals
+			JSR get_bit
+			BCS zx0_new_offset
+
+			JSR get_gamma			; match at the last offset
+			JSR copy_match
+			JSR get_bit
+			JCC zx0_literals
+
+zx0_new_offset:
+			JSR get_gamma_inverted
+			LDA unpack_len+1
+			BEQ zx0_offset_ok
+			CMP #$01				; 256 ends the stream. anything bigger is damage
+			JNE damaged
+			LDA unpack_len
+			JNE damaged
+			JMP done
+zx0_offset_ok:
+			LDA unpack_len			; offset = high part * 128 - the next byte / 2
+			LSR A
+			STA unpack_offset+1
+			LDA #$00
+			ROR A
+			STA unpack_offset
+			JSR get_byte
+			LSR A					; carry = first bit of the match length
+			STA unpack_pages
+			PHP
+			LDA unpack_offset
+			SEC
+			SBC unpack_pages
+			STA unpack_offset
+			BCS zx0_offset_done
+			DEC unpack_offset+1
+zx0_offset_done:
+			PLP
+			JSR get_gamma_from_carry
+			INC unpack_len			; new offset matches are always at least 2 long
+			BNE zx0_copy_new
+			INC unpack_len+1
+zx0_copy_new:
+			JSR copy_match
+			JSR get_bit
+			JCS zx0_new_offset
+			JMP zx0_literals
+
+			; ---- LZ4 ----
+			; LOGIC:
+			;   each block starts with its length (4 bytes). 0 ends the frame. if the top bit is set, the block is stored as is.
+			;   a packed block is a series of sequences: a token, literals, then a 2 byte offset and a match. the last sequence has no match.
+			;   the top 4 bits of the token are the number of literals, and the bottom 4 the match length - 4. 15 means more length bytes follow.
+			;   matches can reach back into earlier blocks: they are all still in memory, so linked blocks need no extra work.
+
+lz4_block:	JSR get_byte			; the block length isn't part of the block, so isn't counted
+			STA unpack_pages
+			JSR get_byte
+			STA unpack_pages+1
+			JSR get_byte
+			PHA
+			JSR get_byte
+			TAX
+			PLA
+			STA unpack_block+2
+			LDA unpack_pages
+			STA unpack_block
+			LDA unpack_pages+1
+			STA unpack_block+1
+			TXA
+			JNE lz4_stored			; no block bigger than 4MB can be stored by LZ4, so only the top bit can be set in the last byte
+			LDA unpack_block
+			ORA unpack_block+1
+			ORA unpack_block+2
+			JEQ done				; end of the frame. any checksum of the whole content after it is ignored
+			
+lz4_sequence:
+			JSR get_block_byte
+			STA unpack_token
+			LSR A
+			LSR A
+			LSR A
+			LSR A
+			JSR get_lz4_length
+			JSR copy_literals
+			LDA unpack_block		; the block ends after the literals of its last sequence
+			ORA unpack_block+1
+			ORA unpack_block+2
+			JEQ lz4_block_done
+			JSR get_block_byte
+			STA unpack_offset
+			JSR get_block_byte
+			STA unpack_offset+1
+			ORA unpack_offset
+			JEQ damaged
+			LDA unpack_token
+			AND #$0F
+			JSR get_lz4_length
+			LDA unpack_len			; matches are always at least 4 long
+			CLC
+			ADC #$04
+			STA unpack_len
+			BCC lz4_copy
+			INC unpack_len+1
+			JEQ damaged
+lz4_copy:	JSR copy_match
+			JMP lz4_sequence
+
+lz4_stored:	CPX #$80
+			JNE damaged
+lz4_stored_byte:
+			LDA unpack_block
+			ORA unpack_block+1
+			ORA unpack_block+2
+			BEQ lz4_block_done
+			JSR get_block_byte
+			JSR put_byte
+			JMP lz4_stored_byte
+
+lz4_block_done:
+			LDA unpack_format		; skip the block's checksum, if the frame has them
+			CMP #UNPACK_LZ4_CHECKSUMS
+			BNE lz4_next_block
+			JSR get_byte
+			JSR get_byte
+			JSR get_byte
+			JSR get_byte
+lz4_next_block:
+			JMP lz4_block
+
+			; ---- the end ----
+
+done:		LDA ptr2				; zero the rest of the last page, if it wasn't filled
+			BEQ zeroed
+			LDA #$00
+zero_rest:	STA (ptr2)
+			INC ptr2
+			BNE zero_rest
+zeroed:		LDA #UNPACK_OK
+			BRA finish
+
+damaged:	LDA #UNPACK_DAMAGED
+			BRA bail_out
+
+no_room:	LDA #UNPACK_NO_ROOM
+
+bail_out:	LDX unpack_stack		; drop whatever subroutines were in progress
+			TXS
+
+finish:		STA unpack_result
+			LDA unpack_out_bank
+			STA _zp_search_loc_bank
+			
+			JSR map_out
+			
+			CLI
+			
+			; do the return. cc65 requires functions return a 16 bit value!
+			LDX #$00
+			LDA unpack_result
+			
+			RTS
+
+			; ---- helpers ----
+
+; A = the next packed byte. trashes X
+get_byte:	LDX unpack_in_pos
+			CPX unpack_in_len
+			BEQ refill
+got_byte:	LDA UNPACK_STREAM_IN,x
+			INX
+			STX unpack_in_pos
+			RTS
+
+refill:		JSR map_out				; put everything back the way C expects it, and fetch some more
+			CLI
+			LDA ptr2
+			STA unpack_saved_ptrs
+			LDA ptr2+1
+			STA unpack_saved_ptrs+1
+			LDA ptr3
+			STA unpack_saved_ptrs+2
+			LDA ptr3+1
+			STA unpack_saved_ptrs+3
+			
+			JSR _File_ReadStreamBuffer
+			
+			SEI
+			STA unpack_in_len
+			LDA unpack_saved_ptrs
+			STA ptr2
+			LDA unpack_saved_ptrs+1
+			STA ptr2+1
+			LDA unpack_saved_ptrs+2
+			STA ptr3
+			LDA unpack_saved_ptrs+3
+			STA ptr3+1
+			JSR map_in
+			
+			LDX #$00
+			STX unpack_in_pos
+			CPX unpack_in_len		; the file ran out before the end of the stream
+			BNE got_byte
+			JMP damaged
+
+; A = the next packed byte of the current block. trashes X
+get_block_byte:
+			LDA unpack_block
+			BNE count_lo
+			LDA unpack_block+1
+			BNE count_mid
+			LDA unpack_block+2
+			JEQ damaged				; the block ran out part way through a sequence
+			DEC unpack_block+2
+count_mid:	DEC unpack_block+1
+count_lo:	DEC unpack_block
+			JMP get_byte
+
+; carry = the next bit. trashes A and X
+get_bit:	ASL unpack_bits
+			BNE got_bit
+			JSR get_block_byte		; out of bits: read the next bit byte, and mark the end of it with a 1
+			SEC
+			ROL A
+			STA unpack_bits
+got_bit:	RTS
+
+; unpack_len = the next interlaced Elias gamma code: a 0 before each bit after the leading 1, and a 1 after the last. trashes A and X
+get_gamma:	JSR get_bit
+get_gamma_from_carry:		; the first bit is already in the carry
+			LDA #$01
+			STA unpack_len
+			STZ unpack_len+1
+gamma_next:	BCS gamma_done
+			JSR get_bit
+			ROL unpack_len
+			ROL unpack_len+1
+			JCS damaged
+			JSR get_bit
+			BRA gamma_next
+gamma_done:	RTS
+
+; unpack_len = the next interlaced Elias gamma code, with every bit after the leading 1 inverted. trashes A and X
+get_gamma_inverted:
+			LDA #$01
+			STA unpack_len
+			STZ unpack_len+1
+inverted_next:
+			JSR get_bit
+			BCS gamma_done
+			JSR get_bit
+			ROL unpack_len
+			ROL unpack_len+1
+			JCS damaged
+			LDA unpack_len
+			EOR #$01
+			STA unpack_len
+			BRA inverted_next
+
+; unpack_len = A, plus any extra LZ4 length bytes if A is 15. trashes A and X
+get_lz4_length:
+			STA unpack_len
+			STZ unpack_len+1
+			CMP #$0F
+			BNE lz4_length_done
+lz4_length_next:
+			JSR get_block_byte
+			PHA
+			CLC
+			ADC unpack_len
+			STA unpack_len
+			BCC lz4_length_added
+			INC unpack_len+1
+			JEQ damaged
+lz4_length_added:
+			PLA
+			CMP #$FF
+			BEQ lz4_length_next
+lz4_length_done:
+			RTS
+
+; copy unpack_len packed bytes, as they are. trashes A and X
+copy_literals:
+			LDA unpack_len
+			ORA unpack_len+1
+			BEQ literals_done
+literal_next:
+			JSR get_block_byte
+			JSR put_byte
+			LDA unpack_len
+			BNE literal_count
+			DEC unpack_len+1
+literal_count:
+			DEC unpack_len
+			LDA unpack_len
+			ORA unpack_len+1
+			BNE literal_next
+literals_done:
+			RTS
+
+; copy unpack_len bytes from unpack_offset bytes back in what has been unpacked so far. trashes A and X
+copy_match:
+			; LOGIC:
+			;   count the position being unpacked into in pages from the start of memory: out bank * 32 + the page in the bank.
+			;   take the offset off that (its high byte is in pages), then split it back into a bank, and a page and byte in the $C000 window.
+			;   a match can't start before the first bank unpacked into. it may be in the same bank as the one being unpacked into: that's fine.
+			LDA unpack_out_bank
+			STZ unpack_pages+1
+			ASL A
+			ROL unpack_pages+1
+			ASL A
+			ROL unpack_pages+1
+			ASL A
+			ROL unpack_pages+1
+			ASL A
+			ROL unpack_pages+1
+			ASL A
+			ROL unpack_pages+1
+			STA unpack_pages
+			LDA ptr2+1
+			SEC
+			SBC #>UNPACK_STREAM_OUT
+			CLC
+			ADC unpack_pages
+			STA unpack_pages
+			BCC counted_pages
+			INC unpack_pages+1
+counted_pages:
+			LDA ptr2
+			SEC
+			SBC unpack_offset
+			STA ptr3
+			LDA unpack_pages
+			SBC unpack_offset+1
+			STA unpack_pages
+			LDA unpack_pages+1
+			SBC #$00
+			JCC damaged
+			STA unpack_pages+1
+			
+			LDA unpack_pages
+			AND #$1F
+			ORA #>UNPACK_STREAM_MATCH
+			STA ptr3+1
+			LDA unpack_pages		; bank = pages / 32
+			LSR unpack_pages+1
+			ROR A
+			LSR unpack_pages+1
+			ROR A
+			LSR unpack_pages+1
+			ROR A
+			LSR unpack_pages+1
+			ROR A
+			LSR unpack_pages+1
+			ROR A
+			CMP unpack_first_bank
+			JCC damaged
+			STA unpack_match_bank
+			JSR map_match_bank
+
+match_next:	LDA (ptr3)
+			JSR put_byte
+			INC ptr3
+			BNE match_count
+			INC ptr3+1
+			LDA ptr3+1
+			CMP #>(UNPACK_STREAM_MATCH + $2000)
+			BNE match_count
+			LDA #>UNPACK_STREAM_MATCH	; on into the next bank
+			STA ptr3+1
+			INC unpack_match_bank
+			JSR map_match_bank
+match_count:
+			LDA unpack_len
+			BNE match_count_lo
+			DEC unpack_len+1
+match_count_lo:
+			DEC unpack_len
+			LDA unpack_len
+			ORA unpack_len+1
+			BNE match_next
+			RTS
+
+; add A to what has been unpacked, moving on to the next bank when one is full. trashes X
+put_byte:	LDX ptr2+1
+			CPX #>(UNPACK_STREAM_OUT + $2000)
+			BEQ next_out_bank
+put_now:	STA (ptr2)
+			INC ptr2
+			BNE put_done
+			INC ptr2+1
+put_done:	RTS
+
+next_out_bank:
+			LDX unpack_out_bank
+			CPX unpack_last_bank
+			JEQ no_room
+			INX
+			STX unpack_out_bank
+			PHA
+.ifdef _SIMULATOR_
+			LDA #$80
+.else
+			LDA #$B3
+.endif
+			STA $0000
+			STX $000D
+.ifdef _SIMULATOR_
+			LDA #$00
+.else
+			LDA #$33
+.endif
+			STA $0000
+			PLA
+			LDX #>UNPACK_STREAM_OUT
+			STX ptr2+1
+			BRA put_now
+
+; map unpack_match_bank in at $C000. trashes A
+map_match_bank:
+.ifdef _SIMULATOR_
+			LDA #$80
+.else
+			LDA #$B3
+.endif
+			STA $0000
+			LDA unpack_match_bank
+			STA $000E
+.ifdef _SIMULATOR_
+			LDA #$00
+.else
+			LDA #$33
+.endif
+			STA $0000
+			RTS
+
+; map the bank being unpacked into, and the match bank, in at $A000 and $C000, and turn off I/O. trashes A
+map_in:		JSR map_match_bank
+.ifdef _SIMULATOR_
+			LDA #$80
+.else
+			LDA #$B3
+.endif
+			STA $0000
+			LDA unpack_out_bank
+			STA $000D
+.ifdef _SIMULATOR_
+			LDA #$00
+.else
+			LDA #$33
+.endif
+			STA $0000
+			LDA #$04				; turn off I/O so the RAM under it is visible
+			STA $0001
+			RTS
+
+; put back what was mapped in at $A000 and $C000, and the I/O setting, on entry. trashes A
+map_out:
+.ifdef _SIMULATOR_
+			LDA #$80
+.else
+			LDA #$B3
+.endif
+			STA $0000
+			LDA unpack_slot_5
+			STA $000D
+			LDA unpack_slot_6
+			STA $000E
+.ifdef _SIMULATOR_
+			LDA #$00
+.else
+			LDA #$33
+.endif
+			STA $0000
+			LDA unpack_io
+			STA $0001
+			RTS
+.endproc
+
+
+
+; ---------------------------------------------------------------
+; void __fastcall__ Memory_MakeCrc32Table(void)
+; ---------------------------------------------------------------
+;// call to a routine in memory.asm that builds the table Memory_Crc32() looks up, in the bank it will find it in
+;// the table bank is mapped in at $C000 (I/O off). see CRC32_TABLE_* in memory.h for where the table goes.
+;// set zp_other_byte to the table bank before calling.
+;// runs with interrupts off, and puts back whatever was mapped at $C000, and the I/O setting, before returning
+
+CRC32_TABLE_0 = $C800			; for every byte value, byte 0 (low) of its table entry
+CRC32_TABLE_1 = $C900			; ... byte 1
+CRC32_TABLE_2 = $CA00			; ... byte 2
+CRC32_TABLE_3 = $CB00			; ... byte 3 (high)
+CRC32_POLYNOMIAL = $EDB88320	; the usual (zip, png, BPS) polynomial, bit-reversed
+
+.segment	"CODE"
+
+.proc	_Memory_MakeCrc32Table: near
+
+.segment	"CODE"
+
+			SEI						; nothing else can run while I/O is mapped out
+			
+			LDA $0001				; stash the I/O setting
+			PHA
+			
+.ifdef _SIMULATOR_
+			LDA #$80				; edit mode (bit 7) + edit lut #4 (bits 4-5 both on) + active lut stays as #4 (bits 0-1 on)
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			LDA $000E				; stash whatever is in slot 6 (kernel#2)
+			PHA
+			
+			LDA _zp_other_byte
+			STA $000E
+
+.ifdef _SIMULATOR_
+			LDA #$00				; Select LUT#0 as active, turn off editing
+.else
+			LDA #$33				; Select LUT#3 as active, turn off editing
+.endif
+			STA $0000
+			
+			LDA #$04				; turn off I/O so the RAM under it is visible
+			STA $0001
+			
+			; for every byte value: tmp1-tmp4 = the value, then 8 times: shift right 1 bit, and if a 1 came out, xor in the polynomial
+			LDX #$00
+
+next_entry:	STX tmp1
+			STZ tmp2
+			STZ tmp3
+			STZ tmp4
+			LDY #$08
+
+next_bit:	LSR tmp4
+			ROR tmp3
+			ROR tmp2
+			ROR tmp1
+			BCC bit_done
+			LDA tmp4
+			EOR #<(CRC32_POLYNOMIAL >> 24)
+			STA tmp4
+			LDA tmp3
+			EOR #<(CRC32_POLYNOMIAL >> 16)
+			STA tmp3
+			LDA tmp2
+			EOR #<(CRC32_POLYNOMIAL >> 8)
+			STA tmp2
+			LDA tmp1
+			EOR #<CRC32_POLYNOMIAL
+			STA tmp1
+bit_done:	DEY
+			BNE next_bit
+			
+			LDA tmp1
+			STA CRC32_TABLE_0,x
+			LDA tmp2
+			STA CRC32_TABLE_1,x
+			LDA tmp3
+			STA CRC32_TABLE_2,x
+			LDA tmp4
+			STA CRC32_TABLE_3,x
+			INX
+			BNE next_entry
+
+.ifdef _SIMULATOR_
+			LDA #$80
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			PLA
+			STA $000E
+
+.ifdef _SIMULATOR_
+			LDA #$00
+.else
+			LDA #$33
+.endif
+			STA $0000
+			
+			PLA						; I/O setting
+			STA $0001
+			
+			CLI
+			
+			RTS
+.endproc
+
+
+
+; ---------------------------------------------------------------
+; uint32_t __fastcall__ Memory_Crc32(uint32_t the_crc)
+; ---------------------------------------------------------------
+;// call to a routine in memory.asm that runs part of one bank of memory, in place, through a CRC-32, one table lookup per byte
+;// the bank is mapped in at $A000, and the table bank at $C000 (I/O off). the table must already have been built by Memory_MakeCrc32Table()
+;// the_crc is the CRC so far: start with $FFFFFFFF, and flip all the bits of the last one returned to get the finished CRC-32
+;// set before calling:
+;//   zp_search_loc_bank: the bank the data is in (0-127)
+;//   zp_from_addr (2 bytes): offset of the data in the bank (0-8191)
+;//   zp_copy_len (2 bytes): length of the data (1-8192). must not run past the end of the bank
+;//   zp_other_byte: the table bank
+;// returns the CRC so far, including the data
+;// runs with interrupts off, and puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+
+CRC32_WINDOW = $A000			; bank goes in slot 5, table bank in slot 6
+
+.segment	"CODE"
+
+.proc	_Memory_Crc32: near
+
+.segment	"CODE"
+
+			STA tmp1				; the CRC so far: tmp1 is the low byte, tmp4 the high
+			STX tmp2
+			LDA sreg
+			STA tmp3
+			LDA sreg+1
+			STA tmp4
+			
+			SEI						; nothing else can run while the overlay and I/O are mapped out
+			
+			LDA $0001				; stash the I/O setting
+			PHA
+			
+.ifdef _SIMULATOR_
+			LDA #$80				; edit mode (bit 7) + edit lut #4 (bits 4-5 both on) + active lut stays as #4 (bits 0-1 on)
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			LDA $000D				; stash whatever is in slots 5 and 6 (overlay, kernel#2)
+			PHA
+			LDA $000E
+			PHA
+			
+			LDA _zp_search_loc_bank
+			STA $000D
+			LDA _zp_other_byte
+			STA $000E
+
+.ifdef _SIMULATOR_
+			LDA #$00				; Select LUT#0 as active, turn off editing
+.else
+			LDA #$33				; Select LUT#3 as active, turn off editing
+.endif
+			STA $0000
+			
+			LDA #$04				; turn off I/O so the RAM under it is visible
+			STA $0001
+			
+			; ptr1 = next byte of data. ptr2 = bytes left.
+			; each byte: crc = (crc >> 8) xor table[(crc xor byte) & $FF]. the shift is free: it is just which byte goes where.
+			LDA _zp_from_addr
+			STA ptr1
+			LDA _zp_from_addr+1
+			CLC
+			ADC #>CRC32_WINDOW
+			STA ptr1+1
+			LDA _zp_copy_len
+			STA ptr2
+			LDA _zp_copy_len+1
+			STA ptr2+1
+
+next_byte:	LDA (ptr1)
+			EOR tmp1
+			TAX
+			LDA tmp2
+			EOR CRC32_TABLE_0,x
+			STA tmp1
+			LDA tmp3
+			EOR CRC32_TABLE_1,x
+			STA tmp2
+			LDA tmp4
+			EOR CRC32_TABLE_2,x
+			STA tmp3
+			LDA CRC32_TABLE_3,x
+			STA tmp4
+			
+			INC ptr1
+			BNE count
+			INC ptr1+1
+count:		LDA ptr2
+			BNE count_lo
+			DEC ptr2+1
+count_lo:	DEC ptr2
+			LDA ptr2
+			ORA ptr2+1
+			BNE next_byte
+
+.ifdef _SIMULATOR_
+			LDA #$80
+.else
+			LDA #$B3
+.endif
+			STA $0000
+
+			PLA
+			STA $000E
+			PLA
+			STA $000D
+
+.ifdef _SIMULATOR_
+			LDA #$00
+.else
+			LDA #$33
+.endif
+			STA $0000
+			
+			PLA						; I/O setting
+			STA $0001
+			
+			CLI
+			
+			; do the return: cc65 wants a 32 bit value in sreg (high word), X and A (low word)
+			LDA tmp3
+			STA sreg
+			LDA tmp4
+			STA sreg+1
+			LDX tmp2
+			LDA tmp1
+			
+			RTS
+.endproc
+
+
+
+; ---------------------------------------------------------------
+; private helpers for the DMA routines above. not callable from C.
+; ---------------------------------------------------------------
+
+.segment	"CODE"
+
+; wait until the beam is in the vertical blank, so the DMA engine doesn't have to share the bus with VICKY's display fetch
+; trashes A and X
+.proc	dma_wait_for_vblank: near
+
+LINE_NO = 261*2  ; 240+21
+			LDA #<LINE_NO
+			LDX #>LINE_NO
+wait1:
+			CPX $D01B
+			BEQ wait1
+wait2:
+			CMP $D01A
+			BEQ wait2
+
+wait3:
+			CPX $D01B
+			BNE wait3
+wait4:
+			CMP $D01A
+			BNE wait4
+
+			RTS
+.endproc
+
+
+; set START on the already configured DMA engine, wait for it to finish, then turn it off again
+; expects interrupts to be disabled by the caller, and re-enables them when done. RTS returns to the caller's caller.
+.proc	dma_start_and_wait: near
+
+wait_idle:	LDA DMA_STATUS
+			BMI wait_idle			; never start while a previous operation is still running
+			
+			; flip the START flag to trigger the DMA operation
+			LDA DMA_CTRL
+			ORA #DMA_CTRL_START
+			STA DMA_CTRL
+			
+			NOP						; give the engine a moment to raise its busy flag before we look at it
+			NOP
+
+wait_dma:	LDA DMA_STATUS
+			BMI wait_dma            ; Wait until DMA is not busy 
+			
+			STZ DMA_CTRL			; Turn off the DMA engine
+			
+			CLI						; re-enable interrupts
+			
+			RTS
+.endproc
@@ -34,6 +34,16 @@
 #define PARAM_FOR_ATTR_MEM	true	// param for functions updating VICKY screen memory: make it affect color/attribute memory
 #define PARAM_FOR_CHAR_MEM	false	// param for functions updating VICKY screen memory: make it affect character memory
 
+#define PARAM_COMPARE_FIND_DIFFERENT	0	// param for Memory_CompareBanks: find the next byte that differs
+#define PARAM_COMPARE_FIND_SAME			1	// param for Memory_CompareBanks: find the next byte that doesn't
+#define PARAM_UNPACK_ZX0				0	// param for Memory_DecompressStream: the stream is ZX0 packed
+#define PARAM_UNPACK_LZ4				1	// param for Memory_DecompressStream: the stream is the blocks of an LZ4 frame
+#define PARAM_UNPACK_LZ4_CHECKSUMS		2	// param for Memory_DecompressStream: the stream is the blocks of an LZ4 frame, each followed by a checksum
+
+#define MEMORY_UNPACK_OK				0	// Memory_DecompressStream result: the whole stream was unpacked
+#define MEMORY_UNPACK_DAMAGED			1	// Memory_DecompressStream result: the stream is damaged, or ran out early
+#define MEMORY_UNPACK_NO_ROOM			2	// Memory_DecompressStream result: the stream unpacks into more banks than it was given
+
 #define ZP_BANK_SLOT		0x10	// zero-page address holding the LUT slot to be modified (0-7) (eg, if 0, will be $08,if 1, $09, etc.)
 #define ZP_BANK_NUM			0x11	// zero-page address holding the new LUT bank# to be set in the ZP_BANK_SLOT
 #define ZP_OLD_BANK_NUM		0x12	// zero-page address holding the original LUT bank # before being changed
@@ -63,6 +73,35 @@
 #define EM_STORAGE_START_SLOT				0x05		// the 0-7 local CPU slot to map it into - overlay slot
 #define EM_STORAGE_START_PHYS_BANK_NUM		0x14		// the system physical bank number/slot where EM storage starts for us.
 
+// window for bulk transfers to/from any bank of physical memory. uses the i/o + kernel#2 slot, so overlay code stays mapped while it works
+#define EM_BULK_WINDOW_SLOT					0x06		// the 0-7 local CPU slot to map it into - only reachable with I/O disabled and interrupts off
+#define EM_BULK_WINDOW_CPU_ADDR				0xC000		// the starting CPU address of the bulk window (16 bit)
+#define EM_BULK_WINDOW_LEN					0x2000		// one 8K bank is visible through the window at any one time
+
+// layout of the multi-phrase search automaton bank (SEARCH_AUTOMATON_EM_SLOT), as Memory_SearchBankForPhrases() expects it
+// it sees the bank through the bulk window, so the class tables hold CPU addresses in the window, not offsets
+#define SEARCH_AUTOMATON_CLASS_LO			0x0000		// 256b: for every byte value, low byte of the CPU address of its transition column
+#define SEARCH_AUTOMATON_CLASS_HI			0x0100		// 256b: ... and the high byte
+#define SEARCH_AUTOMATON_MATCHES			0x0200		// for every state, a bit for each phrase that ends there
+#define SEARCH_AUTOMATON_TRANSITIONS		0x0300		// one column per byte class, each holding the next state for every state
+#define SEARCH_AUTOMATON_MAX_STATES			64			// also the length of each transition column, and the max number of byte classes
+
+// where Memory_ProfileBank() builds its histogram of byte values, in the scratch bank it is given
+#define BANK_PROFILE_HISTOGRAM_LO			0x1E00		// 256b: for every byte value, the low byte of how many times it appears
+#define BANK_PROFILE_HISTOGRAM_HI			0x1F00		// 256b: ... and the high byte
+
+// what Memory_ProfileBank() returns, byte by byte from the low end
+#define BANK_PROFILE_ENTROPY				0			// entropy estimate, in 16ths of a bit per byte (0-128)
+#define BANK_PROFILE_ZEROS					1			// number of $00 bytes / 64 (0-128: 128 is every byte)
+#define BANK_PROFILE_FFS					2			// number of $FF bytes / 64 (0-128)
+#define BANK_PROFILE_LEN					4
+
+// where Memory_MakeCrc32Table() builds the table Memory_Crc32() looks up, in the bank it is given
+#define CRC32_TABLE_0						0x0800		// 256b: for every byte value, byte 0 (low) of its table entry
+#define CRC32_TABLE_1						0x0900		// 256b: ... byte 1
+#define CRC32_TABLE_2						0x0A00		// 256b: ... byte 2
+#define CRC32_TABLE_3						0x0B00		// 256b: ... byte 3 (high)
+
 
 /*****************************************************************************/
 /*                               Enumerations                                */
@@ -111,13 +150,130 @@ uint8_t __fastcall__ Memory_GetMappedBankNum(void);
 // set zp_to_addr, zp_from_addr, zp_copy_len before calling.
 // this version uses the F256's DMA capabilities to copy, so addresses can be 24 bit (system memory, not CPU memory)
 // in other words, no need to page either dst or src into CPU space
-//void __fastcall__ Memory_CopyWithDMA(void);
+// DMA always copies upwards: overlapping ranges with dst above src need App_MoveMemoryWithDMA(), which splits the job up safely
+// the DMA registers are in IO page 0: swap that in before calling (App_MoveMemoryWithDMA() takes care of all of this)
+// pass wait_for_vblank=false only for an operation that follows another one straight away, as part of the same job
+void __fastcall__ Memory_CopyWithDMA(bool wait_for_vblank);
 
 // call to a routine in memory.asm that fills the specified number of bytes to the dst
 // set zp_to_addr, zp_copy_len to num bytes to fill, and zp_other_byte to the fill value before calling.
 // this version uses the F256's DMA capabilities to fill, so addresses can be 24 bit (system memory, not CPU memory)
 // in other words, no need to page either dst into CPU space
-//void __fastcall__ Memory_FillWithDMA(void);
+// the DMA registers are in IO page 0: swap that in before calling (App_FillMemoryWithDMA() takes care of all of this)
+void __fastcall__ Memory_FillWithDMA(void);
+
+// call to a routine in memory.asm that fills a rectangle of bytes at the dst: height rows of width bytes, each row starting stride bytes after the previous
+// set zp_to_addr to the top left corner, zp_copy_len (2 bytes) to the width, zp_copy_len+2 to the height (1-255 rows), 
+//   zp_from_addr (2 bytes) to the destination stride, and zp_other_byte to the fill value before calling.
+// the DMA registers are in IO page 0: swap that in before calling (App_FillMemoryRectWithDMA() takes care of all of this)
+void __fastcall__ Memory_FillWithDMA2D(void);
+
+
+// call to a routine in memory.asm that searches one bank of memory, in place, for a phrase, using Boyer-Moore-Horspool
+// the bank is mapped in at $A000, and the bank after it at $C000 (I/O off), so a match can run over the end of the bank without any copying
+// set before calling:
+//   zp_search_loc_bank: the bank to search. zp_search_loc_page and zp_search_loc_byte: the first position in it to try
+//   zp_from_addr (2 bytes): CPU address of the phrase. must not be in $A000-$DFFF. each byte must already be ANDed with its mask
+//   zp_to_addr (2 bytes): CPU address of the phrase's masks, one per byte: FF=must match exactly, 00=anything matches. same rules as phrase
+//   zp_other_byte: length of the phrase (1-128)
+//   zp_temp_1: offset in the phrase of the anchor byte the skip table is built around (normally the last byte with mask FF)
+//   zp_copy_len (2 bytes): the last position in the bank to try (0-8191). don't let phrase run past the end of memory.
+//   the skip table at STORAGE_FILE_BUFFER_1: for every byte value, how far to slide the phrase when that byte is under the anchor
+// returns 1 and sets zp_search_loc_page/byte to the start of the match, or returns 0 if there is no match in this bank
+// runs with interrupts off, except for a moment between pages, when everything is put back so pending interrupts can be serviced
+// puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+uint8_t __fastcall__ Memory_SearchBank(void);
+
+// call to a routine in memory.asm that runs one bank of memory, in place, through a multi-phrase (Aho-Corasick) search automaton
+// the bank is mapped in at $A000, and the automaton bank at $C000 (I/O off). see SEARCH_AUTOMATON_* above for its layout.
+// the automaton's state carries over from one call to the next, so matches that run over the end of a bank are found without any copying
+// set before calling:
+//   zp_search_loc_bank: the bank to search. zp_search_loc_page and zp_search_loc_byte: the first position in it to feed to the automaton
+//   zp_other_byte: the bank number the automaton is stored in
+//   zp_temp_1: the automaton state to start in (0 at the start of a search, otherwise whatever the previous call left there)
+// returns the match flags (one bit per phrase) and sets zp_search_loc_page/byte to the last byte of the match(es), 
+//   or returns 0 once the end of the bank is reached without a match. either way, zp_temp_1 holds the state to carry on from.
+// runs with interrupts off, and puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+uint8_t __fastcall__ Memory_SearchBankForPhrases(void);
+
+// call to a routine in memory.asm that compares 2 banks of memory, in place, byte for byte
+// the first bank is mapped in at $A000, and the second at $C000 (I/O off), so nothing needs to be copied
+// set before calling:
+//   zp_search_loc_bank: the first bank. zp_search_loc_page and zp_search_loc_byte: the first position in it to look at
+//   zp_other_byte: the second bank
+//   zp_temp_1: PARAM_COMPARE_FIND_DIFFERENT to look for the next byte that differs between the banks, or PARAM_COMPARE_FIND_SAME for the next byte that is the same in both
+// returns 1 and sets zp_search_loc_page/byte to the position found, or returns 0 if the end of the bank is reached first
+// runs with interrupts off, and puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+uint8_t __fastcall__ Memory_CompareBanks(void);
+
+// call to a routine in memory.asm that calculates the Fletcher-32 checksum of one bank of memory, in place
+// the bank is mapped in at $A000, and read as 4096 16-bit little-endian words
+// set zp_search_loc_bank to the bank (0-127) before calling.
+// returns the checksum: sum of sums in the high word, sum of the words in the low word, each mod 65535
+// runs with interrupts off, and puts back whatever was mapped at $A000 before returning
+uint32_t __fastcall__ Memory_ChecksumBank(void);
+
+// call to a routine in memory.asm that works out how one bank of memory is being used, in place, in one pass over it
+// a histogram of the bank's byte values is built in a scratch bank, then the $00 and $FF counts and an entropy estimate are taken from that
+// the bank is mapped in at $A000, and the scratch bank at $C000 (I/O off). see BANK_PROFILE_HISTOGRAM_* above for where the histogram goes.
+// set before calling:
+//   zp_search_loc_bank: the bank to profile (0-127)
+//   zp_other_byte: the scratch bank. must not be the bank being profiled
+// returns, from the low byte up: the entropy estimate in 16ths of a bit per byte (0-128), the number of $00 bytes / 64 (0-128), 
+//   the number of $FF bytes / 64 (0-128), and 0. see BANK_PROFILE_* above
+// runs with interrupts off, and puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+uint32_t __fastcall__ Memory_ProfileBank(void);
+
+// call to a routine in memory.asm that packs one bank of memory, in place, with run-length encoding, into another bank
+// the bank is mapped in at $A000, and the bank to pack it into at $C000 (I/O off). the packed data starts at the beginning of that bank.
+// the packed data is a series of runs, each starting with a control byte:
+//   $00-$7F: that many + 1 bytes follow, to be copied as they are
+//   $80-$FF: the next byte is repeated (control byte - $80) + 3 times
+// set before calling:
+//   zp_search_loc_bank: the bank to pack (0-127)
+//   zp_other_byte: the bank to pack it into. must not be the bank being packed
+// returns the length of the packed data, or 0 if the bank doesn't pack into less than 7936 bytes (it is not worth packing)
+// runs with interrupts off, and puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+uint16_t __fastcall__ Memory_CompressBank(void);
+
+// call to a routine in memory.asm that unpacks data packed by Memory_CompressBank(), in place, into one bank of memory
+// the bank to unpack into is mapped in at $A000, and the bank holding the packed data at $C000 (I/O off). the packed data starts at the beginning of that bank.
+// set before calling:
+//   zp_search_loc_bank: the bank to unpack into (0-127)
+//   zp_other_byte: the bank holding the packed data. must not be the bank being unpacked into
+//   zp_copy_len (2 bytes): the length of the packed data (1-8191)
+// returns 1 if the packed data filled exactly one bank, or 0 if it is damaged (nothing is ever written past the end of the bank)
+// runs with interrupts off, and puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+uint8_t __fastcall__ Memory_DecompressBank(void);
+
+// call to a routine in memory.asm that unpacks a ZX0 stream, or the blocks of an LZ4 frame, straight into consecutive banks of memory
+// the packed data is read into STORAGE_FILE_BUFFER_1: whenever that runs out, File_ReadStreamBuffer() is called to refill it
+// the bank being unpacked into is mapped in at $A000. matches are copied from what has already been unpacked, through $C000 (I/O off)
+// set before calling:
+//   zp_search_loc_bank: the first bank to unpack into (0-127)
+//   zp_other_byte: the last bank it may unpack into
+//   zp_temp_1: PARAM_UNPACK_ZX0, PARAM_UNPACK_LZ4, or PARAM_UNPACK_LZ4_CHECKSUMS. for LZ4, the frame header must already have been read.
+// returns MEMORY_UNPACK_OK, MEMORY_UNPACK_DAMAGED, or MEMORY_UNPACK_NO_ROOM, and sets zp_search_loc_bank to the last bank unpacked into
+// the rest of the last page unpacked into is zeroed, as App_EMReadFromFile() does
+// runs with interrupts off, except while File_ReadStreamBuffer() runs, and puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+uint8_t __fastcall__ Memory_DecompressStream(void);
+
+// call to a routine in memory.asm that builds the table Memory_Crc32() looks up, in the bank it will find it in
+// the table bank is mapped in at $C000 (I/O off). see CRC32_TABLE_* above for where the table goes.
+// set zp_other_byte to the table bank before calling.
+// runs with interrupts off, and puts back whatever was mapped at $C000, and the I/O setting, before returning
+void __fastcall__ Memory_MakeCrc32Table(void);
 
+// call to a routine in memory.asm that runs part of one bank of memory, in place, through a CRC-32, one table lookup per byte
+// the bank is mapped in at $A000, and the table bank at $C000 (I/O off). the table must already have been built by Memory_MakeCrc32Table()
+// the_crc is the CRC so far: start with $FFFFFFFF, and flip all the bits of the last one returned to get the finished CRC-32
+// set before calling:
+//   zp_search_loc_bank: the bank the data is in (0-127)
+//   zp_from_addr (2 bytes): offset of the data in the bank (0-8191)
+//   zp_copy_len (2 bytes): length of the data (1-8192). must not run past the end of the bank
+//   zp_other_byte: the table bank
+// returns the CRC so far, including the data
+// runs with interrupts off, and puts back whatever was mapped at $A000 and $C000, and the I/O setting, before returning
+uint32_t __fastcall__ Memory_Crc32(uint32_t the_crc);
 
 #endif /* MEMORY_H_ */
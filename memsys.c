@@ -22,6 +22,7 @@
 #include "kernel.h"
 #include "list.h"
 #include "list_panel.h"
+#include "memory.h"
 #include "memsys.h"
 #include "strings.h"
 #include "text.h"
@@ -44,6 +45,19 @@
 
 #define MEMSYS_KUPNAME_TEMP_BUFFER_LEN		17	// enough for 16-char name + terminator
 
+#define MEMSYS_CHECKSUM_RECORD_LEN			8	// each bank's record in the checksum table: 4b checksum, 1b flags, 1b KUP size, 2b unused
+#define MEMSYS_CHECKSUM_FLAGS				4	// offset of the flags byte in a checksum record
+#define MEMSYS_CHECKSUM_KUP_SIZE			5	// offset of the KUP size byte (header byte 2) in a checksum record. only meaningful with MEMSYS_CHECKSUM_FLAG_KUP
+#define MEMSYS_CHECKSUM_FLAG_IDENTICAL		0x01	// another bank has the same checksum
+#define MEMSYS_CHECKSUM_FLAG_KUP			0x02	// the bank starts with the KUP signature
+#define MEMSYS_CPU_SPACE_LEN				0x10000UL	// banks 0-7: the 64K f/manager itself is running in
+
+#define MEMSYS_KUP_SIGNATURE_LEN			3	// signature ($F2 $56) + size in banks: all a scan needs to peek at to group banks
+#define MEMSYS_KUP_HEADER_LEN				STORAGE_STRING_BUFFER_1_LEN	// fixed header + name, args, description strings. fits in global_string_buff2
+
+#define MEMSYS_CHECKSUM_IS_STALE(bank_num)	(global_bank_checksum_stale[(bank_num) >> 3] & (1 << ((bank_num) & 0x07)))
+#define MEMSYS_HEADER_IS_STALE(bank_num)	(global_bank_header_stale[(bank_num) >> 3] & (1 << ((bank_num) & 0x07)))
+
 /*****************************************************************************/
 /*                          File-scoped Variables                            */
 /*****************************************************************************/
@@ -64,6 +78,13 @@ extern char*		global_temp_path_2;
 extern char*		global_string_buff1;
 extern char*		global_string_buff2;
 
+extern uint8_t		global_bank_checksum_stale[BANK_CHECKSUM_NUM_BANKS / 8];
+extern uint8_t		global_bank_header_stale[BANK_CHECKSUM_NUM_BANKS / 8];
+
+extern uint8_t		zp_search_loc_bank;
+
+#pragma zpsym ("zp_search_loc_bank");
+
 
 /*****************************************************************************/
 /*                       Private Function Prototypes                         */
@@ -81,11 +102,55 @@ WB2KList* MemSys_FindListItemByBankPath(FMMemorySystem* the_memsys, char* the_ba
 // Returns NULL if nothing matches, or returns pointer to first matching BankObject
 FMBankObject* MemSys_FindBankByBankPath(FMMemorySystem* the_memsys, char* the_bank_path, short the_compare_len);
 
+// callback for App_EMForEachRun(): flags every bank in the checksum table, which is mapped in at the_table, whose checksum is the same as another bank's
+// banks that are waiting to be checksummed again are left out
+bool MemSys_FlagIdenticalBanks(uint8_t* the_table, uint16_t the_len, uint32_t phys_addr);
+
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
 /*****************************************************************************/
 
+// callback for App_EMForEachRun(): flags every bank in the checksum table, which is mapped in at the_table, whose checksum is the same as another bank's
+// banks that are waiting to be checksummed again are left out
+bool MemSys_FlagIdenticalBanks(uint8_t* the_table, uint16_t the_len, uint32_t phys_addr)
+{
+	uint8_t		i;
+	uint8_t		j;
+	uint8_t*	this_record;
+	uint8_t*	other_record;
+	uint32_t	this_checksum;
+	
+	for (i = 0, this_record = the_table; i < BANK_CHECKSUM_NUM_BANKS; i++, this_record += MEMSYS_CHECKSUM_RECORD_LEN)
+	{
+		this_record[MEMSYS_CHECKSUM_FLAGS] &= ~MEMSYS_CHECKSUM_FLAG_IDENTICAL;
+	}
+	
+	// LOGIC:
+	//   128 banks is only 8128 pairs: not worth sorting. checking the low byte first rejects almost every pair without a 32-bit compare.
+	
+	for (i = 0, this_record = the_table; i < BANK_CHECKSUM_NUM_BANKS - 1; i++, this_record += MEMSYS_CHECKSUM_RECORD_LEN)
+	{
+		if (MEMSYS_CHECKSUM_IS_STALE(i))
+		{
+			continue;
+		}
+		
+		this_checksum = *(uint32_t*)this_record;
+		
+		for (j = i + 1, other_record = this_record + MEMSYS_CHECKSUM_RECORD_LEN; j < BANK_CHECKSUM_NUM_BANKS; j++, other_record += MEMSYS_CHECKSUM_RECORD_LEN)
+		{
+			if (other_record[0] == this_record[0] && *(uint32_t*)other_record == this_checksum && MEMSYS_CHECKSUM_IS_STALE(j) == 0)
+			{
+				this_record[MEMSYS_CHECKSUM_FLAGS] |= MEMSYS_CHECKSUM_FLAG_IDENTICAL;
+				other_record[MEMSYS_CHECKSUM_FLAGS] |= MEMSYS_CHECKSUM_FLAG_IDENTICAL;
+			}
+		}
+	}
+	
+	return true;
+}
+
 
 
 
@@ -383,6 +448,8 @@ void MemSys_PopulateBanks(FMMemorySystem* the_memsys)
 {	
 	uint8_t		i;
 	uint8_t*	copy_buffer;
+	uint8_t		the_info[2];	// flags and KUP size bytes of the bank's checksum record
+	uint32_t	info_addr;
 	
 	uint8_t		kup_version;
 	char*		kup_name;
@@ -407,17 +474,45 @@ void MemSys_PopulateBanks(FMMemorySystem* the_memsys)
 	else
 	{
 		flash_offset = 0;
+		
+		// f/manager's own 64K changes constantly as it runs, without going through anything that would mark it changed. 
+		App_MarkBanksChanged(0, MEMSYS_CPU_SPACE_LEN);
 	}
 	
 	// use string buff 2 for interbank copying
 	copy_buffer = (uint8_t*)global_string_buff2;
 	
-	// read the first 256 bytes of every bank in extended memory
+	// LOGIC:
+	//   all a bank's listing depends on is whether it starts with the KUP signature, and if so, how many banks the KUP has.
+	//   those 2 facts are cached in the bank's checksum record, and the bank itself is only peeked at again if its header is marked stale:
+	//     f/manager marks a RAM bank stale whenever it writes to it (App_MarkBanksChanged()), and marks every bank stale when the user refreshes.
+	//     so flash is only re-read on an explicit refresh.
+	//   the name, args, and description strings are only fetched for banks that start a KUP, and only as far as the header can go.
+	
 	for (i = 0; i < MEMORY_BANK_COUNT; i++)
 	{
 		bank_num = i + flash_offset;
+		info_addr = BANK_CHECKSUM_PHYS_ADDR + (uint16_t)bank_num * MEMSYS_CHECKSUM_RECORD_LEN + MEMSYS_CHECKSUM_FLAGS;
 		
-		App_EMDataCopy((uint8_t*)copy_buffer, bank_num, 0, PARAM_COPY_FROM_EM);
+		App_EMBulkCopy(the_info, info_addr, sizeof(the_info), PARAM_COPY_FROM_EM);
+		
+		if (MEMSYS_HEADER_IS_STALE(bank_num))
+		{
+			App_EMBulkCopy(copy_buffer, (uint32_t)bank_num * BYTES_PER_BANK, MEMSYS_KUP_SIGNATURE_LEN, PARAM_COPY_FROM_EM);
+			
+			if (copy_buffer[0] == 0xF2 && copy_buffer[1] == 0x56)
+			{
+				the_info[0] |= MEMSYS_CHECKSUM_FLAG_KUP;
+				the_info[1] = copy_buffer[2];
+			}
+			else
+			{
+				the_info[0] &= ~MEMSYS_CHECKSUM_FLAG_KUP;
+			}
+			
+			App_EMBulkCopy(the_info, info_addr, sizeof(the_info), PARAM_COPY_TO_EM);
+			global_bank_header_stale[bank_num >> 3] &= ~(1 << (bank_num & 0x07));
+		}
 		
 		// check for KUP continuation, or KUP signature $F2$56, or every other bank
 		// LOGIC:
@@ -434,9 +529,12 @@ void MemSys_PopulateBanks(FMMemorySystem* the_memsys)
 			
 			--remaining_kup_banks;
 		}
-		else if (copy_buffer[0] == 0xF2 && copy_buffer[1] == 0x56)
+		else if (the_info[0] & MEMSYS_CHECKSUM_FLAG_KUP)
 		{
-			remaining_kup_banks = num_banks_in_kup = copy_buffer[2];	// Byte  2    the size of program in 8k blocks
+			App_EMBulkCopy(copy_buffer, (uint32_t)bank_num * BYTES_PER_BANK, MEMSYS_KUP_HEADER_LEN, PARAM_COPY_FROM_EM);
+			copy_buffer[MEMSYS_KUP_HEADER_LEN - 1] = 0;	// any string still running at the end of what was fetched stops here
+			
+			remaining_kup_banks = num_banks_in_kup = the_info[1];	// Byte  2    the size of program in 8k blocks
 			kup_version = copy_buffer[6];
 			
 			// get name: all versions of KUP supported the name
@@ -607,9 +705,6 @@ void MemSys_PopulateBanks(FMMemorySystem* the_memsys)
 // check if user is allowed to clear, copy-to, or fill a chosen bank
 bool MemSys_BankIsWriteable(FMMemorySystem* the_memsys)
 {
-	FMBankObject*		the_bank;
-	uint8_t				i;
-	
 	// no one can write to flash
 	if (the_memsys->is_flash_ == true)
 	{
@@ -621,20 +716,39 @@ bool MemSys_BankIsWriteable(FMMemorySystem* the_memsys)
 		return false;
 	}
 	
-	the_bank = &the_memsys->bank_[the_memsys->cur_row_];
+	return MemSys_BankNumIsWriteable(the_memsys->bank_[the_memsys->cur_row_].bank_num_);
+}
 
+
+// check if user is allowed to write to the specified physical bank number (0-127)
+// only RAM banks outside of f/manager's own memory are writeable
+bool MemSys_BankNumIsWriteable(uint8_t the_bank_num)
+{
+	uint8_t				i;
+	
+	// no one can write to flash
+	if (the_bank_num >= MEMORY_BANK_COUNT)
+	{
+		return false;
+	}
+	
 	// user is not allowed to write to first 64K of RAM, or to f/manager extended memory
-	for (i = 0; i <= (uint8_t)OVERLAY_MEMSYSTEM; i++)
+	for (i = 0; i <= (uint8_t)OVERLAY_LAST_IN_USE; i++)
 	{
-		if (the_bank->bank_num_ == i)
+		if (the_bank_num == i)
 		{
 			return false;
 		}
 	}
 	
-	// user is not allowed to write to f/manager strings or filenames RAM either
-	if (the_bank->bank_num_ == STRING_STORAGE_EM_SLOT ||
-		the_bank->bank_num_ == FILENAME_STORAGE_EM_SLOT )
+	// user is not allowed to write to f/manager strings, search results, search automaton, bank checksums, filenames (1 bank per panel), or custom font RAM either
+	if (the_bank_num == STRING_STORAGE_EM_SLOT ||
+		the_bank_num == SEARCH_RESULTS_EM_SLOT ||
+		the_bank_num == SEARCH_AUTOMATON_EM_SLOT ||
+		the_bank_num == BANK_CHECKSUM_EM_SLOT ||
+		the_bank_num == FILENAME_STORAGE_EM_SLOT ||
+		the_bank_num == FILENAME_STORAGE_EM_SLOT + 1 ||
+		the_bank_num == CUSTOM_FONT_VALUE )
 	{
 		return false;
 	}
@@ -642,6 +756,129 @@ bool MemSys_BankIsWriteable(FMMemorySystem* the_memsys)
 	return true;
 }
 
+
+// sets a bit in the_banks for every bank of RAM the user is allowed to write to, and clears it for every other one
+// the_banks must have room for MEMORY_BANK_COUNT bits: bank 0 is bit 0 of the first byte
+// use to hand the MemSys_BankNumIsWriteable() rules to code in another overlay
+void MemSys_GetWriteableBanks(uint8_t* the_banks)
+{
+	uint8_t				the_bank_num;
+	
+	memset(the_banks, 0, MEMORY_BANK_COUNT / 8);
+	
+	for (the_bank_num = 0; the_bank_num < MEMORY_BANK_COUNT; the_bank_num++)
+	{
+		if (MemSys_BankNumIsWriteable(the_bank_num) == true)
+		{
+			the_banks[the_bank_num >> 3] |= (1 << (the_bank_num & 0x07));
+		}
+	}
+}
+
+
+// count how many consecutive banks, starting at the_bank_num, the user is allowed to write to
+// stops counting at the first protected bank (flash, or f/manager's own memory), or at max_count
+uint8_t MemSys_CountWriteableBanks(uint8_t the_bank_num, uint8_t max_count)
+{
+	uint8_t				the_count = 0;
+	
+	while (the_count < max_count && MemSys_BankNumIsWriteable(the_bank_num + the_count) == true)
+	{
+		++the_count;
+	}
+	
+	return the_count;
+}
+
+
+// checksum every bank in the memory system that f/manager has written to since it was last checksummed, then re-flag identical banks
+void MemSys_UpdateChecksums(FMMemorySystem* the_memsys)
+{
+	uint8_t		i;
+	uint8_t		first_bank_num;
+	uint8_t		bank_num;
+	uint8_t		num_stale = 0;
+	uint8_t		num_done = 0;
+	uint32_t	the_checksum;
+	
+	// LOGIC:
+	//   the checksum table at BANK_CHECKSUM_PHYS_ADDR holds one MEMSYS_CHECKSUM_RECORD_LEN record per bank (0-127), in bank order
+	//   checksumming a bank takes about 40ms, so only banks with their bit set in global_bank_checksum_stale are redone.
+	//     f/manager sets those bits whenever it writes to memory: fill, clear, load, copy, and its own bookkeeping (App_MarkBanksChanged())
+	//     f/manager never writes to flash, so flash banks are only checksummed once.
+	//   once all the checksums are current, every bank is compared with every other, RAM and flash alike
+	
+	first_bank_num = (the_memsys->is_flash_ == true) ? MEMORY_BANK_COUNT : 0;
+	
+	for (i = 0; i < MEMORY_BANK_COUNT; i++)
+	{
+		if (MEMSYS_CHECKSUM_IS_STALE(first_bank_num + i))
+		{
+			++num_stale;
+		}
+	}
+	
+	if (num_stale == 0)
+	{
+		return;
+	}
+	
+	if (num_stale > 1)
+	{
+		sprintf(global_string_buff1, General_GetString(ID_STR_MSG_CHECKSUMMING_BANKS), num_stale);
+		Buffer_NewMessage(global_string_buff1);
+		App_ShowProgressBar();
+	}
+	
+	for (i = 0; i < MEMORY_BANK_COUNT; i++)
+	{
+		bank_num = first_bank_num + i;
+		
+		if (MEMSYS_CHECKSUM_IS_STALE(bank_num) == 0)
+		{
+			continue;
+		}
+		
+		zp_search_loc_bank = bank_num;
+		the_checksum = Memory_ChecksumBank();
+		App_EMBulkCopy((uint8_t*)&the_checksum, BANK_CHECKSUM_PHYS_ADDR + (uint16_t)bank_num * MEMSYS_CHECKSUM_RECORD_LEN, sizeof(uint32_t), PARAM_COPY_TO_EM);
+		
+		global_bank_checksum_stale[bank_num >> 3] &= ~(1 << (bank_num & 0x07));
+		
+		if (num_stale > 1)
+		{
+			App_UpdateProgressBar((uint16_t)++num_done * 100 / num_stale);
+		}
+	}
+	
+	App_EMForEachRun(BANK_CHECKSUM_PHYS_ADDR, BANK_CHECKSUM_NUM_BANKS * MEMSYS_CHECKSUM_RECORD_LEN, &MemSys_FlagIdenticalBanks);
+
+	if (num_stale > 1)
+	{
+		App_HideProgressBar();
+	}
+}
+
+
+// gets the checksum of the specified bank (0-127) from the checksum table, and whether another bank has the same checksum
+// returns false if the bank has been written to since it was last checksummed
+bool MemSys_GetBankChecksum(uint8_t the_bank_num, uint32_t* the_checksum, bool* is_identical)
+{
+	uint8_t		the_record[MEMSYS_CHECKSUM_RECORD_LEN];
+	
+	if (the_bank_num >= BANK_CHECKSUM_NUM_BANKS || MEMSYS_CHECKSUM_IS_STALE(the_bank_num))
+	{
+		return false;
+	}
+	
+	App_EMBulkCopy(the_record, BANK_CHECKSUM_PHYS_ADDR + (uint16_t)the_bank_num * MEMSYS_CHECKSUM_RECORD_LEN, MEMSYS_CHECKSUM_RECORD_LEN, PARAM_COPY_FROM_EM);
+	
+	*the_checksum = *(uint32_t*)the_record;
+	*is_identical = (the_record[MEMSYS_CHECKSUM_FLAGS] & MEMSYS_CHECKSUM_FLAG_IDENTICAL) != 0;
+	
+	return true;
+}
+
 	
 // select or unselect 1 file by row id, and change cur_row_ accordingly
 FMBankObject* MemSys_SetBankSelectionByRow(FMMemorySystem* the_memsys, uint16_t the_row, bool do_selection, uint8_t y_offset, bool as_active)
@@ -48,6 +48,7 @@
 /*****************************************************************************/
 
 #define MEMORY_BANK_COUNT		64	// 64 banks each for RAM and Flash in an F256
+#define MEMORY_RAM_SIZE			0x80000	// 64 banks of 8K. RAM is physical $00000-$7FFFF, flash follows it.
 
 #define PARAM_MARK_SELECTED		true	// param for MemSys_SetBankSelectionByRow
 #define PARAM_MARK_UNSELECTED	true	// param for MemSys_SetBankSelectionByRow
@@ -154,6 +155,26 @@ bool MemSys_ExecuteCurrentRow(FMMemorySystem* the_memsys);
 // check if user is allowed to clear, copy-to, or fill a chosen bank
 bool MemSys_BankIsWriteable(FMMemorySystem* the_memsys);
 
+// check if user is allowed to write to the specified physical bank number (0-127)
+// only RAM banks outside of f/manager's own memory are writeable
+bool MemSys_BankNumIsWriteable(uint8_t the_bank_num);
+
+// sets a bit in the_banks for every bank of RAM the user is allowed to write to, and clears it for every other one
+// the_banks must have room for MEMORY_BANK_COUNT bits: bank 0 is bit 0 of the first byte
+// use to hand the MemSys_BankNumIsWriteable() rules to code in another overlay
+void MemSys_GetWriteableBanks(uint8_t* the_banks);
+
+// count how many consecutive banks, starting at the_bank_num, the user is allowed to write to
+// stops counting at the first protected bank (flash, or f/manager's own memory), or at max_count
+uint8_t MemSys_CountWriteableBanks(uint8_t the_bank_num, uint8_t max_count);
+
+// checksum every bank in the memory system that f/manager has written to since it was last checksummed, then re-flag identical banks
+void MemSys_UpdateChecksums(FMMemorySystem* the_memsys);
+
+// gets the checksum of the specified bank (0-127) from the checksum table, and whether another bank has the same checksum
+// returns false if the bank has been written to since it was last checksummed
+bool MemSys_GetBankChecksum(uint8_t the_bank_num, uint32_t* the_checksum, bool* is_identical);
+
 
 // **** FILL AND CLEAR FUNCTIONS *****
 
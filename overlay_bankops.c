@@ -0,0 +1,287 @@
+/*
+ * overlay_bankops.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ *
+ *  Routines for memory jobs that work on more than 1 bank at a time: copying any range of RAM, etc.
+ *    these sit alongside memsys.c and bank.c, which live in the MEMSYSTEM overlay and have little room left
+ *    nothing here may call into MEMSYSTEM (MemSys_*, Bank_*), or into SCREEN: all overlays use the same CPU bank, so only one can be mapped in at a time
+ *    so the caller asks the user for input, and gets anything it needs from MEMSYSTEM, before loading this overlay
+ *
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "overlay_bankops.h"
+#include "app.h"
+#include "bank.h"
+#include "comm_buffer.h"
+#include "debug.h"
+#include "general.h"
+#include "memsys.h"
+#include "strings.h"
+
+// C includes
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// F256 includes
+#include "f256.h"
+
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                           File-scope Variables                            */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern char*				global_string_buff1;
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// returns true if every bank from the_first_bank_num to the_last_bank_num is set in the_writeable_banks
+bool BankOps_BanksAreWriteable(uint8_t* the_writeable_banks, uint8_t the_first_bank_num, uint8_t the_last_bank_num);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// returns true if every bank from the_first_bank_num to the_last_bank_num is set in the_writeable_banks
+bool BankOps_BanksAreWriteable(uint8_t* the_writeable_banks, uint8_t the_first_bank_num, uint8_t the_last_bank_num)
+{
+	uint8_t		the_bank_num;
+	
+	for (the_bank_num = the_first_bank_num; the_bank_num <= the_last_bank_num; the_bank_num++)
+	{
+		if ((the_writeable_banks[the_bank_num >> 3] & (1 << (the_bank_num & 0x07))) == 0)
+		{
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// **** COPY FUNCTIONS *****
+
+
+// copy a range of physical memory, entered by the user as hex from,to,length, to anywhere else in RAM
+// the range can be any length, doesn't need to line up with banks, and source and destination may overlap
+// the_writeable_banks is the bitset filled in by MemSys_GetWriteableBanks(): every bank the destination touches must be set in it
+// shows a message saying what was copied, or why not. returns false if the input was bad or the range isn't allowed
+bool BankOps_CopyRange(char* the_string, uint8_t* the_writeable_banks)
+{
+	uint32_t	src_addr;
+	uint32_t	dst_addr;
+	uint32_t	the_len;
+	char*		the_end;
+	
+	// LOGIC:
+	//   3 hex numbers, separated by commas.
+	//   DMA can only read and write RAM. the destination must also stay clear of f/manager's own memory, so check every bank it touches.
+	
+	src_addr = strtoul(the_string, &the_end, 16);
+	
+	if (*the_end != ',')
+	{
+		goto bad_input;
+	}
+	
+	dst_addr = strtoul(the_end + 1, &the_end, 16);
+	
+	if (*the_end != ',')
+	{
+		goto bad_input;
+	}
+	
+	the_len = strtoul(the_end + 1, &the_end, 16);
+	
+	if (*the_end != '\0' || the_len == 0)
+	{
+		goto bad_input;
+	}
+	
+	// both ranges must be entirely in RAM. (written this way round so a huge number can't wrap around)
+	if (src_addr >= MEMORY_RAM_SIZE || the_len > MEMORY_RAM_SIZE - src_addr ||
+		dst_addr >= MEMORY_RAM_SIZE || the_len > MEMORY_RAM_SIZE - dst_addr)
+	{
+		goto not_allowed;
+	}
+	
+	if (BankOps_BanksAreWriteable(the_writeable_banks, dst_addr / BYTES_PER_BANK, (dst_addr + the_len - 1) / BYTES_PER_BANK) == false)
+	{
+		goto not_allowed;
+	}
+	
+	App_MoveMemoryWithDMA(dst_addr, src_addr, the_len);
+
+	sprintf(global_string_buff1, General_GetString(ID_STR_MSG_N_BYTES_COPIED_FROM_TO), the_len, src_addr, dst_addr);
+	Buffer_NewMessage(global_string_buff1);
+	
+	return true;
+	
+bad_input:
+	Buffer_NewMessage(General_GetString(ID_STR_ERROR_BAD_COPY_RANGE));
+	return false;
+	
+not_allowed:
+	Buffer_NewMessage(General_GetString(ID_STR_ERROR_COPY_RANGE_NOT_ALLOWED));
+	return false;
+}
+
+
+
+// **** SAVE FUNCTIONS *****
+
+
+// check a range of banks, entered by the user as hex bank,count[,offset], and turn it into a physical start address and length
+// the banks must all be in the memory system whose first bank is the_first_bank_num (0 for RAM, MEMORY_BANK_COUNT for flash)
+// the optional offset skips that many bytes at the start of the first bank
+// shows a message and returns false if the input was bad or the range isn't allowed
+bool BankOps_ParseSaveRange(char* the_string, uint8_t the_first_bank_num, uint32_t* the_start_addr, uint32_t* the_len)
+{
+	uint8_t		end_bank_num;
+	uint8_t		the_bank_num;
+	uint32_t	the_value;
+	char*		the_end;
+	
+	// LOGIC:
+	//   the range is a bank count, not an end address, to match how banks are picked everywhere else in the panel.
+	//   check each number as it comes in, so a huge one can't wrap around when squeezed into 8 bits
+	
+	end_bank_num = the_first_bank_num + MEMORY_BANK_COUNT;
+	
+	the_value = strtoul(the_string, &the_end, 16);
+	
+	if (*the_end != ',')
+	{
+		goto bad_input;
+	}
+	
+	if (the_value < the_first_bank_num || the_value >= end_bank_num)
+	{
+		goto not_allowed;
+	}
+	
+	the_bank_num = (uint8_t)the_value;
+	the_value = strtoul(the_end + 1, &the_end, 16);
+	
+	if ((*the_end != ',' && *the_end != '\0') || the_value == 0)
+	{
+		goto bad_input;
+	}
+	
+	if (the_value > end_bank_num - the_bank_num)
+	{
+		goto not_allowed;
+	}
+	
+	*the_start_addr = (uint32_t)the_bank_num * BYTES_PER_BANK;
+	*the_len = the_value * BYTES_PER_BANK;
+	the_value = 0;
+	
+	if (*the_end == ',')
+	{
+		the_value = strtoul(the_end + 1, &the_end, 16);
+		
+		if (*the_end != '\0')
+		{
+			goto bad_input;
+		}
+	}
+	
+	if (the_value >= *the_len)
+	{
+		goto not_allowed;
+	}
+	
+	*the_start_addr += the_value;
+	*the_len -= the_value;
+	
+	return true;
+	
+bad_input:
+	Buffer_NewMessage(General_GetString(ID_STR_ERROR_BAD_SAVE_RANGE));
+	return false;
+	
+not_allowed:
+	Buffer_NewMessage(General_GetString(ID_STR_ERROR_SAVE_RANGE_NOT_ALLOWED));
+	return false;
+}
+
+
+// write the_len bytes of memory, starting at physical address the_start_addr, to an already open file, straight from each mapped bank
+// shows the progress bar while it works, and hides it again when done
+// returns false if any write came up short
+bool BankOps_SaveRange(FILE* the_target_handle, uint32_t the_start_addr, uint32_t the_len)
+{
+	uint8_t		the_bank_num;
+	uint16_t	bank_offset;
+	uint16_t	chunk_len;
+	uint32_t	the_addr;
+	uint32_t	bytes_remaining;
+	bool		success = true;
+	
+	// LOGIC:
+	//   the whole range goes out through the one open file, straight from each mapped bank, BANK_SAVE_CHUNK_LEN bytes at a time.
+	//   the chunks line up with chunk boundaries in the bank, so no single write can run off the end of a bank.
+	//   App_EMWriteToFile maps the bank into the overlay slot, but puts this overlay back before it returns.
+	
+	App_ShowProgressBar();
+
+	the_addr = the_start_addr;
+	bytes_remaining = the_len;
+	
+	while (bytes_remaining > 0 && success == true)
+	{
+		the_bank_num = the_addr / BYTES_PER_BANK;
+		bank_offset = the_addr & (BYTES_PER_BANK - 1);
+		chunk_len = BANK_SAVE_CHUNK_LEN - (bank_offset & (BANK_SAVE_CHUNK_LEN - 1));
+		
+		if (chunk_len > bytes_remaining)
+		{
+			chunk_len = bytes_remaining;
+		}
+		
+		success = App_EMWriteToFile(the_target_handle, the_bank_num, bank_offset, chunk_len);
+		
+		the_addr += chunk_len;
+		bytes_remaining -= chunk_len;
+		
+		App_UpdateProgressBar((uint8_t)(((the_len - bytes_remaining) * 100) / the_len));
+	}
+	
+	App_HideProgressBar();
+	
+	return success;
+}
@@ -0,0 +1,70 @@
+/*
+ * overlay_bankops.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef OVERLAY_BANKOPS_H_
+#define OVERLAY_BANKOPS_H_
+
+/* about this class
+ *
+ *  Routines for memory jobs that work on more than 1 bank at a time: copying any range of RAM, etc.
+ *    these sit alongside memsys.c and bank.c, which live in the MEMSYSTEM overlay and have little room left
+ *    nothing here may call into MEMSYSTEM (MemSys_*, Bank_*), or into SCREEN: all overlays use the same CPU bank, so only one can be mapped in at a time
+ *    so the caller asks the user for input, and gets anything it needs from MEMSYSTEM, before loading this overlay
+ *
+ */
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+#include "app.h"
+#include <stdint.h>
+#include <stdio.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+
+// **** COPY FUNCTIONS *****
+
+// copy a range of physical memory, entered by the user as hex from,to,length, to anywhere else in RAM
+// the range can be any length, doesn't need to line up with banks, and source and destination may overlap
+// the_writeable_banks is the bitset filled in by MemSys_GetWriteableBanks(): every bank the destination touches must be set in it
+// shows a message saying what was copied, or why not. returns false if the input was bad or the range isn't allowed
+bool BankOps_CopyRange(char* the_string, uint8_t* the_writeable_banks);
+
+
+// **** SAVE FUNCTIONS *****
+
+// check a range of banks, entered by the user as hex bank,count[,offset], and turn it into a physical start address and length
+// the banks must all be in the memory system whose first bank is the_first_bank_num (0 for RAM, MEMORY_BANK_COUNT for flash)
+// the optional offset skips that many bytes at the start of the first bank
+// shows a message and returns false if the input was bad or the range isn't allowed
+bool BankOps_ParseSaveRange(char* the_string, uint8_t the_first_bank_num, uint32_t* the_start_addr, uint32_t* the_len);
+
+// write the_len bytes of memory, starting at physical address the_start_addr, to an already open file, straight from each mapped bank
+// shows the progress bar while it works, and hides it again when done
+// returns false if any write came up short
+bool BankOps_SaveRange(FILE* the_target_handle, uint32_t the_start_addr, uint32_t the_len);
+
+#endif /* OVERLAY_BANKOPS_H_ */
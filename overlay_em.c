@@ -51,9 +51,14 @@
 #define	CH_LINE_BREAK	10
 #define	CH_LINE_RETURN	13
 
-#define HEX_DISPLAY_NUM_CHARS_PER_ROW		16	// we can fit 16 chars across, and have space for hex addr and text view
-#define HEX_DISPLAY_NUM_ROWS				59	// we use one row for title/instructions
-#define HEX_DISPLAY_MAX_CHARS_PER_SCREEN	(HEX_DISPLAY_NUM_CHARS_PER_ROW * HEX_DISPLAY_NUM_ROWS)
+// scratch space for building the multi-phrase search automaton, in the automaton bank after the parts Memory_SearchBankForPhrases() uses
+#define SEARCH_AUTOMATON_PARENT				0x1300	// for every state, the state it is reached from
+#define SEARCH_AUTOMATON_LABEL				0x1340	// for every state, the (case-folded) byte that reaches it
+#define SEARCH_AUTOMATON_FAIL				0x1380	// for every state, the longest proper suffix of it that is also a state
+#define SEARCH_AUTOMATON_ORDER				0x13C0	// the states in breadth-first order
+#define SEARCH_AUTOMATON_VALUE_CLASS		0x1400	// 256b: for every case-folded byte value, its byte class (0 = not in any phrase)
+#define SEARCH_AUTOMATON_FOLD				0x1500	// 256b: for every byte value, the byte to treat it as
+#define SEARCH_AUTOMATON_NO_EDGE			0xFF	// marks a missing trie edge while a transition column is built
 #
 
 /*****************************************************************************/
@@ -65,6 +70,7 @@
 
 static uint8_t				em_temp_buffer_384b_storage[384];
 static uint8_t*				em_temp_buffer_384b = em_temp_buffer_384b_storage;
+static bool					em_search_ignore_case;	// for EM_BuildSearchAutomaton(), which is a callback and can't be passed it
 
 /*****************************************************************************/
 /*                             Global Variables                              */
@@ -72,7 +78,10 @@ static uint8_t*				em_temp_buffer_384b = em_temp_buffer_384b_storage;
 
 extern uint8_t				global_search_phrase_len;
 extern char*				global_search_phrase;
+extern uint8_t*				global_search_mask;
 extern char*				global_search_phrase_human_readable;
+extern uint8_t*				global_multi_search_phrases;
+extern char*				global_multi_search_human_readable;
 extern char*				global_string[NUM_STRINGS];
 extern char*				global_string_buff1;
 extern char*				global_string_buff2;
@@ -102,6 +111,17 @@ extern uint8_t	zp_search_loc_bank;
 // returns NULL if entire string was displayed, or returns pointer to next char needing display if available space was all used
 char* EM_WrapAndDisplayString(char* the_message, uint8_t x, uint8_t y, uint8_t col_width, uint8_t max_allowed_rows);
 
+// builds the Horspool skip table for global_search_phrase/mask/len, and tells Memory_SearchBank() where the phrase is
+void EM_PrepareSearch(void);
+
+// tells Memory_SearchBank() the last position in bank ZP_SEARCH_LOC_BANK a match may start at
+// last_bank_num is the last bank being searched: a match may not run on past the end of it
+void EM_SetLastSearchPosition(uint8_t last_bank_num);
+
+// builds the multi-phrase search automaton for global_multi_search_phrases in the automaton bank, which App_EMForEachRun() has mapped in at the_window
+// returns false if the phrases need more than SEARCH_AUTOMATON_MAX_STATES states
+bool EM_BuildSearchAutomaton(uint8_t* the_window, uint16_t the_len, uint32_t phys_addr);
+
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
@@ -208,6 +228,264 @@ char* EM_WrapAndDisplayString(char* the_message, uint8_t x, uint8_t y, uint8_t c
 
 
 
+// builds the Horspool skip table for global_search_phrase/mask/len, and tells Memory_SearchBank() where the phrase is
+void EM_PrepareSearch(void)
+{
+	uint8_t		i;
+	uint8_t		anchor;
+	uint8_t		the_mask;
+	uint8_t		the_value;
+	uint8_t		b;
+	uint8_t*	skip_table = (uint8_t*)STORAGE_FILE_BUFFER_1;
+	
+	// LOGIC:
+	//   the skip table goes in STORAGE_FILE_BUFFER_1. it's rebuilt on every search, because other things use that buffer in between.
+	//   the table is built around an "anchor": the last byte of the phrase that has to match exactly. 
+	//     for a plain phrase that's the last char, which is normal Horspool. any wildcards after it are simply carried along.
+	//     if nothing in the phrase is fixed, the last byte is used anyway, which just makes the skips small.
+	//   a byte that can't appear at any position before the anchor lets the phrase slide all the way past it (anchor+1)
+	//   a masked byte before the anchor marks every byte value it could match, so those never skip too far
+	//   working left to right means a position closer to the anchor (smaller skip) always wins
+	
+	anchor = global_search_phrase_len - 1;
+	
+	for (i = global_search_phrase_len; i > 0; i--)
+	{
+		if (global_search_mask[i - 1] == 0xFF)
+		{
+			anchor = i - 1;
+			break;
+		}
+	}
+	
+	memset(skip_table, anchor + 1, 256);
+	
+	for (i = 0; i < anchor; i++)
+	{
+		the_mask = global_search_mask[i];
+		the_value = (uint8_t)global_search_phrase[i];
+		
+		if (the_mask == 0xFF)
+		{
+			skip_table[the_value] = anchor - i;
+		}
+		else
+		{
+			b = 0;
+			
+			do
+			{
+				if ((b & the_mask) == the_value)
+				{
+					skip_table[b] = anchor - i;
+				}
+			} while (++b != 0);
+		}
+	}
+	
+	*(uint16_t*)ZP_FROM_ADDR = (uint16_t)global_search_phrase;
+	*(uint16_t*)ZP_TO_ADDR = (uint16_t)global_search_mask;
+	*(uint8_t*)ZP_OTHER_PARAM = global_search_phrase_len;
+	*(uint8_t*)ZP_TEMP_1 = anchor;
+}
+
+
+
+// tells Memory_SearchBank() the last position in bank ZP_SEARCH_LOC_BANK a match may start at
+// last_bank_num is the last bank being searched: a match may not run on past the end of it
+void EM_SetLastSearchPosition(uint8_t last_bank_num)
+{
+	// a match can start anywhere in the bank and run on into the next one, except in the last bank being searched
+	//   (otherwise a search of RAM could report a match that runs from its last bank on into flash)
+	if (zp_search_loc_bank < last_bank_num)
+	{
+		*(uint16_t*)ZP_COPY_LEN = BYTES_PER_BANK - 1;
+	}
+	else
+	{
+		*(uint16_t*)ZP_COPY_LEN = BYTES_PER_BANK - global_search_phrase_len;
+	}
+}
+
+
+// builds the multi-phrase search automaton for global_multi_search_phrases in the automaton bank, which App_EMForEachRun() has mapped in at the_window
+// returns false if the phrases need more than SEARCH_AUTOMATON_MAX_STATES states
+bool EM_BuildSearchAutomaton(uint8_t* the_window, uint16_t the_len, uint32_t phys_addr)
+{
+	uint8_t*	the_phrase = global_multi_search_phrases;
+	uint8_t*	parent = the_window + SEARCH_AUTOMATON_PARENT;
+	uint8_t*	label = the_window + SEARCH_AUTOMATON_LABEL;
+	uint8_t*	fail = the_window + SEARCH_AUTOMATON_FAIL;
+	uint8_t*	order = the_window + SEARCH_AUTOMATON_ORDER;
+	uint8_t*	value_class = the_window + SEARCH_AUTOMATON_VALUE_CLASS;
+	uint8_t*	fold = the_window + SEARCH_AUTOMATON_FOLD;
+	uint8_t*	matches = the_window + SEARCH_AUTOMATON_MATCHES;
+	uint8_t*	the_column;
+	uint16_t	column_addr;
+	uint8_t		phrase_len;
+	uint8_t		phrase_bit = 1;
+	uint8_t		num_states = 1;
+	uint8_t		num_classes = 1;
+	uint8_t		num_ordered = 1;
+	uint8_t		the_class;
+	uint8_t		the_value;
+	uint8_t		i;
+	uint8_t		s;
+	uint8_t		t;
+	uint8_t		b;
+	
+	// LOGIC:
+	//   this runs with the automaton bank mapped in, and uses the end of that bank as scratch space, so it needs no RAM of its own.
+	//   1) fold table: every byte maps to itself, or for ignore-case, A-Z map to a-z. phrases are folded as they go into the trie.
+	//   2) trie: state 0 is the root. each state knows its parent and the byte that reaches it. a phrase's last state gets its match bit.
+	//   3) byte classes: every distinct byte in the trie gets a class, and everything else is class 0. 
+	//      the class tables Memory_SearchBankForPhrases() reads are indexed by the raw byte, so the fold table costs nothing during the search.
+	//   4) failure links, in breadth-first order, so a state's match bits can pick up those of its failure state (phrases inside phrases).
+	//   5) transitions: one column per class, filled in breadth-first order. with no trie edge, a state does whatever its failure state does.
+	//      that turns the trie into a full state machine: exactly one lookup per byte of memory, no backing up.
+	
+	// 1) fold table
+	b = 0;
+	
+	do
+	{
+		fold[b] = (em_search_ignore_case == true && b >= 'A' && b <= 'Z') ? b + ('a' - 'A') : b;
+	} while (++b != 0);
+	
+	// 2) trie
+	memset(matches, 0, SEARCH_AUTOMATON_MAX_STATES);
+	
+	while ((phrase_len = *the_phrase++) != 0)
+	{
+		s = 0;
+		
+		for (i = 0; i < phrase_len; i++)
+		{
+			the_value = fold[*the_phrase++];
+			
+			for (t = 1; t < num_states; t++)
+			{
+				if (parent[t] == s && label[t] == the_value)
+				{
+					break;
+				}
+			}
+			
+			if (t == num_states)
+			{
+				if (num_states == SEARCH_AUTOMATON_MAX_STATES)
+				{
+					return false;
+				}
+				
+				parent[t] = s;
+				label[t] = the_value;
+				++num_states;
+			}
+			
+			s = t;
+		}
+		
+		matches[s] |= phrase_bit;
+		phrase_bit <<= 1;
+	}
+	
+	// 3) byte classes, and the tables that take a raw byte to its transition column
+	memset(value_class, 0, 256);
+	
+	for (t = 1; t < num_states; t++)
+	{
+		if (value_class[label[t]] == 0)
+		{
+			value_class[label[t]] = num_classes++;
+		}
+	}
+	
+	b = 0;
+	
+	do
+	{
+		column_addr = (uint16_t)the_window + SEARCH_AUTOMATON_TRANSITIONS + (uint16_t)value_class[fold[b]] * SEARCH_AUTOMATON_MAX_STATES;
+		the_window[SEARCH_AUTOMATON_CLASS_LO + b] = (uint8_t)column_addr;
+		the_window[SEARCH_AUTOMATON_CLASS_HI + b] = (uint8_t)(column_addr >> 8);
+	} while (++b != 0);
+	
+	// 4) breadth-first order, then failure links
+	order[0] = 0;
+	
+	for (i = 0; i < num_ordered; i++)
+	{
+		for (t = 1; t < num_states; t++)
+		{
+			if (parent[t] == order[i])
+			{
+				order[num_ordered++] = t;
+			}
+		}
+	}
+	
+	fail[0] = 0;
+	
+	for (i = 1; i < num_states; i++)
+	{
+		t = order[i];
+		s = parent[t];
+		fail[t] = 0;
+		
+		// follow the parent's failure links until one of them has an edge for this state's byte. children of the root fail to the root.
+		while (s != 0)
+		{
+			s = fail[s];
+			
+			for (b = 1; b < num_states; b++)
+			{
+				if (parent[b] == s && label[b] == label[t])
+				{
+					break;
+				}
+			}
+			
+			if (b < num_states)
+			{
+				fail[t] = b;
+				break;
+			}
+		}
+		
+		matches[t] |= matches[fail[t]];
+	}
+	
+	// 5) transitions
+	for (the_class = 0; the_class < num_classes; the_class++)
+	{
+		the_column = the_window + SEARCH_AUTOMATON_TRANSITIONS + (uint16_t)the_class * SEARCH_AUTOMATON_MAX_STATES;
+		memset(the_column, SEARCH_AUTOMATON_NO_EDGE, num_states);
+		
+		for (t = 1; t < num_states; t++)
+		{
+			if (value_class[label[t]] == the_class)
+			{
+				the_column[parent[t]] = t;
+			}
+		}
+		
+		for (i = 0; i < num_states; i++)
+		{
+			t = order[i];
+			
+			if (the_column[t] == SEARCH_AUTOMATON_NO_EDGE)
+			{
+				the_column[t] = (t == 0) ? 0 : the_column[fail[t]];
+			}
+		}
+	}
+	
+	return true;
+}
+
+
+
+
 /*****************************************************************************/
 /*                        Public Function Definitions                        */
 /*****************************************************************************/
@@ -466,156 +744,6 @@ void EM_DisplayAsText(uint8_t em_bank_num, uint8_t num_pages, char* the_name)
 }
 
 
-// displays the content found in EM as hex codes and text to right, similar to a ML monitor
-// em_bank_num is used to derive the base EM address
-// num_pages is the number of EM 256b pages that need displaying
-// the_name is only used to provide feedback to the user about what they are viewing
-void EM_DisplayAsHex(uint8_t em_bank_num, uint8_t num_pages, char* the_name)
-{
-	// LOGIC
-	//   Data must have already been loaded into EM at the em_bank_num specified
-	//   user can hit esc / runstop to stop at any time, or any other key to continue to the next screenful
-	//   for the 'address', we start at 0 assuming this is a file, and we are counting from start of file
-	//     but if the em_bank_num <> EM_STORAGE_START_PHYS_BANK_NUM, we're almost certainly viewing memory, in which case show calculated EM address
-	
-	// LOGIC
-	//   we only have 80x60 to work with, and we need a row for "hit space for more, esc to stop"
-	//     only 16 bytes of hex can be shown on one row of 80 chars (2 per byte + 1 space; plus 16 chars at right for view, plus addr at left)
-	//     so 59 rows * 16 bytes = 944 max bytes can be shown
-	//     we read 256 b chunks from EM, so we need about 3.7 chunks (59/16) per screenful.
-	//   we need 1 buffer:
-	//     1 to capture the 256b coming in from EM each EM read. we can peel off 16 byte slices of this for each row.
-
-	uint8_t		user_input;
-	uint8_t		rows_displayed_this_chunk;
-	uint8_t		n;
-	uint8_t		i = 0;
-	uint8_t		y = 0;
-	uint32_t	loc_in_file = 0x0000;	// will track the location within the file, so we can show to users on left side. 
-	bool		keep_going = true;
-	bool		user_exit = false;
-	bool		copy_again;
-	uint8_t*	copy_buffer;
-	uint8_t*	buffer_curr_loc;
-	
-	// primary local buffer will use 384b dedicated storage in the EM overlay (only needs 256 technically, but this gives us some flex)
-	copy_buffer = em_temp_buffer_384b;
-	
-	// are we showing a file on disk, or actually showing memory
-	if (em_bank_num == EM_STORAGE_START_PHYS_BANK_NUM)
-	{
-		loc_in_file = 0x0000;
-	}
-	else
-	{
-		loc_in_file = (uint32_t)((uint32_t)em_bank_num * (uint32_t)8192);
-	}
-	
-	// EM chunk read loop
-	while (keep_going == true && i < num_pages)
-	{
-		App_EMDataCopy(copy_buffer, em_bank_num, i++, PARAM_COPY_FROM_EM);
-
-		buffer_curr_loc = copy_buffer;
-		copy_again = false;
-		rows_displayed_this_chunk = 0;
-		
-		// process each chunk and any remainder from previous read cycle
-		do
-		{		
-			if (y == 0)
-			{
-				Text_ClearScreen(FILE_CONTENTS_FOREGROUND_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
-				sprintf(global_string_buff1, General_GetString(ID_STR_MSG_HEX_VIEW_INSTRUCTIONS), the_name);
-				Text_DrawStringAtXY(0, y++, global_string_buff1, FILE_CONTENTS_ACCENT_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
-				++y;
-			}
-			
-			// address display at left
-			Text_SetXY(1,y);
-			Text_SetChar('$');
-			Text_DrawByteAsHexChars( (uint8_t) ((loc_in_file >> 16 ) & 0xff));
-			Text_DrawByteAsHexChars( (uint8_t) ((loc_in_file >> 8 ) & 0xff));
-			Text_DrawByteAsHexChars( (uint8_t) (loc_in_file & 0xff));
-			Text_SetXY(11,y);
-// 			sprintf(global_string_buff1, "%06lX: ", loc_in_file);
-// 			Text_DrawStringAtXY(0, y, global_string_buff1, FILE_CONTENTS_ACCENT_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
-		
-			// main hex display in middle
-			for (n=0; n < HEX_DISPLAY_NUM_CHARS_PER_ROW; n++)
-			{
-				Text_DrawByteAsHexChars(buffer_curr_loc[n]);
-				Text_SetChar(CH_SPACE);
-			}
-			
-			// 'text' display at right
-			Text_SetChar(CH_SPACE);
-			Text_SetChar(CH_SPACE);
-			
-			for (n=0; n < HEX_DISPLAY_NUM_CHARS_PER_ROW; n++)
-			{
-				Text_SetChar(buffer_curr_loc[n]);
-			}
-// 			sprintf(global_string_buff1, "%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x  ", 
-// 				buffer_curr_loc[0], buffer_curr_loc[1], buffer_curr_loc[2], buffer_curr_loc[3], buffer_curr_loc[4], buffer_curr_loc[5], buffer_curr_loc[6], buffer_curr_loc[7], 
-// 				buffer_curr_loc[8], buffer_curr_loc[9], buffer_curr_loc[10], buffer_curr_loc[11], buffer_curr_loc[12], buffer_curr_loc[13], buffer_curr_loc[14], buffer_curr_loc[15]);
-// 			Text_DrawStringAtXY(MEM_DUMP_START_X_FOR_HEX, y, global_string_buff1, FILE_CONTENTS_FOREGROUND_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
-
-// 			// 'text' display at right
-// 			// render chars with char draw function to avoid problem of 0s getting treated as nulls in sprintf
-// 			Text_DrawCharsAtXY(MEM_DUMP_START_X_FOR_CHAR, y, (uint8_t*)buffer_curr_loc, MEM_DUMP_BYTES_PER_ROW);
-		
-			loc_in_file += MEM_DUMP_BYTES_PER_ROW;
-			buffer_curr_loc += MEM_DUMP_BYTES_PER_ROW;
-			++rows_displayed_this_chunk;
-			
-			// check if we need to ask user to go on to a new screen
-			++y;
-			
-			if (y == MAX_TEXT_VIEW_ROWS_PER_PAGE)
-			{
-				user_input = Keyboard_GetChar();
-				
-				if (user_input == CH_ESC || user_input == 'q' || user_input == CH_RUNSTOP)
-				{
-					keep_going = false;
-					user_exit = true;
-				}
-				else
-				{
-					y = 0;
-				}
-			}
-			
-			// check if we need to get more bytes from EM
-			if (rows_displayed_this_chunk > 15)
-			{
-				// whole chunk has now been displayed = we need to get another chunk
-				//sprintf(global_string_buff1, "need more data, i=%u", i);
-				//Buffer_NewMessage(global_string_buff1);
-				
-				if (i < num_pages)
-				{
-					copy_again = true;
-				}
-				else
-				{
-					// there isn't enough in copy buffer to fill a row, but also last chunk has already been read from EM
-					keep_going = false;					
-				}
-			}
-			
-		} while (copy_again == false && keep_going == true);		
-	}
-	
-	// if user hasn't already said they are done, give them a chance to look at the last displayed page
-	if (user_exit != true)
-	{
-		Keyboard_GetChar();
-	}
-}
-
-
 // searches memory starting at the passed bank num, for the sequence of characters found in global_search_phrase/len
 // global_search_phrase can be NULL terminated or not (null terminator will not be searched for; use byte string to find instead if important.
 // if new_search is false, it will start at the previous find position + 1. 
@@ -634,50 +762,35 @@ void EM_DisplayAsHex(uint8_t em_bank_num, uint8_t num_pages, char* the_name)
 bool EM_SearchMemory(bool new_search)
 {
 	// LOGIC
-	//       after detecting we have <(search-string-length) chars left, and more chunks to go, copy remainder to another 256b buffer. copy more in. process remainder buffer first.
+	//   the search itself is Memory_SearchBank(), in assembly. it looks at each bank in place, so nothing is copied into a buffer, 
+	//     and a phrase that runs over the end of a page or bank is just a longer compare.
+	//   Boyer-Moore-Horspool: line the phrase up, compare right to left, and on a mismatch slide the phrase along by however far 
+	//     the skip table says for the byte under its last char. the longer the phrase, the further most slides go.
+	//   one bank per call, so between banks we can check if user wants to stop.
 
 	uint32_t	find_location;
-	uint16_t	remain_len = 0;
-	uint16_t	this_remain_len;
-	uint8_t		i;
-	uint8_t		starting_offset;
-	uint8_t		this_temp_bank_num;
-	uint8_t		this_temp_page_num;
-	char*		this_phrase;
-	uint8_t*	buffer_curr_loc;
-	uint8_t*	copy_buffer = (uint8_t*)STORAGE_FILE_BUFFER_1;
-	uint8_t*	this_memory_loc;
 
 	DEBUG_OUT(("%s %d: search_len=%u, new_search=%u, first 6 of search phrase = %x%x%x%x%x%x", __func__ , __LINE__, global_search_phrase_len, new_search, global_search_phrase[0], global_search_phrase[1], global_search_phrase[2], global_search_phrase[3], global_search_phrase[4], global_search_phrase[5]));
 
 	// want to have this global flag start at false every time as there are multiple failure routes
 	global_find_next_enabled = false;
 
+	if (global_search_phrase_len == 0)
+	{
+		return false;
+	}
+	
 	// if this is a new search, leave zp1-3 as is. 
 	// if this is a find next operation, start at position immediately following the last good hit
 	if (new_search == false)
 	{
-		if (zp_search_loc_byte < 255)
+		if (++zp_search_loc_byte == 0)
 		{
-			++zp_search_loc_byte;
-		}
-		else
-		{
-			zp_search_loc_byte = 0;
-			
-			if (zp_search_loc_page < PAGES_PER_BANK)
-			{
-				++zp_search_loc_page;
-			}
-			else
+			if (++zp_search_loc_page == PAGES_PER_BANK)
 			{
 				zp_search_loc_page = 0;
 			
-				if (zp_search_loc_bank < NUM_MEMORY_BANKS)
-				{
-					++zp_search_loc_bank;
-				}
-				else
+				if (++zp_search_loc_bank >= NUM_MEMORY_BANKS)
 				{
 					// apparently last search ended on the last byte of system memory!
 					return false;
@@ -686,128 +799,277 @@ bool EM_SearchMemory(bool new_search)
 		}
 	}
 	
-	starting_offset = zp_search_loc_byte;
-	remain_len = 256 - starting_offset;
+	EM_PrepareSearch();
 
 	// bank loop
-	while (*(uint8_t*)ZP_SEARCH_LOC_BANK < NUM_MEMORY_BANKS) //NUM_MEMORY_BANKS
+	while (zp_search_loc_bank < NUM_MEMORY_BANKS)
 	{
+		EM_SetLastSearchPosition(NUM_MEMORY_BANKS - 1);
+		
+		if (Memory_SearchBank() != 0)
+		{
+			find_location = (uint32_t)((uint32_t)zp_search_loc_bank * (uint32_t)8192) + (uint32_t)zp_search_loc_page * 256 + zp_search_loc_byte;
+			sprintf(global_string_buff1, General_GetString(ID_STR_MSG_SEARCH_BANK_SUCCESS), global_search_phrase_human_readable, find_location, *(uint8_t*)ZP_SEARCH_LOC_BANK);
+			Buffer_NewMessage(global_string_buff1);
+			
+			return true;
+		}
 		
-		// page loop
-		while (*(uint8_t*)ZP_SEARCH_LOC_PAGE < PAGES_PER_BANK)
+		// give user a chance to stop search
+		if (Keyboard_GetKeyIfPressed() == CH_RUNSTOP)
 		{
-			App_EMDataCopy(copy_buffer, zp_search_loc_bank, zp_search_loc_page, PARAM_COPY_FROM_EM);
+			goto no_match;
+		}
+
+		zp_search_loc_byte = 0;
+		zp_search_loc_page = 0;
+		++zp_search_loc_bank;	// == bank number
+	}
 	
-			buffer_curr_loc = copy_buffer + starting_offset;
-			starting_offset = 0; // only need this on the first page we copy in
+no_match:
+	zp_search_loc_byte = 255;	// to make it doubly clear we didn't find anything
+	sprintf(global_string_buff1, General_GetString(ID_STR_MSG_SEARCH_BANK_FAILURE), global_search_phrase_human_readable);
+	Buffer_NewMessage(global_string_buff1);
+	return false;
+}
+
 
-			//DEBUG_OUT(("%s %d: remain_len=%u, buffer_curr_loc=%p", __func__ , __LINE__, remain_len, buffer_curr_loc ));
-			//DEBUG_OUT(("%s %d: ZP_SEARCH_LOC_BYTE=%x, ZP_SEARCH_LOC_PAGE=%x, ZP_SEARCH_LOC_BANK=%x", __func__ , __LINE__, zp_search_loc_byte, zp_search_loc_page, zp_search_loc_bank));
+// searches every bank from first_bank_num to last_bank_num, for every match to global_search_phrase/len
+// the physical address of each match is stored in the search results table in EM, up to SEARCH_RESULTS_MAX_HITS matches
+// uses the ZP_SEARCH_LOC_* bytes while working, so "find next" will not pick up where it left off afterwards
+// returns the number of matches stored
+uint16_t EM_SearchMemoryForAll(uint8_t first_bank_num, uint8_t last_bank_num)
+{
+	// LOGIC
+	//   one pass, using the same in-place Horspool search as EM_SearchMemory(). after each match, carry on from the next byte.
+	//   each match goes straight into the results table as a 4-byte physical address, so the count is only limited by the table.
+	//   user can stop between banks; whatever was found up to then is kept.
+	
+	uint16_t	num_hits = 0;
+	uint32_t	find_location;
+	
+	global_find_next_enabled = false;
+
+	if (global_search_phrase_len == 0)
+	{
+		return 0;
+	}
+	
+	EM_PrepareSearch();
+	
+	zp_search_loc_byte = 0;
+	zp_search_loc_page = 0;
+	zp_search_loc_bank = first_bank_num;
+
+	while (zp_search_loc_bank <= last_bank_num && num_hits < SEARCH_RESULTS_MAX_HITS)
+	{
+		EM_SetLastSearchPosition(last_bank_num);
+		
+		if (Memory_SearchBank() != 0)
+		{
+			find_location = (uint32_t)zp_search_loc_bank * BYTES_PER_BANK + (uint16_t)zp_search_loc_page * 256 + zp_search_loc_byte;
+			App_EMBulkCopy((uint8_t*)&find_location, SEARCH_RESULTS_PHYS_ADDR + (uint32_t)num_hits * sizeof(uint32_t), sizeof(uint32_t), PARAM_COPY_TO_EM);
+			++num_hits;
 			
-			// start compare, looking for first byte in memory that matches first byte of search
+			// carry on from the byte after the start of this match, unless that was the last byte of the bank
+			if (++zp_search_loc_byte != 0 || ++zp_search_loc_page != PAGES_PER_BANK)
+			{
+				continue;
+			}
+		}
+		
+		// give user a chance to stop search
+		if (Keyboard_GetKeyIfPressed() == CH_RUNSTOP)
+		{
+			break;
+		}
+
+		zp_search_loc_byte = 0;
+		zp_search_loc_page = 0;
+		++zp_search_loc_bank;
+	}
+	
+	if (num_hits < SEARCH_RESULTS_MAX_HITS)
+	{
+		sprintf(global_string_buff1, General_GetString(ID_STR_MSG_SEARCH_ALL_RESULT), num_hits, global_search_phrase_human_readable);
+	}
+	else
+	{
+		sprintf(global_string_buff1, General_GetString(ID_STR_MSG_SEARCH_ALL_TABLE_FULL), num_hits, global_search_phrase_human_readable);
+	}
+	
+	Buffer_NewMessage(global_string_buff1);
+	
+	return num_hits;
+}
+
+
+// searches every bank from first_bank_num to last_bank_num, in one pass, for every match to any of the phrases in global_multi_search_phrases
+// builds an Aho-Corasick automaton for the phrases in the automaton bank first. if ignore_case is true, A-Z and a-z match each other.
+// the physical address of each match, with its phrase number (1-8) in the top byte, is stored in the search results table in EM, up to SEARCH_RESULTS_MAX_HITS matches
+// returns the number of matches stored
+uint16_t EM_SearchMemoryForAllPhrases(uint8_t first_bank_num, uint8_t last_bank_num, bool ignore_case)
+{
+	// LOGIC
+	//   the automaton is built once, straight into its own bank. after that, every byte of memory is looked at exactly once, 
+	//     no matter how many phrases there are, so this is as fast for 8 phrases as for 1.
+	//   Memory_SearchBankForPhrases() stops on the last byte of any match. the match flags say which phrase(s) ended there, 
+	//     and each phrase's length gives back where it started. then carry on from the next byte, in the same automaton state.
+	//   the state carries from bank to bank too, so matches that cross a bank boundary are found.
+	//   user can stop between banks; whatever was found up to then is kept.
+	
+	uint16_t	num_hits = 0;
+	uint32_t	end_location;
+	uint32_t	find_location;
+	uint8_t		phrase_len[MAX_SEARCH_PHRASES];
+	uint8_t		num_phrases = 0;
+	uint8_t*	the_phrase = global_multi_search_phrases;
+	uint8_t		the_state = 0;
+	uint8_t		the_matches;
+	uint8_t		i;
+	
+	global_find_next_enabled = false;
+
+	while (*the_phrase != 0 && num_phrases < MAX_SEARCH_PHRASES)
+	{
+		phrase_len[num_phrases++] = *the_phrase;
+		the_phrase += *the_phrase + 1;
+	}
+	
+	if (num_phrases == 0)
+	{
+		return 0;
+	}
+	
+	em_search_ignore_case = ignore_case;
+	
+	App_MarkBanksChanged(SEARCH_AUTOMATON_PHYS_ADDR, BYTES_PER_BANK);
+	
+	if (App_EMForEachRun(SEARCH_AUTOMATON_PHYS_ADDR, BYTES_PER_BANK, &EM_BuildSearchAutomaton) == false)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_SEARCH_MULTI_PHRASES));
+		return 0;
+	}
+	
+	zp_search_loc_byte = 0;
+	zp_search_loc_page = 0;
+	zp_search_loc_bank = first_bank_num;
+
+	while (zp_search_loc_bank <= last_bank_num && num_hits < SEARCH_RESULTS_MAX_HITS)
+	{
+		*(uint8_t*)ZP_OTHER_PARAM = SEARCH_AUTOMATON_EM_SLOT;
+		*(uint8_t*)ZP_TEMP_1 = the_state;
+		the_matches = Memory_SearchBankForPhrases();
+		the_state = *(uint8_t*)ZP_TEMP_1;
+		
+		if (the_matches != 0)
+		{
+			end_location = (uint32_t)zp_search_loc_bank * BYTES_PER_BANK + (uint16_t)zp_search_loc_page * 256 + zp_search_loc_byte;
 			
-			for (; remain_len > 0; buffer_curr_loc++, --remain_len, ++zp_search_loc_byte)
+			for (i = 0; the_matches != 0 && num_hits < SEARCH_RESULTS_MAX_HITS; i++, the_matches >>= 1)
 			{
-				if (*buffer_curr_loc != *global_search_phrase)
-				{
-					continue;
-				}
-				
-				//DEBUG_OUT(("%s %d: match to first char %x found at curr_loc=%p (%06lx), remain_len=%i", __func__ , __LINE__, *global_search_phrase, buffer_curr_loc , (uint32_t)((uint32_t)zp_search_loc_bank * (uint32_t)8192) + (uint32_t)zp_search_loc_page * (uint32_t)256 + zp_search_loc_byte, remain_len));
-				// found match to first char
-				this_phrase = global_search_phrase;
-				this_memory_loc = buffer_curr_loc;
-				this_remain_len = remain_len;
-				
-				for (i = 1; i < global_search_phrase_len; ++i, --this_remain_len)
+				if (the_matches & 0x01)
 				{
-					++this_phrase;
-					++this_memory_loc;
-					
-					if (this_remain_len == 1)
-					{
-						//DEBUG_OUT(("%s %d: hit end of page while checking a potential match %c,%p,%i", __func__ , __LINE__, *this_phrase, this_memory_loc, i));
-						
-						if (i == global_search_phrase_len)
-						{
-							//DEBUG_OUT(("%s %d: ... but the last char of phrase was the last byte of page, so it's ok", __func__ , __LINE__));
-						}
-						else
-						{
-							//DEBUG_OUT(("%s %d: ... still have %u more chars to find, so need to pull in a new bank temporarily", __func__ , __LINE__, global_search_phrase_len - i));
-							// need to peek into the next bank, without throwing off zp #s. for all we know, this search is still going to fail (eg, we found "auto", phrase is "automobile", and first part of next bank is "matic", not "mobile".)
-							// can't destroy the current buffer for this reason, so we'll use a string buffer as the temp one.
-							
-							// but can't search past end of memory, so check that first
-							if (*(uint8_t*)ZP_SEARCH_LOC_BANK < NUM_MEMORY_BANKS || (*(uint8_t*)ZP_SEARCH_LOC_PAGE < PAGES_PER_BANK))
-							{
-								this_temp_bank_num = zp_search_loc_bank;
-								
-								// are we just going to the next page, or also to the next bank?
-								if (zp_search_loc_page < PAGES_PER_BANK)
-								{
-									this_temp_page_num = zp_search_loc_page + 1;
-								}
-								else
-								{
-									this_temp_page_num = 0;
-									++this_temp_bank_num;
-								}
-								App_EMDataCopy((uint8_t*)global_string_buff2, this_temp_bank_num, this_temp_page_num, PARAM_COPY_FROM_EM);
-								// now we can continue matching check
-								this_remain_len = 256;
-								this_memory_loc = (uint8_t*)global_string_buff2;
-							}
-							else
-							{
-								DEBUG_OUT(("%s %d: can't do a temp bank read, because we were on the last page of the bank of memory! zp3=%u, zp2=%u", __func__ , __LINE__, zp_search_loc_bank, zp_search_loc_page));
-								
-								goto no_match;
-							}
-						}
-					}
-					
-					if (*this_phrase != *this_memory_loc)
-					{
-						break;
-					}
-					//DEBUG_OUT(("%s %d: char match='%c' %x, i=%u", __func__ , __LINE__, *this_phrase, *this_phrase, i));
+					find_location = (end_location + 1 - phrase_len[i]) | ((uint32_t)(i + 1) << 24);
+					App_EMBulkCopy((uint8_t*)&find_location, SEARCH_RESULTS_PHYS_ADDR + (uint32_t)num_hits * sizeof(uint32_t), sizeof(uint32_t), PARAM_COPY_TO_EM);
+					++num_hits;
 				}
-				
-				if (i == global_search_phrase_len)
-				{
-					// all the chars must have matched
-					find_location = (uint32_t)((uint32_t)zp_search_loc_bank * (uint32_t)8192) + (uint32_t)zp_search_loc_page * 256 + zp_search_loc_byte;
-					sprintf(global_string_buff1, General_GetString(ID_STR_MSG_SEARCH_BANK_SUCCESS), global_search_phrase_human_readable, find_location, *(uint8_t*)ZP_SEARCH_LOC_BANK);
-					Buffer_NewMessage(global_string_buff1);
-					
-					return true;
-				}					
 			}
 			
-			// need to get another page of memory
-			remain_len = 256;
-
-			// give user a chance to stop search
-			if (Keyboard_GetKeyIfPressed() == CH_RUNSTOP)
+			// carry on from the byte after the end of this match, unless that was the last byte of the bank
+			if (++zp_search_loc_byte != 0 || ++zp_search_loc_page != PAGES_PER_BANK)
 			{
-				goto no_match;
+				continue;
 			}
-
-			++zp_search_loc_page;	// == page counter
-			*(uint8_t*)ZP_SEARCH_LOC_BYTE = 0;	// start the byte-in-page counter over again
 		}
 		
-		*(uint8_t*)ZP_SEARCH_LOC_PAGE = 0;	// start the page counter over again.
-		
-		++zp_search_loc_bank;	// == bank number
+		// give user a chance to stop search
+		if (Keyboard_GetKeyIfPressed() == CH_RUNSTOP)
+		{
+			break;
+		}
+
+		zp_search_loc_byte = 0;
+		zp_search_loc_page = 0;
+		++zp_search_loc_bank;
+	}
+	
+	if (num_hits < SEARCH_RESULTS_MAX_HITS)
+	{
+		sprintf(global_string_buff1, General_GetString(ID_STR_MSG_SEARCH_ALL_RESULT), num_hits, global_multi_search_human_readable);
+	}
+	else
+	{
+		sprintf(global_string_buff1, General_GetString(ID_STR_MSG_SEARCH_ALL_TABLE_FULL), num_hits, global_multi_search_human_readable);
 	}
 	
-no_match:
-	zp_search_loc_byte = 255;	// to make it doubly clear we didn't find anything
-	sprintf(global_string_buff1, General_GetString(ID_STR_MSG_SEARCH_BANK_FAILURE), global_search_phrase_human_readable);
 	Buffer_NewMessage(global_string_buff1);
-	return false;
+	
+	return num_hits;
 }
 
 
+// compares 2 banks of memory byte for byte, and stores each run of differing bytes in the results table
+// each entry has the offset in the bank of the first differing byte in its low 16 bits, and of the last one in its high 16 bits
+// up to SEARCH_RESULTS_MAX_HITS ranges are stored; any after that are not looked for
+// returns the number of ranges stored (0 if the banks are identical)
+uint16_t EM_CompareBanks(uint8_t em_bank_num, uint8_t compare_bank_num)
+{
+	// LOGIC
+	//   Memory_CompareBanks() has both banks mapped in at once, and runs through them a page at a time, so there is no copying at all.
+	//   it alternates between looking for the next byte that differs (the start of a range) and the next one that doesn't (just past its end).
+	//   if the bank ends while in a range, the range runs to the last byte of the bank.
+	
+	uint16_t	num_ranges = 0;
+	uint16_t	num_bytes = 0;
+	uint16_t	first_offset;
+	uint16_t	last_offset;
+	uint32_t	the_range;
+	bool		at_end = false;
+	
+	zp_search_loc_byte = 0;
+	zp_search_loc_page = 0;
+	zp_search_loc_bank = em_bank_num;
+	*(uint8_t*)ZP_OTHER_PARAM = compare_bank_num;
+	
+	while (at_end == false && num_ranges < SEARCH_RESULTS_MAX_HITS)
+	{
+		*(uint8_t*)ZP_TEMP_1 = PARAM_COMPARE_FIND_DIFFERENT;
+		
+		if (Memory_CompareBanks() == 0)
+		{
+			break;
+		}
+		
+		first_offset = (uint16_t)zp_search_loc_page * 256 + zp_search_loc_byte;
+		*(uint8_t*)ZP_TEMP_1 = PARAM_COMPARE_FIND_SAME;
+		
+		if (Memory_CompareBanks() == 0)
+		{
+			last_offset = BYTES_PER_BANK - 1;
+			at_end = true;
+		}
+		else
+		{
+			last_offset = (uint16_t)zp_search_loc_page * 256 + zp_search_loc_byte - 1;
+		}
+		
+		the_range = ((uint32_t)last_offset << 16) | first_offset;
+		App_EMBulkCopy((uint8_t*)&the_range, SEARCH_RESULTS_PHYS_ADDR + (uint32_t)num_ranges * sizeof(uint32_t), sizeof(uint32_t), PARAM_COPY_TO_EM);
+		++num_ranges;
+		num_bytes += last_offset - first_offset + 1;
+	}
+	
+	if (num_ranges == 0)
+	{
+		sprintf(global_string_buff1, General_GetString(ID_STR_MSG_COMPARE_IDENTICAL), em_bank_num, compare_bank_num);
+	}
+	else
+	{
+		sprintf(global_string_buff1, General_GetString(ID_STR_MSG_COMPARE_RESULT), num_bytes, em_bank_num, compare_bank_num, num_ranges);
+	}
+	
+	Buffer_NewMessage(global_string_buff1);
+	
+	return num_ranges;
+}
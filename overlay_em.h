@@ -32,6 +32,8 @@
 
 #define NUM_MEMORY_BANKS		0x80
 #define MAX_SEARCH_PHRASE_LEN	32	// arbitrary. 
+#define MAX_SEARCH_PHRASES		8	// for multi-phrase search: one bit per phrase in the automaton's match flags
+#define MAX_MULTI_SEARCH_INPUT_LEN	60	// all the phrases for a multi-phrase search, with | between them. short enough to keep the automaton within SEARCH_AUTOMATON_MAX_STATES
 
 #define PARAM_START_FROM_THIS_BANK		true	// parameter for EM_SearchMemory
 #define PARAM_START_AFTER_LAST_HIT		false	// parameter for EM_SearchMemory
@@ -60,12 +62,6 @@ char* EM_DisplayStringWithLineBreaks(char* the_message, uint8_t x, uint8_t y, ui
 // the_name is only used to provide feedback to the user about what they are viewing
 void EM_DisplayAsText(uint8_t em_bank_num, uint8_t num_pages, char* the_name);
 
-// displays the content found in EM as hex codes and text to right, similar to a ML monitor
-// em_bank_num is used to derive the base EM address
-// num_pages is the number of EM 256b chunks that need displaying
-// the_name is only used to provide feedback to the user about what they are viewing
-void EM_DisplayAsHex(uint8_t em_bank_num, uint8_t num_pages, char* the_name);
-
 // searches memory starting at the passed bank num, for the sequence of characters found in global_search_phrase/len
 // global_search_phrase can be NULL terminated or not (null terminator will not be searched for; use byte string to find instead if important.
 // if new_search is false, it will start at the previous find position + 1. 
@@ -83,4 +79,22 @@ void EM_DisplayAsHex(uint8_t em_bank_num, uint8_t num_pages, char* the_name);
 //    will set ZP_SEARCH_LOC_BANK to the bank the hit was found on (e.g, for hit at $A123: 5)
 bool EM_SearchMemory(bool new_search);
 
+// searches every bank from first_bank_num to last_bank_num, for every match to global_search_phrase/len
+// the physical address of each match is stored in the search results table in EM, up to SEARCH_RESULTS_MAX_HITS matches
+// uses the ZP_SEARCH_LOC_* bytes while working, so "find next" will not pick up where it left off afterwards
+// returns the number of matches stored
+uint16_t EM_SearchMemoryForAll(uint8_t first_bank_num, uint8_t last_bank_num);
+
+// searches every bank from first_bank_num to last_bank_num, in one pass, for every match to any of the phrases in global_multi_search_phrases
+// builds an Aho-Corasick automaton for the phrases in the automaton bank first. if ignore_case is true, A-Z and a-z match each other.
+// the physical address of each match, with its phrase number (1-8) in the top byte, is stored in the search results table in EM, up to SEARCH_RESULTS_MAX_HITS matches
+// returns the number of matches stored
+uint16_t EM_SearchMemoryForAllPhrases(uint8_t first_bank_num, uint8_t last_bank_num, bool ignore_case);
+
+// compares 2 banks of memory byte for byte, and stores each run of differing bytes in the results table
+// each entry has the offset in the bank of the first differing byte in its low 16 bits, and of the last one in its high 16 bits
+// up to SEARCH_RESULTS_MAX_HITS ranges are stored; any after that are not looked for
+// returns the number of ranges stored (0 if the banks are identical)
+uint16_t EM_CompareBanks(uint8_t em_bank_num, uint8_t compare_bank_num);
+
 #endif /* OVERLAY_EM_H_ */
@@ -0,0 +1,813 @@
+/*
+ * overlay_fileops.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ *
+ *  Routines for working on many files at once: marking files by name, and the other multi-file jobs
+ *    also keeps track of free space on each drive, so a copy or save that can't fit is refused before it starts
+ *    these sit alongside folder.c and file.c, which live in the DISKSYS overlay and have no room left
+ *    nothing here may call into DISKSYS (Folder_*, File_*): both overlays use the same CPU bank, so only one can be mapped in at a time
+ *    the file mark bitsets belong to folder.c, and live in MAIN, so both overlays can get at them
+ *
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "overlay_fileops.h"
+#include "app.h"
+#include "comm_buffer.h"
+#include "debug.h"
+#include "dirent.h"
+#include "file.h"
+#include "folder.h"
+#include "general.h"
+#include "kernel.h"
+#include "list.h"
+#include "screen.h"
+#include "strings.h"
+#include "text.h"
+
+// C includes
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// F256 includes
+#include "f256.h"
+
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                           File-scope Variables                            */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern uint8_t				global_marked_files[NUM_PANELS][FOLDER_MARK_BITSET_SIZE];
+extern uint8_t				global_unmarkable_files[NUM_PANELS][FOLDER_MARK_BITSET_SIZE];
+
+extern char*				global_temp_path_1;
+extern char*				global_temp_path_2;
+extern char*				global_retrieved_em_filename;
+extern char*				global_string_buff1;
+
+extern int32_t				global_free_bytes_on_disk[DEVICE_MAX_DEVICE_COUNT];
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// returns true if the_name matches the_pattern. '*' matches any run of characters (including none), '?' matches any 1 character. not case sensitive.
+bool FileOps_NameMatchesPattern(const char* the_name, const char* the_pattern);
+
+// deletes the file or empty folder at the_path. same as File_Delete(), which can't be called from here.
+bool FileOps_DeletePath(char* the_path, bool is_directory);
+
+// returns true if the passed file is marked. same as Folder_IsFileMarked(), which can't be called from here.
+bool FileOps_IsFileMarked(WB2KFileObject* the_file);
+
+// unmarks the passed file. same as Folder_SetFileMark(the_file, false), which can't be called from here.
+void FileOps_UnmarkFile(WB2KFileObject* the_file);
+
+// returns true if the folder's file list has a file with the passed name (not case sensitive)
+bool FileOps_FolderHasFileNamed(WB2KFolderObject* the_folder, const char* the_file_name);
+
+// moves the named file or folder out of the_folder and into the target folder by renaming it. source and target must be on the same device.
+// the target folder is the_target_parent_path + the_target_subfolder_name (pass "" to use the parent path as-is)
+// returns false if the kernel refused the rename, or if a folder would be moved inside itself
+bool FileOps_MoveFileByRename(WB2KFolderObject* the_folder, const char* the_file_name, bool is_directory, char* the_target_parent_path, char* the_target_subfolder_name);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// returns true if the_name matches the_pattern. '*' matches any run of characters (including none), '?' matches any 1 character. not case sensitive.
+bool FileOps_NameMatchesPattern(const char* the_name, const char* the_pattern)
+{
+	const char*		star_in_pattern = NULL;
+	const char*		name_at_star;
+	
+	// LOGIC:
+	//   walk both strings together. on a '*', remember where it was and where we were in the name.
+	//   on a mismatch after a '*', let the '*' swallow 1 more char of the name and try again from just after it.
+	//   no recursion, and each char of the name is revisited at most once per '*', so it's cheap enough for filenames.
+	
+	while (*the_name)
+	{
+		if (*the_pattern == '*')
+		{
+			star_in_pattern = ++the_pattern;
+			name_at_star = the_name;
+		}
+		else if (*the_pattern == '?' || General_ToLower(*the_pattern) == General_ToLower(*the_name))
+		{
+			++the_pattern;
+			++the_name;
+		}
+		else if (star_in_pattern != NULL)
+		{
+			the_pattern = star_in_pattern;
+			the_name = ++name_at_star;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	
+	// name is used up: only trailing '*'s can be left in the pattern
+	while (*the_pattern == '*')
+	{
+		++the_pattern;
+	}
+	
+	return (*the_pattern == '\0');
+}
+
+
+// deletes the file or empty folder at the_path. same as File_Delete(), which can't be called from here.
+bool FileOps_DeletePath(char* the_path, bool is_directory)
+{
+	bool	success = false;
+	
+	if (is_directory)
+	{
+		success = Kernel_DeleteFolder(the_path);
+	}
+	
+	// kernel doesn't actually detect folders, it just sets anything to directory if it has size=0. so try again as a file.
+	if (success == false)
+	{
+		success = Kernel_DeleteFile(the_path);
+	}
+	
+	if (success == false)
+	{
+		LOG_ERR(("%s %d: not able to delete '%s'", __func__ , __LINE__, the_path));
+	}
+	
+	return success;
+}
+
+
+// returns true if the passed file is marked. same as Folder_IsFileMarked(), which can't be called from here.
+bool FileOps_IsFileMarked(WB2KFileObject* the_file)
+{
+	return ((global_marked_files[the_file->panel_id_][the_file->id_ >> 3] & (1 << (the_file->id_ & 0x07))) != 0);
+}
+
+
+// unmarks the passed file. same as Folder_SetFileMark(the_file, false), which can't be called from here.
+void FileOps_UnmarkFile(WB2KFileObject* the_file)
+{
+	global_marked_files[the_file->panel_id_][the_file->id_ >> 3] &= ~(1 << (the_file->id_ & 0x07));
+}
+
+
+// returns true if the folder's file list has a file with the passed name (not case sensitive)
+bool FileOps_FolderHasFileNamed(WB2KFolderObject* the_folder, const char* the_file_name)
+{
+	uint16_t	the_compare_len = General_Strnlen(the_file_name, FILE_MAX_FILENAME_SIZE);
+	WB2KList*	the_item;
+	
+	// LOGIC:
+	//   same test as Folder_FindListItemByFileName(), which can't be called from here.
+	//   App_GetFilenameFromEM() reuses 1 buffer, so the_file_name must not point into it.
+	
+	the_item = *(the_folder->list_);
+
+	while (the_item != NULL)
+	{
+		App_GetFilenameFromEM((WB2KFileObject*)(the_item->payload_));
+		
+		if (General_Strnlen(global_retrieved_em_filename, FILE_MAX_FILENAME_SIZE) == the_compare_len && 
+			General_Strncasecmp(the_file_name, global_retrieved_em_filename, the_compare_len) == 0)
+		{
+			return true;
+		}
+
+		the_item = the_item->next_item_;
+	}
+	
+	return false;
+}
+
+
+// moves the named file or folder out of the_folder and into the target folder by renaming it. source and target must be on the same device.
+// the target folder is the_target_parent_path + the_target_subfolder_name (pass "" to use the parent path as-is)
+// returns false if the kernel refused the rename, or if a folder would be moved inside itself
+bool FileOps_MoveFileByRename(WB2KFolderObject* the_folder, const char* the_file_name, bool is_directory, char* the_target_parent_path, char* the_target_subfolder_name)
+{
+	uint16_t	path_len;
+	
+	// LOGIC:
+	//   rename only rewrites the directory entries, so this costs the same for a 2 MB file as for a 2 byte one.
+	//   the kernel will happily move a folder into its own sub-folder, leaving it unreachable, so check for that first:
+	//     if the whole source path (followed by a separator or the end) starts the target folder path, refuse.
+	
+	General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_folder->file_path_, (char*)the_file_name);
+	General_CreateFilePathFromFolderAndFile(global_temp_path_2, the_target_parent_path, the_target_subfolder_name);
+	
+	if (is_directory)
+	{
+		path_len = General_Strnlen(global_temp_path_1, FILE_MAX_PATHNAME_SIZE);
+		
+		if (General_Strncasecmp(global_temp_path_2, global_temp_path_1, path_len) == 0 && (global_temp_path_2[path_len] == '/' || global_temp_path_2[path_len] == '\0'))
+		{
+			LOG_INFO(("%s %d: can't move folder '%s' into itself ('%s')", __func__ , __LINE__, global_temp_path_1, global_temp_path_2));
+			return false;
+		}
+	}
+	
+	// add the file name on to the target folder path. a disk root ("0:") doesn't get a separator.
+	path_len = General_Strnlen(global_temp_path_2, FILE_MAX_PATHNAME_SIZE);
+	
+	if (path_len != 2)
+	{
+		global_temp_path_2[path_len++] = '/';
+		global_temp_path_2[path_len] = '\0';
+	}
+	
+	General_Strlcat(global_temp_path_2, the_file_name, FILE_MAX_PATHNAME_SIZE);
+	
+	if (rename(global_temp_path_1, global_temp_path_2) < 0)
+	{
+		LOG_INFO(("%s %d: kernel could not rename '%s' to '%s'", __func__ , __LINE__, global_temp_path_1, global_temp_path_2));
+		return false;
+	}
+	
+	return true;
+}
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// **** MARKING (MULTI-SELECT) FUNCTIONS *****
+
+
+// marks all, unmarks all, or inverts the marks of all files in the folder, depending on the_mark_action (PARAM_MARK_ALL, etc.)
+// does not re-render
+void FileOps_SetAllFileMarks(WB2KFolderObject* the_folder, uint8_t the_mark_action)
+{
+	uint8_t		i;
+	uint8_t*	the_marks;
+	uint8_t*	the_unmarkables;
+	
+	if (the_folder == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		App_Exit(ERROR_FOLDER_WAS_NULL);	// crash early, crash often
+	}
+	
+	the_marks = global_marked_files[the_folder->panel_id_];
+	
+	if (the_mark_action == PARAM_MARK_NONE)
+	{
+		memset(the_marks, 0, FOLDER_MARK_BITSET_SIZE);
+		return;
+	}
+	
+	// LOGIC:
+	//   work 8 files at a time, 1 byte of the bitset per pass.
+	//   bits for navigation entries ('..'), and for ids no file is using (past the end of the list, or deleted), are always left clear.
+	
+	the_unmarkables = global_unmarkable_files[the_folder->panel_id_];
+	
+	for (i = 0; i < FOLDER_MARK_BITSET_SIZE; i++)
+	{
+		if (the_mark_action == PARAM_MARK_ALL)
+		{
+			the_marks[i] = ~the_unmarkables[i];
+		}
+		else
+		{
+			the_marks[i] = ~(the_marks[i] | the_unmarkables[i]);
+		}
+	}
+}
+
+
+// marks every file whose name matches the passed wildcard pattern ('*' = any run of characters, '?' = any 1 character; not case sensitive)
+// already-marked files stay marked. does not re-render.
+// returns the number of files that matched the pattern
+uint16_t FileOps_MarkFilesByPattern(WB2KFolderObject* the_folder, const char* the_pattern)
+{
+	uint16_t	the_count = 0;
+	uint8_t		the_byte;
+	uint8_t		the_mask;
+	uint8_t*	the_marks;
+	uint8_t*	the_unmarkables;
+	WB2KList*	the_item;
+	
+	if (the_folder == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		App_Exit(ERROR_FOLDER_WAS_NULL);	// crash early, crash often
+	}
+	
+	the_marks = global_marked_files[the_folder->panel_id_];
+	the_unmarkables = global_unmarkable_files[the_folder->panel_id_];
+	the_item = *(the_folder->list_);
+
+	while (the_item != NULL)
+	{
+		WB2KFileObject*		this_file = (WB2KFileObject*)(the_item->payload_);
+
+		// same as Folder_SetFileMark(), which can't be called from here: skip navigation entries
+		the_byte = this_file->id_ >> 3;
+		the_mask = 1 << (this_file->id_ & 0x07);
+		
+		if ((the_unmarkables[the_byte] & the_mask) == 0 && FileOps_NameMatchesPattern(App_GetFilenameFromEM(this_file), the_pattern) == true)
+		{
+			the_marks[the_byte] |= the_mask;
+			++the_count;
+		}
+
+		the_item = the_item->next_item_;
+	}
+	
+	return the_count;
+}
+
+
+
+// **** DELETE FUNCTIONS *****
+
+
+// deletes every marked file and folder (with all its contents) from disk, in list order, stopping at the first one that can't be deleted
+// the_marked_count is only used to move the progress bar. y_offset is the first displayable row of the panel.
+// blanks each file's row on screen as it goes, but does not touch the folder's file list: 
+//   caller should pass the returned count to Folder_RemoveMarkedFiles(), then re-display the panel.
+// returns the number of marked files that were deleted
+uint16_t FileOps_DeleteMarkedFiles(WB2KFolderObject* the_folder, uint16_t the_marked_count, uint8_t y_offset)
+{
+	uint16_t	num_files = 0;
+	uint32_t	percent_done;
+	WB2KList*	the_item;
+
+	if (the_folder == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		App_Exit(ERROR_FOLDER_WAS_NULL);	// crash early, crash often
+	}
+
+	// LOGIC:
+	//   1 progress bar for the whole job, advanced once per marked item. (we can't know how many files are inside marked folders without walking them twice)
+	//   each row is blanked as soon as its file is gone from disk, so the user sees the job progress.
+	//   File_Destroy() etc. are in DISKSYS, so the list is left alone here. files are deleted in list order, 
+	//     so the first num_files marked items in the list are exactly the ones that are gone.
+	
+	if (the_marked_count == 0)
+	{
+		return 0;
+	}
+	
+	App_ShowProgressBar();
+
+	the_item = *(the_folder->list_);
+
+	while (the_item != NULL)
+	{
+		WB2KFileObject*		this_file = (WB2KFileObject*)(the_item->payload_);
+
+		if (FileOps_IsFileMarked(this_file) == true)
+		{
+			General_CreateFilePathFromFolderAndFile(global_temp_path_1, the_folder->file_path_, App_GetFilenameFromEM(this_file));
+			
+			// meatloaf "folders" are links on the server, not something we can walk and empty
+			if (this_file->is_directory_ && the_folder->is_meatloaf_ == false)
+			{
+				if (FileOps_DeleteFolderTree(global_temp_path_1) == false)
+				{
+					break;
+				}
+			}
+			else if (FileOps_DeletePath(global_temp_path_1, this_file->is_directory_) == false)
+			{
+				break;
+			}
+			
+			if (this_file->display_row_ != -1)
+			{
+				Text_FillBox(this_file->x_, this_file->display_row_ + y_offset, this_file->x_ + (UI_PANEL_INNER_WIDTH - 1), this_file->display_row_ + y_offset, CH_SPACE, LIST_INACTIVE_COLOR, APP_BACKGROUND_COLOR);
+			}
+			
+			++num_files;
+			percent_done = ((uint32_t)num_files * 100) / (uint32_t)the_marked_count;
+			App_UpdateProgressBar((uint8_t)percent_done);
+		}
+
+		the_item = the_item->next_item_;
+	}
+	
+	App_HideProgressBar();
+	
+	return num_files;
+}
+
+
+// deletes the folder at the_path, and every file and folder inside it. 
+// the_path is used as the working buffer while walking the tree: on failure, it will hold the path of the item that could not be deleted.
+// returns false on the first file or folder that could not be deleted
+bool FileOps_DeleteFolderTree(char* the_path)
+{
+	uint8_t			depth = 0;
+	uint8_t			path_len_stack[FILEOPS_MAX_DELETE_DEPTH];	// length of the_path at each level above the current one, to pop back to
+	uint16_t		path_len;
+	bool			entry_is_dir;
+	char*			this_name;
+	struct DIR*		dir;
+	struct dirent*	dirent;
+
+	// LOGIC:
+	//   depth-first, with an explicit stack instead of recursion (the cc65 C stack is small, and each level would need its own path buffer).
+	//   the_path itself holds the stack of folder names; path_len_stack holds where each level's name starts, so going up is just a truncate.
+	//   we can't count on the kernel to keep reading a directory while entries are deleted from it, so for each pass:
+	//     open the current folder, read up to its first real entry, and close it again.
+	//     if the entry is a file, delete it. if it's a folder, push it and make it the current folder.
+	//     if there was no entry, the current folder is empty: delete it and pop back to its parent.
+	//   every pass deletes one thing or goes one level down, so the job always ends. a failed delete stops it rather than retrying forever.
+	//   the kernel reports any 0-byte file as a folder: opening that will fail, it will look empty, and FileOps_DeletePath() will fall back to deleting it as a file.
+	
+	for (;;)
+	{
+		this_name = NULL;
+		
+		if ( (dir = Kernel_OpenDir(the_path)) != NULL)
+		{
+			while ( (dirent = Kernel_ReadDir(dir)) != NULL)
+			{
+				// skip the volume label, and the "." and ".." entries.
+				if (_DE_ISLBL(dirent->d_type) || 
+					(dirent->d_name[0] == '.' && (dirent->d_name[1] == 0 || (dirent->d_name[1] == '.' && dirent->d_name[2] == 0))))
+				{
+					continue;
+				}
+				
+				// dirent is static in Kernel_ReadDir(), so the name is still good after closing the dir
+				this_name = dirent->d_name;
+				entry_is_dir = _DE_ISDIR(dirent->d_type);
+				break;
+			}
+
+			Kernel_CloseDir(dir);
+		}
+		
+		if (this_name == NULL)
+		{
+			// current folder is empty: delete it, and go back up a level
+			if (FileOps_DeletePath(the_path, true) == false)
+			{
+				return false;
+			}
+			
+			if (depth == 0)
+			{
+				return true;
+			}
+			
+			the_path[path_len_stack[--depth]] = '\0';
+			continue;
+		}
+		
+		// build path to the entry
+		path_len = General_Strnlen(the_path, FILE_MAX_PATHNAME_SIZE);
+		
+		if (path_len + General_Strnlen(this_name, FILE_MAX_FILENAME_SIZE) + 2 > FILE_MAX_PATHNAME_SIZE)
+		{
+			LOG_ERR(("%s %d: path too long under '%s'", __func__ , __LINE__, the_path));
+			return false;
+		}
+		
+		the_path[path_len] = '/';
+		General_Strlcpy(the_path + path_len + 1, this_name, FILE_MAX_PATHNAME_SIZE - path_len - 1);
+		
+		if (entry_is_dir)
+		{
+			if (depth == FILEOPS_MAX_DELETE_DEPTH)
+			{
+				LOG_ERR(("%s %d: folders nested too deeply at '%s'", __func__ , __LINE__, the_path));
+				return false;
+			}
+			
+			path_len_stack[depth++] = path_len;
+		}
+		else
+		{
+			if (FileOps_DeletePath(the_path, false) == false)
+			{
+				return false;
+			}
+			
+			the_path[path_len] = '\0';
+		}
+	}
+}
+
+
+
+// **** MOVE FUNCTIONS *****
+
+
+// moves every marked file and folder into the target folder by renaming it, and unmarks each one that was moved
+// source and target folders must be on the same device. 
+// files the kernel won't rename, or with a name already used in the target, are left marked: caller can copy+delete those instead.
+// returns the number of files moved
+int16_t FileOps_MoveMarkedFilesByRename(WB2KFolderObject* the_folder, WB2KFolderObject* the_target_folder)
+{
+	int16_t			num_files = 0;
+	char			the_file_name[FILE_MAX_FILENAME_SIZE];
+	WB2KList*		the_item;
+
+	// LOGIC:
+	//   on the same device, a move is just a rename of the directory entry: no data is read or written, however big the file.
+	//   this is the only way folders can be moved, as Folder_CopyFile can't copy them yet.
+	//   if the target already has a file of that name, rename would fail, so leave it for copy, which picks a unique name.
+	
+	if (the_folder == NULL || the_target_folder == NULL)
+	{
+		LOG_ERR(("%s %d: the source and/or target folder was NULL", __func__ , __LINE__));
+		App_Exit(ERROR_FOLDER_WAS_NULL);	// crash early, crash often
+	}
+
+	the_item = *(the_folder->list_);
+
+	while (the_item != NULL)
+	{
+		WB2KFileObject*		this_file = (WB2KFileObject*)(the_item->payload_);
+
+		if (FileOps_IsFileMarked(this_file) == true)
+		{
+			General_Strlcpy(the_file_name, App_GetFilenameFromEM(this_file), FILE_MAX_FILENAME_SIZE);
+			
+			if (FileOps_FolderHasFileNamed(the_target_folder, the_file_name) == false && 
+				FileOps_MoveFileByRename(the_folder, the_file_name, this_file->is_directory_, the_target_folder->file_path_, "") == true)
+			{
+				FileOps_UnmarkFile(this_file);
+				++num_files;
+			}
+		}
+
+		the_item = the_item->next_item_;
+	}
+
+	return num_files;
+}
+
+
+// moves every marked file and folder into the_target_folder_file, a folder in the same folder, by renaming it
+// use when both panels show the same folder, and you only have a target folder file, not a full folder object to work with.
+// returns -1 in event of error, or count of files moved
+int16_t FileOps_MoveMarkedFilesToFolderFile(WB2KFolderObject* the_folder, WB2KFileObject* the_target_folder_file)
+{
+	int16_t			num_files = 0;
+	char			the_target_name[FILE_MAX_FILENAME_SIZE];
+	char			the_file_name[FILE_MAX_FILENAME_SIZE];
+	WB2KList*		the_item;
+
+	// LOGIC:
+	//   the target folder is a folder in the_folder, so everything is on the same device: every move is a rename.
+	//   with no folder object for the target, we can't check it for name clashes: the kernel will refuse the rename instead, and we stop there.
+	//   the target folder itself is skipped if it is marked. compare by name: the target file object may come from the other panel's copy of this folder.
+
+	if (the_folder == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		App_Exit(ERROR_FOLDER_WAS_NULL);	// crash early, crash often
+	}
+
+	if (the_target_folder_file == NULL)
+	{
+		LOG_ERR(("%s %d: the target folder file was NULL", __func__ , __LINE__));
+		return -1;
+	}
+
+	// get our own copy of the target folder's name: the EM filename buffer will be reused for each file moved
+	General_Strlcpy(the_target_name, App_GetFilenameFromEM(the_target_folder_file), FILE_MAX_FILENAME_SIZE);
+	
+	the_item = *(the_folder->list_);
+
+	while (the_item != NULL)
+	{
+		WB2KFileObject*		this_file = (WB2KFileObject*)(the_item->payload_);
+
+		if (FileOps_IsFileMarked(this_file) == true)
+		{
+			General_Strlcpy(the_file_name, App_GetFilenameFromEM(this_file), FILE_MAX_FILENAME_SIZE);
+			
+			if (strcmp(the_file_name, the_target_name) != 0)
+			{
+				if (FileOps_MoveFileByRename(the_folder, the_file_name, this_file->is_directory_, the_folder->file_path_, the_target_name) == false)
+				{
+					LOG_ERR(("%s %d: Move action failed with file '%s'", __func__ , __LINE__, the_file_name));
+					return -1;
+				}
+
+				FileOps_UnmarkFile(this_file);
+				++num_files;
+			}
+		}
+
+		the_item = the_item->next_item_;
+	}
+
+	return num_files;
+}
+
+
+
+// **** FREE SPACE FUNCTIONS *****
+
+
+// remember the free space the kernel reported the last time a directory on the specified disk drive was read to the end
+// call after every full directory read, so the amount shown in the panel header stays current
+// if the kernel had no free record for the drive, that is remembered as FILE_FREE_BYTES_NOT_REPORTED until the next full read
+void FileOps_RememberFreeBytesOnDisk(uint8_t the_device_number)
+{
+	int32_t		the_free_blocks;
+	uint16_t	the_block_size;
+	
+	if (the_device_number >= DEVICE_MAX_DEVICE_COUNT)
+	{
+		return;
+	}
+	
+	the_free_blocks = Kernel_GetFreeBlocks(the_device_number);
+	
+	if (the_free_blocks < 0)
+	{
+		global_free_bytes_on_disk[the_device_number] = FILE_FREE_BYTES_NOT_REPORTED;
+		return;
+	}
+	
+	the_block_size = (the_device_number == 0 ? FILE_BYTES_PER_BLOCK : FILE_BYTES_PER_BLOCK_IEC);
+	
+	// an SD card can have more free space than fits in 31 bits. anything that big is "plenty" for our purposes.
+	if (the_free_blocks > FILE_FREE_BYTES_MAX / the_block_size)
+	{
+		global_free_bytes_on_disk[the_device_number] = FILE_FREE_BYTES_MAX;
+	}
+	else
+	{
+		global_free_bytes_on_disk[the_device_number] = the_free_blocks * the_block_size;
+	}
+}
+
+
+// get the free space on the specified disk drive, in bytes
+// uses the amount remembered from the last time a directory on that drive was read, and only reads the drive's root directory if there isn't one
+// returns FILE_FREE_BYTES_UNKNOWN if the drive doesn't report its free space, or in event of error
+int32_t FileOps_GetFreeBytesOnDisk(uint8_t the_device_number)
+{
+	DIR*		dir;
+	char		drive_path[3];
+	char*		the_drive_path = drive_path;
+	
+	// LOGIC:
+	//   the kernel reports free space as a "free" record at the end of every directory listing, so any full read of a directory updates it.
+	//   Panel_Refresh does one of those every time a disk panel is refreshed, so normally the amount is already known.
+	//   if it isn't, the root directory of the drive is the smallest thing we can be sure exists. on a 1541, this still takes a few seconds.
+	//   some drives never send a free record. that is remembered too (FILE_FREE_BYTES_NOT_REPORTED), so they aren't read again on every copy or save.
+	
+	if (the_device_number >= DEVICE_MAX_DEVICE_COUNT || global_free_bytes_on_disk[the_device_number] == FILE_FREE_BYTES_NOT_REPORTED)
+	{
+		return FILE_FREE_BYTES_UNKNOWN;
+	}
+	
+	if (global_free_bytes_on_disk[the_device_number] != FILE_FREE_BYTES_UNKNOWN)
+	{
+		return global_free_bytes_on_disk[the_device_number];
+	}
+	
+	sprintf(the_drive_path, "%u:", the_device_number);
+	
+	if ( (dir = Kernel_OpenDir(the_drive_path)) == NULL)
+	{
+		return FILE_FREE_BYTES_UNKNOWN;
+	}
+	
+	while (Kernel_ReadDir(dir) != NULL)
+	{
+		// just reading to the end, where the free record is
+	}
+	
+	Kernel_CloseDir(dir);
+	
+	FileOps_RememberFreeBytesOnDisk(the_device_number);
+	
+	if (global_free_bytes_on_disk[the_device_number] == FILE_FREE_BYTES_NOT_REPORTED)
+	{
+		return FILE_FREE_BYTES_UNKNOWN;
+	}
+	
+	return global_free_bytes_on_disk[the_device_number];
+}
+
+
+// returns the number of bytes a file of the passed size will take up on the specified disk drive, counting the unused part of its last block
+uint32_t FileOps_GetSizeOnDisk(uint8_t the_device_number, uint32_t the_size)
+{
+	uint16_t	the_block_size;
+	
+	// account for FAT32 sectors vs IEC blocks, same as when estimating file size from a directory listing
+	if (the_device_number == 0)
+	{
+		the_block_size = FILE_BYTES_PER_BLOCK;
+	}
+	else
+	{
+		the_block_size = FILE_BYTES_PER_BLOCK_IEC;
+	}
+	
+	return ((the_size + the_block_size - 1) / the_block_size) * the_block_size;
+}
+
+
+// checks whether the specified disk drive has room for the passed number of bytes, before starting a long write
+// shows an error message and returns false if it does not. returns true if it does, or if the drive doesn't report its free space
+bool FileOps_CheckRoomOnDisk(uint8_t the_device_number, uint32_t the_bytes_needed)
+{
+	int32_t		the_bytes_free;
+	
+	the_bytes_free = FileOps_GetFreeBytesOnDisk(the_device_number);
+	
+	// if the drive can't tell us, let the write go ahead: it will fail at the point where the disk fills up, same as always
+	if (the_bytes_free == FILE_FREE_BYTES_UNKNOWN || the_bytes_needed <= (uint32_t)the_bytes_free)
+	{
+		return true;
+	}
+	
+	sprintf(global_string_buff1, General_GetString(ID_STR_ERROR_NOT_ENOUGH_ROOM), the_bytes_needed, (uint32_t)the_bytes_free);
+	Buffer_NewMessage(global_string_buff1);
+	
+	return false;
+}
+
+
+// checks that the target folder's disk has room for all the marked files, or for the current file if none are marked
+// folders are not counted, as they are not copied. shows an error message and returns false if there isn't room
+bool FileOps_CheckRoomForMarkedFiles(WB2KFolderObject* the_folder, WB2KFolderObject* the_target_folder)
+{
+	uint32_t			bytes_needed = 0;
+	bool				use_marks = false;
+	WB2KList*			the_item;
+	WB2KFileObject*		this_file;
+
+	if (the_folder == NULL || the_target_folder == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		App_Exit(ERROR_FOLDER_WAS_NULL);	// crash early, crash often
+	}
+
+	// LOGIC:
+	//   add up the whole job before writing anything, so a copy that can't fit fails right away instead of minutes in.
+	//   each file is rounded up to whole blocks of the target drive, as that is what it will really use there.
+	
+	the_item = *(the_folder->list_);
+
+	while (the_item != NULL && use_marks == false)
+	{
+		use_marks = FileOps_IsFileMarked((WB2KFileObject*)(the_item->payload_));
+		the_item = the_item->next_item_;
+	}
+	
+	the_item = *(the_folder->list_);
+
+	while (the_item != NULL)
+	{
+		this_file = (WB2KFileObject*)(the_item->payload_);
+
+		if (this_file->is_directory_ == false)
+		{
+			if ( (use_marks == true && FileOps_IsFileMarked(this_file) == true) || (use_marks == false && this_file->selected_ == true) )
+			{
+				bytes_needed += FileOps_GetSizeOnDisk(the_target_folder->device_number_, this_file->size_);
+			}
+		}
+
+		the_item = the_item->next_item_;
+	}
+	
+	return FileOps_CheckRoomOnDisk(the_target_folder->device_number_, bytes_needed);
+}
@@ -0,0 +1,119 @@
+/*
+ * overlay_fileops.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef OVERLAY_FILEOPS_H_
+#define OVERLAY_FILEOPS_H_
+
+/* about this class
+ *
+ *  Routines for working on many files at once: marking files by name, and the other multi-file jobs
+ *    also keeps track of free space on each drive, so a copy or save that can't fit is refused before it starts
+ *    these sit alongside folder.c and file.c, which live in the DISKSYS overlay and have no room left
+ *    nothing here may call into DISKSYS (Folder_*, File_*): both overlays use the same CPU bank, so only one can be mapped in at a time
+ *    the file mark bitsets belong to folder.c, and live in MAIN, so both overlays can get at them
+ *
+ */
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+#include "app.h"
+#include "folder.h"
+#include <stdint.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define PARAM_MARK_NONE				0		// for FileOps_SetAllFileMarks()
+#define PARAM_MARK_ALL				1		// for FileOps_SetAllFileMarks()
+#define PARAM_MARK_INVERT			2		// for FileOps_SetAllFileMarks()
+
+#define FILEOPS_MAX_DELETE_DEPTH	32		// deepest level of sub-folders FileOps_DeleteFolderTree() will go into. each level costs 1 byte of C stack.
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+
+// **** MARKING (MULTI-SELECT) FUNCTIONS *****
+
+// marks all, unmarks all, or inverts the marks of all files in the folder, depending on the_mark_action (PARAM_MARK_ALL, etc.)
+// does not re-render
+void FileOps_SetAllFileMarks(WB2KFolderObject* the_folder, uint8_t the_mark_action);
+
+// marks every file whose name matches the passed wildcard pattern ('*' = any run of characters, '?' = any 1 character; not case sensitive)
+// already-marked files stay marked. does not re-render.
+// returns the number of files that matched the pattern
+uint16_t FileOps_MarkFilesByPattern(WB2KFolderObject* the_folder, const char* the_pattern);
+
+
+// **** DELETE FUNCTIONS *****
+
+// deletes every marked file and folder (with all its contents) from disk, in list order, stopping at the first one that can't be deleted
+// the_marked_count is only used to move the progress bar. y_offset is the first displayable row of the panel.
+// blanks each file's row on screen as it goes, but does not touch the folder's file list: 
+//   caller should pass the returned count to Folder_RemoveMarkedFiles(), then re-display the panel.
+// returns the number of marked files that were deleted
+uint16_t FileOps_DeleteMarkedFiles(WB2KFolderObject* the_folder, uint16_t the_marked_count, uint8_t y_offset);
+
+// deletes the folder at the_path, and every file and folder inside it. 
+// the_path is used as the working buffer while walking the tree: on failure, it will hold the path of the item that could not be deleted.
+// returns false on the first file or folder that could not be deleted
+bool FileOps_DeleteFolderTree(char* the_path);
+
+
+// **** MOVE FUNCTIONS *****
+
+// moves every marked file and folder into the target folder by renaming it, and unmarks each one that was moved
+// source and target folders must be on the same device. 
+// files the kernel won't rename, or with a name already used in the target, are left marked: caller can copy+delete those instead.
+// returns the number of files moved
+int16_t FileOps_MoveMarkedFilesByRename(WB2KFolderObject* the_folder, WB2KFolderObject* the_target_folder);
+
+// moves every marked file and folder into the_target_folder_file, a folder in the same folder, by renaming it
+// use when both panels show the same folder, and you only have a target folder file, not a full folder object to work with.
+// returns -1 in event of error, or count of files moved
+int16_t FileOps_MoveMarkedFilesToFolderFile(WB2KFolderObject* the_folder, WB2KFileObject* the_target_folder_file);
+
+
+// **** FREE SPACE FUNCTIONS *****
+
+// remember the free space the kernel reported the last time a directory on the specified disk drive was read to the end
+// call after every full directory read, so the amount shown in the panel header stays current
+// if the kernel had no free record for the drive, that is remembered as FILE_FREE_BYTES_NOT_REPORTED until the next full read
+void FileOps_RememberFreeBytesOnDisk(uint8_t the_device_number);
+
+// get the free space on the specified disk drive, in bytes
+// uses the amount remembered from the last time a directory on that drive was read, and only reads the drive's root directory if there isn't one
+// returns FILE_FREE_BYTES_UNKNOWN if the drive doesn't report its free space, or in event of error
+int32_t FileOps_GetFreeBytesOnDisk(uint8_t the_device_number);
+
+// returns the number of bytes a file of the passed size will take up on the specified disk drive, counting the unused part of its last block
+uint32_t FileOps_GetSizeOnDisk(uint8_t the_device_number, uint32_t the_size);
+
+// checks whether the specified disk drive has room for the passed number of bytes, before starting a long write
+// shows an error message and returns false if it does not. returns true if it does, or if the drive doesn't report its free space
+bool FileOps_CheckRoomOnDisk(uint8_t the_device_number, uint32_t the_bytes_needed);
+
+// checks that the target folder's disk has room for all the marked files, or for the current file if none are marked
+// folders are not counted, as they are not copied. shows an error message and returns false if there isn't room
+bool FileOps_CheckRoomForMarkedFiles(WB2KFolderObject* the_folder, WB2KFolderObject* the_target_folder);
+
+#endif /* OVERLAY_FILEOPS_H_ */
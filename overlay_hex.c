@@ -0,0 +1,1068 @@
+/*
+ * overlay_hex.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ *
+ *  Routines for looking at EM and memory as hex: the hex viewer, the search results list, and the bank map
+ *    these started out in overlay_em.c, and were moved to their own overlay when it ran out of room
+ *    the results list and the bank map open the hex viewer, so they live in the same overlay
+ *
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "overlay_hex.h"
+#include "app.h"
+#include "bank.h"
+#include "comm_buffer.h"
+#include "debug.h"
+#include "general.h"
+#include "keyboard.h"
+#include "memory.h"
+#include "sys.h"
+#include "text.h"
+#include "strings.h"
+
+// C includes
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// F256 includes
+#include "f256.h"
+
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define HEX_DISPLAY_NUM_CHARS_PER_ROW		16	// we can fit 16 chars across, and have space for hex addr and text view
+#define HEX_DISPLAY_FIRST_ROW				2	// title/instructions, then a blank row, then the rows of hex
+#define HEX_DISPLAY_NUM_ROWS				(MAX_TEXT_VIEW_ROWS_PER_PAGE - HEX_DISPLAY_FIRST_ROW)
+#define HEX_DISPLAY_MAX_CHARS_PER_SCREEN	(HEX_DISPLAY_NUM_CHARS_PER_ROW * HEX_DISPLAY_NUM_ROWS)	// 57 * 16 = 912
+#define HEX_DISPLAY_GOTO_MAX_DIGITS			5	// len("FFFFF"): enough for any physical address
+#define HEX_DISPLAY_LIVE_NUM_ROWS			24	// the live monitor keeps its snapshot in hex_temp_buffer_384b: 24 * 16 = 384
+#define HEX_DISPLAY_LIVE_TICKS_PER_SEC		6	// how often the live monitor re-reads its window
+#define HEX_DISPLAY_LIVE_TICK_FRAMES		(60 / HEX_DISPLAY_LIVE_TICKS_PER_SEC)	// the kernel's frame timer counts at 60 Hz
+
+#define BANK_MAP_NUM_COLS					16
+#define BANK_MAP_BANKS_PER_SYSTEM			(BANK_CHECKSUM_NUM_BANKS / 2)	// RAM, then flash
+#define BANK_MAP_NUM_ROWS_PER_SYSTEM		(BANK_MAP_BANKS_PER_SYSTEM / BANK_MAP_NUM_COLS)
+#define BANK_MAP_FIRST_COL					8	// column the grid starts at: leaves room for the RAM/FLASH labels
+#define BANK_MAP_CELL_WIDTH					4	// 3 chars of cell, then 1 for the selection brackets
+#define BANK_MAP_CELL_HEIGHT				3	// bank number, entropy, then a blank row
+#define BANK_MAP_RAM_FIRST_ROW				2
+#define BANK_MAP_FLASH_FIRST_ROW			(BANK_MAP_RAM_FIRST_ROW + BANK_MAP_NUM_ROWS_PER_SYSTEM * BANK_MAP_CELL_HEIGHT + 1)
+#define BANK_MAP_DETAIL_ROW					(BANK_MAP_FLASH_FIRST_ROW + BANK_MAP_NUM_ROWS_PER_SYSTEM * BANK_MAP_CELL_HEIGHT + 1)
+#define BANK_MAP_LEGEND_ROW					(BANK_MAP_DETAIL_ROW + 2)
+#define BANK_MAP_LEGEND_ENTRY_WIDTH			12
+#define BANK_MAP_EVERY_BYTE					128	// what Memory_ProfileBank() reports for the $00 or $FF count if every byte in the bank is one
+#define BANK_MAP_ENTROPY_PER_CLASS			32	// 2 bits per byte, in 16ths of a bit
+
+#define BANK_MAP_CLASS_EMPTY				0	// every byte is $00
+#define BANK_MAP_CLASS_ERASED				1	// every byte is $FF
+#define BANK_MAP_CLASS_ENTROPY				2	// first of the classes for everything else: one per 2 bits of entropy, lowest first
+#define BANK_MAP_NUM_CLASSES				6
+
+#define BANK_MAP_IS_STALE(bank_num)			(global_bank_profile_stale[(bank_num) >> 3] & (1 << ((bank_num) & 0x07)))
+#define HEX_DISPLAY_FIRST_HEX_COL			11	// column the first byte's hex digits start at: after the address
+#define HEX_DISPLAY_FIRST_TEXT_COL			(HEX_DISPLAY_FIRST_HEX_COL + HEX_DISPLAY_NUM_CHARS_PER_ROW * 3 + 2)	// column the text view starts at: after the hex and 2 spaces
+
+#define SEARCH_RESULTS_FIRST_ROW			2	// title/instructions, then a blank row, then the list
+#define SEARCH_RESULTS_ROWS_PER_PAGE		(MAX_TEXT_VIEW_ROWS_PER_PAGE - SEARCH_RESULTS_FIRST_ROW)
+
+
+/*****************************************************************************/
+/*                           File-scope Variables                            */
+/*****************************************************************************/
+
+
+#pragma data-name ("OVERLAY_HEX")
+
+static uint8_t				hex_temp_buffer_384b_storage[384];
+static uint8_t*				hex_temp_buffer_384b = hex_temp_buffer_384b_storage;
+
+// bank map cell colors, by BANK_MAP_CLASS_*: gray for empty, blue for erased flash, then green through red as the data gets busier
+static uint8_t				hex_bank_map_back_color[BANK_MAP_NUM_CLASSES] = {COLOR_DARK_GRAY, COLOR_BLUE, COLOR_GREEN, COLOR_BRIGHT_YELLOW, COLOR_ORANGE, COLOR_RED};
+static uint8_t				hex_bank_map_fore_color[BANK_MAP_NUM_CLASSES] = {COLOR_LIGHT_GRAY, COLOR_BRIGHT_WHITE, COLOR_BLACK, COLOR_BLACK, COLOR_BLACK, COLOR_BLACK};
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern char*				global_string[NUM_STRINGS];
+extern char*				global_string_buff1;
+extern char*				global_string_buff2;
+
+extern uint8_t				global_bank_profile_stale[BANK_CHECKSUM_NUM_BANKS / 8];
+
+extern TextDialogTemplate	global_dlg;	// dialog we'll configure and re-use for different purposes
+extern char					global_dlg_title[36];	// arbitrary
+extern char					global_dlg_body_msg[70];	// arbitrary
+
+extern uint8_t				temp_screen_buffer_char[APP_DIALOG_BUFF_SIZE];	// WARNING HBD: don't make dialog box bigger than will fit!
+extern uint8_t				temp_screen_buffer_attr[APP_DIALOG_BUFF_SIZE];	// WARNING HBD: don't make dialog box bigger than will fit!
+
+extern uint8_t	zp_search_loc_bank;
+
+#pragma zpsym ("zp_search_loc_bank");
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// draws one row of the search results list
+// the top byte of the_addr is the phrase number for a multi-phrase search, or 0
+void Hex_DrawSearchResultRow(uint16_t the_index, uint32_t the_addr, uint8_t y, bool is_selected);
+
+// draws one row of the compare results list
+// the_range has the offset in the bank of the first differing byte in its low 16 bits, and of the last one in its high 16 bits
+void Hex_DrawCompareResultRow(uint16_t the_index, uint32_t the_range, uint8_t em_bank_num, uint8_t y, bool is_selected);
+
+// draws one row of the search or compare results list. see Hex_DisplayResultsList() for the params
+void Hex_DrawResultsRow(uint16_t the_index, uint32_t the_entry, uint8_t y, bool is_selected, uint8_t em_bank_num, uint8_t compare_bank_num);
+
+// draws num_rows rows of hex, starting top_offset bytes from the start of em_bank_num. only the bytes that fit on screen are read from EM
+// the_len is the number of bytes there are to show, counting from the start of em_bank_num: rows past it are left blank
+// addr_shown is the address to label the start of em_bank_num with in the address column
+// if num_rows is no more than HEX_DISPLAY_LIVE_NUM_ROWS, hex_temp_buffer_384b is left holding all the bytes shown
+void Hex_DrawHexScreen(uint8_t em_bank_num, uint16_t top_offset, uint16_t the_len, uint32_t addr_shown, uint8_t num_rows, uint8_t compare_bank_num);
+
+// re-reads the bytes shown by the live hex monitor, and redraws (in color) only the hex and text cells of the ones that changed since the last look
+// hex_temp_buffer_384b must hold the bytes last shown, as Hex_DrawHexScreen() leaves it. it is updated with the new ones
+void Hex_RefreshLiveHexScreen(uint8_t em_bank_num, uint16_t top_offset, uint16_t the_len);
+
+// asks the user for a hex address for the hex viewer to go to
+// returns false if the user cancelled, or didn't enter a hex number
+bool Hex_AskForHexAddress(uint32_t* the_addr);
+
+// shows the search matches or compare ranges in the results table as a list the user can move through with the cursor keys
+// for search matches, pass PARAM_NO_COMPARE_BANK as compare_bank_num: the_phrase_desc is shown in the title, and em_bank_num is not used
+// for compare ranges, em_bank_num and compare_bank_num are the 2 banks that were compared, and the_phrase_desc is not used
+// ENTER opens the hex viewer at the selected entry; ESC or RUN/STOP returns
+void Hex_DisplayResultsList(uint16_t num_hits, char* the_phrase_desc, uint8_t em_bank_num, uint8_t compare_bank_num);
+
+// profiles every bank of RAM and flash that has its bit set in global_bank_profile_stale, and stores the results at BANK_PROFILE_PHYS_ADDR
+// progress is shown on row y, as each bank takes about 50ms
+void Hex_UpdateBankProfiles(uint8_t y);
+
+// works out which of the BANK_MAP_CLASS_* colors a bank's profile gets
+uint8_t Hex_GetBankMapClass(uint8_t* the_profile);
+
+// draws one bank's cell in the bank map, colored by its profile, with brackets either side if it is the selected one
+void Hex_DrawBankMapCell(uint8_t bank_num, uint8_t* the_profile, bool is_selected);
+
+// draws the line under the bank map that spells out the selected bank's profile
+void Hex_DrawBankMapDetail(uint8_t bank_num, uint8_t* the_profile);
+
+// draws the whole bank map screen from the stored profiles, with selected_bank_num selected
+void Hex_DrawBankMap(uint8_t selected_bank_num);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// draws one row of the search results list
+// the top byte of the_addr is the phrase number for a multi-phrase search, or 0
+void Hex_DrawSearchResultRow(uint16_t the_index, uint32_t the_addr, uint8_t y, bool is_selected)
+{
+	uint8_t		the_color;
+	uint8_t		the_phrase_num;
+	char*		end_of_row;
+	
+	the_color = (is_selected == true) ? FILE_CONTENTS_FOREGROUND_COLOR : FILE_CONTENTS_ACCENT_COLOR;
+	the_phrase_num = (uint8_t)(the_addr >> 24);
+	the_addr &= SEARCH_RESULTS_ADDR_MASK;
+	
+	end_of_row = global_string_buff1 + sprintf(global_string_buff1, "%c %4u  $%05lX  Bank $%02X + $%04X", (is_selected == true ? '>' : ' '), the_index + 1, the_addr, (uint8_t)(the_addr / BYTES_PER_BANK), (uint16_t)(the_addr & (BYTES_PER_BANK - 1)));
+	
+	if (the_phrase_num != 0)
+	{
+		sprintf(end_of_row, "  phrase %u", the_phrase_num);
+	}
+	
+	Text_DrawStringAtXY(1, y, global_string_buff1, the_color, FILE_CONTENTS_BACKGROUND_COLOR);
+}
+
+
+// draws one row of the compare results list
+// the_range has the offset in the bank of the first differing byte in its low 16 bits, and of the last one in its high 16 bits
+void Hex_DrawCompareResultRow(uint16_t the_index, uint32_t the_range, uint8_t em_bank_num, uint8_t y, bool is_selected)
+{
+	uint8_t		the_color;
+	uint16_t	first_offset;
+	uint16_t	last_offset;
+	uint32_t	bank_addr;
+	
+	the_color = (is_selected == true) ? FILE_CONTENTS_FOREGROUND_COLOR : FILE_CONTENTS_ACCENT_COLOR;
+	first_offset = (uint16_t)the_range;
+	last_offset = (uint16_t)(the_range >> 16);
+	bank_addr = (uint32_t)em_bank_num * BYTES_PER_BANK;
+	
+	sprintf(global_string_buff1, "%c %4u  $%05lX-$%05lX  Bank $%02X + $%04X  %u bytes", (is_selected == true ? '>' : ' '), the_index + 1, bank_addr + first_offset, bank_addr + last_offset, em_bank_num, first_offset, last_offset - first_offset + 1);
+	Text_DrawStringAtXY(1, y, global_string_buff1, the_color, FILE_CONTENTS_BACKGROUND_COLOR);
+}
+
+
+// draws one row of the search or compare results list. see Hex_DisplayResultsList() for the params
+void Hex_DrawResultsRow(uint16_t the_index, uint32_t the_entry, uint8_t y, bool is_selected, uint8_t em_bank_num, uint8_t compare_bank_num)
+{
+	if (compare_bank_num == PARAM_NO_COMPARE_BANK)
+	{
+		Hex_DrawSearchResultRow(the_index, the_entry, y, is_selected);
+	}
+	else
+	{
+		Hex_DrawCompareResultRow(the_index, the_entry, em_bank_num, y, is_selected);
+	}
+}
+
+
+// draws num_rows rows of hex, starting top_offset bytes from the start of em_bank_num. only the bytes that fit on screen are read from EM
+// the_len is the number of bytes there are to show, counting from the start of em_bank_num: rows past it are left blank
+// addr_shown is the address to label the start of em_bank_num with in the address column
+// if num_rows is no more than HEX_DISPLAY_LIVE_NUM_ROWS, hex_temp_buffer_384b is left holding all the bytes shown
+void Hex_DrawHexScreen(uint8_t em_bank_num, uint16_t top_offset, uint16_t the_len, uint32_t addr_shown, uint8_t num_rows, uint8_t compare_bank_num)
+{
+	// LOGIC
+	//   the rows are read from EM in chunks of up to 256b (16 rows), never more than is left to show on screen.
+	//     a chunk may straddle 2 banks: App_EMBulkCopy() takes care of that
+	//   when comparing, the same chunk of the compare bank goes in STORAGE_FILE_BUFFER_1, and is walked through alongside the main one.
+	//   every row is drawn as normal, then any byte that differs gets its hex and text cells recolored.
+	//   the_len and top_offset are always multiples of 16, so every row drawn is a full one
+	//   when the whole screen fits in the temp buffer, each chunk goes in after the one before instead of at the start, 
+	//     so the buffer ends up with everything shown: the live monitor compares against that.
+	
+	uint8_t		n;
+	uint8_t		y = HEX_DISPLAY_FIRST_ROW;
+	uint8_t		rows_left = num_rows;
+	uint16_t	chunk_len;
+	uint16_t	the_offset = top_offset;
+	uint32_t	the_addr;
+	uint8_t*	buffer_curr_loc;
+	uint8_t*	compare_curr_loc;
+	
+	// clearing also puts back the normal color on any cells that had been marked as different
+	Text_FillBox(0, HEX_DISPLAY_FIRST_ROW, SCREEN_LAST_COL, MAX_TEXT_VIEW_ROWS_PER_PAGE - 1, CH_SPACE, FILE_CONTENTS_FOREGROUND_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+	
+	while (rows_left > 0 && the_offset < the_len)
+	{
+		chunk_len = the_len - the_offset;
+		
+		if (chunk_len > STORAGE_FILE_BUFFER_1_LEN)
+		{
+			chunk_len = STORAGE_FILE_BUFFER_1_LEN;
+		}
+		
+		if (chunk_len > (uint16_t)rows_left * HEX_DISPLAY_NUM_CHARS_PER_ROW)
+		{
+			chunk_len = (uint16_t)rows_left * HEX_DISPLAY_NUM_CHARS_PER_ROW;
+		}
+		
+		buffer_curr_loc = hex_temp_buffer_384b;
+		
+		if (num_rows <= HEX_DISPLAY_LIVE_NUM_ROWS)
+		{
+			buffer_curr_loc += the_offset - top_offset;
+		}
+		
+		App_EMBulkCopy(buffer_curr_loc, (uint32_t)em_bank_num * BYTES_PER_BANK + the_offset, chunk_len, PARAM_COPY_FROM_EM);
+
+		if (compare_bank_num != PARAM_NO_COMPARE_BANK)
+		{
+			App_EMBulkCopy((uint8_t*)STORAGE_FILE_BUFFER_1, (uint32_t)compare_bank_num * BYTES_PER_BANK + the_offset, chunk_len, PARAM_COPY_FROM_EM);
+		}
+		
+		compare_curr_loc = (uint8_t*)STORAGE_FILE_BUFFER_1;
+		
+		for (; chunk_len > 0; chunk_len -= HEX_DISPLAY_NUM_CHARS_PER_ROW)
+		{
+			the_addr = addr_shown + the_offset;
+			
+			// address display at left
+			Text_SetXY(1,y);
+			Text_SetChar('$');
+			Text_DrawByteAsHexChars( (uint8_t) ((the_addr >> 16 ) & 0xff));
+			Text_DrawByteAsHexChars( (uint8_t) ((the_addr >> 8 ) & 0xff));
+			Text_DrawByteAsHexChars( (uint8_t) (the_addr & 0xff));
+			Text_SetXY(HEX_DISPLAY_FIRST_HEX_COL,y);
+		
+			// main hex display in middle
+			for (n=0; n < HEX_DISPLAY_NUM_CHARS_PER_ROW; n++)
+			{
+				Text_DrawByteAsHexChars(buffer_curr_loc[n]);
+				Text_SetChar(CH_SPACE);
+			}
+			
+			// 'text' display at right
+			Text_SetChar(CH_SPACE);
+			Text_SetChar(CH_SPACE);
+			
+			for (n=0; n < HEX_DISPLAY_NUM_CHARS_PER_ROW; n++)
+			{
+				Text_SetChar(buffer_curr_loc[n]);
+			}
+			
+			if (compare_bank_num != PARAM_NO_COMPARE_BANK)
+			{
+				for (n=0; n < HEX_DISPLAY_NUM_CHARS_PER_ROW; n++)
+				{
+					if (buffer_curr_loc[n] != compare_curr_loc[n])
+					{
+						Text_SetColorAtXY(HEX_DISPLAY_FIRST_HEX_COL + n * 3, y, FILE_CONTENTS_CHANGED_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+						Text_SetColorAtXY(HEX_DISPLAY_FIRST_HEX_COL + n * 3 + 1, y, FILE_CONTENTS_CHANGED_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+						Text_SetColorAtXY(HEX_DISPLAY_FIRST_TEXT_COL + n, y, FILE_CONTENTS_CHANGED_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+					}
+				}
+			}
+			
+			the_offset += HEX_DISPLAY_NUM_CHARS_PER_ROW;
+			buffer_curr_loc += HEX_DISPLAY_NUM_CHARS_PER_ROW;
+			compare_curr_loc += HEX_DISPLAY_NUM_CHARS_PER_ROW;
+			++y;
+			--rows_left;
+		}
+	}
+}
+
+
+// re-reads the bytes shown by the live hex monitor, and redraws (in color) only the hex and text cells of the ones that changed since the last look
+// hex_temp_buffer_384b must hold the bytes last shown, as Hex_DrawHexScreen() leaves it. it is updated with the new ones
+void Hex_RefreshLiveHexScreen(uint8_t em_bank_num, uint16_t top_offset, uint16_t the_len)
+{
+	// LOGIC
+	//   the fresh bytes are read into STORAGE_FILE_BUFFER_1 a chunk at a time (the live monitor is never used with a compare bank, so it is free)
+	//   redrawing only the cells that changed keeps this to a few hundred compares when nothing is happening, and avoids any flicker.
+	//   changed cells are left in the changed color until the next full redraw, so it is easy to see what has been touched
+	
+	uint8_t		x;
+	uint8_t		y;
+	uint16_t	i;
+	uint16_t	chunk_start;
+	uint16_t	chunk_len;
+	uint16_t	watch_len;
+	uint8_t*	new_bytes = (uint8_t*)STORAGE_FILE_BUFFER_1;
+	uint8_t*	old_bytes;
+	
+	watch_len = the_len - top_offset;
+	
+	if (watch_len > HEX_DISPLAY_LIVE_NUM_ROWS * HEX_DISPLAY_NUM_CHARS_PER_ROW)
+	{
+		watch_len = HEX_DISPLAY_LIVE_NUM_ROWS * HEX_DISPLAY_NUM_CHARS_PER_ROW;
+	}
+	
+	for (chunk_start = 0; chunk_start < watch_len; chunk_start += chunk_len)
+	{
+		chunk_len = watch_len - chunk_start;
+		
+		if (chunk_len > STORAGE_FILE_BUFFER_1_LEN)
+		{
+			chunk_len = STORAGE_FILE_BUFFER_1_LEN;
+		}
+		
+		App_EMBulkCopy(new_bytes, (uint32_t)em_bank_num * BYTES_PER_BANK + top_offset + chunk_start, chunk_len, PARAM_COPY_FROM_EM);
+		
+		old_bytes = hex_temp_buffer_384b + chunk_start;
+		
+		for (i = 0; i < chunk_len; i++)
+		{
+			if (new_bytes[i] != old_bytes[i])
+			{
+				old_bytes[i] = new_bytes[i];
+				
+				x = (chunk_start + i) % HEX_DISPLAY_NUM_CHARS_PER_ROW;
+				y = HEX_DISPLAY_FIRST_ROW + (chunk_start + i) / HEX_DISPLAY_NUM_CHARS_PER_ROW;
+				
+				Text_SetXY(HEX_DISPLAY_FIRST_HEX_COL + x * 3, y);
+				Text_DrawByteAsHexChars(new_bytes[i]);
+				Text_SetCharAtXY(HEX_DISPLAY_FIRST_TEXT_COL + x, y, new_bytes[i]);
+				
+				Text_SetColorAtXY(HEX_DISPLAY_FIRST_HEX_COL + x * 3, y, FILE_CONTENTS_CHANGED_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+				Text_SetColorAtXY(HEX_DISPLAY_FIRST_HEX_COL + x * 3 + 1, y, FILE_CONTENTS_CHANGED_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+				Text_SetColorAtXY(HEX_DISPLAY_FIRST_TEXT_COL + x, y, FILE_CONTENTS_CHANGED_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+			}
+		}
+	}
+}
+
+
+// asks the user for a hex address for the hex viewer to go to
+// returns false if the user cancelled, or didn't enter a hex number
+bool Hex_AskForHexAddress(uint32_t* the_addr)
+{
+	char*	the_end;
+	bool	success;
+	
+	General_Strlcpy((char*)&global_dlg_title, General_GetString(ID_STR_DLG_HEX_GOTO_TITLE), COMM_BUFFER_MAX_STRING_LEN);
+	General_Strlcpy((char*)&global_dlg_body_msg, General_GetString(ID_STR_DLG_HEX_GOTO_BODY), APP_DIALOG_WIDTH);
+	global_string_buff2[0] = 0;	// clear whatever string had been in this buffer before
+	
+	success = Text_DisplayTextEntryDialog(&global_dlg, (char*)&temp_screen_buffer_char, (char*)&temp_screen_buffer_attr, global_string_buff2, HEX_DISPLAY_GOTO_MAX_DIGITS, APP_ACCENT_COLOR, APP_FOREGROUND_COLOR, APP_BACKGROUND_COLOR);
+	
+	if (success == false)
+	{
+		return false;
+	}
+	
+	*the_addr = strtoul(global_string_buff2, &the_end, 16);
+	
+	return (the_end != global_string_buff2);
+}
+
+
+// profiles every bank of RAM and flash that has its bit set in global_bank_profile_stale, and stores the results at BANK_PROFILE_PHYS_ADDR
+// progress is shown on row y, as each bank takes about 50ms
+void Hex_UpdateBankProfiles(uint8_t y)
+{
+	// LOGIC
+	//   Memory_ProfileBank() needs 512 bytes of scratch space in another bank for its histogram. 
+	//     normally that is the checksum table's bank, which has room to spare after the profiles, and is only f/manager's bookkeeping.
+	//     the checksum bank itself is profiled with the search automaton's bank as scratch instead: the automaton is built fresh for every search.
+	
+	uint8_t		bank_num;
+	uint8_t		num_stale = 0;
+	uint8_t		num_done = 0;
+	uint32_t	the_profile;
+	
+	for (bank_num = 0; bank_num < BANK_CHECKSUM_NUM_BANKS; bank_num++)
+	{
+		if (BANK_MAP_IS_STALE(bank_num))
+		{
+			++num_stale;
+		}
+	}
+	
+	for (bank_num = 0; bank_num < BANK_CHECKSUM_NUM_BANKS && num_done < num_stale; bank_num++)
+	{
+		if (BANK_MAP_IS_STALE(bank_num) == 0)
+		{
+			continue;
+		}
+		
+		sprintf(global_string_buff1, General_GetString(ID_STR_MSG_BANK_MAP_SCANNING), ++num_done, num_stale);
+		Text_DrawStringAtXY(0, y, global_string_buff1, FILE_CONTENTS_ACCENT_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+		
+		zp_search_loc_bank = bank_num;
+		
+		if (bank_num == BANK_CHECKSUM_EM_SLOT)
+		{
+			*(uint8_t*)ZP_OTHER_PARAM = SEARCH_AUTOMATON_EM_SLOT;
+			App_MarkBanksChanged(SEARCH_AUTOMATON_PHYS_ADDR + BANK_PROFILE_HISTOGRAM_LO, 512);
+		}
+		else
+		{
+			*(uint8_t*)ZP_OTHER_PARAM = BANK_CHECKSUM_EM_SLOT;
+		}
+		
+		the_profile = Memory_ProfileBank();
+		App_EMBulkCopy((uint8_t*)&the_profile, BANK_PROFILE_PHYS_ADDR + (uint16_t)bank_num * BANK_PROFILE_LEN, BANK_PROFILE_LEN, PARAM_COPY_TO_EM);
+		
+		global_bank_profile_stale[bank_num >> 3] &= ~(1 << (bank_num & 0x07));
+	}
+	
+	Text_FillBox(0, y, SCREEN_LAST_COL, y, CH_SPACE, FILE_CONTENTS_FOREGROUND_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+}
+
+
+// works out which of the BANK_MAP_CLASS_* colors a bank's profile gets
+uint8_t Hex_GetBankMapClass(uint8_t* the_profile)
+{
+	uint8_t		the_class;
+	
+	if (the_profile[BANK_PROFILE_ZEROS] == BANK_MAP_EVERY_BYTE)
+	{
+		return BANK_MAP_CLASS_EMPTY;
+	}
+	
+	if (the_profile[BANK_PROFILE_FFS] == BANK_MAP_EVERY_BYTE)
+	{
+		return BANK_MAP_CLASS_ERASED;
+	}
+	
+	the_class = BANK_MAP_CLASS_ENTROPY + (the_profile[BANK_PROFILE_ENTROPY] / BANK_MAP_ENTROPY_PER_CLASS);
+	
+	if (the_class >= BANK_MAP_NUM_CLASSES)
+	{
+		the_class = BANK_MAP_NUM_CLASSES - 1;	// 8 bits exactly
+	}
+	
+	return the_class;
+}
+
+
+// draws one bank's cell in the bank map, colored by its profile, with brackets either side if it is the selected one
+void Hex_DrawBankMapCell(uint8_t bank_num, uint8_t* the_profile, bool is_selected)
+{
+	uint8_t		x;
+	uint8_t		y;
+	uint8_t		the_class;
+	uint8_t		the_bracket = CH_SPACE;
+	uint8_t		the_entropy = the_profile[BANK_PROFILE_ENTROPY];
+	
+	x = BANK_MAP_FIRST_COL + 1 + (bank_num % BANK_MAP_NUM_COLS) * BANK_MAP_CELL_WIDTH;
+	y = BANK_MAP_RAM_FIRST_ROW + (bank_num / BANK_MAP_NUM_COLS) * BANK_MAP_CELL_HEIGHT;
+	
+	if (bank_num >= BANK_MAP_BANKS_PER_SYSTEM)
+	{
+		y += BANK_MAP_FLASH_FIRST_ROW - BANK_MAP_RAM_FIRST_ROW - BANK_MAP_NUM_ROWS_PER_SYSTEM * BANK_MAP_CELL_HEIGHT;
+	}
+	
+	// the whole map is 128 of these, so no sprintf: fill in the colors, then drop the chars into place
+	the_class = Hex_GetBankMapClass(the_profile);
+	Text_FillBox(x, y, x + BANK_MAP_CELL_WIDTH - 2, y + 1, CH_SPACE, hex_bank_map_fore_color[the_class], hex_bank_map_back_color[the_class]);
+	
+	Text_SetXY(x, y);
+	Text_SetChar('$');
+	Text_DrawByteAsHexChars(bank_num);
+	
+	Text_SetXY(x, y + 1);
+	Text_SetChar('0' + the_entropy / 16);
+	Text_SetChar('.');
+	Text_SetChar('0' + (the_entropy % 16) * 10 / 16);
+	
+	if (is_selected)
+	{
+		the_bracket = '[';
+	}
+	
+	Text_SetCharAndColorAtXY(x - 1, y, the_bracket, FILE_CONTENTS_ACCENT_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+	Text_SetCharAndColorAtXY(x - 1, y + 1, the_bracket, FILE_CONTENTS_ACCENT_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+	
+	if (is_selected)
+	{
+		the_bracket = ']';
+	}
+	
+	Text_SetCharAndColorAtXY(x + BANK_MAP_CELL_WIDTH - 1, y, the_bracket, FILE_CONTENTS_ACCENT_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+	Text_SetCharAndColorAtXY(x + BANK_MAP_CELL_WIDTH - 1, y + 1, the_bracket, FILE_CONTENTS_ACCENT_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+}
+
+
+// draws the line under the bank map that spells out the selected bank's profile
+void Hex_DrawBankMapDetail(uint8_t bank_num, uint8_t* the_profile)
+{
+	uint8_t		the_entropy = the_profile[BANK_PROFILE_ENTROPY];
+	
+	sprintf(global_string_buff1, General_GetString(ID_STR_MSG_BANK_MAP_DETAIL), 
+		bank_num, 
+		(uint32_t)bank_num * BYTES_PER_BANK, 
+		(uint16_t)the_profile[BANK_PROFILE_ZEROS] * 100 / BANK_MAP_EVERY_BYTE, 
+		(uint16_t)the_profile[BANK_PROFILE_FFS] * 100 / BANK_MAP_EVERY_BYTE, 
+		the_entropy / 16, 
+		(the_entropy % 16) * 10 / 16
+	);
+	
+	Text_FillBox(0, BANK_MAP_DETAIL_ROW, SCREEN_LAST_COL, BANK_MAP_DETAIL_ROW, CH_SPACE, FILE_CONTENTS_FOREGROUND_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+	Text_DrawStringAtXY(BANK_MAP_FIRST_COL, BANK_MAP_DETAIL_ROW, global_string_buff1, FILE_CONTENTS_FOREGROUND_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+}
+
+
+// draws the whole bank map screen from the stored profiles, with selected_bank_num selected
+void Hex_DrawBankMap(uint8_t selected_bank_num)
+{
+	// LOGIC
+	//   the 512 bytes of profiles don't fit in the temp buffer at once, so they are brought in one memory system (64 banks, 256 bytes) at a time
+	
+	uint8_t		bank_num;
+	uint8_t		n;
+	uint8_t		x;
+	uint8_t*	the_profile;
+	
+	Text_ClearScreen(FILE_CONTENTS_FOREGROUND_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+	Text_DrawStringAtXY(0, 0, General_GetString(ID_STR_MSG_BANK_MAP_INSTRUCTIONS), FILE_CONTENTS_ACCENT_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+	Text_DrawStringAtXY(0, BANK_MAP_RAM_FIRST_ROW, General_GetString(ID_STR_LBL_BANK_MAP_RAM), FILE_CONTENTS_ACCENT_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+	Text_DrawStringAtXY(0, BANK_MAP_FLASH_FIRST_ROW, General_GetString(ID_STR_LBL_BANK_MAP_FLASH), FILE_CONTENTS_ACCENT_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+	
+	for (bank_num = 0; bank_num < BANK_CHECKSUM_NUM_BANKS; bank_num++)
+	{
+		if (bank_num % BANK_MAP_BANKS_PER_SYSTEM == 0)
+		{
+			App_EMBulkCopy(hex_temp_buffer_384b, BANK_PROFILE_PHYS_ADDR + (uint16_t)bank_num * BANK_PROFILE_LEN, BANK_MAP_BANKS_PER_SYSTEM * BANK_PROFILE_LEN, PARAM_COPY_FROM_EM);
+		}
+		
+		the_profile = hex_temp_buffer_384b + (bank_num % BANK_MAP_BANKS_PER_SYSTEM) * BANK_PROFILE_LEN;
+		
+		Hex_DrawBankMapCell(bank_num, the_profile, (bank_num == selected_bank_num));
+		
+		if (bank_num == selected_bank_num)
+		{
+			Hex_DrawBankMapDetail(bank_num, the_profile);
+		}
+	}
+	
+	// legend: a swatch of each color, and what it means
+	x = BANK_MAP_FIRST_COL;
+	
+	for (n = 0; n < BANK_MAP_NUM_CLASSES; n++)
+	{
+		Text_FillBox(x, BANK_MAP_LEGEND_ROW, x + BANK_MAP_CELL_WIDTH - 2, BANK_MAP_LEGEND_ROW, CH_SPACE, hex_bank_map_fore_color[n], hex_bank_map_back_color[n]);
+		
+		if (n == BANK_MAP_CLASS_EMPTY)
+		{
+			General_Strlcpy(global_string_buff1, General_GetString(ID_STR_LBL_BANK_MAP_EMPTY), COMM_BUFFER_MAX_STRING_LEN);
+		}
+		else if (n == BANK_MAP_CLASS_ERASED)
+		{
+			General_Strlcpy(global_string_buff1, General_GetString(ID_STR_LBL_BANK_MAP_ERASED), COMM_BUFFER_MAX_STRING_LEN);
+		}
+		else
+		{
+			sprintf(global_string_buff1, General_GetString(ID_STR_LBL_BANK_MAP_ENTROPY), (n - BANK_MAP_CLASS_ENTROPY) * 2, (n - BANK_MAP_CLASS_ENTROPY) * 2 + 2);
+		}
+		
+		Text_DrawStringAtXY(x + BANK_MAP_CELL_WIDTH, BANK_MAP_LEGEND_ROW, global_string_buff1, FILE_CONTENTS_FOREGROUND_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+		x += BANK_MAP_LEGEND_ENTRY_WIDTH;
+	}
+}
+
+
+// shows the search matches or compare ranges in the results table as a list the user can move through with the cursor keys
+// for search matches, pass PARAM_NO_COMPARE_BANK as compare_bank_num: the_phrase_desc is shown in the title, and em_bank_num is not used
+// for compare ranges, em_bank_num and compare_bank_num are the 2 banks that were compared, and the_phrase_desc is not used
+// ENTER opens the hex viewer at the selected entry; ESC or RUN/STOP returns
+void Hex_DisplayResultsList(uint16_t num_hits, char* the_phrase_desc, uint8_t em_bank_num, uint8_t compare_bank_num)
+{
+	// LOGIC
+	//   one screenful of addresses at a time is copied out of the results table into the HEX overlay's temp buffer (57 * 4 = 228 bytes).
+	//   moving within the screen only redraws the 2 rows that changed. moving off it redraws the whole list from the next/previous screenful.
+	//   the hex viewer starts at the page the match (or range) starts on, so it is always on the first screen. 
+	//   for a compare, the hex viewer shows the first bank, with the bytes that differ from the second bank highlighted.
+	//   the hex viewer uses the same temp buffer, so the list is redrawn from scratch when it returns.
+	
+	uint16_t	selected = 0;
+	uint16_t	prev_selected = 0;
+	uint16_t	first_shown;
+	uint16_t	num_shown;
+	uint16_t	n;
+	uint32_t	the_addr;
+	uint32_t*	the_hits = (uint32_t*)hex_temp_buffer_384b;
+	uint8_t		user_input;
+	bool		redraw_all = true;
+	bool		keep_going = true;
+	char		hit_name[12];
+	
+	if (num_hits == 0)
+	{
+		return;
+	}
+	
+	do
+	{
+		if (redraw_all == true)
+		{
+			first_shown = selected - (selected % SEARCH_RESULTS_ROWS_PER_PAGE);
+			num_shown = num_hits - first_shown;
+			
+			if (num_shown > SEARCH_RESULTS_ROWS_PER_PAGE)
+			{
+				num_shown = SEARCH_RESULTS_ROWS_PER_PAGE;
+			}
+			
+			App_EMBulkCopy((uint8_t*)the_hits, SEARCH_RESULTS_PHYS_ADDR + (uint32_t)first_shown * sizeof(uint32_t), num_shown * sizeof(uint32_t), PARAM_COPY_FROM_EM);
+			
+			Text_ClearScreen(FILE_CONTENTS_FOREGROUND_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+			
+			if (compare_bank_num == PARAM_NO_COMPARE_BANK)
+			{
+				sprintf(global_string_buff1, General_GetString(ID_STR_MSG_SEARCH_RESULTS_INSTRUCTIONS), num_hits, the_phrase_desc);
+			}
+			else
+			{
+				sprintf(global_string_buff1, General_GetString(ID_STR_MSG_COMPARE_RESULTS_INSTRUCTIONS), num_hits, em_bank_num, compare_bank_num);
+			}
+			
+			Text_DrawStringAtXY(0, 0, global_string_buff1, FILE_CONTENTS_ACCENT_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+			
+			for (n = 0; n < num_shown; n++)
+			{
+				Hex_DrawResultsRow(first_shown + n, the_hits[n], SEARCH_RESULTS_FIRST_ROW + n, (first_shown + n == selected), em_bank_num, compare_bank_num);
+			}
+			
+			redraw_all = false;
+		}
+		else if (prev_selected != selected)
+		{
+			Hex_DrawResultsRow(prev_selected, the_hits[prev_selected - first_shown], SEARCH_RESULTS_FIRST_ROW + (prev_selected - first_shown), false, em_bank_num, compare_bank_num);
+			Hex_DrawResultsRow(selected, the_hits[selected - first_shown], SEARCH_RESULTS_FIRST_ROW + (selected - first_shown), true, em_bank_num, compare_bank_num);
+		}
+		
+		prev_selected = selected;
+		user_input = Keyboard_GetChar();
+		
+		switch (user_input)
+		{
+			case MOVE_UP:
+				if (selected > 0)
+				{
+					--selected;
+					redraw_all = (selected < first_shown);
+				}
+				break;
+				
+			case MOVE_DOWN:
+				if (selected < num_hits - 1)
+				{
+					++selected;
+					redraw_all = (selected >= first_shown + num_shown);
+				}
+				break;
+				
+			case ACTION_SELECT:
+				if (compare_bank_num == PARAM_NO_COMPARE_BANK)
+				{
+					the_addr = the_hits[selected - first_shown] & SEARCH_RESULTS_ADDR_MASK;
+					sprintf(hit_name, "$%05lX", the_addr);
+					Hex_DisplayAsHex((uint8_t)(the_addr / BYTES_PER_BANK), (uint8_t)((the_addr & (BYTES_PER_BANK - 1)) / 256), PAGES_PER_BANK, hit_name, PARAM_NO_COMPARE_BANK);
+				}
+				else
+				{
+					sprintf(hit_name, "$%02X vs $%02X", em_bank_num, compare_bank_num);
+					Hex_DisplayAsHex(em_bank_num, (uint8_t)((uint16_t)the_hits[selected - first_shown] / 256), PAGES_PER_BANK, hit_name, compare_bank_num);
+				}
+				redraw_all = true;
+				break;
+				
+			case CH_ESC:
+			case CH_RUNSTOP:
+			case 'q':
+				keep_going = false;
+				break;
+				
+			default:
+				break;
+		}
+		
+	} while (keep_going == true);
+}
+
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// displays the content found in EM as hex codes and text to right, similar to a ML monitor
+// em_bank_num is used to derive the base EM address
+// first_page is the EM 256b chunk to start at (0 to start at em_bank_num's address)
+// num_pages is the number of EM 256b chunks there are, counting from the start of em_bank_num
+// the_name is only used to provide feedback to the user about what they are viewing
+// compare_bank_num is another bank to compare against: bytes that differ from the same place in it are highlighted. PARAM_NO_COMPARE_BANK for none
+// up/down scroll by a row, left/right (or space) by a screenful, g goes to an address, and l turns live mode on/off. ESC or RUN/STOP returns
+void Hex_DisplayAsHex(uint8_t em_bank_num, uint8_t first_page, uint8_t num_pages, char* the_name, uint8_t compare_bank_num)
+{
+	// LOGIC
+	//   Data must have already been loaded into EM at the em_bank_num specified
+	//   for the 'address', we start at 0 assuming this is a file, and we are counting from start of file
+	//     but if the em_bank_num <> EM_STORAGE_START_PHYS_BANK_NUM, we're almost certainly viewing memory, in which case show calculated EM address
+	
+	// LOGIC
+	//   we only have 80x60 to work with, and we need a row for "hit space for more, esc to stop", plus a blank one
+	//     only 16 bytes of hex can be shown on one row of 80 chars (2 per byte + 1 space; plus 16 chars at right for view, plus addr at left)
+	//     so 57 rows * 16 bytes = 912 max bytes can be shown
+	//   the only state is the offset (from the start of em_bank_num) of the top row. every key just works out a new one, 
+	//     and the screen is redrawn from it, reading only the bytes it shows. so going to any address costs the same as a line scroll.
+	//   the top row is never allowed past the point where the last row of data is on the last row of the screen.
+	//   the address the user types in is in the same terms as the address column: a file offset for files, a physical address for memory
+	
+	// LOGIC
+	//   live mode is for watching memory that something else is changing. it shrinks the screen to the 384 bytes hex_temp_buffer_384b can hold,
+	//     and instead of waiting for a key, polls for one. every time the tick timer goes off, the window is re-read and only changed cells redrawn.
+	//   it is not offered when comparing: the compare bank uses the buffer the live refresh reads into.
+	
+	uint8_t		user_input;
+	uint8_t		num_rows = HEX_DISPLAY_NUM_ROWS;
+	uint16_t	screen_len = HEX_DISPLAY_MAX_CHARS_PER_SCREEN;
+	uint16_t	the_len = (uint16_t)num_pages * 256;
+	uint16_t	top_offset = (uint16_t)first_page * 256;
+	uint16_t	prev_top_offset;
+	uint16_t	max_top_offset;
+	uint32_t	addr_shown;
+	uint32_t	new_addr;
+	bool		redraw = true;
+	bool		live = false;
+	bool		keep_going = true;
+	
+	// are we showing a file on disk, or actually showing memory
+	if (em_bank_num == EM_STORAGE_START_PHYS_BANK_NUM)
+	{
+		addr_shown = 0x0000;
+	}
+	else
+	{
+		addr_shown = (uint32_t)em_bank_num * BYTES_PER_BANK;
+	}
+	
+	Text_ClearScreen(FILE_CONTENTS_FOREGROUND_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+	sprintf(global_string_buff1, General_GetString(ID_STR_MSG_HEX_VIEW_INSTRUCTIONS), the_name);
+	Text_DrawStringAtXY(0, 0, global_string_buff1, FILE_CONTENTS_ACCENT_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+	
+	do
+	{
+		// the screen size changes with live mode, so this is worked out fresh each time
+		max_top_offset = 0;
+		
+		if (the_len > screen_len)
+		{
+			max_top_offset = the_len - screen_len;
+		}
+		
+		if (top_offset > max_top_offset)
+		{
+			top_offset = max_top_offset;
+			redraw = true;
+		}
+		
+		if (redraw == true)
+		{
+			Hex_DrawHexScreen(em_bank_num, top_offset, the_len, addr_shown, num_rows, compare_bank_num);
+		}
+		
+		prev_top_offset = top_offset;
+		
+		if (live == true)
+		{
+			while ((user_input = Keyboard_GetKeyIfPressed()) == 0)
+			{
+				if (Keyboard_TickElapsed() == true)
+				{
+					Hex_RefreshLiveHexScreen(em_bank_num, top_offset, the_len);
+					Keyboard_StartTick(HEX_DISPLAY_LIVE_TICK_FRAMES);
+				}
+			}
+		}
+		else
+		{
+			user_input = Keyboard_GetChar();
+		}
+		
+		redraw = false;
+		
+		switch (user_input)
+		{
+			case MOVE_UP:
+				if (top_offset > 0)
+				{
+					top_offset -= HEX_DISPLAY_NUM_CHARS_PER_ROW;
+				}
+				break;
+				
+			case MOVE_DOWN:
+				if (top_offset < max_top_offset)
+				{
+					top_offset += HEX_DISPLAY_NUM_CHARS_PER_ROW;
+				}
+				break;
+				
+			case MOVE_LEFT:
+				if (top_offset > screen_len)
+				{
+					top_offset -= screen_len;
+				}
+				else
+				{
+					top_offset = 0;
+				}
+				break;
+				
+			case MOVE_RIGHT:
+			case CH_SPACE:
+				if (max_top_offset - top_offset > screen_len)
+				{
+					top_offset += screen_len;
+				}
+				else
+				{
+					top_offset = max_top_offset;
+				}
+				break;
+				
+			case 'g':
+				if (Hex_AskForHexAddress(&new_addr) == true)
+				{
+					if (new_addr < addr_shown)
+					{
+						new_addr = addr_shown;
+					}
+					
+					new_addr -= addr_shown;
+					
+					if (new_addr > max_top_offset)
+					{
+						top_offset = max_top_offset;
+					}
+					else
+					{
+						top_offset = (uint16_t)new_addr & ~(HEX_DISPLAY_NUM_CHARS_PER_ROW - 1);
+					}
+				}
+				break;
+				
+			case 'l':
+				if (compare_bank_num != PARAM_NO_COMPARE_BANK)
+				{
+					break;
+				}
+				
+				live = !live;
+				
+				if (live == true)
+				{
+					num_rows = HEX_DISPLAY_LIVE_NUM_ROWS;
+					sprintf(global_string_buff1, General_GetString(ID_STR_MSG_HEX_VIEW_LIVE), HEX_DISPLAY_LIVE_NUM_ROWS * HEX_DISPLAY_NUM_CHARS_PER_ROW, HEX_DISPLAY_LIVE_TICKS_PER_SEC);
+					Text_DrawStringAtXY(0, 1, global_string_buff1, FILE_CONTENTS_CHANGED_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+					Keyboard_StartTick(HEX_DISPLAY_LIVE_TICK_FRAMES);
+				}
+				else
+				{
+					num_rows = HEX_DISPLAY_NUM_ROWS;
+					Text_FillBox(0, 1, SCREEN_LAST_COL, 1, CH_SPACE, FILE_CONTENTS_FOREGROUND_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+				}
+				
+				screen_len = (uint16_t)num_rows * HEX_DISPLAY_NUM_CHARS_PER_ROW;
+				redraw = true;
+				break;
+				
+			case CH_ESC:
+			case CH_RUNSTOP:
+			case 'q':
+				keep_going = false;
+				break;
+				
+			default:
+				break;
+		}
+		
+		// the goto dialog puts back what was under it, so the screen only needs redrawing if the top row moved
+		if (top_offset != prev_top_offset)
+		{
+			redraw = true;
+		}
+		
+	} while (keep_going == true);
+}
+
+
+// shows the matches stored by EM_SearchMemoryForAll() or EM_SearchMemoryForAllPhrases() as a list the user can move through with the cursor keys
+// the_phrase_desc is shown in the title, and should be what the user typed in
+// ENTER opens the hex viewer at the selected match; ESC or RUN/STOP returns
+void Hex_DisplaySearchResults(uint16_t num_hits, char* the_phrase_desc)
+{
+	Hex_DisplayResultsList(num_hits, the_phrase_desc, 0, PARAM_NO_COMPARE_BANK);
+}
+
+
+// shows the ranges stored by EM_CompareBanks() as a list the user can move through with the cursor keys
+// ENTER opens the hex viewer on the first bank at the selected range, with every byte that differs from the second bank highlighted; ESC or RUN/STOP returns
+void Hex_DisplayCompareResults(uint16_t num_ranges, uint8_t em_bank_num, uint8_t compare_bank_num)
+{
+	Hex_DisplayResultsList(num_ranges, NULL, em_bank_num, compare_bank_num);
+}
+
+
+// shows every bank of RAM and flash as a colored cell in a 16x8 grid, so empty, erased, and used banks can be told apart at a glance
+// any bank f/manager has written to since it was last looked at is profiled again first. the rest come from the stored profiles
+// the arrow keys move between banks, ENTER opens the hex viewer on the selected bank, and R profiles every bank again. ESC or RUN/STOP returns
+void Hex_DisplayBankMap(void)
+{
+	// LOGIC
+	//   the first visit profiles all 128 banks (about 6 seconds). after that, only banks marked by App_MarkBanksChanged() are redone, 
+	//     so the map normally comes up straight away. R is there for memory changed by something other than f/manager.
+	//   moving the selection only redraws the 2 cells involved, and the detail line: each fetches its own profile from EM.
+	
+	uint8_t		selected = 0;
+	uint8_t		prev_selected;
+	uint8_t		user_input;
+	uint8_t		the_profile[BANK_PROFILE_LEN];
+	bool		redraw_all = true;
+	bool		keep_going = true;
+	char		bank_name[4];
+	
+	do
+	{
+		if (redraw_all == true)
+		{
+			Text_ClearScreen(FILE_CONTENTS_FOREGROUND_COLOR, FILE_CONTENTS_BACKGROUND_COLOR);
+			Hex_UpdateBankProfiles(0);
+			Hex_DrawBankMap(selected);
+			redraw_all = false;
+		}
+		
+		prev_selected = selected;
+		user_input = Keyboard_GetChar();
+		
+		switch (user_input)
+		{
+			case MOVE_UP:
+				if (selected >= BANK_MAP_NUM_COLS)
+				{
+					selected -= BANK_MAP_NUM_COLS;
+				}
+				break;
+				
+			case MOVE_DOWN:
+				if (selected < BANK_CHECKSUM_NUM_BANKS - BANK_MAP_NUM_COLS)
+				{
+					selected += BANK_MAP_NUM_COLS;
+				}
+				break;
+				
+			case MOVE_LEFT:
+				if (selected > 0)
+				{
+					--selected;
+				}
+				break;
+				
+			case MOVE_RIGHT:
+				if (selected < BANK_CHECKSUM_NUM_BANKS - 1)
+				{
+					++selected;
+				}
+				break;
+				
+			case ACTION_SELECT:
+				sprintf(bank_name, "$%02X", selected);
+				Hex_DisplayAsHex(selected, 0, PAGES_PER_BANK, bank_name, PARAM_NO_COMPARE_BANK);
+				redraw_all = true;
+				break;
+				
+			case ACTION_REFRESH_PANEL:
+				memset(global_bank_profile_stale, 0xFF, sizeof(global_bank_profile_stale));
+				redraw_all = true;
+				break;
+				
+			case CH_ESC:
+			case CH_RUNSTOP:
+			case 'q':
+				keep_going = false;
+				break;
+				
+			default:
+				break;
+		}
+		
+		if (redraw_all == false && selected != prev_selected)
+		{
+			App_EMBulkCopy(the_profile, BANK_PROFILE_PHYS_ADDR + (uint16_t)prev_selected * BANK_PROFILE_LEN, BANK_PROFILE_LEN, PARAM_COPY_FROM_EM);
+			Hex_DrawBankMapCell(prev_selected, the_profile, false);
+			App_EMBulkCopy(the_profile, BANK_PROFILE_PHYS_ADDR + (uint16_t)selected * BANK_PROFILE_LEN, BANK_PROFILE_LEN, PARAM_COPY_FROM_EM);
+			Hex_DrawBankMapCell(selected, the_profile, true);
+			Hex_DrawBankMapDetail(selected, the_profile);
+		}
+		
+	} while (keep_going == true);
+}
@@ -0,0 +1,71 @@
+/*
+ * overlay_hex.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef OVERLAY_HEX_H_
+#define OVERLAY_HEX_H_
+
+/* about this class
+ *
+ *  Routines for looking at EM and memory as hex: the hex viewer and the search results list
+ *    these started out in overlay_em.c, and were moved to their own overlay when it ran out of room
+ *    the results list opens the hex viewer, so they live in the same overlay
+ *
+ */
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+#include "app.h"
+#include "text.h"
+#include <stdint.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define PARAM_NO_COMPARE_BANK			0xFF	// parameter for Hex_DisplayAsHex: don't highlight differences from another bank
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// displays the content found in EM as hex codes and text to right, similar to a ML monitor
+// em_bank_num is used to derive the base EM address
+// first_page is the EM 256b chunk to start at (0 to start at em_bank_num's address)
+// num_pages is the number of EM 256b chunks there are, counting from the start of em_bank_num
+// the_name is only used to provide feedback to the user about what they are viewing
+// compare_bank_num is another bank to compare against: bytes that differ from the same place in it are highlighted. PARAM_NO_COMPARE_BANK for none
+// up/down scroll by a row, left/right (or space) by a screenful, g goes to an address, and l turns live mode on/off. ESC or RUN/STOP returns
+void Hex_DisplayAsHex(uint8_t em_bank_num, uint8_t first_page, uint8_t num_pages, char* the_name, uint8_t compare_bank_num);
+
+// shows the matches stored by EM_SearchMemoryForAll() or EM_SearchMemoryForAllPhrases() as a list the user can move through with the cursor keys
+// the_phrase_desc is shown in the title, and should be what the user typed in
+// ENTER opens the hex viewer at the selected match; ESC or RUN/STOP returns
+void Hex_DisplaySearchResults(uint16_t num_hits, char* the_phrase_desc);
+
+// shows the ranges stored by EM_CompareBanks() as a list the user can move through with the cursor keys
+// ENTER opens the hex viewer on the first bank at the selected range, with every byte that differs from the second bank highlighted; ESC or RUN/STOP returns
+void Hex_DisplayCompareResults(uint16_t num_ranges, uint8_t em_bank_num, uint8_t compare_bank_num);
+
+// shows every bank of RAM and flash as a colored cell in a 16x8 grid, so empty, erased, and used banks can be told apart at a glance
+// any bank f/manager has written to since it was last looked at is profiled again first. the rest come from the stored profiles
+// the arrow keys move between banks, ENTER opens the hex viewer on the selected bank, and R profiles every bank again. ESC or RUN/STOP returns
+void Hex_DisplayBankMap(void);
+
+#endif /* OVERLAY_HEX_H_ */
@@ -0,0 +1,837 @@
+/*
+ * overlay_patch.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ *
+ *  Routines for applying IPS and BPS patches to data in memory
+ *    the patch is read a bank at a time through SEARCH_AUTOMATON_EM_SLOT, so it can be far bigger than the data it patches
+ *    the panel asks the user, opens the files, and refreshes itself: loading the file to patch, applying, and writing the result happen here, so they stay out of MAIN
+ *
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "overlay_patch.h"
+#include "app.h"
+#include "bank.h"
+#include "comm_buffer.h"
+#include "debug.h"
+#include "file.h"
+#include "general.h"
+#include "memory.h"
+#include "strings.h"
+
+// C includes
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// F256 includes
+#include "f256.h"
+
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define PATCH_IPS_SIGNATURE				"PATCH"
+#define PATCH_IPS_SIGNATURE_LEN			5
+#define PATCH_IPS_EOF					0x454F46UL	// "EOF", where the offset of the next record would be
+#define PATCH_BPS_SIGNATURE				"BPS1"
+#define PATCH_BPS_SIGNATURE_LEN			4
+#define PATCH_BPS_FOOTER_LEN			12	// source, target, and patch CRC-32s, each little-endian
+#define PATCH_BPS_MAX_NUMBER_LEN		4	// bytes: a BPS number this long is already bigger than all of RAM
+#define PATCH_BPS_SOURCE_READ			0
+#define PATCH_BPS_TARGET_READ			1
+#define PATCH_BPS_SOURCE_COPY			2
+#define PATCH_BPS_TARGET_COPY			3
+#define PATCH_NO_PAGE					-1	// patch_page: nothing is cached
+
+
+/*****************************************************************************/
+/*                           File-scope Variables                            */
+/*****************************************************************************/
+
+
+#pragma data-name ("OVERLAY_PATCH")
+
+static FILE*				patch_handler;
+static uint16_t				patch_pos;		// next byte of the patch, in SEARCH_AUTOMATON_EM_SLOT
+static uint16_t				patch_len;		// bytes of the patch in SEARCH_AUTOMATON_EM_SLOT. under 8192 once the file has run out
+static uint16_t				patch_crc_pos;	// first byte in SEARCH_AUTOMATON_EM_SLOT not yet run through patch_crc
+static uint32_t				patch_crc;
+static bool					patch_counting;	// false once the patch's own CRC has been reached
+static int16_t				patch_page;		// page of SEARCH_AUTOMATON_EM_SLOT copied into STORAGE_FILE_BUFFER_1, or PATCH_NO_PAGE
+static uint32_t				patch_src_len;
+static uint32_t				patch_dst_len;
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern char*				global_string_buff1;
+
+extern uint8_t				zp_search_loc_bank;
+
+#pragma zpsym ("zp_search_loc_bank");
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// runs the_len bytes at the_offset in the_bank_num through the CRC-32 so far, using the table at BANK_CRC32_TABLE_PHYS_ADDR
+uint32_t Patch_Crc32(uint32_t the_crc, uint8_t the_bank_num, uint16_t the_offset, uint16_t the_len);
+
+// returns the finished CRC-32 of the_len bytes of physical memory starting at phys_addr. the range may cross any number of bank boundaries
+uint32_t Patch_Crc32Range(uint32_t phys_addr, uint32_t the_len);
+
+// runs the part of the patch bank that has been read, but not yet counted, through the patch's CRC-32
+void Patch_UpdateCrc(void);
+
+// reads the next bank of the patch file into SEARCH_AUTOMATON_EM_SLOT
+// returns false if the file has run out
+bool Patch_Refill(void);
+
+// returns the next byte of the patch, or -1 if the patch has run out
+int16_t Patch_GetByte(void);
+
+// reads the next the_len bytes of the patch into the_buffer
+// returns false if the patch runs out first
+bool Patch_GetBytes(uint8_t* the_buffer, uint8_t the_len);
+
+// copies the next the_len bytes of the patch to physical address phys_addr, using DMA
+// returns false if the patch runs out first
+bool Patch_CopyTo(uint32_t phys_addr, uint32_t the_len);
+
+// reads a BPS variable-length number from the patch
+// returns false if the patch runs out first, or the number is too big to mean anything here
+bool Patch_GetNumber(uint32_t* the_number);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// runs the_len bytes at the_offset in the_bank_num through the CRC-32 so far, using the table at BANK_CRC32_TABLE_PHYS_ADDR
+uint32_t Patch_Crc32(uint32_t the_crc, uint8_t the_bank_num, uint16_t the_offset, uint16_t the_len)
+{
+	zp_search_loc_bank = the_bank_num;
+	*(uint16_t*)ZP_FROM_ADDR = the_offset;
+	*(uint16_t*)ZP_COPY_LEN = the_len;
+	*(uint8_t*)ZP_OTHER_PARAM = BANK_CHECKSUM_EM_SLOT;
+	
+	return Memory_Crc32(the_crc);
+}
+
+
+// returns the finished CRC-32 of the_len bytes of physical memory starting at phys_addr. the range may cross any number of bank boundaries
+uint32_t Patch_Crc32Range(uint32_t phys_addr, uint32_t the_len)
+{
+	uint32_t	the_crc = 0xFFFFFFFFUL;
+	uint16_t	the_offset;
+	uint16_t	the_chunk_len;
+	
+	while (the_len > 0)
+	{
+		the_offset = phys_addr & (BYTES_PER_BANK - 1);
+		the_chunk_len = BYTES_PER_BANK - the_offset;
+		
+		if (the_len < the_chunk_len)
+		{
+			the_chunk_len = the_len;
+		}
+		
+		the_crc = Patch_Crc32(the_crc, (uint8_t)(phys_addr >> 13), the_offset, the_chunk_len);
+		phys_addr += the_chunk_len;
+		the_len -= the_chunk_len;
+	}
+	
+	return ~the_crc;
+}
+
+
+// runs the part of the patch bank that has been read, but not yet counted, through the patch's CRC-32
+void Patch_UpdateCrc(void)
+{
+	if (patch_counting && patch_pos > patch_crc_pos)
+	{
+		patch_crc = Patch_Crc32(patch_crc, SEARCH_AUTOMATON_EM_SLOT, patch_crc_pos, patch_pos - patch_crc_pos);
+	}
+	
+	patch_crc_pos = patch_pos;
+}
+
+
+// reads the next bank of the patch file into SEARCH_AUTOMATON_EM_SLOT
+// returns false if the file has run out
+bool Patch_Refill(void)
+{
+	// LOGIC:
+	//   the bank being replaced is counted before it goes: the CRC is always one pass over the patch, in the bank it was read into.
+	
+	Patch_UpdateCrc();
+	
+	patch_len = App_EMReadFromFile(patch_handler, SEARCH_AUTOMATON_EM_SLOT);
+	patch_pos = 0;
+	patch_crc_pos = 0;
+	patch_page = PATCH_NO_PAGE;
+	
+	return (patch_len > 0);
+}
+
+
+// returns the next byte of the patch, or -1 if the patch has run out
+int16_t Patch_GetByte(void)
+{
+	if (patch_pos == patch_len)
+	{
+		if (patch_len < BYTES_PER_BANK || Patch_Refill() == false)
+		{
+			return -1;
+		}
+	}
+	
+	if ((patch_pos >> 8) != patch_page)
+	{
+		patch_page = patch_pos >> 8;
+		App_EMDataCopy((uint8_t*)STORAGE_FILE_BUFFER_1, SEARCH_AUTOMATON_EM_SLOT, patch_page, PARAM_COPY_FROM_EM);
+	}
+	
+	return ((uint8_t*)STORAGE_FILE_BUFFER_1)[patch_pos++ & 0xFF];
+}
+
+
+// reads the next the_len bytes of the patch into the_buffer
+// returns false if the patch runs out first
+bool Patch_GetBytes(uint8_t* the_buffer, uint8_t the_len)
+{
+	int16_t		the_byte;
+	
+	for (; the_len > 0; the_len--)
+	{
+		if ( (the_byte = Patch_GetByte()) < 0)
+		{
+			return false;
+		}
+		
+		*the_buffer++ = the_byte;
+	}
+	
+	return true;
+}
+
+
+// copies the next the_len bytes of the patch to physical address phys_addr, using DMA
+// returns false if the patch runs out first
+bool Patch_CopyTo(uint32_t phys_addr, uint32_t the_len)
+{
+	uint16_t	the_chunk_len;
+	
+	// LOGIC:
+	//   literal data goes straight from the patch bank to where it belongs, as much of it as the patch bank holds at a time.
+	//   the bytes never pass through CPU space.
+	
+	while (the_len > 0)
+	{
+		if (patch_pos == patch_len)
+		{
+			if (patch_len < BYTES_PER_BANK || Patch_Refill() == false)
+			{
+				return false;
+			}
+		}
+		
+		the_chunk_len = patch_len - patch_pos;
+		
+		if (the_len < the_chunk_len)
+		{
+			the_chunk_len = the_len;
+		}
+		
+		App_MoveMemoryWithDMA(phys_addr, SEARCH_AUTOMATON_PHYS_ADDR + patch_pos, the_chunk_len);
+		patch_pos += the_chunk_len;
+		phys_addr += the_chunk_len;
+		the_len -= the_chunk_len;
+	}
+	
+	return true;
+}
+
+
+// reads a BPS variable-length number from the patch
+// returns false if the patch runs out first, or the number is too big to mean anything here
+bool Patch_GetNumber(uint32_t* the_number)
+{
+	uint32_t	the_data = 0;
+	uint8_t		the_shift = 0;
+	uint8_t		i;
+	int16_t		the_byte;
+	
+	// LOGIC:
+	//   7 bits per byte, low bits first. the top bit marks the last byte.
+	//   every byte but the last also adds one to the next 7 bits, so each number has only one encoding.
+	
+	for (i = 0; i < PATCH_BPS_MAX_NUMBER_LEN; i++)
+	{
+		if ( (the_byte = Patch_GetByte()) < 0)
+		{
+			return false;
+		}
+		
+		the_data += (uint32_t)(the_byte & 0x7F) << the_shift;
+		
+		if (the_byte & 0x80)
+		{
+			*the_number = the_data;
+			return true;
+		}
+		
+		the_shift += 7;
+		the_data += (uint32_t)1 << the_shift;
+	}
+	
+	return false;
+}
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// gets ready to apply the patch in the open file, and works out what kind of patch it is
+// the patch is read a bank at a time into SEARCH_AUTOMATON_EM_SLOT. the CRC-32 table is (re)built at BANK_CRC32_TABLE_PHYS_ADDR
+// for a BPS patch, sets src_len and dst_len to the lengths of the data before and after patching. an IPS patch doesn't say: both are set to 0
+// returns PATCH_FORMAT_IPS, PATCH_FORMAT_BPS, or PATCH_FORMAT_UNKNOWN
+uint8_t Patch_Open(FILE* the_file_handler, uint32_t* src_len, uint32_t* dst_len)
+{
+	uint8_t		the_signature[PATCH_IPS_SIGNATURE_LEN];
+	uint32_t	the_metadata_len;
+	
+	*src_len = 0;
+	*dst_len = 0;
+	
+	*(uint8_t*)ZP_OTHER_PARAM = BANK_CHECKSUM_EM_SLOT;
+	Memory_MakeCrc32Table();
+	
+	App_MarkBanksChanged(SEARCH_AUTOMATON_PHYS_ADDR, BYTES_PER_BANK);
+	
+	// start out as if a full bank had just been used up, so the first byte asked for reads the first bank
+	patch_handler = the_file_handler;
+	patch_len = BYTES_PER_BANK;
+	patch_pos = BYTES_PER_BANK;
+	patch_crc_pos = BYTES_PER_BANK;
+	patch_crc = 0xFFFFFFFFUL;
+	patch_counting = true;
+	patch_page = PATCH_NO_PAGE;
+	
+	if (Patch_GetBytes(the_signature, PATCH_BPS_SIGNATURE_LEN) == false)
+	{
+		return PATCH_FORMAT_UNKNOWN;
+	}
+	
+	if (memcmp(the_signature, PATCH_BPS_SIGNATURE, PATCH_BPS_SIGNATURE_LEN) == 0)
+	{
+		if (Patch_GetNumber(&patch_src_len) == false || Patch_GetNumber(&patch_dst_len) == false || Patch_GetNumber(&the_metadata_len) == false)
+		{
+			return PATCH_FORMAT_UNKNOWN;
+		}
+		
+		// the metadata is only for people to read: skip it
+		for (; the_metadata_len > 0; the_metadata_len--)
+		{
+			if (Patch_GetByte() < 0)
+			{
+				return PATCH_FORMAT_UNKNOWN;
+			}
+		}
+		
+		*src_len = patch_src_len;
+		*dst_len = patch_dst_len;
+		
+		return PATCH_FORMAT_BPS;
+	}
+	
+	if (Patch_GetBytes(&the_signature[PATCH_BPS_SIGNATURE_LEN], PATCH_IPS_SIGNATURE_LEN - PATCH_BPS_SIGNATURE_LEN) == false)
+	{
+		return PATCH_FORMAT_UNKNOWN;
+	}
+	
+	if (memcmp(the_signature, PATCH_IPS_SIGNATURE, PATCH_IPS_SIGNATURE_LEN) == 0)
+	{
+		patch_counting = false;	// IPS has no CRC
+		
+		return PATCH_FORMAT_IPS;
+	}
+	
+	return PATCH_FORMAT_UNKNOWN;
+}
+
+
+// applies the IPS patch opened by Patch_Open(), in place, to the data at physical address the_addr
+// the patch may not write past the_addr + max_len. set the_len to the length of the data before patching: it is set to the length after
+// IPS has no checksums: if the patch turns out to be damaged, the data may already have been partly patched
+// returns PATCH_OK, PATCH_ERROR_DAMAGED, or PATCH_ERROR_TOO_BIG
+uint8_t Patch_ApplyIPS(uint32_t the_addr, uint32_t max_len, uint32_t* the_len)
+{
+	uint8_t		the_record[3];
+	uint32_t	the_offset;
+	uint16_t	the_size;
+	uint8_t		the_fill_value;
+	
+	// LOGIC:
+	//   each record is a 3-byte offset and a 2-byte size, big-endian, then that many bytes to copy in.
+	//   a size of 0 means a run instead: a 2-byte count and the byte to repeat.
+	//   the list ends with "EOF" where the next offset would be. some patchers add a 3-byte length after that, to cut the data down to.
+	
+	while (true)
+	{
+		if (Patch_GetBytes(the_record, 3) == false)
+		{
+			return PATCH_ERROR_DAMAGED;
+		}
+		
+		the_offset = ((uint32_t)the_record[0] << 16) | ((uint16_t)the_record[1] << 8) | the_record[2];
+		
+		if (the_offset == PATCH_IPS_EOF)
+		{
+			break;
+		}
+		
+		if (Patch_GetBytes(the_record, 2) == false)
+		{
+			return PATCH_ERROR_DAMAGED;
+		}
+		
+		the_size = ((uint16_t)the_record[0] << 8) | the_record[1];
+		
+		if (the_size == 0)
+		{
+			if (Patch_GetBytes(the_record, 3) == false)
+			{
+				return PATCH_ERROR_DAMAGED;
+			}
+			
+			the_size = ((uint16_t)the_record[0] << 8) | the_record[1];
+			the_fill_value = the_record[2];
+			
+			if (the_size == 0)
+			{
+				continue;
+			}
+			
+			if (the_offset + the_size > max_len)
+			{
+				return PATCH_ERROR_TOO_BIG;
+			}
+			
+			App_FillMemoryWithDMA(the_addr + the_offset, the_size, the_fill_value);
+		}
+		else
+		{
+			if (the_offset + the_size > max_len)
+			{
+				return PATCH_ERROR_TOO_BIG;
+			}
+			
+			if (Patch_CopyTo(the_addr + the_offset, the_size) == false)
+			{
+				return PATCH_ERROR_DAMAGED;
+			}
+		}
+		
+		if (the_offset + the_size > *the_len)
+		{
+			*the_len = the_offset + the_size;
+		}
+	}
+	
+	if (Patch_GetBytes(the_record, 3) == true)
+	{
+		*the_len = ((uint32_t)the_record[0] << 16) | ((uint16_t)the_record[1] << 8) | the_record[2];
+		
+		if (*the_len > max_len)
+		{
+			return PATCH_ERROR_TOO_BIG;
+		}
+	}
+	
+	return PATCH_OK;
+}
+
+
+// applies the BPS patch opened by Patch_Open() to the data at physical address src_addr, building the result at dst_addr
+// the ranges must not overlap. the patch, the source, and the result are all checked against the CRC-32s at the end of the patch
+// returns PATCH_OK, PATCH_ERROR_DAMAGED, PATCH_ERROR_WRONG_SOURCE, or PATCH_ERROR_BAD_RESULT
+uint8_t Patch_ApplyBPS(uint32_t src_addr, uint32_t dst_addr)
+{
+	uint32_t	out_pos = 0;
+	uint32_t	src_rel_pos = 0;
+	uint32_t	dst_rel_pos = 0;
+	uint32_t	the_data;
+	uint32_t	the_len;
+	uint32_t	the_chunk_len;
+	uint32_t	copy_from;
+	uint8_t		the_footer[PATCH_BPS_FOOTER_LEN];
+	uint8_t		last_bank_done = 0;
+	
+	// LOGIC:
+	//   the result is written once, front to back. each command is a number: the low 2 bits say what to do, the rest how many bytes (- 1).
+	//     source read: the bytes at the same place in the source. 
+	//     target read: the bytes that follow in the patch.
+	//     source copy / target copy: bytes from elsewhere in the source, or from earlier in the result. 
+	//       a second number moves where they come from (low bit is the sign) from where the last copy of that kind ended.
+	//   everything is moved with DMA. a target copy can overlap what it is writing (that is how BPS does runs), so it is done in
+	//     chunks that each end where the result did when the chunk began: the first copies the pattern once, the next twice, and so on.
+	
+	while (out_pos < patch_dst_len)
+	{
+		if (Patch_GetNumber(&the_data) == false)
+		{
+			return PATCH_ERROR_DAMAGED;
+		}
+		
+		the_len = (the_data >> 2) + 1;
+		
+		if (the_len > patch_dst_len - out_pos)
+		{
+			return PATCH_ERROR_DAMAGED;
+		}
+		
+		switch (the_data & 0x03)
+		{
+			case PATCH_BPS_SOURCE_READ:
+				if (out_pos + the_len > patch_src_len)
+				{
+					return PATCH_ERROR_DAMAGED;
+				}
+				
+				App_MoveMemoryWithDMA(dst_addr + out_pos, src_addr + out_pos, the_len);
+				out_pos += the_len;
+				break;
+				
+			case PATCH_BPS_TARGET_READ:
+				if (Patch_CopyTo(dst_addr + out_pos, the_len) == false)
+				{
+					return PATCH_ERROR_DAMAGED;
+				}
+				
+				out_pos += the_len;
+				break;
+				
+			case PATCH_BPS_SOURCE_COPY:
+				if (Patch_GetNumber(&the_data) == false)
+				{
+					return PATCH_ERROR_DAMAGED;
+				}
+				
+				if (the_data & 0x01)
+				{
+					if ((the_data >> 1) > src_rel_pos)
+					{
+						return PATCH_ERROR_DAMAGED;
+					}
+					
+					src_rel_pos -= (the_data >> 1);
+				}
+				else
+				{
+					src_rel_pos += (the_data >> 1);
+				}
+				
+				if (src_rel_pos > patch_src_len || the_len > patch_src_len - src_rel_pos)
+				{
+					return PATCH_ERROR_DAMAGED;
+				}
+				
+				App_MoveMemoryWithDMA(dst_addr + out_pos, src_addr + src_rel_pos, the_len);
+				src_rel_pos += the_len;
+				out_pos += the_len;
+				break;
+				
+			case PATCH_BPS_TARGET_COPY:
+				if (Patch_GetNumber(&the_data) == false)
+				{
+					return PATCH_ERROR_DAMAGED;
+				}
+				
+				if (the_data & 0x01)
+				{
+					if ((the_data >> 1) > dst_rel_pos)
+					{
+						return PATCH_ERROR_DAMAGED;
+					}
+					
+					dst_rel_pos -= (the_data >> 1);
+				}
+				else
+				{
+					dst_rel_pos += (the_data >> 1);
+				}
+				
+				if (dst_rel_pos >= out_pos)
+				{
+					return PATCH_ERROR_DAMAGED;
+				}
+				
+				copy_from = dst_rel_pos;
+				dst_rel_pos += the_len;
+				
+				while (the_len > 0)
+				{
+					the_chunk_len = out_pos - copy_from;
+					
+					if (the_len < the_chunk_len)
+					{
+						the_chunk_len = the_len;
+					}
+					
+					App_MoveMemoryWithDMA(dst_addr + out_pos, dst_addr + copy_from, the_chunk_len);
+					out_pos += the_chunk_len;
+					the_len -= the_chunk_len;
+				}
+				break;
+		}
+		
+		if ((uint8_t)(out_pos >> 13) != last_bank_done)
+		{
+			last_bank_done = (uint8_t)(out_pos >> 13);
+			App_UpdateProgressBar((uint8_t)(out_pos * 100 / patch_dst_len));
+		}
+	}
+	
+	// the patch's own CRC covers everything but itself: stop counting once the source and target CRCs have been read
+	if (Patch_GetBytes(the_footer, PATCH_BPS_FOOTER_LEN - sizeof(uint32_t)) == false)
+	{
+		return PATCH_ERROR_DAMAGED;
+	}
+	
+	Patch_UpdateCrc();
+	patch_counting = false;
+	
+	if (Patch_GetBytes(&the_footer[PATCH_BPS_FOOTER_LEN - sizeof(uint32_t)], sizeof(uint32_t)) == false)
+	{
+		return PATCH_ERROR_DAMAGED;
+	}
+	
+	if (~patch_crc != *(uint32_t*)&the_footer[8])
+	{
+		return PATCH_ERROR_DAMAGED;
+	}
+	
+	if (Patch_Crc32Range(src_addr, patch_src_len) != *(uint32_t*)&the_footer[0])
+	{
+		return PATCH_ERROR_WRONG_SOURCE;
+	}
+	
+	if (Patch_Crc32Range(dst_addr, patch_dst_len) != *(uint32_t*)&the_footer[4])
+	{
+		return PATCH_ERROR_BAD_RESULT;
+	}
+	
+	return PATCH_OK;
+}
+
+
+
+// reads the open file to be patched into the EM storage area at $28000, a bank at a time, and sets the_len to exactly how long it is
+// returns PATCH_OK, or PATCH_ERROR_TOO_BIG if the file doesn't all fit
+uint8_t Patch_LoadSource(FILE* the_file_handler, uint32_t* the_len)
+{
+	uint8_t			the_bank_num = EM_STORAGE_START_PHYS_BANK_NUM;
+	uint8_t			the_byte;
+	uint16_t		bytes_read;
+	uint32_t		max_len = (uint32_t)FILE_EM_STORAGE_MAX_BANKS * BYTES_PER_BANK;
+	
+	*the_len = 0;
+	
+	do
+	{
+		bytes_read = App_EMReadFromFile(the_file_handler, the_bank_num++);
+		*the_len += bytes_read;
+	} while (bytes_read == BYTES_PER_BANK && *the_len < max_len);
+	
+	// a file that fills the whole area may still have more to come
+	if (*the_len == max_len && fread(&the_byte, sizeof(char), 1, the_file_handler) == 1)
+	{
+		return PATCH_ERROR_TOO_BIG;
+	}
+	
+	return PATCH_OK;
+}
+
+
+// applies the patch in the open file to the src_len bytes at physical address src_addr, and sets the_format to the kind of patch it was
+// for_file: the data is a file loaded by Patch_LoadSource(). an IPS result is built in place, a BPS result in the banks after the file
+// otherwise the data is RAM, which may be patched up to max_len bytes past src_addr. a BPS result is built in the EM storage area, and only copied over the source once every check has passed
+// sets dst_addr and dst_len to where the result ended up, and how long it is. max_len is set to the room the result had, for reporting PATCH_ERROR_TOO_BIG
+// returns PATCH_OK, or one of the PATCH_ERROR_* results
+uint8_t Patch_ApplyToData(FILE* the_file_handler, bool for_file, uint32_t src_addr, uint32_t src_len, uint32_t* max_len, uint32_t* dst_addr, uint32_t* dst_len, uint8_t* the_format)
+{
+	uint8_t				the_result = PATCH_OK;
+	uint32_t			bps_src_len;
+	
+	*the_format = Patch_Open(the_file_handler, &bps_src_len, dst_len);
+	
+	if (*the_format == PATCH_FORMAT_IPS)
+	{
+		if (for_file == true)
+		{
+			// an IPS patch can make the file longer: anything between the end of the file and what the patch adds past it is 0
+			if (src_len < *max_len)
+			{
+				App_FillMemoryWithDMA(src_addr + src_len, *max_len - src_len, 0);
+			}
+		}
+		
+		// RAM has no length of its own: there, the result is as long as the patch reaches
+		*dst_addr = src_addr;
+		*dst_len = src_len;
+		
+		return Patch_ApplyIPS(src_addr, *max_len, dst_len);
+	}
+	
+	if (*the_format != PATCH_FORMAT_BPS)
+	{
+		return PATCH_ERROR_NOT_A_PATCH;
+	}
+	
+	if (for_file == true)
+	{
+		// build the result in the banks after the file
+		*dst_addr = src_addr + (src_len + (BYTES_PER_BANK - 1)) / BYTES_PER_BANK * BYTES_PER_BANK;
+		*max_len -= *dst_addr - src_addr;
+		
+		if (bps_src_len != src_len)
+		{
+			the_result = PATCH_ERROR_WRONG_SOURCE;
+		}
+	}
+	else
+	{
+		// the source, and the result once it is copied back, must stay clear of the banks the result is built in
+		if (src_addr < EM_STORAGE_START_PHYS_ADDR + (uint32_t)FILE_EM_STORAGE_MAX_BANKS * BYTES_PER_BANK &&
+			src_addr + (bps_src_len > *dst_len ? bps_src_len : *dst_len) > EM_STORAGE_START_PHYS_ADDR)
+		{
+			return PATCH_ERROR_USES_STAGING;
+		}
+		
+		if (bps_src_len > *max_len || *dst_len > *max_len)
+		{
+			the_result = PATCH_ERROR_TOO_BIG;
+		}
+		else
+		{
+			*dst_addr = EM_STORAGE_START_PHYS_ADDR;
+			*max_len = (uint32_t)FILE_EM_STORAGE_MAX_BANKS * BYTES_PER_BANK;
+		}
+	}
+	
+	if (the_result == PATCH_OK && *dst_len > *max_len)
+	{
+		the_result = PATCH_ERROR_TOO_BIG;
+	}
+	
+	if (the_result == PATCH_OK)
+	{
+		App_ShowProgressBar();
+		the_result = Patch_ApplyBPS(src_addr, *dst_addr);
+		App_HideProgressBar();
+	}
+	
+	// every check passed: now the result can replace what was in RAM
+	if (the_result == PATCH_OK && for_file == false)
+	{
+		App_MoveMemoryWithDMA(src_addr, *dst_addr, *dst_len);
+		*dst_addr = src_addr;
+	}
+	
+	return the_result;
+}
+
+
+// writes the_len bytes of memory starting at physical address the_addr to the open file, showing progress as it goes
+// returns false on any disk error
+bool Patch_WriteResult(FILE* the_file_handler, uint32_t the_addr, uint32_t the_len)
+{
+	uint8_t				the_bank_num;
+	uint16_t			bank_offset;
+	uint16_t			chunk_len;
+	uint32_t			bytes_remaining = the_len;
+	bool				success = true;
+	
+	App_ShowProgressBar();
+	
+	while (bytes_remaining > 0 && success == true)
+	{
+		the_bank_num = the_addr / BYTES_PER_BANK;
+		bank_offset = the_addr & (BYTES_PER_BANK - 1);
+		chunk_len = BANK_SAVE_CHUNK_LEN - (bank_offset & (BANK_SAVE_CHUNK_LEN - 1));
+		
+		if (chunk_len > bytes_remaining)
+		{
+			chunk_len = bytes_remaining;
+		}
+		
+		success = App_EMWriteToFile(the_file_handler, the_bank_num, bank_offset, chunk_len);
+		
+		the_addr += chunk_len;
+		bytes_remaining -= chunk_len;
+		
+		App_UpdateProgressBar((uint8_t)(((the_len - bytes_remaining) * 100) / the_len));
+	}
+	
+	App_HideProgressBar();
+	
+	return success;
+}
+
+
+// tells the user how applying a patch went. dst_len and max_len are only used by the messages that show them
+void Patch_ShowResult(uint8_t the_format, uint8_t the_result, uint32_t dst_len, uint32_t max_len)
+{
+	switch (the_result)
+	{
+		case PATCH_OK:
+			sprintf(global_string_buff1, General_GetString(the_format == PATCH_FORMAT_IPS ? ID_STR_MSG_IPS_PATCH_APPLIED : ID_STR_MSG_BPS_PATCH_APPLIED), dst_len);
+			Buffer_NewMessage(global_string_buff1);
+			break;
+			
+		case PATCH_ERROR_TOO_BIG:
+			sprintf(global_string_buff1, General_GetString(ID_STR_ERROR_PATCH_TOO_BIG), max_len);
+			Buffer_NewMessage(global_string_buff1);
+			break;
+			
+		case PATCH_ERROR_WRONG_SOURCE:
+			Buffer_NewMessage(General_GetString(ID_STR_ERROR_PATCH_WRONG_SOURCE));
+			break;
+			
+		case PATCH_ERROR_BAD_RESULT:
+			Buffer_NewMessage(General_GetString(ID_STR_ERROR_PATCH_BAD_RESULT));
+			break;
+			
+		case PATCH_ERROR_NOT_A_PATCH:
+			Buffer_NewMessage(General_GetString(ID_STR_ERROR_NOT_A_PATCH));
+			break;
+			
+		case PATCH_ERROR_USES_STAGING:
+			Buffer_NewMessage(General_GetString(ID_STR_ERROR_PATCH_USES_STAGING));
+			break;
+			
+		default:
+			Buffer_NewMessage(General_GetString(ID_STR_ERROR_PATCH_DAMAGED));
+			break;
+	}
+}
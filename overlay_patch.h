@@ -0,0 +1,93 @@
+/*
+ * overlay_patch.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef OVERLAY_PATCH_H_
+#define OVERLAY_PATCH_H_
+
+/* about this class
+ *
+ *  Routines for applying IPS and BPS patches to data in memory
+ *    the patch is read a bank at a time through SEARCH_AUTOMATON_EM_SLOT, so it can be far bigger than the data it patches
+ *    the panel asks the user, opens the files, and refreshes itself: loading the file to patch, applying, and writing the result happen here, so they stay out of MAIN
+ *
+ */
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+#include "app.h"
+#include <stdint.h>
+#include <stdio.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define PATCH_FORMAT_UNKNOWN		0	// Patch_Open() result: the file is not a patch
+#define PATCH_FORMAT_IPS			1	// Patch_Open() result: the file is an IPS patch
+#define PATCH_FORMAT_BPS			2	// Patch_Open() result: the file is a BPS patch
+
+#define PATCH_OK					0	// Patch_Apply*() result: the patch was applied
+#define PATCH_ERROR_DAMAGED			1	// Patch_Apply*() result: the patch ran out early, points outside the data, or fails its own CRC
+#define PATCH_ERROR_TOO_BIG			2	// Patch_Apply*() result: the patched data would not fit in the room given
+#define PATCH_ERROR_WRONG_SOURCE	3	// Patch_ApplyBPS() result: the source is not the one the patch was made from
+#define PATCH_ERROR_BAD_RESULT		4	// Patch_ApplyBPS() result: the patched data is not what the patch says it should be
+#define PATCH_ERROR_NOT_A_PATCH		5	// Patch_ApplyToData() result: the file is neither an IPS nor a BPS patch
+#define PATCH_ERROR_USES_STAGING	6	// Patch_ApplyToData() result: the RAM being patched overlaps the banks a BPS result is built in
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// gets ready to apply the patch in the open file, and works out what kind of patch it is
+// the patch is read a bank at a time into SEARCH_AUTOMATON_EM_SLOT. the CRC-32 table is (re)built at BANK_CRC32_TABLE_PHYS_ADDR
+// for a BPS patch, sets src_len and dst_len to the lengths of the data before and after patching. an IPS patch doesn't say: both are set to 0
+// returns PATCH_FORMAT_IPS, PATCH_FORMAT_BPS, or PATCH_FORMAT_UNKNOWN
+uint8_t Patch_Open(FILE* the_file_handler, uint32_t* src_len, uint32_t* dst_len);
+
+// applies the IPS patch opened by Patch_Open(), in place, to the data at physical address the_addr
+// the patch may not write past the_addr + max_len. set the_len to the length of the data before patching: it is set to the length after
+// IPS has no checksums: if the patch turns out to be damaged, the data may already have been partly patched
+// returns PATCH_OK, PATCH_ERROR_DAMAGED, or PATCH_ERROR_TOO_BIG
+uint8_t Patch_ApplyIPS(uint32_t the_addr, uint32_t max_len, uint32_t* the_len);
+
+// applies the BPS patch opened by Patch_Open() to the data at physical address src_addr, building the result at dst_addr
+// the ranges must not overlap. the patch, the source, and the result are all checked against the CRC-32s at the end of the patch
+// returns PATCH_OK, PATCH_ERROR_DAMAGED, PATCH_ERROR_WRONG_SOURCE, or PATCH_ERROR_BAD_RESULT
+uint8_t Patch_ApplyBPS(uint32_t src_addr, uint32_t dst_addr);
+
+// reads the open file to be patched into the EM storage area at $28000, a bank at a time, and sets the_len to exactly how long it is
+// returns PATCH_OK, or PATCH_ERROR_TOO_BIG if the file doesn't all fit
+uint8_t Patch_LoadSource(FILE* the_file_handler, uint32_t* the_len);
+
+// applies the patch in the open file to the src_len bytes at physical address src_addr, and sets the_format to the kind of patch it was
+// for_file: the data is a file loaded by Patch_LoadSource(). an IPS result is built in place, a BPS result in the banks after the file
+// otherwise the data is RAM, which may be patched up to max_len bytes past src_addr. a BPS result is built in the EM storage area, and only copied over the source once every check has passed
+// sets dst_addr and dst_len to where the result ended up, and how long it is. max_len is set to the room the result had, for reporting PATCH_ERROR_TOO_BIG
+// returns PATCH_OK, or one of the PATCH_ERROR_* results
+uint8_t Patch_ApplyToData(FILE* the_file_handler, bool for_file, uint32_t src_addr, uint32_t src_len, uint32_t* max_len, uint32_t* dst_addr, uint32_t* dst_len, uint8_t* the_format);
+
+// writes the_len bytes of memory starting at physical address the_addr to the open file, showing progress as it goes
+// returns false on any disk error
+bool Patch_WriteResult(FILE* the_file_handler, uint32_t the_addr, uint32_t the_len);
+
+// tells the user how applying a patch went. dst_len and max_len are only used by the messages that show them
+void Patch_ShowResult(uint8_t the_format, uint8_t the_result, uint32_t dst_len, uint32_t max_len);
+
+#endif /* OVERLAY_PATCH_H_ */
@@ -0,0 +1,373 @@
+/*
+ * overlay_snapshot.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ *
+ *  Routines for saving RAM to a snapshot file, and restoring it again
+ *    the panel asks the user, opens the files, and refreshes itself: these do the work in between, so it stays out of MAIN
+ *
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "overlay_snapshot.h"
+#include "app.h"
+#include "bank.h"
+#include "comm_buffer.h"
+#include "debug.h"
+#include "general.h"
+#include "memory.h"
+#include "memsys.h"
+#include "strings.h"
+
+// C includes
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// F256 includes
+#include "f256.h"
+
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define SNAPSHOT_BANK_IS_FLAGGED(the_banks, bank_num)	((the_banks)[(bank_num) >> 3] & (1 << ((bank_num) & 0x07)))
+
+
+/*****************************************************************************/
+/*                           File-scope Variables                            */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern char*				global_string_buff1;
+
+extern uint8_t				global_snapshot_count;
+
+extern uint8_t				zp_search_loc_bank;
+
+#pragma zpsym ("zp_search_loc_bank");
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// makes the staged checksums the ones the next snapshot is compared against, and counts one more snapshot made or restored
+void Snapshot_AcceptPendingChecksums(void);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// makes the staged checksums the ones the next snapshot is compared against, and counts one more snapshot made or restored
+void Snapshot_AcceptPendingChecksums(void)
+{
+	App_EMBulkCopy((uint8_t*)STORAGE_FILE_BUFFER_1, BANK_SNAPSHOT_PENDING_PHYS_ADDR, BANK_SNAPSHOT_CHECKSUMS_LEN, PARAM_COPY_FROM_EM);
+	App_EMBulkCopy((uint8_t*)STORAGE_FILE_BUFFER_1, BANK_SNAPSHOT_PHYS_ADDR, BANK_SNAPSHOT_CHECKSUMS_LEN, PARAM_COPY_TO_EM);
+	
+	if (global_snapshot_count < 255)
+	{
+		++global_snapshot_count;
+	}
+}
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// checksums every bank flagged in the_banks, and stages the checksums for the next snapshot file. banks not flagged are staged as 0
+// the_banks is a bitmap of the banks of RAM, as MemSys_GetWriteableBanks() makes it. on entry it flags the banks the user can write to
+// on return, only the banks that need storing are still flagged: every one for the first snapshot, after that only those that changed since the last snapshot made or restored
+// returns the number of banks that need storing
+uint8_t Snapshot_FindChangedBanks(uint8_t* the_banks)
+{
+	uint8_t		the_bank_num;
+	uint8_t		num_banks = 0;
+	uint32_t	the_checksum;
+	uint32_t	prev_checksum;
+	
+	// LOGIC:
+	//   every bank the user can write to gets a fresh checksum: the cached ones only notice f/manager's own writes, and other programs may have run since.
+	//   all the checksums go in the file, stored or not, so a restore can check each bank it writes, and can become the basis for the next snapshot.
+	//   a bank is stored if there is no previous snapshot, or if its checksum differs from the one the previous snapshot recorded.
+	
+	for (the_bank_num = 0; the_bank_num < MEMORY_BANK_COUNT; the_bank_num++)
+	{
+		the_checksum = 0;
+		
+		if (SNAPSHOT_BANK_IS_FLAGGED(the_banks, the_bank_num))
+		{
+			zp_search_loc_bank = the_bank_num;
+			the_checksum = Memory_ChecksumBank();
+			App_EMBulkCopy((uint8_t*)&prev_checksum, BANK_SNAPSHOT_PHYS_ADDR + (uint16_t)the_bank_num * 4, 4, PARAM_COPY_FROM_EM);
+			
+			if (global_snapshot_count == 0 || the_checksum != prev_checksum)
+			{
+				++num_banks;
+			}
+			else
+			{
+				the_banks[the_bank_num >> 3] &= ~(1 << (the_bank_num & 0x07));
+			}
+		}
+		
+		App_EMBulkCopy((uint8_t*)&the_checksum, BANK_SNAPSHOT_PENDING_PHYS_ADDR + (uint16_t)the_bank_num * 4, 4, PARAM_COPY_TO_EM);
+	}
+	
+	return num_banks;
+}
+
+
+// writes a snapshot of the num_banks banks flagged in the_banks to the open file, then closes it
+// each bank is packed by Memory_CompressBank() if it will pack, and written as is if it won't
+// once the whole file is written, the staged checksums become the ones the next snapshot is compared against
+// tells the user how it went. returns false on any disk error
+bool Snapshot_Save(FILE* the_file_handler, uint8_t* the_banks, uint8_t num_banks)
+{
+	uint8_t		the_bank_num;
+	uint8_t		num_saved = 0;
+	uint8_t		src_bank_num;
+	uint8_t		the_header[BANK_SNAPSHOT_HEADER_LEN];
+	uint8_t		the_record[BANK_SNAPSHOT_RECORD_LEN];
+	uint16_t	data_len;
+	uint32_t	file_len;
+	bool		success;
+	
+	// LOGIC:
+	//   each stored bank is packed by Memory_CompressBank() into the search automaton bank and written straight from there. if it won't pack, it is written as is.
+	//   the previous snapshot's checksums are only replaced once the whole file has been written.
+	
+	App_ShowProgressBar();
+	
+	memcpy(the_header, BANK_SNAPSHOT_SIGNATURE, BANK_SNAPSHOT_SIGNATURE_LEN);
+	the_header[BANK_SNAPSHOT_VERSION] = BANK_SNAPSHOT_CURRENT_VERSION;
+	the_header[BANK_SNAPSHOT_NUM_RECORDS] = num_banks;
+	the_header[BANK_SNAPSHOT_FLAGS] = (global_snapshot_count == 0) ? 0 : BANK_SNAPSHOT_FLAG_INCREMENTAL;
+	the_header[BANK_SNAPSHOT_FLAGS + 1] = 0;
+	
+	success = (fwrite(the_header, sizeof(char), BANK_SNAPSHOT_HEADER_LEN, the_file_handler) == BANK_SNAPSHOT_HEADER_LEN);
+	
+	if (success)
+	{
+		success = App_EMWriteToFile(the_file_handler, BANK_CHECKSUM_EM_SLOT, BANK_SNAPSHOT_PENDING_PHYS_ADDR - BANK_CHECKSUM_PHYS_ADDR, BANK_SNAPSHOT_CHECKSUMS_LEN);
+	}
+	
+	file_len = BANK_SNAPSHOT_HEADER_LEN + BANK_SNAPSHOT_CHECKSUMS_LEN;
+	App_MarkBanksChanged(SEARCH_AUTOMATON_PHYS_ADDR, BYTES_PER_BANK);
+	
+	for (the_bank_num = 0; the_bank_num < MEMORY_BANK_COUNT && success == true; the_bank_num++)
+	{
+		if (SNAPSHOT_BANK_IS_FLAGGED(the_banks, the_bank_num) == 0)
+		{
+			continue;
+		}
+		
+		zp_search_loc_bank = the_bank_num;
+		*(uint8_t*)ZP_OTHER_PARAM = SEARCH_AUTOMATON_EM_SLOT;
+		data_len = Memory_CompressBank();
+		
+		if (data_len == 0)
+		{
+			the_record[BANK_SNAPSHOT_RECORD_ENCODING] = BANK_SNAPSHOT_ENCODING_RAW;
+			data_len = BYTES_PER_BANK;
+			src_bank_num = the_bank_num;
+		}
+		else
+		{
+			the_record[BANK_SNAPSHOT_RECORD_ENCODING] = BANK_SNAPSHOT_ENCODING_PACKED;
+			src_bank_num = SEARCH_AUTOMATON_EM_SLOT;
+		}
+		
+		the_record[BANK_SNAPSHOT_RECORD_BANK] = the_bank_num;
+		*(uint16_t*)&the_record[BANK_SNAPSHOT_RECORD_DATA_LEN] = data_len;
+		
+		success = (fwrite(the_record, sizeof(char), BANK_SNAPSHOT_RECORD_LEN, the_file_handler) == BANK_SNAPSHOT_RECORD_LEN);
+		
+		if (success)
+		{
+			success = App_EMWriteToFile(the_file_handler, src_bank_num, 0, data_len);
+		}
+		
+		file_len += BANK_SNAPSHOT_RECORD_LEN + data_len;
+		++num_saved;
+		
+		App_UpdateProgressBar((uint8_t)(((uint16_t)num_saved * 100) / num_banks));
+	}
+	
+	fclose(the_file_handler);
+	
+	App_HideProgressBar();
+	
+	if (success == false)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_GENERIC_DISK));
+		return false;
+	}
+	
+	sprintf(global_string_buff1, General_GetString(global_snapshot_count == 0 ? ID_STR_MSG_SNAPSHOT_FULL_SAVED : ID_STR_MSG_SNAPSHOT_INCR_SAVED), num_saved, file_len);
+	Buffer_NewMessage(global_string_buff1);
+	
+	// this snapshot is now the one the next snapshot is compared against
+	Snapshot_AcceptPendingChecksums();
+	
+	return true;
+}
+
+
+// reads the header and checksums of the snapshot in the open file, and stages the checksums for Snapshot_Restore() to check banks against
+// sets num_banks to the number of banks stored in the file
+// returns false if the file is not a snapshot f/manager can read
+bool Snapshot_Open(FILE* the_file_handler, uint8_t* num_banks)
+{
+	uint8_t			the_header[BANK_SNAPSHOT_HEADER_LEN];
+	
+	if (fread(the_header, sizeof(char), BANK_SNAPSHOT_HEADER_LEN, the_file_handler) != BANK_SNAPSHOT_HEADER_LEN ||
+		memcmp(the_header, BANK_SNAPSHOT_SIGNATURE, BANK_SNAPSHOT_SIGNATURE_LEN) != 0 ||
+		the_header[BANK_SNAPSHOT_VERSION] != BANK_SNAPSHOT_CURRENT_VERSION ||
+		fread((uint8_t*)STORAGE_FILE_BUFFER_1, sizeof(char), BANK_SNAPSHOT_CHECKSUMS_LEN, the_file_handler) != BANK_SNAPSHOT_CHECKSUMS_LEN)
+	{
+		return false;
+	}
+	
+	App_EMBulkCopy((uint8_t*)STORAGE_FILE_BUFFER_1, BANK_SNAPSHOT_PENDING_PHYS_ADDR, BANK_SNAPSHOT_CHECKSUMS_LEN, PARAM_COPY_TO_EM);
+	*num_banks = the_header[BANK_SNAPSHOT_NUM_RECORDS];
+	
+	return true;
+}
+
+
+// writes the num_banks banks stored in the snapshot opened by Snapshot_Open() back into RAM, then closes the file
+// the_banks is a bitmap of the banks the user can write to: a record for any other bank (f/manager's own, like the filename and font banks) is read past, and the bank is left alone
+// every bank written is checked against the checksum the snapshot recorded for it. if every one passes, the staged checksums become the ones the next snapshot is compared against
+// tells the user how it went. returns false if the file is not a snapshot, if a bank fails its check, or on any disk error
+bool Snapshot_Restore(FILE* the_file_handler, uint8_t* the_banks, uint8_t num_banks)
+{
+	uint8_t			the_bank_num;
+	uint8_t			num_restored = 0;
+	uint8_t			num_skipped = 0;
+	uint8_t			num_bad = 0;
+	uint8_t			the_record[BANK_SNAPSHOT_RECORD_LEN];
+	uint16_t		data_len;
+	uint32_t		expected_checksum;
+	bool			is_good;
+	bool			is_snapshot = true;
+	bool			success = true;
+	
+	// LOGIC:
+	//   packed banks are read into the search automaton bank, then unpacked from there by Memory_DecompressBank(). unpacked banks are read straight in.
+	//   whatever the file says, nothing is written to flash or to f/manager's own banks.
+	//     a snapshot made by a build that protected fewer banks may hold one of them: its data goes into the search automaton bank, and is dropped.
+	//     otherwise a restore could overwrite the filenames a panel is showing, or the custom font.
+	
+	App_ShowProgressBar();
+	App_MarkBanksChanged(SEARCH_AUTOMATON_PHYS_ADDR, BYTES_PER_BANK);
+	
+	while (num_restored < num_banks && success == true)
+	{
+		if (fread(the_record, sizeof(char), BANK_SNAPSHOT_RECORD_LEN, the_file_handler) != BANK_SNAPSHOT_RECORD_LEN)
+		{
+			success = false;
+			break;
+		}
+		
+		the_bank_num = the_record[BANK_SNAPSHOT_RECORD_BANK];
+		data_len = *(uint16_t*)&the_record[BANK_SNAPSHOT_RECORD_DATA_LEN];
+		
+		if (the_bank_num >= MEMORY_BANK_COUNT || data_len == 0 || data_len > BYTES_PER_BANK ||
+			the_record[BANK_SNAPSHOT_RECORD_ENCODING] > BANK_SNAPSHOT_ENCODING_PACKED ||
+			(the_record[BANK_SNAPSHOT_RECORD_ENCODING] == BANK_SNAPSHOT_ENCODING_RAW && data_len != BYTES_PER_BANK))
+		{
+			is_snapshot = false;
+			success = false;
+			break;
+		}
+		
+		if (SNAPSHOT_BANK_IS_FLAGGED(the_banks, the_bank_num) == 0)
+		{
+			success = App_EMReadRangeFromFile(the_file_handler, SEARCH_AUTOMATON_EM_SLOT, 0, data_len);
+			++num_skipped;
+			++num_restored;
+			App_UpdateProgressBar((uint8_t)(((uint16_t)num_restored * 100) / num_banks));
+			continue;
+		}
+		
+		if (the_record[BANK_SNAPSHOT_RECORD_ENCODING] == BANK_SNAPSHOT_ENCODING_RAW)
+		{
+			success = App_EMReadRangeFromFile(the_file_handler, the_bank_num, 0, BYTES_PER_BANK);
+			is_good = true;
+		}
+		else
+		{
+			success = App_EMReadRangeFromFile(the_file_handler, SEARCH_AUTOMATON_EM_SLOT, 0, data_len);
+			
+			App_MarkBanksChanged((uint32_t)the_bank_num * BYTES_PER_BANK, BYTES_PER_BANK);
+			zp_search_loc_bank = the_bank_num;
+			*(uint8_t*)ZP_OTHER_PARAM = SEARCH_AUTOMATON_EM_SLOT;
+			*(uint16_t*)ZP_COPY_LEN = data_len;
+			is_good = (Memory_DecompressBank() == 1);
+		}
+		
+		// check the bank against the checksum the snapshot recorded for it
+		App_EMBulkCopy((uint8_t*)&expected_checksum, BANK_SNAPSHOT_PENDING_PHYS_ADDR + (uint16_t)the_bank_num * 4, 4, PARAM_COPY_FROM_EM);
+		zp_search_loc_bank = the_bank_num;
+		
+		if (is_good == false || Memory_ChecksumBank() != expected_checksum)
+		{
+			++num_bad;
+		}
+		
+		++num_restored;
+		
+		App_UpdateProgressBar((uint8_t)(((uint16_t)num_restored * 100) / num_banks));
+	}
+	
+	fclose(the_file_handler);
+	
+	App_HideProgressBar();
+	
+	if (is_snapshot == false)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_NOT_A_SNAPSHOT));
+		return false;
+	}
+	
+	if (success == false)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_ERROR_GENERIC_DISK));
+		return false;
+	}
+	
+	if (num_bad > 0)
+	{
+		sprintf(global_string_buff1, General_GetString(ID_STR_ERROR_SNAPSHOT_CHECKSUM), num_bad);
+		Buffer_NewMessage(global_string_buff1);
+		return false;
+	}
+	
+	sprintf(global_string_buff1, General_GetString(ID_STR_MSG_SNAPSHOT_RESTORED), num_restored - num_skipped);
+	Buffer_NewMessage(global_string_buff1);
+	
+	// RAM now matches the snapshot: it is what the next snapshot is compared against
+	Snapshot_AcceptPendingChecksums();
+	
+	return true;
+}
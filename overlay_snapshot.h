@@ -0,0 +1,68 @@
+/*
+ * overlay_snapshot.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef OVERLAY_SNAPSHOT_H_
+#define OVERLAY_SNAPSHOT_H_
+
+/* about this class
+ *
+ *  Routines for saving RAM to a snapshot file, and restoring it again
+ *    the panel asks the user, opens the files, and refreshes itself: these do the work in between, so it stays out of MAIN
+ *
+ */
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+#include "app.h"
+#include <stdint.h>
+#include <stdio.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// checksums every bank flagged in the_banks, and stages the checksums for the next snapshot file. banks not flagged are staged as 0
+// the_banks is a bitmap of the banks of RAM, as MemSys_GetWriteableBanks() makes it. on entry it flags the banks the user can write to
+// on return, only the banks that need storing are still flagged: every one for the first snapshot, after that only those that changed since the last snapshot made or restored
+// returns the number of banks that need storing
+uint8_t Snapshot_FindChangedBanks(uint8_t* the_banks);
+
+// writes a snapshot of the num_banks banks flagged in the_banks to the open file, then closes it
+// each bank is packed by Memory_CompressBank() if it will pack, and written as is if it won't
+// once the whole file is written, the staged checksums become the ones the next snapshot is compared against
+// tells the user how it went. returns false on any disk error
+bool Snapshot_Save(FILE* the_file_handler, uint8_t* the_banks, uint8_t num_banks);
+
+// reads the header and checksums of the snapshot in the open file, and stages the checksums for Snapshot_Restore() to check banks against
+// sets num_banks to the number of banks stored in the file
+// returns false if the file is not a snapshot f/manager can read
+bool Snapshot_Open(FILE* the_file_handler, uint8_t* num_banks);
+
+// writes the num_banks banks stored in the snapshot opened by Snapshot_Open() back into RAM, then closes the file
+// the_banks is a bitmap of the banks the user can write to: a record for any other bank (f/manager's own, like the filename and font banks) is read past, and the bank is left alone
+// every bank written is checked against the checksum the snapshot recorded for it. if every one passes, the staged checksums become the ones the next snapshot is compared against
+// tells the user how it went. returns false if the file is not a snapshot, if a bank fails its check, or on any disk error
+bool Snapshot_Restore(FILE* the_file_handler, uint8_t* the_banks, uint8_t num_banks);
+
+#endif /* OVERLAY_SNAPSHOT_H_ */
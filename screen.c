@@ -75,29 +75,47 @@ static UI_Button		uibutton[NUM_BUTTONS] =
 	{BUTTON_ID_SORT_BY_TYPE,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_DIR_CMD_Y + 1,	ID_STR_DEV_SORT_BY_TYPE,	UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_SORT_BY_TYPE	}, 
 	{BUTTON_ID_SORT_BY_NAME,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_DIR_CMD_Y + 2,	ID_STR_DEV_SORT_BY_NAME,	UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_SORT_BY_NAME	}, 
 	{BUTTON_ID_SORT_BY_SIZE,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_DIR_CMD_Y + 3,	ID_STR_DEV_SORT_BY_SIZE,	UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_SORT_BY_SIZE	}, 
-	// FILE actions
-	{BUTTON_ID_COPY,			UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y,		ID_STR_FILE_COPY_RIGHT,		UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_COPY	}, 
-	{BUTTON_ID_DELETE,			UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y + 1,	ID_STR_FILE_DELETE,			UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_DELETE_ALT	}, 
-	{BUTTON_ID_DUPLICATE,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y + 2,	ID_STR_FILE_DUP,			UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_DUPLICATE	}, 
-	{BUTTON_ID_RENAME,			UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y + 3,	ID_STR_FILE_RENAME,			UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_RENAME	}, 
 	// FILE & BANK actions
-	{BUTTON_ID_TEXT_VIEW,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y + 4,	ID_STR_FILE_TEXT_PREVIEW,	UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_VIEW_AS_TEXT	}, 
-	{BUTTON_ID_HEX_VIEW,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y + 5,	ID_STR_FILE_HEX_PREVIEW,	UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_VIEW_AS_HEX	}, 
-	{BUTTON_ID_LOAD,			UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y + 6,	ID_STR_FILE_LOAD,			UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_LOAD	}, 
-	// BANK actions
-	{BUTTON_ID_BANK_FILL,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y + 7,	ID_STR_BANK_FILL,			UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_FILL_MEMORY	}, 
-	{BUTTON_ID_BANK_CLEAR,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y + 8,	ID_STR_BANK_CLEAR,			UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_CLEAR_MEMORY	}, 
-	{BUTTON_ID_BANK_FIND,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y + 9,	ID_STR_BANK_FIND,			UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_SEARCH_MEMORY	}, 
-	{BUTTON_ID_BANK_FIND_NEXT,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y + 10,	ID_STR_BANK_FIND_NEXT,		UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_SEARCH_MEMORY	}, 
+	{BUTTON_ID_COPY,			UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y,		ID_STR_FILE_COPY_RIGHT,		UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_COPY	}, 
+	{BUTTON_ID_TEXT_VIEW,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y + 1,	ID_STR_FILE_TEXT_PREVIEW,	UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_VIEW_AS_TEXT	}, 
+	{BUTTON_ID_HEX_VIEW,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y + 2,	ID_STR_FILE_HEX_PREVIEW,	UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_VIEW_AS_HEX	}, 
+	{BUTTON_ID_LOAD,			UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_FILE_CMD_Y + 3,	ID_STR_FILE_LOAD,			UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_LOAD	}, 
+	// FILE actions (disk panels only)
+	{BUTTON_ID_DELETE,			UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y,		ID_STR_FILE_DELETE,			UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_DELETE_ALT	}, 
+	{BUTTON_ID_DUPLICATE,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 1,	ID_STR_FILE_DUP,			UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_DUPLICATE	}, 
+	{BUTTON_ID_RENAME,			UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 2,	ID_STR_FILE_RENAME,			UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_RENAME	}, 
+	{BUTTON_ID_MOVE,			UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 3,	ID_STR_FILE_MOVE,			UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_MOVE	}, 
+	{BUTTON_ID_MARK,			UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 4,	ID_STR_FILE_MARK,			UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_MARK_TOGGLE	}, 
+	{BUTTON_ID_MARK_ALL,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 5,	ID_STR_FILE_MARK_ALL,		UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_MARK_ALL	}, 
+	{BUTTON_ID_MARK_INVERT,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 6,	ID_STR_FILE_MARK_INVERT,	UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_MARK_INVERT	}, 
+	{BUTTON_ID_MARK_PATTERN,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 7,	ID_STR_FILE_MARK_PATTERN,	UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_MARK_BY_PATTERN	}, 
+	{BUTTON_ID_UNMARK_ALL,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 8,	ID_STR_FILE_UNMARK_ALL,		UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_UNMARK_ALL	}, 
+	{BUTTON_ID_RESTORE_SNAPSHOT,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 9,	ID_STR_FILE_RESTORE_SNAPSHOT,	UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_RESTORE_SNAPSHOT	}, 
+	{BUTTON_ID_APPLY_PATCH,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 10,	ID_STR_FILE_APPLY_PATCH,	UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_APPLY_PATCH	}, 
+	// BANK actions (memory panels only)
+	{BUTTON_ID_BANK_FILL,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y,		ID_STR_BANK_FILL,			UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_FILL_MEMORY	}, 
+	{BUTTON_ID_BANK_CLEAR,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 1,	ID_STR_BANK_CLEAR,			UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_CLEAR_MEMORY	}, 
+	{BUTTON_ID_BANK_FIND,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 2,	ID_STR_BANK_FIND,			UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_SEARCH_MEMORY	}, 
+	{BUTTON_ID_BANK_FIND_NEXT,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 3,	ID_STR_BANK_FIND_NEXT,		UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_SEARCH_MEMORY	}, 
+	{BUTTON_ID_BANK_COPY_RANGE,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 4,	ID_STR_BANK_COPY_RANGE,		UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_COPY_MEMORY_RANGE	}, 
+	{BUTTON_ID_BANK_SAVE_RANGE,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 5,	ID_STR_BANK_SAVE_RANGE,		UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_SAVE_MEMORY_RANGE	}, 
+	{BUTTON_ID_BANK_FIND_ALL,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 6,	ID_STR_BANK_FIND_ALL,		UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_SEARCH_MEMORY_ALL	}, 
+	{BUTTON_ID_BANK_FIND_MULTI,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 7,	ID_STR_BANK_FIND_MULTI,		UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_SEARCH_MEMORY_MULTI	}, 
+	{BUTTON_ID_BANK_COMPARE,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 8,	ID_STR_BANK_COMPARE,		UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_COMPARE_BANKS	}, 
+	{BUTTON_ID_BANK_SNAPSHOT,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_PANEL_CMD_Y + 9,	ID_STR_BANK_SNAPSHOT,		UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_SNAPSHOT_MEMORY	}, 
 	
 	
 	// APP actions
 	{BUTTON_ID_SET_CLOCK,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_APP_CMD_Y,		ID_STR_APP_SET_CLOCK,		UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_SET_TIME	}, 
 	{BUTTON_ID_ABOUT,			UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_APP_CMD_Y + 1,	ID_STR_APP_ABOUT,			UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_ABOUT	}, 
-	{BUTTON_ID_EXIT_TO_BASIC,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_APP_CMD_Y + 2,	ID_STR_APP_EXIT_TO_BASIC,	UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_EXIT_TO_BASIC	}, 
-	{BUTTON_ID_EXIT_TO_DOS,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_APP_CMD_Y + 3,	ID_STR_APP_EXIT_TO_DOS,		UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_EXIT_TO_DOS	}, 
-	{BUTTON_ID_QUIT,			UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_APP_CMD_Y + 4,	ID_STR_APP_QUIT,			UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_QUIT	}, 
+	{BUTTON_ID_BANK_MAP,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_APP_CMD_Y + 2,	ID_STR_APP_BANK_MAP,		UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_BANK_MAP	}, 
+	{BUTTON_ID_EXIT_TO_BASIC,	UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_APP_CMD_Y + 3,	ID_STR_APP_EXIT_TO_BASIC,	UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_EXIT_TO_BASIC	}, 
+	{BUTTON_ID_EXIT_TO_DOS,		UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_APP_CMD_Y + 4,	ID_STR_APP_EXIT_TO_DOS,		UI_BUTTON_STATE_ACTIVE,		UI_BUTTON_STATE_CHANGED,	ACTION_EXIT_TO_DOS	}, 
+	{BUTTON_ID_QUIT,			UI_MIDDLE_AREA_START_X,		UI_MIDDLE_AREA_APP_CMD_Y + 5,	ID_STR_APP_QUIT,			UI_BUTTON_STATE_INACTIVE,	UI_BUTTON_STATE_CHANGED,	ACTION_QUIT	}, 
 };
+
+static bool				screen_menu_for_disk = true;		// whether the disk-only or the bank-only buttons are currently drawn in the shared rows
+static bool				screen_menu_panel_rows_changed = true;	// set when the shared rows need to be wiped before redrawing them
  
 static uint8_t			screen_titlebar[UI_BYTE_SIZE_OF_APP_TITLEBAR] = 
 {
@@ -144,6 +162,10 @@ void Screen_DrawUI(void);
 // if not hex, it will return -1
 int16_t ScreenConvertHexCharToByteValue(uint8_t the_char);
 
+// sets the passed button active or inactive, and flags it as changed if that is different from before
+// does not render
+void ScreenSetMenuItemActive(uint8_t the_button_id, bool make_active);
+
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
@@ -236,6 +258,18 @@ int16_t ScreenConvertHexCharToByteValue(uint8_t the_char)
 }
 
 
+// sets the passed button active or inactive, and flags it as changed if that is different from before
+// does not render
+void ScreenSetMenuItemActive(uint8_t the_button_id, bool make_active)
+{
+	if (uibutton[the_button_id].active_ != make_active)
+	{
+		uibutton[the_button_id].active_ = make_active;
+		uibutton[the_button_id].changed_ = true;
+	}
+}
+
+
 
 /*****************************************************************************/
 /*                        Public Function Definitions                        */
@@ -263,6 +297,7 @@ void Screen_DrawPanelHeader(uint8_t x, bool for_disk)
 	else
 	{
 		Text_DrawStringAtXY(x, y, General_GetString(ID_STR_LBL_FILENAME), LIST_HEADER_COLOR, PANEL_BACKGROUND_COLOR);
+		Text_DrawStringAtXY(x + UI_PANEL_BANK_SUM_OFFSET, y, General_GetString(ID_STR_LBL_BANK_CHECKSUM), LIST_HEADER_COLOR, PANEL_BACKGROUND_COLOR);
 		x += UI_PANEL_BANK_NUM_OFFSET;
 		Text_DrawStringAtXY(x, y, General_GetString(ID_STR_LBL_BANK_NUM), LIST_HEADER_COLOR, PANEL_BACKGROUND_COLOR);
 		x += UI_PANEL_BANK_ADDR_OFFSET;
@@ -364,6 +399,7 @@ void Screen_UpdateMenuStates(UI_Menu_Enabler_Info* the_enabling_info)
 	bool	other_panel_for_disk = the_enabling_info->other_panel_for_disk_;
 	bool	other_panel_for_flash = the_enabling_info->other_panel_for_flash_;
 	bool	other_panel_is_meatloaf = the_enabling_info->other_panel_is_meatloaf_;
+	uint8_t	i;
 	
 // LOGIC:
 //       - Pass it some info on the currently selected item and panel:
@@ -399,6 +435,18 @@ void Screen_UpdateMenuStates(UI_Menu_Enabler_Info* the_enabling_info)
     //    - 0, 1, 2 (SD card, floppy1, floppy2)
     // will set these in a different function that is only called once, on startup.
 	
+	// the disk-only and the bank-only buttons share the same rows: if the panel type changed, the other set needs drawing
+	if (for_disk != screen_menu_for_disk)
+	{
+		screen_menu_for_disk = for_disk;
+		screen_menu_panel_rows_changed = true;
+		
+		for (i = BUTTON_ID_FIRST_DISK_ONLY; i <= BUTTON_ID_LAST_BANK_ONLY; i++)
+		{
+			uibutton[i].changed_ = true;
+		}
+	}
+	
 	if (for_disk == false)
 	{
 		// handle memory system-specific menu items
@@ -435,6 +483,22 @@ void Screen_UpdateMenuStates(UI_Menu_Enabler_Info* the_enabling_info)
 			}
 		}
 
+		// a range copy is always RAM to RAM, so it can be started from either memory panel
+		ScreenSetMenuItemActive(BUTTON_ID_BANK_COPY_RANGE, true);
+		
+		// RAM and flash can both be saved; the target disk is checked when the range is saved
+		ScreenSetMenuItemActive(BUTTON_ID_BANK_SAVE_RANGE, true);
+		ScreenSetMenuItemActive(BUTTON_ID_BANK_FIND_ALL, true);
+		ScreenSetMenuItemActive(BUTTON_ID_BANK_FIND_MULTI, true);
+		
+		// compare needs a bank on both sides
+		ScreenSetMenuItemActive(BUTTON_ID_BANK_COMPARE, other_panel_for_disk == false);
+		
+		// a snapshot is written to the disk shown in the other panel
+		ScreenSetMenuItemActive(BUTTON_ID_BANK_SNAPSHOT, other_panel_for_disk == true);
+		ScreenSetMenuItemActive(BUTTON_ID_RESTORE_SNAPSHOT, false);
+		ScreenSetMenuItemActive(BUTTON_ID_APPLY_PATCH, false);
+
 		if (for_flash == false)
 		{
 			if (uibutton[BUTTON_ID_BANK_FILL].active_ != true)
@@ -517,6 +581,12 @@ void Screen_UpdateMenuStates(UI_Menu_Enabler_Info* the_enabling_info)
 			uibutton[BUTTON_ID_RENAME].changed_ = true;
 		}
 
+		// move and the marking keys have no meaning for memory banks
+		for (i = BUTTON_ID_MOVE; i <= BUTTON_ID_UNMARK_ALL; i++)
+		{
+			ScreenSetMenuItemActive(i, false);
+		}
+
 		if (uibutton[BUTTON_ID_FORMAT].active_ != false)
 		{
 			uibutton[BUTTON_ID_FORMAT].active_ = false;
@@ -690,6 +760,21 @@ void Screen_UpdateMenuStates(UI_Menu_Enabler_Info* the_enabling_info)
 			}
 		}
 
+		// move needs 2 real disk panels: a meatloaf folder can't have files moved into or out of it
+		ScreenSetMenuItemActive(BUTTON_ID_MOVE, (is_meatloaf == false && other_panel_for_disk == true && other_panel_is_meatloaf == false));
+
+		// marking files only changes what is shown, so it works in any disk panel
+		for (i = BUTTON_ID_MARK; i <= BUTTON_ID_UNMARK_ALL; i++)
+		{
+			ScreenSetMenuItemActive(i, true);
+		}
+
+		// a snapshot file is unpacked back into RAM, so the other panel must be showing memory
+		ScreenSetMenuItemActive(BUTTON_ID_RESTORE_SNAPSHOT, (the_file_type != 0 && other_panel_for_disk == false));
+		
+		// the selected file is the patch: what it patches is whatever the other panel has selected
+		ScreenSetMenuItemActive(BUTTON_ID_APPLY_PATCH, the_file_type != 0);
+
 		// disable all memory-system-only items
 
 		if (uibutton[BUTTON_ID_BANK_FIND].active_ != false)
@@ -715,6 +800,13 @@ void Screen_UpdateMenuStates(UI_Menu_Enabler_Info* the_enabling_info)
 			uibutton[BUTTON_ID_BANK_CLEAR].active_ = false;
 			uibutton[BUTTON_ID_BANK_CLEAR].changed_ = true;
 		}
+
+		ScreenSetMenuItemActive(BUTTON_ID_BANK_COPY_RANGE, false);
+		ScreenSetMenuItemActive(BUTTON_ID_BANK_SAVE_RANGE, false);
+		ScreenSetMenuItemActive(BUTTON_ID_BANK_FIND_ALL, false);
+		ScreenSetMenuItemActive(BUTTON_ID_BANK_FIND_MULTI, false);
+		ScreenSetMenuItemActive(BUTTON_ID_BANK_COMPARE, false);
+		ScreenSetMenuItemActive(BUTTON_ID_BANK_SNAPSHOT, false);
 	}
 }
 
@@ -729,11 +821,29 @@ void Screen_RenderMenu(bool sparse_render)
 	uint8_t		y1;
 	uint8_t		text_color;
 
+	// the disk-only and bank-only sets are different lengths: wipe the shared rows so no leftover labels from the other set remain
+	if (screen_menu_panel_rows_changed == true || sparse_render == false)
+	{
+		Text_FillBox(UI_MIDDLE_AREA_START_X, UI_MIDDLE_AREA_PANEL_CMD_Y, (UI_MIDDLE_AREA_START_X + UI_MIDDLE_AREA_WIDTH - 1), (UI_MIDDLE_AREA_PANEL_CMD_Y + UI_MIDDLE_AREA_PANEL_CMD_ROWS - 1), CH_SPACE, MENU_FOREGROUND_COLOR, MENU_BACKGROUND_COLOR);
+		screen_menu_panel_rows_changed = false;
+	}
+	
 	// draw buttons
 	for (i = 0; i < NUM_BUTTONS; i++)
 	{
 		//DEBUG_OUT(("%s %d: btn %i change=%u, active=%u, %s", __func__ , __LINE__, i, uibutton[i].changed_, uibutton[i].active_, General_GetString(uibutton[i].string_id_)));
 		
+		// skip the set of buttons that belongs to the other kind of panel
+		if (screen_menu_for_disk == true && i >= BUTTON_ID_FIRST_BANK_ONLY && i <= BUTTON_ID_LAST_BANK_ONLY)
+		{
+			continue;
+		}
+		
+		if (screen_menu_for_disk == false && i >= BUTTON_ID_FIRST_DISK_ONLY && i <= BUTTON_ID_LAST_DISK_ONLY)
+		{
+			continue;
+		}
+		
 		if (uibutton[i].changed_ == true || sparse_render == false)
 		{
 			text_color = (uibutton[i].active_ == true ? MENU_FOREGROUND_COLOR : MENU_INACTIVE_COLOR);
@@ -913,12 +1023,19 @@ bool Screen_ShowUserTwoButtonDialog(char* dialog_title, uint8_t dialog_body_stri
 
 
 // utility function for checking user input for either normal string or series of numbers
-// if preceded by "#" will check for list of 2-digit hex numbers. eg, (#FF,AA,01,00,EE).
+// if preceded by "#" will check for list of 2-digit hex numbers. eg, (#FF,AA,01,00,EE). commas or spaces between them are optional.
+// in a hex series, "?" in place of a digit matches any value for that digit: "??" is any byte, "A?" is A0-AF.
+// a number followed by "/" and a 2-digit hex mask only has to match in the bits set in the mask: "80/C0" is any of 80-BF.
 // will convert to bytes and terminate with 0. In example above, it will return 5 as the len. 
+// the_mask gets one mask byte per converted byte (FF = must match exactly); converted bytes are already ANDed with their mask.
+// for normal strings, every mask byte is FF.
 // either way, will return the length of the set of characters that should be thought of as one unit. 
-uint8_t ScreenEvaluateUserStringForHexSeries(char** the_string)
+uint8_t ScreenEvaluateUserStringForHexSeries(char** the_string, uint8_t* the_mask)
 {
 	uint8_t		this_byte;
+	uint8_t		i;
+	uint8_t		the_value;
+	uint8_t		value_mask;
 	int16_t		byte[2];
 	uint8_t		the_len = 0;
 	char*		local_string = *the_string;
@@ -927,6 +1044,8 @@ uint8_t ScreenEvaluateUserStringForHexSeries(char** the_string)
 	// LOGIC:
 	//   if the string is just normal text, we don't change it, we just return the len
 	//   if the string is a series of hex chars, we overwrite from the beginning of the string with the byte values
+	//   each hex digit contributes a nibble to the value and, unless it was "?", a 0xF nibble to the mask
+	//   an explicit "/mask" is ANDed into the mask built from the digits, so "A?/F8" still ignores the low 4 bits
 
 	//DEBUG_OUT(("%s %d: local_string='%s'", __func__ , __LINE__, local_string));
 	
@@ -938,38 +1057,73 @@ uint8_t ScreenEvaluateUserStringForHexSeries(char** the_string)
 	{
 		// treat string as a normal string
 		--local_string;
+		the_len = strlen(local_string);
+		memset(the_mask, 0xFF, the_len);
 		//DEBUG_OUT(("%s %d: doesn't start with #, treating as string with len %u", __func__ , __LINE__, strlen(local_string)));
-		return strlen(local_string);
+		return the_len;
 	}
 
 	// assume user was trying to provide series of hex numbers
-	while (*local_string)
+	while (*local_string && the_len < sizeof(converted_storage) - 1)
 	{
-		byte[0] = ScreenConvertHexCharToByteValue(*local_string++);
-		byte[1] = ScreenConvertHexCharToByteValue(*local_string++);
-		this_byte = *local_string++; // will be comma if there is another number encoded here
-		//DEBUG_OUT(("%s %d: byte0=%x, byte1=%x, this_byte=%x (%c)", __func__ , __LINE__, byte[0], byte[1], this_byte, this_byte));
-		//DEBUG_OUT(("%s %d: the_len=%u, val=%x", __func__ , __LINE__, the_len, (uint8_t)byte[0] * (uint8_t)16 + (uint8_t)byte[1]));
+		the_value = 0;
+		value_mask = 0;
 		
-		if (byte[0] < 0 || byte[1] < 0)
+		for (i = 0; i < 2; i++)
 		{
-			// one or both chars were not hex chars. abandon effort.
-			goto conversion_complete;
+			this_byte = *local_string++;
+			the_value <<= 4;
+			value_mask <<= 4;
+			
+			if (this_byte == '?')
+			{
+				// wildcard digit: leave its mask bits off
+				continue;
+			}
+			
+			byte[0] = ScreenConvertHexCharToByteValue(this_byte);
+			
+			if (byte[0] < 0)
+			{
+				// not a hex char (or ran into the terminator). abandon effort.
+				goto conversion_complete;
+			}
+			
+			the_value |= (uint8_t)byte[0];
+			value_mask |= 0x0F;
 		}
 		
-		converted_storage[the_len++] = (uint8_t)byte[0] * (uint8_t)16 + (uint8_t)byte[1];
-		//DEBUG_OUT(("%s %d: converted_storage[the_len-1]=%x", __func__ , __LINE__, converted_storage[the_len-1]));
+		this_byte = *local_string++; // will be comma if there is another number encoded here, or / if a bit mask follows
+		
+		if (this_byte == '/')
+		{
+			byte[0] = ScreenConvertHexCharToByteValue(*local_string++);
+			byte[1] = ScreenConvertHexCharToByteValue(*local_string++);
+			
+			if (byte[0] < 0 || byte[1] < 0)
+			{
+				// one or both chars were not hex chars. abandon effort.
+				goto conversion_complete;
+			}
+			
+			value_mask &= (uint8_t)byte[0] * (uint8_t)16 + (uint8_t)byte[1];
+			this_byte = *local_string++;
+		}
+		
+		//DEBUG_OUT(("%s %d: the_len=%u, val=%x, mask=%x", __func__ , __LINE__, the_len, the_value, value_mask));
+		
+		the_mask[the_len] = value_mask;
+		converted_storage[the_len++] = the_value & value_mask;
 		
 		if (this_byte == 0)
 		{
 			// hit end of search string
 			goto conversion_complete;
 		}
-		else if (this_byte != ',')
+		else if (this_byte != ',' && this_byte != ' ')
 		{
 			// not sure what's next, but let's give user benefit of doubt and assume they left out commas and just entered FFEEDD0102 etc.
 			--local_string;
-			//DEBUG_OUT(("%s %d: third char wasn't comma. the_len=%u, converted='%s'", __func__ , __LINE__, the_len, converted));
 		}
 	}
 	
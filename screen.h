@@ -40,7 +40,7 @@
 #define PARAM_RENDER_ALL_MENU_ITEMS			false	// parameter for Screen_RenderMenu
 
 // there are 12 buttons which can be accessed with the same code
-#define NUM_BUTTONS					27
+#define NUM_BUTTONS					42
 
 // DEVICE actions
 #define BUTTON_ID_DEV_SD_CARD		0
@@ -55,29 +55,50 @@
 #define BUTTON_ID_SORT_BY_NAME		(BUTTON_ID_SORT_BY_TYPE + 1)
 #define BUTTON_ID_SORT_BY_SIZE		(BUTTON_ID_SORT_BY_NAME + 1)
 
-// FILE actions
-#define BUTTON_ID_COPY				(BUTTON_ID_SORT_BY_SIZE + 1)
-#define BUTTON_ID_DELETE			(BUTTON_ID_COPY + 1)
-#define BUTTON_ID_DUPLICATE			(BUTTON_ID_DELETE + 1)
-#define BUTTON_ID_RENAME			(BUTTON_ID_DUPLICATE + 1)
 // FILE & BANK actions
-#define BUTTON_ID_TEXT_VIEW			(BUTTON_ID_RENAME + 1)
+#define BUTTON_ID_COPY				(BUTTON_ID_SORT_BY_SIZE + 1)
+#define BUTTON_ID_TEXT_VIEW			(BUTTON_ID_COPY + 1)
 #define BUTTON_ID_HEX_VIEW			(BUTTON_ID_TEXT_VIEW + 1)
 #define BUTTON_ID_LOAD				(BUTTON_ID_HEX_VIEW + 1)
 
-// memory bank buttons
-#define BUTTON_ID_BANK_FILL			(BUTTON_ID_LOAD + 1)
+// FILE actions: only drawn when the active panel is a disk. they share rows with the memory bank buttons.
+#define BUTTON_ID_DELETE			(BUTTON_ID_LOAD + 1)
+#define BUTTON_ID_DUPLICATE			(BUTTON_ID_DELETE + 1)
+#define BUTTON_ID_RENAME			(BUTTON_ID_DUPLICATE + 1)
+#define BUTTON_ID_MOVE				(BUTTON_ID_RENAME + 1)
+#define BUTTON_ID_MARK				(BUTTON_ID_MOVE + 1)
+#define BUTTON_ID_MARK_ALL			(BUTTON_ID_MARK + 1)
+#define BUTTON_ID_MARK_INVERT		(BUTTON_ID_MARK_ALL + 1)
+#define BUTTON_ID_MARK_PATTERN		(BUTTON_ID_MARK_INVERT + 1)
+#define BUTTON_ID_UNMARK_ALL		(BUTTON_ID_MARK_PATTERN + 1)
+#define BUTTON_ID_RESTORE_SNAPSHOT	(BUTTON_ID_UNMARK_ALL + 1)
+#define BUTTON_ID_APPLY_PATCH		(BUTTON_ID_RESTORE_SNAPSHOT + 1)
+
+// memory bank buttons: only drawn when the active panel is a memory system
+#define BUTTON_ID_BANK_FILL			(BUTTON_ID_APPLY_PATCH + 1)
 #define BUTTON_ID_BANK_CLEAR		(BUTTON_ID_BANK_FILL + 1)
 #define BUTTON_ID_BANK_FIND			(BUTTON_ID_BANK_CLEAR + 1)
 #define BUTTON_ID_BANK_FIND_NEXT	(BUTTON_ID_BANK_FIND + 1)
+#define BUTTON_ID_BANK_COPY_RANGE	(BUTTON_ID_BANK_FIND_NEXT + 1)
+#define BUTTON_ID_BANK_SAVE_RANGE	(BUTTON_ID_BANK_COPY_RANGE + 1)
+#define BUTTON_ID_BANK_FIND_ALL		(BUTTON_ID_BANK_SAVE_RANGE + 1)
+#define BUTTON_ID_BANK_FIND_MULTI	(BUTTON_ID_BANK_FIND_ALL + 1)
+#define BUTTON_ID_BANK_COMPARE		(BUTTON_ID_BANK_FIND_MULTI + 1)
+#define BUTTON_ID_BANK_SNAPSHOT		(BUTTON_ID_BANK_COMPARE + 1)
 
 // app menu buttons
-#define BUTTON_ID_SET_CLOCK			(BUTTON_ID_BANK_FIND_NEXT + 1)
+#define BUTTON_ID_SET_CLOCK			(BUTTON_ID_BANK_SNAPSHOT + 1)
 #define BUTTON_ID_ABOUT				(BUTTON_ID_SET_CLOCK + 1)
-#define BUTTON_ID_EXIT_TO_BASIC		(BUTTON_ID_ABOUT + 1)
+#define BUTTON_ID_BANK_MAP			(BUTTON_ID_ABOUT + 1)
+#define BUTTON_ID_EXIT_TO_BASIC		(BUTTON_ID_BANK_MAP + 1)
 #define BUTTON_ID_EXIT_TO_DOS		(BUTTON_ID_EXIT_TO_BASIC + 1)
 #define BUTTON_ID_QUIT				(BUTTON_ID_EXIT_TO_DOS + 1)
 
+#define BUTTON_ID_FIRST_DISK_ONLY	BUTTON_ID_DELETE
+#define BUTTON_ID_LAST_DISK_ONLY	BUTTON_ID_APPLY_PATCH
+#define BUTTON_ID_FIRST_BANK_ONLY	BUTTON_ID_BANK_FILL
+#define BUTTON_ID_LAST_BANK_ONLY	BUTTON_ID_BANK_SNAPSHOT
+
 #define UI_BUTTON_STATE_INACTIVE	false
 #define UI_BUTTON_STATE_ACTIVE		true
 
@@ -91,7 +112,7 @@
 #define UI_MIDDLE_AREA_START_Y			4
 #define UI_MIDDLE_AREA_WIDTH			10
 
-#define UI_MIDDLE_AREA_DEV_MENU_Y		(UI_MIDDLE_AREA_START_Y + 2)
+#define UI_MIDDLE_AREA_DEV_MENU_Y		(UI_MIDDLE_AREA_START_Y)
 #define UI_MIDDLE_AREA_DEV_CMD_Y		(UI_MIDDLE_AREA_DEV_MENU_Y + 3)
 
 #define UI_MIDDLE_AREA_DIR_MENU_Y		(UI_MIDDLE_AREA_DEV_CMD_Y + 8)
@@ -100,7 +121,10 @@
 #define UI_MIDDLE_AREA_FILE_MENU_Y		(UI_MIDDLE_AREA_DIR_CMD_Y + 5)
 #define UI_MIDDLE_AREA_FILE_CMD_Y		(UI_MIDDLE_AREA_FILE_MENU_Y + 3)
 
-#define UI_MIDDLE_AREA_APP_MENU_Y		(UI_MIDDLE_AREA_FILE_CMD_Y + 12)
+#define UI_MIDDLE_AREA_PANEL_CMD_Y		(UI_MIDDLE_AREA_FILE_CMD_Y + 4)	// first row of the disk-only or bank-only buttons
+#define UI_MIDDLE_AREA_PANEL_CMD_ROWS	11								// rows needed by the longer of the 2 sets
+
+#define UI_MIDDLE_AREA_APP_MENU_Y		(UI_MIDDLE_AREA_PANEL_CMD_Y + UI_MIDDLE_AREA_PANEL_CMD_ROWS)
 #define UI_MIDDLE_AREA_APP_CMD_Y		(UI_MIDDLE_AREA_APP_MENU_Y + 3)
 
 #define UI_PANEL_INNER_WIDTH			33
@@ -115,6 +139,7 @@
 #define UI_PANEL_FILESIZE_OFFSET		5	// from start of filesize to start of filetype
 #define UI_PANEL_BANK_NUM_OFFSET		21	// from start of bank name to start of bank number
 #define UI_PANEL_BANK_ADDR_OFFSET		5	// from start of bank number to start of address
+#define UI_PANEL_BANK_SUM_OFFSET		12	// from start of bank name to start of checksum. names are cut off 1 before it.
 
 #define UI_PANEL_FILENAME_SORT_OFFSET	(UI_PANEL_FILENAME_OFFSET + 3)	// from start of col header to pos right of it for sort icon
 #define UI_PANEL_FILETYPE_SORT_OFFSET	(UI_PANEL_FILENAME_SORT_OFFSET + UI_PANEL_FILETYPE_OFFSET)	// from start of col header to pos right of it for sort icon
@@ -258,10 +283,14 @@ char* Screen_GetStringFromUser(char* dialog_title, char* dialog_body, char* star
 bool Screen_ShowUserTwoButtonDialog(char* dialog_title, uint8_t dialog_body_string_id, uint8_t positive_btn_label_string_id, uint8_t negative_btn_label_string_id);
 
 // utility function for checking user input for either normal string or series of numbers
-// if preceded by "#" will check for list of 2-digit hex numbers. eg, (#FF,AA,01,00,EE).
+// if preceded by "#" will check for list of 2-digit hex numbers. eg, (#FF,AA,01,00,EE). commas or spaces between them are optional.
+// in a hex series, "?" in place of a digit matches any value for that digit: "??" is any byte, "A?" is A0-AF.
+// a number followed by "/" and a 2-digit hex mask only has to match in the bits set in the mask: "80/C0" is any of 80-BF.
 // will convert to bytes and terminate with 0. In example above, it will return 5 as the len. 
+// the_mask gets one mask byte per converted byte (FF = must match exactly); converted bytes are already ANDed with their mask.
+// for normal strings, every mask byte is FF.
 // either way, will return the length of the set of characters that should be thought of as one unit. 
-uint8_t ScreenEvaluateUserStringForHexSeries(char** the_string);
+uint8_t ScreenEvaluateUserStringForHexSeries(char** the_string, uint8_t* the_mask);
 
 
 #endif /* SCREEN_H_ */
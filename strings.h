@@ -130,5 +130,95 @@
 #define ID_STR_MACHINE_JR 128
 #define ID_STR_MACHINE_K 129
 #define ID_STR_MACHINE_UNKNOWN 130
-#define NUM_STRINGS 131
-#define TOTAL_STRING_BYTES 3186
+#define ID_STR_DLG_MARK_PATTERN_TITLE 131
+#define ID_STR_DLG_ENTER_MARK_PATTERN 132
+#define ID_STR_DLG_DELETE_MARKED_TITLE 133
+#define ID_STR_MSG_N_FILES_MARKED 134
+#define ID_STR_MSG_N_FILES_COPIED 135
+#define ID_STR_MSG_N_FILES_DELETED 136
+#define ID_STR_MSG_N_FILES_MOVED 137
+#define ID_STR_MSG_MOVING 138
+#define ID_STR_ERROR_MOVE_NEEDS_2_DISK_PANELS 139
+#define ID_STR_FILE_MOVE 140
+#define ID_STR_FILE_MARK 141
+#define ID_STR_FILE_MARK_ALL 142
+#define ID_STR_FILE_MARK_INVERT 143
+#define ID_STR_FILE_MARK_PATTERN 144
+#define ID_STR_FILE_UNMARK_ALL 145
+#define ID_STR_ERROR_NOT_ENOUGH_ROOM 146
+#define ID_STR_LBL_N_KB_FREE 147
+#define ID_STR_LBL_N_MB_FREE 148
+#define ID_STR_DLG_COPY_RANGE_TITLE 149
+#define ID_STR_DLG_ENTER_COPY_RANGE 150
+#define ID_STR_ERROR_BAD_COPY_RANGE 151
+#define ID_STR_ERROR_COPY_RANGE_NOT_ALLOWED 152
+#define ID_STR_MSG_N_BYTES_COPIED_FROM_TO 153
+#define ID_STR_BANK_COPY_RANGE 154
+#define ID_STR_ERROR_LOAD_NEEDS_PROTECTED_BANKS 155
+#define ID_STR_MSG_N_BANKS_LOADED 156
+#define ID_STR_DLG_SAVE_RANGE_TITLE 157
+#define ID_STR_DLG_ENTER_SAVE_RANGE 158
+#define ID_STR_ERROR_BAD_SAVE_RANGE 159
+#define ID_STR_ERROR_SAVE_RANGE_NOT_ALLOWED 160
+#define ID_STR_ERROR_SAVE_RANGE_NEEDS_DISK 161
+#define ID_STR_MSG_N_BYTES_SAVED_FROM 162
+#define ID_STR_BANK_SAVE_RANGE 163
+#define ID_STR_MSG_SEARCH_ALL_RESULT 164
+#define ID_STR_MSG_SEARCH_ALL_TABLE_FULL 165
+#define ID_STR_MSG_SEARCH_RESULTS_INSTRUCTIONS 166
+#define ID_STR_BANK_FIND_ALL 167
+#define ID_STR_DLG_SEARCH_MULTI_TITLE 168
+#define ID_STR_DLG_SEARCH_MULTI_BODY 169
+#define ID_STR_DLG_SEARCH_IGNORE_CASE 170
+#define ID_STR_ERROR_SEARCH_MULTI_PHRASES 171
+#define ID_STR_BANK_FIND_MULTI 172
+#define ID_STR_ERROR_COMPARE_NEEDS_MEMORY 173
+#define ID_STR_MSG_COMPARE_IDENTICAL 174
+#define ID_STR_MSG_COMPARE_RESULT 175
+#define ID_STR_MSG_COMPARE_RESULTS_INSTRUCTIONS 176
+#define ID_STR_BANK_COMPARE 177
+#define ID_STR_MSG_CHECKSUMMING_BANKS 178
+#define ID_STR_LBL_BANK_CHECKSUM 179
+#define ID_STR_DLG_HEX_GOTO_TITLE 180
+#define ID_STR_DLG_HEX_GOTO_BODY 181
+#define ID_STR_MSG_HEX_VIEW_LIVE 182
+#define ID_STR_MSG_BANK_MAP_INSTRUCTIONS 183
+#define ID_STR_MSG_BANK_MAP_SCANNING 184
+#define ID_STR_MSG_BANK_MAP_DETAIL 185
+#define ID_STR_LBL_BANK_MAP_RAM 186
+#define ID_STR_LBL_BANK_MAP_FLASH 187
+#define ID_STR_LBL_BANK_MAP_EMPTY 188
+#define ID_STR_LBL_BANK_MAP_ERASED 189
+#define ID_STR_LBL_BANK_MAP_ENTROPY 190
+#define ID_STR_APP_BANK_MAP 191
+#define ID_STR_DLG_SNAPSHOT_TITLE 192
+#define ID_STR_MSG_SNAPSHOT_CHECKING 193
+#define ID_STR_MSG_SNAPSHOT_NOTHING_CHANGED 194
+#define ID_STR_MSG_SNAPSHOT_FULL_SAVED 195
+#define ID_STR_MSG_SNAPSHOT_INCR_SAVED 196
+#define ID_STR_ERROR_RESTORE_NEEDS_RAM 197
+#define ID_STR_ERROR_NOT_A_SNAPSHOT 198
+#define ID_STR_DLG_RESTORE_SNAPSHOT_TITLE 199
+#define ID_STR_ERROR_SNAPSHOT_CHECKSUM 200
+#define ID_STR_MSG_SNAPSHOT_RESTORED 201
+#define ID_STR_BANK_SNAPSHOT 202
+#define ID_STR_FILE_RESTORE_SNAPSHOT 203
+#define ID_STR_FILETYPE_LZ4 204
+#define ID_STR_FILETYPE_ZX0 205
+#define ID_STR_ERROR_PACKED_FILE_DAMAGED 206
+#define ID_STR_ERROR_UNPACK_NO_ROOM 207
+#define ID_STR_MSG_N_BANKS_UNPACKED 208
+#define ID_STR_ERROR_PATCH_NEEDS_FILES 209
+#define ID_STR_ERROR_NOT_A_PATCH 210
+#define ID_STR_ERROR_PATCH_DAMAGED 211
+#define ID_STR_ERROR_PATCH_TOO_BIG 212
+#define ID_STR_ERROR_PATCH_WRONG_SOURCE 213
+#define ID_STR_ERROR_PATCH_BAD_RESULT 214
+#define ID_STR_ERROR_PATCH_USES_STAGING 215
+#define ID_STR_MSG_IPS_PATCH_APPLIED 216
+#define ID_STR_MSG_BPS_PATCH_APPLIED 217
+#define ID_STR_DLG_PATCH_RAM_TITLE 218
+#define ID_STR_DLG_PATCH_TO_FILE_TITLE 219
+#define ID_STR_FILE_APPLY_PATCH 220
+#define NUM_STRINGS 221
+#define TOTAL_STRING_BYTES 6438